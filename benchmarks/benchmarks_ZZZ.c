@@ -22,6 +22,7 @@
 #include "amcl-extensions/big_XXX.h"
 #include "amcl-extensions/ecp_ZZZ.h"
 #include "amcl-extensions/ecp2_ZZZ.h"
+#include "internal-utilities/sha256.h"
 
 #include <ecdaa/credential_ZZZ.h>
 #include <ecdaa/member_keypair_ZZZ.h>
@@ -29,16 +30,35 @@
 #include <ecdaa/issuer_keypair_ZZZ.h>
 #include <ecdaa/signature_ZZZ.h>
 #include <ecdaa/group_public_key_ZZZ.h>
+#include <ecdaa/prepared_credential_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
 #include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+#include <ecdaa/basename_ctx_ZZZ.h>
+#include <ecdaa/verifier_pool_ZZZ.h>
+#include <ecdaa/presignature_pool_ZZZ.h>
 #include <ecdaa/rand.h>
 
 #include <sys/time.h>
 #include <string.h>
+#include <unistd.h>
 
 static void schnorr_sign_benchmark();
 
 static void sign_benchmark();
+static void sign_prepared_benchmark();
 static void verify_benchmark();
+static void verify_prepared_benchmark();
+static void basename_ctx_benchmark();
+static void presignature_pool_benchmark();
+static void hash_to_curve_benchmark();
+static void serialize_batch_benchmark();
+static void message_hash_benchmark();
+static void multi_hash_benchmark();
+static void batch_verify_benchmark();
+static void verifier_pool_benchmark();
+static void sk_revocation_benchmark();
+static void bsn_revocation_benchmark();
 
 typedef struct sign_and_verify_fixture {
     uint8_t *msg;
@@ -61,7 +81,19 @@ int main()
     schnorr_sign_benchmark();
 
     sign_benchmark();
+    sign_prepared_benchmark();
     verify_benchmark();
+    verify_prepared_benchmark();
+    basename_ctx_benchmark();
+    presignature_pool_benchmark();
+    hash_to_curve_benchmark();
+    serialize_batch_benchmark();
+    message_hash_benchmark();
+    multi_hash_benchmark();
+    batch_verify_benchmark();
+    verifier_pool_benchmark();
+    sk_revocation_benchmark();
+    bsn_revocation_benchmark();
 }
 
 static void setup(sign_and_verify_fixture* fixture)
@@ -87,10 +119,7 @@ static void setup(sign_and_verify_fixture* fixture)
     fixture->basename = (uint8_t*) "BASENAME";
     fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
 
-    fixture->revocations.sk_length=0;
-    fixture->revocations.sk_list=NULL;
-    fixture->revocations.bsn_length=0;
-    fixture->revocations.bsn_list=NULL;
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
 }
 
 static void teardown(sign_and_verify_fixture* fixture)
@@ -163,6 +192,46 @@ static void sign_benchmark()
             rounds * 1000000ULL / elapsed);
 }
 
+static ECP_ZZZ prepared_cred_tables[ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS)];
+
+static void sign_prepared_benchmark()
+{
+    unsigned rounds = 250;
+
+    printf("Starting sign-and-verify::sign_prepared_benchmark (%u iterations)...\n", rounds);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_prepared_credential_ZZZ prepared_cred;
+    struct ecdaa_signature_ZZZ sig;
+
+    for (int window_bits = ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS; window_bits <= ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS; ++window_bits) {
+        size_t table_length = ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits);
+        BENCHMARK_ASSERT(0 == ecdaa_prepared_credential_ZZZ_prepare(&prepared_cred, &fixture.cred, window_bits, prepared_cred_tables, table_length));
+
+        struct timeval tv1;
+        gettimeofday(&tv1, NULL);
+
+        for (unsigned i = 0; i < rounds; i++) {
+            BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign_prepared(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &prepared_cred, benchmark_randomness));
+        }
+
+        struct timeval tv2;
+        gettimeofday(&tv2, NULL);
+        unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+            (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+        printf("%d-bit window (%6zu KB of tables): %llu usec (%6llu signs/s)\n",
+                window_bits,
+                table_length * sizeof(ECP_ZZZ) / 1024,
+                elapsed,
+                rounds * 1000000ULL / elapsed);
+    }
+
+    teardown(&fixture);
+}
+
 static void verify_benchmark()
 {
     unsigned rounds = 250;
@@ -194,3 +263,531 @@ static void verify_benchmark()
             elapsed,
             rounds * 1000000ULL / elapsed);
 }
+
+static struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+
+static void verify_prepared_benchmark()
+{
+    unsigned rounds = 250;
+
+    printf("Starting sign-and-verify::verify_prepared_benchmark (%u iterations)...\n", rounds);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+
+    BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, benchmark_randomness));
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_verify_prepared(&sig, &prepared_gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    }
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    teardown(&fixture);
+
+    printf("%llu usec (%6llu verifications/s)\n",
+            elapsed,
+            rounds * 1000000ULL / elapsed);
+}
+
+static struct ecdaa_basename_ctx_ZZZ signer_basename_ctx;
+static struct ecdaa_basename_ctx_ZZZ verifier_basename_ctx;
+
+static void basename_ctx_benchmark()
+{
+    unsigned rounds = 250;
+
+    printf("Starting sign-and-verify::basename_ctx_benchmark (%u iterations)...\n", rounds);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    BENCHMARK_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&signer_basename_ctx, fixture.basename, fixture.basename_len));
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+    BENCHMARK_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&verifier_basename_ctx, fixture.basename, fixture.basename_len));
+
+    struct ecdaa_signature_ZZZ sig;
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, benchmark_randomness));
+    }
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long sign_elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+    }
+
+    gettimeofday(&tv2, NULL);
+    unsigned long long verify_elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    teardown(&fixture);
+
+    printf("sign: %llu usec (%6llu signs/s)\n",
+            sign_elapsed,
+            rounds * 1000000ULL / sign_elapsed);
+    printf("verify: %llu usec (%6llu verifications/s)\n",
+            verify_elapsed,
+            rounds * 1000000ULL / verify_elapsed);
+}
+
+static void presignature_pool_benchmark()
+{
+    enum { ROUNDS = 250 };
+
+    printf("Starting sign-and-verify::presignature_pool_benchmark (%u iterations)...\n", ROUNDS);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    // Large, so keep it off the stack.
+    static struct ecdaa_signature_ZZZ_sign_ctx slots[ROUNDS];
+    struct ecdaa_presignature_pool_ZZZ pool;
+    BENCHMARK_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&pool, slots, ROUNDS, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, benchmark_randomness));
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    BENCHMARK_ASSERT(ROUNDS == ecdaa_presignature_pool_ZZZ_fill(&pool, ROUNDS));
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long fill_elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    struct ecdaa_signature_ZZZ sig;
+
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&pool, &sig, fixture.msg, fixture.msg_len));
+    }
+
+    gettimeofday(&tv2, NULL);
+    unsigned long long sign_elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    ecdaa_presignature_pool_ZZZ_destroy(&pool);
+
+    teardown(&fixture);
+
+    printf("fill (offline): %llu usec (%6llu presignatures/s)\n",
+            fill_elapsed,
+            ROUNDS * 1000000ULL / fill_elapsed);
+    printf("sign (online): %llu usec (%6llu signs/s)\n",
+            sign_elapsed,
+            ROUNDS * 1000000ULL / (sign_elapsed ? sign_elapsed : 1));
+}
+
+static void hash_to_curve_benchmark()
+{
+    unsigned rounds = 2500;
+
+    printf("Starting ecp::hash_to_curve_benchmark (%u iterations)...\n", rounds);
+
+    // A different basename each time, so try-and-increment's varying cost shows.
+    ECP_ZZZ point;
+    unsigned long long worst[2] = {0, 0};
+    unsigned long long total[2] = {0, 0};
+    for (unsigned i = 0; i < rounds; i++) {
+        for (int method = 0; method < 2; method++) {
+            struct timeval tv1;
+            gettimeofday(&tv1, NULL);
+
+            if (0 == method)
+                ecp_ZZZ_fromhash(&point, (uint8_t*)&i, sizeof(i));
+            else
+                ecp_ZZZ_fromhash_fouque_tibouchi(&point, (uint8_t*)&i, sizeof(i));
+
+            struct timeval tv2;
+            gettimeofday(&tv2, NULL);
+            unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+                (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+            total[method] += elapsed;
+            if (elapsed > worst[method])
+                worst[method] = elapsed;
+        }
+    }
+
+    printf("try-and-increment: %llu usec (worst %llu usec)\n", total[0], worst[0]);
+    printf("Fouque-Tibouchi:   %llu usec (worst %llu usec)\n", total[1], worst[1]);
+}
+
+static void serialize_batch_benchmark()
+{
+    unsigned rounds = 2500;
+
+    printf("Starting ecp::serialize_batch_benchmark (%u iterations)...\n", rounds);
+
+    // Six projective points, as in a signature transcript.
+    ECP_ZZZ points[6];
+    ECP_ZZZ *point_ptrs[6];
+    for (int i = 0; i < 6; i++) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, benchmark_randomness);
+        ecp_ZZZ_set_to_generator(&points[i]);
+        ECP_ZZZ_mul(&points[i], scalar);
+
+        FP_YYY r;
+        ecp_ZZZ_random_mod_order(&scalar, benchmark_randomness);
+        FP_YYY_nres(&r, scalar);
+        FP_YYY_mul(&points[i].x, &points[i].x, &r);
+        FP_YYY_mul(&points[i].y, &points[i].y, &r);
+        FP_YYY_mul(&points[i].z, &points[i].z, &r);
+
+        point_ptrs[i] = &points[i];
+    }
+
+    uint8_t buffer[6*ECP_ZZZ_LENGTH];
+    unsigned long long total[2] = {0, 0};
+    for (int method = 0; method < 2; method++) {
+        struct timeval tv1;
+        gettimeofday(&tv1, NULL);
+
+        for (unsigned i = 0; i < rounds; i++) {
+            if (0 == method) {
+                for (int j = 0; j < 6; j++)
+                    ecp_ZZZ_serialize(buffer + j*ECP_ZZZ_LENGTH, &points[j]);
+            } else {
+                ecp_ZZZ_serialize_batch(buffer, point_ptrs, 6);
+            }
+        }
+
+        struct timeval tv2;
+        gettimeofday(&tv2, NULL);
+        total[method] = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+            (tv1.tv_usec + tv1.tv_sec * 1000000);
+    }
+
+    printf("one at a time: %llu usec\n", total[0]);
+    printf("batched:       %llu usec\n", total[1]);
+}
+
+static void message_hash_benchmark()
+{
+    unsigned rounds = 10000;
+
+    printf("Starting big::message_hash_benchmark (%u iterations, 4 KiB messages)...\n", rounds);
+
+    static uint8_t msg[4096];
+    memset(msg, 0xa5, sizeof(msg));
+
+    enum ecdaa_sha256_implementation original = ecdaa_sha256_get_implementation();
+    enum ecdaa_sha256_implementation all[] = {ECDAA_SHA256_PORTABLE, ECDAA_SHA256_SHA_NI};
+    const char *names[] = {"portable", "SHA-NI"};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i) {
+        if (0 != ecdaa_sha256_set_implementation(all[i]))
+            continue;
+
+        BIG_XXX digest;
+
+        struct timeval tv1;
+        gettimeofday(&tv1, NULL);
+
+        for (unsigned j = 0; j < rounds; j++) {
+            big_XXX_from_hash(&digest, msg, sizeof(msg));
+        }
+
+        struct timeval tv2;
+        gettimeofday(&tv2, NULL);
+        unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+            (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+        printf("%s: %llu usec (%6llu hashes/s)\n",
+                names[i],
+                elapsed,
+                rounds * 1000000ULL / elapsed);
+    }
+    ecdaa_sha256_set_implementation(original);
+}
+
+static void multi_hash_benchmark()
+{
+    unsigned rounds = 10000;
+
+    printf("Starting big::multi_hash_benchmark (%u iterations, %d transcript-sized messages)...\n", rounds, ECDAA_SHA256_MULTI_LANES);
+
+    static uint8_t msgs[ECDAA_SHA256_MULTI_LANES][390];
+    const uint8_t *msg_ptrs[ECDAA_SHA256_MULTI_LANES];
+    uint32_t msg_lens[ECDAA_SHA256_MULTI_LANES];
+    for (size_t i = 0; i < ECDAA_SHA256_MULTI_LANES; ++i) {
+        memset(msgs[i], (int)i, sizeof(msgs[i]));
+        msg_ptrs[i] = msgs[i];
+        msg_lens[i] = sizeof(msgs[i]);
+    }
+
+    enum ecdaa_sha256_multi_implementation original = ecdaa_sha256_multi_get_implementation();
+    enum ecdaa_sha256_multi_implementation all[] = {ECDAA_SHA256_MULTI_SERIAL, ECDAA_SHA256_MULTI_AVX2};
+    const char *names[] = {"serial", "AVX2"};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i) {
+        if (0 != ecdaa_sha256_multi_set_implementation(all[i]))
+            continue;
+
+        BIG_XXX digests[ECDAA_SHA256_MULTI_LANES];
+
+        struct timeval tv1;
+        gettimeofday(&tv1, NULL);
+
+        for (unsigned j = 0; j < rounds; j++) {
+            big_XXX_from_hash_batch(digests, msg_ptrs, msg_lens, ECDAA_SHA256_MULTI_LANES);
+        }
+
+        struct timeval tv2;
+        gettimeofday(&tv2, NULL);
+        unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+            (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+        printf("%s: %llu usec (%6llu hashes/s)\n",
+                names[i],
+                elapsed,
+                rounds * ECDAA_SHA256_MULTI_LANES * 1000000ULL / elapsed);
+    }
+    ecdaa_sha256_multi_set_implementation(original);
+}
+
+static void batch_verify_benchmark()
+{
+    unsigned rounds = 25;
+    enum { BATCH_SIZE = 32 };
+
+    printf("Starting sign-and-verify::batch_verify_benchmark (%u iterations of %u signatures)...\n", rounds, BATCH_SIZE);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sigs[BATCH_SIZE];
+    uint8_t *messages[BATCH_SIZE];
+    uint32_t message_lengths[BATCH_SIZE];
+    uint8_t *basenames[BATCH_SIZE];
+    uint32_t basename_lengths[BATCH_SIZE];
+    int results[BATCH_SIZE];
+    for (unsigned i = 0; i < BATCH_SIZE; i++) {
+        messages[i] = fixture.msg;
+        message_lengths[i] = fixture.msg_len;
+        basenames[i] = fixture.basename;
+        basename_lengths[i] = fixture.basename_len;
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], messages[i], message_lengths[i], basenames[i], basename_lengths[i], &fixture.sk, &fixture.cred, benchmark_randomness));
+    }
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify(sigs, messages, message_lengths, basenames, basename_lengths, BATCH_SIZE, &fixture.ipk.gpk, &fixture.revocations, results));
+    }
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    teardown(&fixture);
+
+    printf("%llu usec (%6llu verifications/s)\n",
+            elapsed,
+            rounds * BATCH_SIZE * 1000000ULL / elapsed);
+}
+
+static void verifier_pool_benchmark()
+{
+    enum { NUM_JOBS = 64, MAX_THREADS = 64 };
+    unsigned rounds = 4;
+
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t num_threads = (num_cpus < 1) ? 1 : (num_cpus > MAX_THREADS ? MAX_THREADS : (size_t)num_cpus);
+
+    printf("Starting sign-and-verify::verifier_pool_benchmark (%u iterations of %u signatures, %zu threads)...\n", rounds, NUM_JOBS, num_threads);
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    struct ecdaa_signature_ZZZ sigs[NUM_JOBS];
+    struct ecdaa_verifier_pool_job_ZZZ jobs[NUM_JOBS];
+    for (unsigned i = 0; i < NUM_JOBS; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, benchmark_randomness));
+        jobs[i].signature = &sigs[i];
+        jobs[i].message = fixture.msg;
+        jobs[i].message_len = fixture.msg_len;
+        jobs[i].basename = fixture.basename;
+        jobs[i].basename_len = fixture.basename_len;
+        jobs[i].callback = NULL;
+        jobs[i].user_data = NULL;
+    }
+
+    pthread_t threads[MAX_THREADS];
+    struct ecdaa_verifier_pool_job_ZZZ *submitted[NUM_JOBS];
+    struct ecdaa_verifier_pool_job_ZZZ *completed[NUM_JOBS];
+    struct ecdaa_verifier_pool_ZZZ pool;
+    BENCHMARK_ASSERT(0 == ecdaa_verifier_pool_ZZZ_init(&pool, &prepared_gpk, &fixture.revocations, ECDAA_VERIFY_POLICY_COMPLETE, threads, num_threads, submitted, completed, NUM_JOBS));
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        for (unsigned j = 0; j < NUM_JOBS; j++) {
+            BENCHMARK_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&pool, &jobs[j]));
+        }
+
+        struct ecdaa_verifier_pool_job_ZZZ *collected[NUM_JOBS];
+        size_t num_collected;
+        while (0 != (num_collected = ecdaa_verifier_pool_ZZZ_wait(&pool, collected, NUM_JOBS))) {
+            for (size_t j = 0; j < num_collected; j++) {
+                BENCHMARK_ASSERT(0 == collected[j]->result);
+            }
+        }
+    }
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    ecdaa_verifier_pool_ZZZ_destroy(&pool);
+
+    teardown(&fixture);
+
+    printf("%llu usec (%6llu verifications/s)\n",
+            elapsed,
+            rounds * NUM_JOBS * 1000000ULL / elapsed);
+}
+
+static struct ecdaa_member_secret_key_ZZZ sk_rev_list[100000];
+
+static void sk_revocation_benchmark()
+{
+    size_t list_lengths[] = {0, 10, 100, 1000, 10000, 100000};
+
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t num_threads = (num_cpus < 1) ? 1 : (size_t)num_cpus;
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, benchmark_randomness));
+
+    for (size_t i = 0; i < sizeof(sk_rev_list) / sizeof(sk_rev_list[0]); i++) {
+        ecp_ZZZ_random_mod_order(&sk_rev_list[i].sk, benchmark_randomness);
+    }
+
+    for (size_t l = 0; l < sizeof(list_lengths) / sizeof(list_lengths[0]); l++) {
+        // Keep the total work roughly constant.
+        unsigned rounds = list_lengths[l] < 100 ? 25 : (list_lengths[l] < 10000 ? 5 : 1);
+
+        struct ecdaa_revocations_ZZZ revocations = {.sk_length=list_lengths[l], .sk_list=sk_rev_list, .bsn_length=0, .bsn_list=NULL, .sk_scan_threads=num_threads, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+
+        printf("Starting sign-and-verify::sk_revocation_benchmark (%u iterations, %zu revoked keys, %zu threads)...\n", rounds, list_lengths[l], num_threads);
+
+        struct timeval tv1;
+        gettimeofday(&tv1, NULL);
+
+        for (unsigned i = 0; i < rounds; i++) {
+            BENCHMARK_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+        }
+
+        struct timeval tv2;
+        gettimeofday(&tv2, NULL);
+        unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+            (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+        printf("%llu usec (%6llu verifications/s)\n",
+                elapsed,
+                rounds * 1000000ULL / elapsed);
+    }
+
+    teardown(&fixture);
+}
+
+#define BSN_REVOCATION_BENCHMARK_LENGTH 100000
+static ECP_ZZZ bsn_rev_list[BSN_REVOCATION_BENCHMARK_LENGTH];
+static uint8_t bsn_rev_set_slots[2 * 131072 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+static uint8_t bsn_rev_set_bloom[262144];
+
+static void bsn_revocation_benchmark()
+{
+    unsigned rounds = 1000;
+
+    // Consecutive multiples of a random point are as good as random K's here.
+    ECP_ZZZ base;
+    BIG_XXX scalar;
+    ecp_ZZZ_random_mod_order(&scalar, benchmark_randomness);
+    ecp_ZZZ_mul_generator(&base, scalar);
+    ECP_ZZZ_copy(&bsn_rev_list[0], &base);
+    for (size_t i = 1; i < BSN_REVOCATION_BENCHMARK_LENGTH; i++) {
+        ECP_ZZZ_copy(&bsn_rev_list[i], &bsn_rev_list[i-1]);
+        ECP_ZZZ_add(&bsn_rev_list[i], &base);
+        ECP_ZZZ_affine(&bsn_rev_list[i]);
+    }
+
+    struct ecdaa_bsn_revocation_set_ZZZ set;
+    BENCHMARK_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, bsn_rev_set_slots, 2 * 131072, bsn_rev_set_bloom, sizeof(bsn_rev_set_bloom)));
+    for (size_t i = 0; i < BSN_REVOCATION_BENCHMARK_LENGTH; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&set, &bsn_rev_list[i]));
+    }
+
+    // An unrevoked K (the worst case for the list).
+    ECP_ZZZ K;
+    ecp_ZZZ_random_mod_order(&scalar, benchmark_randomness);
+    ecp_ZZZ_mul_generator(&K, scalar);
+    ECP_ZZZ_affine(&K);
+
+    printf("Starting bsn-revocation::list_lookup_benchmark (%d iterations, %d revoked basenames)...\n", 10, BSN_REVOCATION_BENCHMARK_LENGTH);
+
+    struct timeval tv1;
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < 10; i++) {
+        for (size_t j = 0; j < BSN_REVOCATION_BENCHMARK_LENGTH; ++j) {
+            BENCHMARK_ASSERT(!ECP_ZZZ_equals(&bsn_rev_list[j], &K));
+        }
+    }
+
+    struct timeval tv2;
+    gettimeofday(&tv2, NULL);
+    unsigned long long elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    printf("%llu usec (%6llu lookups/s, %zu bytes)\n",
+            elapsed,
+            10 * 1000000ULL / elapsed,
+            sizeof(bsn_rev_list));
+
+    printf("Starting bsn-revocation::set_lookup_benchmark (%d iterations, %d revoked basenames)...\n", rounds, BSN_REVOCATION_BENCHMARK_LENGTH);
+
+    gettimeofday(&tv1, NULL);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        BENCHMARK_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &K));
+    }
+
+    gettimeofday(&tv2, NULL);
+    elapsed = (tv2.tv_usec + tv2.tv_sec * 1000000) -
+        (tv1.tv_usec + tv1.tv_sec * 1000000);
+
+    printf("%llu usec (%6llu lookups/s, %zu bytes)\n",
+            elapsed,
+            rounds * 1000000ULL / elapsed,
+            sizeof(bsn_rev_set_slots) + sizeof(bsn_rev_set_bloom));
+}
@@ -18,25 +18,29 @@
 
 #include "./big_XXX.h"
 #include "internal-utilities/explicit_bzero.h"
+#include "internal-utilities/sha256.h"
 
 #include <amcl/ecp_ZZZ.h>
 #include <amcl/amcl.h>
 
-#include <assert.h>
+#include <string.h>
 
-static void convert_hash_to_big_XXX(BIG_XXX *big_out, hash256 *hash);
+static void convert_hash_to_big_XXX(BIG_XXX *big_out, struct ecdaa_sha256 *hash);
+
+static void hash_messages_batch_XXX(BIG_XXX *big_out,
+                                    const uint8_t ***msgs_in,
+                                    const uint32_t **msg_lens,
+                                    size_t num_segments,
+                                    size_t num_hashes);
 
 void big_XXX_from_hash(BIG_XXX *big_out,
                        const uint8_t *msg_in,
                        uint32_t msg_len)
 {
-    hash256 hash;
-    HASH256_init(&hash);
+    struct ecdaa_sha256 hash;
+    ecdaa_sha256_init(&hash);
 
-    // Process input one-byte-at-a-time.
-    for (uint32_t i=0; i < msg_len; ++i) {
-        HASH256_process(&hash, msg_in[i]);
-    }
+    ecdaa_sha256_update(&hash, msg_in, msg_len);
 
     convert_hash_to_big_XXX(big_out, &hash);
 }
@@ -47,18 +51,11 @@ void big_XXX_from_two_message_hash(BIG_XXX *big_out,
                                    const uint8_t *msg2_in,
                                    uint32_t msg2_len)
 {
-    hash256 hash;
-    HASH256_init(&hash);
-
-    // Process msg1 one-byte-at-a-time.
-    for (uint32_t i=0; i < msg1_len; ++i) {
-        HASH256_process(&hash, msg1_in[i]);
-    }
+    struct ecdaa_sha256 hash;
+    ecdaa_sha256_init(&hash);
 
-    // Process msg2 one-byte-at-a-time.
-    for (uint32_t i=0; i < msg2_len; ++i) {
-        HASH256_process(&hash, msg2_in[i]);
-    }
+    ecdaa_sha256_update(&hash, msg1_in, msg1_len);
+    ecdaa_sha256_update(&hash, msg2_in, msg2_len);
 
     convert_hash_to_big_XXX(big_out, &hash);
 }
@@ -71,25 +68,56 @@ void big_XXX_from_three_message_hash(BIG_XXX *big_out,
                                      const uint8_t *msg3_in,
                                      uint32_t msg3_len)
 {
-    hash256 hash;
-    HASH256_init(&hash);
+    struct ecdaa_sha256 hash;
+    ecdaa_sha256_init(&hash);
 
-    // Process msg1 one-byte-at-a-time.
-    for (uint32_t i=0; i < msg1_len; ++i) {
-        HASH256_process(&hash, msg1_in[i]);
-    }
+    ecdaa_sha256_update(&hash, msg1_in, msg1_len);
+    ecdaa_sha256_update(&hash, msg2_in, msg2_len);
+    ecdaa_sha256_update(&hash, msg3_in, msg3_len);
 
-    // Process msg2 one-byte-at-a-time.
-    for (uint32_t i=0; i < msg2_len; ++i) {
-        HASH256_process(&hash, msg2_in[i]);
-    }
+    convert_hash_to_big_XXX(big_out, &hash);
+}
 
-    // Process msg3 one-byte-at-a-time.
-    for (uint32_t i=0; i < msg3_len; ++i) {
-        HASH256_process(&hash, msg3_in[i]);
-    }
+void big_XXX_from_sha256(BIG_XXX *big_out,
+                         struct ecdaa_sha256 *hash)
+{
+    convert_hash_to_big_XXX(big_out, hash);
+}
 
-    convert_hash_to_big_XXX(big_out, &hash);
+void big_XXX_from_hash_batch(BIG_XXX *big_out,
+                             const uint8_t **msg_in,
+                             const uint32_t *msg_len,
+                             size_t num_hashes)
+{
+    const uint8_t **msgs_in[] = {msg_in};
+    const uint32_t *msg_lens[] = {msg_len};
+    hash_messages_batch_XXX(big_out, msgs_in, msg_lens, 1, num_hashes);
+}
+
+void big_XXX_from_two_message_hash_batch(BIG_XXX *big_out,
+                                         const uint8_t **msg1_in,
+                                         const uint32_t *msg1_len,
+                                         const uint8_t **msg2_in,
+                                         const uint32_t *msg2_len,
+                                         size_t num_hashes)
+{
+    const uint8_t **msgs_in[] = {msg1_in, msg2_in};
+    const uint32_t *msg_lens[] = {msg1_len, msg2_len};
+    hash_messages_batch_XXX(big_out, msgs_in, msg_lens, 2, num_hashes);
+}
+
+void big_XXX_from_three_message_hash_batch(BIG_XXX *big_out,
+                                           const uint8_t **msg1_in,
+                                           const uint32_t *msg1_len,
+                                           const uint8_t **msg2_in,
+                                           const uint32_t *msg2_len,
+                                           const uint8_t **msg3_in,
+                                           const uint32_t *msg3_len,
+                                           size_t num_hashes)
+{
+    const uint8_t **msgs_in[] = {msg1_in, msg2_in, msg3_in};
+    const uint32_t *msg_lens[] = {msg1_len, msg2_len, msg3_len};
+    hash_messages_batch_XXX(big_out, msgs_in, msg_lens, 3, num_hashes);
 }
 
 void big_XXX_mod_mul_and_add(BIG_XXX *big_out,
@@ -113,16 +141,77 @@ void big_XXX_mod_mul_and_add(BIG_XXX *big_out,
     BIG_XXX_mod(*big_out, modulus);
 }
 
-static void convert_hash_to_big_XXX(BIG_XXX *big_out, hash256 *hash)
+int big_XXX_to_wnaf(signed char *digits_out,
+                    BIG_XXX scalar,
+                    int window_bits)
 {
-    char hash_as_bytes[32] = {0};
-    assert(hash->hlen == sizeof(hash_as_bytes));
+    BIG_XXX k;
+    BIG_XXX_copy(k, scalar);
+    BIG_XXX_norm(k);
+
+    int num_digits = 0;
+    while (!BIG_XXX_iszilch(k)) {
+        int digit = 0;
+        if (BIG_XXX_parity(k)) {
+            // digit = k mods 2^window_bits
+            digit = BIG_XXX_lastbits(k, window_bits);
+            if (digit >= (1 << (window_bits - 1))) {
+                digit -= (1 << window_bits);
+                BIG_XXX_inc(k, -digit);
+            } else {
+                BIG_XXX_dec(k, digit);
+            }
+            BIG_XXX_norm(k);
+        }
+        digits_out[num_digits++] = (signed char)digit;
+        BIG_XXX_fshr(k, 1);
+    }
+
+    return num_digits;
+}
+
+static void convert_hash_to_big_XXX(BIG_XXX *big_out, struct ecdaa_sha256 *hash)
+{
+    uint8_t hash_as_bytes[ECDAA_SHA256_DIGEST_LENGTH] = {0};
 
     // Clears the hash object after output.
-    HASH256_hash(hash, hash_as_bytes);
+    ecdaa_sha256_final(hash, hash_as_bytes);
 
     // Convert byte-string to un-normalized BIG.
-    BIG_XXX_fromBytesLen(*big_out, hash_as_bytes, hash->hlen);
+    BIG_XXX_fromBytesLen(*big_out, (char*)hash_as_bytes, sizeof(hash_as_bytes));
 
     explicit_bzero(hash_as_bytes, sizeof(hash_as_bytes));
 }
+
+static void hash_messages_batch_XXX(BIG_XXX *big_out,
+                                    const uint8_t ***msgs_in,
+                                    const uint32_t **msg_lens,
+                                    size_t num_segments,
+                                    size_t num_hashes)
+{
+    // One group of lanes at a time, so nothing needs allocating.
+    struct ecdaa_sha256_message messages[ECDAA_SHA256_MULTI_LANES];
+    uint8_t digests[ECDAA_SHA256_MULTI_LANES * ECDAA_SHA256_DIGEST_LENGTH];
+
+    for (size_t begin = 0; begin < num_hashes; begin += ECDAA_SHA256_MULTI_LANES) {
+        size_t count = num_hashes - begin;
+        if (count > ECDAA_SHA256_MULTI_LANES)
+            count = ECDAA_SHA256_MULTI_LANES;
+
+        memset(messages, 0, sizeof(messages));
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < num_segments; ++j) {
+                messages[i].segments[j] = msgs_in[j][begin + i];
+                messages[i].segment_lengths[j] = msg_lens[j][begin + i];
+            }
+        }
+
+        ecdaa_sha256_multi(digests, messages, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            BIG_XXX_fromBytesLen(big_out[begin + i], (char*)(digests + i*ECDAA_SHA256_DIGEST_LENGTH), ECDAA_SHA256_DIGEST_LENGTH);
+        }
+    }
+
+    explicit_bzero(digests, sizeof(digests));
+}
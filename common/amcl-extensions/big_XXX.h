@@ -28,8 +28,11 @@ extern "C" {
 #include <amcl/amcl.h>
 #include <amcl/randapi.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
+struct ecdaa_sha256;
+
 /*
  * Hash the supplied message and convert to a BIG_XXX.
  *
@@ -61,6 +64,42 @@ void big_XXX_from_three_message_hash(BIG_XXX *big_out,
                                      const uint8_t *msg3_in,
                                      uint32_t msg3_len);
 
+/*
+ * Finish an incremental hash (see `ecdaa_sha256_update`) and convert to a BIG_XXX,
+ *  as for big_XXX_from_hash.
+ *
+ * The hash context is cleared.
+ */
+void big_XXX_from_sha256(BIG_XXX *big_out,
+                         struct ecdaa_sha256 *hash);
+
+/*
+ * Batched versions of the above: big_out[i] = Hash(msg1_in[i] | msg2_in[i] | ...), for i < num_hashes.
+ *
+ * The hashes are computed several at a time (see `ecdaa_sha256_multi`),
+ *  so this is faster than separate calls when there are several independent messages to hash.
+ */
+void big_XXX_from_hash_batch(BIG_XXX *big_out,
+                             const uint8_t **msg_in,
+                             const uint32_t *msg_len,
+                             size_t num_hashes);
+
+void big_XXX_from_two_message_hash_batch(BIG_XXX *big_out,
+                                         const uint8_t **msg1_in,
+                                         const uint32_t *msg1_len,
+                                         const uint8_t **msg2_in,
+                                         const uint32_t *msg2_len,
+                                         size_t num_hashes);
+
+void big_XXX_from_three_message_hash_batch(BIG_XXX *big_out,
+                                           const uint8_t **msg1_in,
+                                           const uint32_t *msg1_len,
+                                           const uint8_t **msg2_in,
+                                           const uint32_t *msg2_len,
+                                           const uint8_t **msg3_in,
+                                           const uint32_t *msg3_len,
+                                           size_t num_hashes);
+
 /*
  * Multiply two BIG_XXX's, then add the product to a third BIG_XXX, all modulo a given modulus.
  *
@@ -75,6 +114,26 @@ void big_XXX_mod_mul_and_add(BIG_XXX *big_out,
                              BIG_XXX multiplicand2,
                              BIG_XXX modulus);
 
+/*
+ * Recode a non-negative BIG_XXX into width-`window_bits` NAF form.
+ *
+ * digits_out[i] (least-significant first) is either zero or odd,
+ *  with absolute value less than 2^(window_bits-1),
+ *  and of any `window_bits` consecutive digits at most one is non-zero.
+ *  scalar = sum(digits_out[i] * 2^i).
+ *
+ * `digits_out` must have room for BIG_XXX_WNAF_MAX_DIGITS entries.
+ * `window_bits` must be between 2 and 7.
+ *
+ * NOT constant-time, so only use with public scalars.
+ *
+ * Returns the number of digits written (0 if scalar is zero).
+ */
+#define BIG_XXX_WNAF_MAX_DIGITS (NLEN_XXX*BASEBITS_XXX + 1)
+int big_XXX_to_wnaf(signed char *digits_out,
+                    BIG_XXX scalar,
+                    int window_bits);
+
 #ifdef __cplusplus
 }
 #endif
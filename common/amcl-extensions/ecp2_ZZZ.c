@@ -17,6 +17,21 @@
  *****************************************************************************/
 
 #include "./ecp2_ZZZ.h"
+#include "./pairing_ZZZ.h"
+#include "./big_XXX.h"
+
+/*
+ * G2 membership can be checked with psi when we know the curve family.
+ */
+#if defined(ECDAA_PAIRING_TYPE_ZZZ) && defined(SEXTIC_TWIST_ZZZ) && defined(SIGN_OF_X_ZZZ)
+#if ECDAA_PAIRING_TYPE_ZZZ == BN || ECDAA_PAIRING_TYPE_ZZZ == BLS
+#define ECDAA_PSI_SUBGROUP_CHECK_ZZZ
+#endif
+#endif
+
+#define MUL_MULTI_BATCH_SIZE 4
+
+static void mul_multi_batch_ecp2_ZZZ(ECP2_ZZZ *point_out, ECP2_ZZZ **points, BIG_XXX *scalars, size_t count);
 
 size_t ecp2_ZZZ_length(void)
 {
@@ -39,6 +54,71 @@ void ecp2_ZZZ_set_to_generator(ECP2_ZZZ *point)
     ECP2_ZZZ_set(point, &x, &y);
 }
 
+void ecp2_ZZZ_mul_vartime(ECP2_ZZZ *point,
+                          BIG_XXX scalar)
+{
+    signed char digits[BIG_XXX_WNAF_MAX_DIGITS];
+    int num_digits = big_XXX_to_wnaf(digits, scalar, ECP2_ZZZ_MUL_VARTIME_WINDOW_BITS);
+
+    // table[j] = (2j+1)*point
+    ECP2_ZZZ table[1 << (ECP2_ZZZ_MUL_VARTIME_WINDOW_BITS - 2)];
+    ECP2_ZZZ twice_point;
+    ECP2_ZZZ_copy(&table[0], point);
+    ECP2_ZZZ_copy(&twice_point, point);
+    ECP2_ZZZ_dbl(&twice_point);
+    for (int j = 1; j < (1 << (ECP2_ZZZ_MUL_VARTIME_WINDOW_BITS - 2)); ++j) {
+        ECP2_ZZZ_copy(&table[j], &table[j-1]);
+        ECP2_ZZZ_add(&table[j], &twice_point);
+    }
+
+    ECP2_ZZZ_inf(point);
+    for (int i = num_digits - 1; i >= 0; --i) {
+        ECP2_ZZZ_dbl(point);
+        if (digits[i] > 0) {
+            ECP2_ZZZ_add(point, &table[digits[i] >> 1]);
+        } else if (digits[i] < 0) {
+            ECP2_ZZZ_sub(point, &table[(-digits[i]) >> 1]);
+        }
+    }
+
+    ECP2_ZZZ_affine(point);
+}
+
+void ecp2_ZZZ_mul_multi(ECP2_ZZZ *point_out,
+                        ECP2_ZZZ **points,
+                        BIG_XXX *scalars,
+                        size_t num_points)
+{
+    // Points are handled in batches, to bound the size of the tables on the stack.
+    ECP2_ZZZ partial;
+    ECP2_ZZZ_inf(point_out);
+    for (size_t begin = 0; begin < num_points; begin += MUL_MULTI_BATCH_SIZE) {
+        size_t count = num_points - begin;
+        if (count > MUL_MULTI_BATCH_SIZE)
+            count = MUL_MULTI_BATCH_SIZE;
+
+        mul_multi_batch_ecp2_ZZZ(&partial, points + begin, scalars + begin, count);
+        ECP2_ZZZ_add(point_out, &partial);
+    }
+
+    ECP2_ZZZ_affine(point_out);
+}
+
+void ecp2_ZZZ_mul2(ECP2_ZZZ *point_out,
+                   ECP2_ZZZ *point1,
+                   BIG_XXX scalar1,
+                   ECP2_ZZZ *point2,
+                   BIG_XXX scalar2)
+{
+    ECP2_ZZZ *points[2] = {point1, point2};
+
+    BIG_XXX scalars[2];
+    BIG_XXX_copy(scalars[0], scalar1);
+    BIG_XXX_copy(scalars[1], scalar2);
+
+    ecp2_ZZZ_mul_multi(point_out, points, scalars, 2);
+}
+
 void ecp2_ZZZ_serialize(uint8_t *buffer_out,
                         ECP2_ZZZ *point)
 {
@@ -97,17 +177,109 @@ int ecp2_ZZZ_deserialize(ECP2_ZZZ *point_out,
 
     // 6) Check that point is in the proper subgroup
     //  (step 4 in X9.62 Sec 5.2.2)
-    //  (check order*point == inf).
+    if (!ecp2_ZZZ_in_subgroup(point_out)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+#ifdef SEXTIC_TWIST_ZZZ
+void ecp2_ZZZ_psi(ECP2_ZZZ *point)
+{
+    BIG_XXX a, b;
+    BIG_XXX_rcopy(a, Fra_YYY);
+    BIG_XXX_rcopy(b, Frb_YYY);
+
+    FP2_YYY X;
+    FP2_YYY_from_BIGs(&X, a, b);
+#if SEXTIC_TWIST_ZZZ == M_TYPE
+    FP2_YYY_inv(&X, &X);
+    FP2_YYY_norm(&X);
+#endif
+
+    ECP2_ZZZ_frob(point, &X);
+}
+#endif
+
+int ecp2_ZZZ_in_subgroup(ECP2_ZZZ *point)
+{
+#ifdef ECDAA_PSI_SUBGROUP_CHECK_ZZZ
+    // On G2, psi acts as multiplication by p mod r = t - 1,
+    //  i.e. by 6u^2 on BN curves and by u on BLS12 curves.
+    //  For these curves, that also characterizes G2
+    //  (cf. Scott, "A note on group membership tests for G1, G2 and GT
+    //   on BLS pairing-friendly curves", 2021).
+    BIG_XXX e;
+    BIG_XXX_rcopy(e, CURVE_Bnx_ZZZ);
+#if ECDAA_PAIRING_TYPE_ZZZ == BN
+    BIG_XXX u, curve_order;
+    BIG_XXX_copy(u, e);
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+    BIG_XXX_modmul(e, u, u, curve_order);
+    BIG_XXX_imul(e, e, 6);
+    BIG_XXX_norm(e);
+#endif
+
+    ECP2_ZZZ psi_point, multiple;
+    ECP2_ZZZ_copy(&psi_point, point);
+    ecp2_ZZZ_psi(&psi_point);
+
+    ECP2_ZZZ_copy(&multiple, point);
+    ecp2_ZZZ_mul_vartime(&multiple, e);
+#if ECDAA_PAIRING_TYPE_ZZZ == BLS && SIGN_OF_X_ZZZ == NEGATIVEX
+    ECP2_ZZZ_neg(&multiple);
+#endif
+
+    return ECP2_ZZZ_equals(&psi_point, &multiple);
+#else
+    // (check order*point == inf).
     ECP2_ZZZ point_copy;
-    ECP2_ZZZ_copy(&point_copy, point_out);
+    ECP2_ZZZ_copy(&point_copy, point);
 
     BIG_XXX curve_order;
     BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
-    ECP2_ZZZ_mul(&point_copy, curve_order);
+    ecp2_ZZZ_mul_vartime(&point_copy, curve_order);
 
-    if (!ECP2_ZZZ_isinf(&point_copy)) {
-        return -1;
+    return ECP2_ZZZ_isinf(&point_copy);
+#endif
+}
+
+static void mul_multi_batch_ecp2_ZZZ(ECP2_ZZZ *point_out, ECP2_ZZZ **points, BIG_XXX *scalars, size_t count)
+{
+    // table[i][j] = j*points[i]
+    ECP2_ZZZ table[MUL_MULTI_BATCH_SIZE][1 << ECP2_ZZZ_MUL_MULTI_WINDOW_BITS];
+    int max_bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        BIG_XXX_norm(scalars[i]);
+        int bits = BIG_XXX_nbits(scalars[i]);
+        if (bits > max_bits)
+            max_bits = bits;
+
+        ECP2_ZZZ_inf(&table[i][0]);
+        ECP2_ZZZ_copy(&table[i][1], points[i]);
+        for (int j = 2; j < (1 << ECP2_ZZZ_MUL_MULTI_WINDOW_BITS); ++j) {
+            ECP2_ZZZ_copy(&table[i][j], &table[i][j-1]);
+            ECP2_ZZZ_add(&table[i][j], points[i]);
+        }
     }
 
-    return 0;
+    // Process the windows of all scalars together, most-significant first.
+    ECP2_ZZZ_inf(point_out);
+    int num_windows = (max_bits + ECP2_ZZZ_MUL_MULTI_WINDOW_BITS - 1) / ECP2_ZZZ_MUL_MULTI_WINDOW_BITS;
+    for (int window = num_windows - 1; window >= 0; --window) {
+        for (int k = 0; k < ECP2_ZZZ_MUL_MULTI_WINDOW_BITS; ++k) {
+            ECP2_ZZZ_dbl(point_out);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            int digit = 0;
+            for (int bit = ECP2_ZZZ_MUL_MULTI_WINDOW_BITS - 1; bit >= 0; --bit) {
+                digit = 2*digit + BIG_XXX_bit(scalars[i], window*ECP2_ZZZ_MUL_MULTI_WINDOW_BITS + bit);
+            }
+
+            if (0 != digit)
+                ECP2_ZZZ_add(point_out, &table[i][digit]);
+        }
+    }
 }
@@ -36,6 +36,40 @@ size_t ecp2_ZZZ_length(void);
  */
 void ecp2_ZZZ_set_to_generator(ECP2_ZZZ *point);
 
+/*
+ * Multiply a G2 point by a scalar (point = scalar*point),
+ *  using a width-ECP2_ZZZ_MUL_VARTIME_WINDOW_BITS NAF of the scalar.
+ *
+ * NOT constant-time, so only use with public scalars and points (e.g. when verifying).
+ *
+ * Output is affine.
+ */
+#define ECP2_ZZZ_MUL_VARTIME_WINDOW_BITS 5
+void ecp2_ZZZ_mul_vartime(ECP2_ZZZ *point,
+                          BIG_XXX scalar);
+
+/*
+ * Apply the untwist-Frobenius-twist endomorphism (psi) to a point.
+ *
+ * Only available on curves whose sextic twist type is known (SEXTIC_TWIST_ZZZ).
+ */
+#ifdef SEXTIC_TWIST_ZZZ
+void ecp2_ZZZ_psi(ECP2_ZZZ *point);
+#endif
+
+/*
+ * Check that a point (already known to be on the curve) is in G2.
+ *
+ * On BN and BLS12 curves, this checks psi(point) == [p mod r]point,
+ *  which needs only a half-length scalar multiplication.
+ *  On other curves, it checks [r]point == inf.
+ *
+ * Returns:
+ * 1 if the point is in G2
+ * 0 otherwise
+ */
+int ecp2_ZZZ_in_subgroup(ECP2_ZZZ *point);
+
 /*
  * Serialize an ECP2_ZZZ point.
  *
@@ -56,6 +90,33 @@ void ecp2_ZZZ_serialize(uint8_t *buffer_out,
 int ecp2_ZZZ_deserialize(ECP2_ZZZ *point_out,
                          uint8_t *buffer);
 
+/*
+ * Compute sum(scalars[i] * points[i]).
+ *
+ * Uses Straus' method (with ECP2_ZZZ_MUL_MULTI_WINDOW_BITS-bit windows):
+ *  the scalar multiplications are interleaved, so they share one chain of doublings.
+ *
+ * NOT constant-time, so only use with public scalars (e.g. when verifying).
+ *
+ * Output is affine.
+ */
+#define ECP2_ZZZ_MUL_MULTI_WINDOW_BITS 4
+void ecp2_ZZZ_mul_multi(ECP2_ZZZ *point_out,
+                        ECP2_ZZZ **points,
+                        BIG_XXX *scalars,
+                        size_t num_points);
+
+/*
+ * Compute scalar1*point1 + scalar2*point2, as with `ecp2_ZZZ_mul_multi`.
+ *
+ * NOT constant-time, so only use with public scalars (e.g. when verifying).
+ */
+void ecp2_ZZZ_mul2(ECP2_ZZZ *point_out,
+                   ECP2_ZZZ *point1,
+                   BIG_XXX scalar1,
+                   ECP2_ZZZ *point2,
+                   BIG_XXX scalar2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,43 @@
 #include "./big_XXX.h"
 
 #include "internal-utilities/rand_pool.h"
+#include "internal-utilities/explicit_bzero.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define MUL_MULTI_BATCH_SIZE 4
+
+static void mul_multi_batch_ecp_ZZZ(ECP_ZZZ *point_out, ECP_ZZZ **points, BIG_XXX *scalars, size_t count);
+
+static void select_generator_multiple_ZZZ(ECP_ZZZ *point_out, int position, int digit);
+
+static void select_fixed_base_multiple_ZZZ(ECP_ZZZ *point_out, ECP_ZZZ *row, unsigned num_entries, int digit);
+
+static void ecp_ZZZ_cmove(ECP_ZZZ *point, ECP_ZZZ *other, int move);
+
+static void batch_affine_group_ZZZ(ECP_ZZZ **points, size_t num_points);
+
+static void scale_to_affine_ZZZ(ECP_ZZZ *point, FP_YYY *z_inverse, FP_YYY *one);
+
+static void recode_signed_odd_ZZZ(signed char *digits_out, BIG_XXX t, int window_bits, int num_positions);
+
+static void hash_to_field_ZZZ(FP_YYY *element_out, uint8_t index, const uint8_t *message, uint32_t message_length);
+
+static void fouque_tibouchi_constants_init_ZZZ(void);
+
+static int fouque_tibouchi_map_ZZZ(ECP_ZZZ *point_out, FP_YYY *t, FP_YYY *sqrt_neg3, FP_YYY *b);
+
+static int fp_YYY_is_square(FP_YYY *x);
+
+// Constants for `ecp_ZZZ_fromhash_fouque_tibouchi`,
+//  computed on first use, exactly once (by `fouque_tibouchi_constants_init_ZZZ`).
+static pthread_once_t fouque_tibouchi_once_ZZZ = PTHREAD_ONCE_INIT;
+static int fouque_tibouchi_supported_ZZZ = 0;
+static FP_YYY fouque_tibouchi_sqrt_neg3_ZZZ;
+static FP_YYY fouque_tibouchi_b_ZZZ;
+// (q-1)/2, the exponent for Euler's criterion in `fp_YYY_is_square`.
+static BIG_XXX euler_exponent_YYY;
 
 size_t ecp_ZZZ_length(void)
 {
@@ -34,6 +71,223 @@ void ecp_ZZZ_set_to_generator(ECP_ZZZ *point)
     ECP_ZZZ_set(point, gx, gy);
 }
 
+void ecp_ZZZ_mul_vartime(ECP_ZZZ *point,
+                         BIG_XXX scalar)
+{
+    signed char digits[BIG_XXX_WNAF_MAX_DIGITS];
+    int num_digits = big_XXX_to_wnaf(digits, scalar, ECP_ZZZ_MUL_VARTIME_WINDOW_BITS);
+
+    // table[j] = (2j+1)*point
+    ECP_ZZZ table[1 << (ECP_ZZZ_MUL_VARTIME_WINDOW_BITS - 2)];
+    ECP_ZZZ twice_point;
+    ECP_ZZZ_copy(&table[0], point);
+    ECP_ZZZ_copy(&twice_point, point);
+    ECP_ZZZ_dbl(&twice_point);
+    for (int j = 1; j < (1 << (ECP_ZZZ_MUL_VARTIME_WINDOW_BITS - 2)); ++j) {
+        ECP_ZZZ_copy(&table[j], &table[j-1]);
+        ECP_ZZZ_add(&table[j], &twice_point);
+    }
+
+    ECP_ZZZ_inf(point);
+    for (int i = num_digits - 1; i >= 0; --i) {
+        ECP_ZZZ_dbl(point);
+        if (digits[i] > 0) {
+            ECP_ZZZ_add(point, &table[digits[i] >> 1]);
+        } else if (digits[i] < 0) {
+            ECP_ZZZ_sub(point, &table[(-digits[i]) >> 1]);
+        }
+    }
+
+    ECP_ZZZ_affine(point);
+}
+
+void ecp_ZZZ_mul_generator(ECP_ZZZ *point_out,
+                           BIG_XXX scalar)
+{
+    // 1) Make the scalar odd (t = scalar + 1 if scalar is even),
+    //      so every digit of its signed recoding is odd, and thus non-zero.
+    BIG_XXX t;
+    BIG_XXX_copy(t, scalar);
+    BIG_XXX_norm(t);
+    int even = 1 - BIG_XXX_parity(t);
+    BIG_XXX_inc(t, even);
+    BIG_XXX_norm(t);
+
+    // 2) Recode t into signed, odd digits in [-15, 15], one per table position.
+    signed char digits[ECP_ZZZ_GENERATOR_TABLE_POSITIONS];
+    recode_signed_odd_ZZZ(digits, t, ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS, ECP_ZZZ_GENERATOR_TABLE_POSITIONS);
+
+    // 3) Sum digit[i] * 16^i * G, looked up from the table.
+    ECP_ZZZ result, multiple;
+    select_generator_multiple_ZZZ(&result, 0, digits[0]);
+    for (int i = 1; i < ECP_ZZZ_GENERATOR_TABLE_POSITIONS; ++i) {
+        select_generator_multiple_ZZZ(&multiple, i, digits[i]);
+        ECP_ZZZ_add(&result, &multiple);
+    }
+
+    // 4) Undo step 1, if necessary.
+    ECP_ZZZ corrected;
+    ECP_ZZZ_copy(&corrected, &result);
+    ecp_ZZZ_set_to_generator(&multiple);
+    ECP_ZZZ_sub(&corrected, &multiple);
+    ecp_ZZZ_cmove(&result, &corrected, even);
+
+    ECP_ZZZ_affine(&result);
+    ECP_ZZZ_copy(point_out, &result);
+
+    // Clear sensitive intermediate memory.
+    explicit_bzero(t, sizeof(BIG_XXX));
+    explicit_bzero(digits, sizeof(digits));
+    explicit_bzero(&result, sizeof(ECP_ZZZ));
+    explicit_bzero(&corrected, sizeof(ECP_ZZZ));
+    explicit_bzero(&multiple, sizeof(ECP_ZZZ));
+}
+
+void ecp_ZZZ_fixed_base_table_build(struct ecp_ZZZ_fixed_base_table *table_out,
+                                    ECP_ZZZ *point)
+{
+    ecp_ZZZ_fixed_base_table_build_window(&table_out->entries[0][0], point, ECP_ZZZ_FIXED_BASE_WINDOW_BITS);
+}
+
+void ecp_ZZZ_fixed_base_mul(ECP_ZZZ *point_out,
+                            struct ecp_ZZZ_fixed_base_table *table,
+                            BIG_XXX scalar)
+{
+    ecp_ZZZ_fixed_base_mul_window(point_out, &table->entries[0][0], ECP_ZZZ_FIXED_BASE_WINDOW_BITS, scalar);
+}
+
+void ecp_ZZZ_fixed_base_table_build_window(ECP_ZZZ *table_out,
+                                           ECP_ZZZ *point,
+                                           int window_bits)
+{
+    int num_positions = ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(window_bits);
+    int num_entries = 1 << (window_bits - 1);
+
+    ECP_ZZZ base, twice_base;
+    ECP_ZZZ_copy(&base, point);
+    for (int i = 0; i < num_positions; ++i) {
+        // Odd multiples of base = 2^(w*i) * point
+        ECP_ZZZ *row = table_out + i*num_entries;
+        ECP_ZZZ_copy(&twice_base, &base);
+        ECP_ZZZ_dbl(&twice_base);
+        ECP_ZZZ_copy(&row[0], &base);
+        for (int j = 1; j < num_entries; ++j) {
+            ECP_ZZZ_copy(&row[j], &row[j-1]);
+            ECP_ZZZ_add(&row[j], &twice_base);
+        }
+
+        for (int k = 0; k < window_bits; ++k) {
+            ECP_ZZZ_dbl(&base);
+        }
+    }
+}
+
+void ecp_ZZZ_fixed_base_mul_window(ECP_ZZZ *point_out,
+                                   ECP_ZZZ *table,
+                                   int window_bits,
+                                   BIG_XXX scalar)
+{
+    // Same as `ecp_ZZZ_mul_generator`, but with the run-time table.
+    int num_positions = ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(window_bits);
+    unsigned num_entries = 1u << (window_bits - 1);
+
+    BIG_XXX t;
+    BIG_XXX_copy(t, scalar);
+    BIG_XXX_norm(t);
+    int even = 1 - BIG_XXX_parity(t);
+    BIG_XXX_inc(t, even);
+    BIG_XXX_norm(t);
+
+    signed char digits[ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(ECP_ZZZ_FIXED_BASE_MIN_WINDOW_BITS)];
+    recode_signed_odd_ZZZ(digits, t, window_bits, num_positions);
+
+    ECP_ZZZ result, multiple;
+    select_fixed_base_multiple_ZZZ(&result, table, num_entries, digits[0]);
+    for (int i = 1; i < num_positions; ++i) {
+        select_fixed_base_multiple_ZZZ(&multiple, table + i*num_entries, num_entries, digits[i]);
+        ECP_ZZZ_add(&result, &multiple);
+    }
+
+    ECP_ZZZ corrected;
+    ECP_ZZZ_copy(&corrected, &result);
+    ECP_ZZZ_sub(&corrected, &table[0]);
+    ecp_ZZZ_cmove(&result, &corrected, even);
+
+    ECP_ZZZ_affine(&result);
+    ECP_ZZZ_copy(point_out, &result);
+
+    // Clear sensitive intermediate memory.
+    explicit_bzero(t, sizeof(BIG_XXX));
+    explicit_bzero(digits, sizeof(digits));
+    explicit_bzero(&result, sizeof(ECP_ZZZ));
+    explicit_bzero(&corrected, sizeof(ECP_ZZZ));
+    explicit_bzero(&multiple, sizeof(ECP_ZZZ));
+}
+
+void ecp_ZZZ_fixed_base_mul_vartime(ECP_ZZZ *point_out,
+                                    struct ecp_ZZZ_fixed_base_table *table,
+                                    BIG_XXX scalar)
+{
+    // Same recoding as `ecp_ZZZ_mul_generator`:
+    //  make the scalar odd, so that every digit is odd (and thus has a table entry).
+    BIG_XXX t;
+    BIG_XXX_copy(t, scalar);
+    BIG_XXX_norm(t);
+    int even = 1 - BIG_XXX_parity(t);
+    BIG_XXX_inc(t, even);
+    BIG_XXX_norm(t);
+
+    signed char digits[ECP_ZZZ_FIXED_BASE_POSITIONS];
+    recode_signed_odd_ZZZ(digits, t, ECP_ZZZ_FIXED_BASE_WINDOW_BITS, ECP_ZZZ_FIXED_BASE_POSITIONS);
+
+    ECP_ZZZ_inf(point_out);
+    for (int i = 0; i < ECP_ZZZ_FIXED_BASE_POSITIONS; ++i) {
+        if (digits[i] > 0) {
+            ECP_ZZZ_add(point_out, &table->entries[i][(digits[i] - 1) >> 1]);
+        } else if (digits[i] < 0) {
+            ECP_ZZZ_sub(point_out, &table->entries[i][(-digits[i] - 1) >> 1]);
+        }
+    }
+
+    if (even)
+        ECP_ZZZ_sub(point_out, &table->entries[0][0]);
+}
+
+void ecp_ZZZ_mul_multi(ECP_ZZZ *point_out,
+                       ECP_ZZZ **points,
+                       BIG_XXX *scalars,
+                       size_t num_points)
+{
+    // Points are handled in batches, to bound the size of the tables on the stack.
+    ECP_ZZZ partial;
+    ECP_ZZZ_inf(point_out);
+    for (size_t begin = 0; begin < num_points; begin += MUL_MULTI_BATCH_SIZE) {
+        size_t count = num_points - begin;
+        if (count > MUL_MULTI_BATCH_SIZE)
+            count = MUL_MULTI_BATCH_SIZE;
+
+        mul_multi_batch_ecp_ZZZ(&partial, points + begin, scalars + begin, count);
+        ECP_ZZZ_add(point_out, &partial);
+    }
+
+    ECP_ZZZ_affine(point_out);
+}
+
+void ecp_ZZZ_mul2(ECP_ZZZ *point_out,
+                  ECP_ZZZ *point1,
+                  BIG_XXX scalar1,
+                  ECP_ZZZ *point2,
+                  BIG_XXX scalar2)
+{
+    ECP_ZZZ *points[2] = {point1, point2};
+
+    BIG_XXX scalars[2];
+    BIG_XXX_copy(scalars[0], scalar1);
+    BIG_XXX_copy(scalars[1], scalar2);
+
+    ecp_ZZZ_mul_multi(point_out, points, scalars, 2);
+}
+
 void ecp_ZZZ_serialize(uint8_t *buffer_out,
                        ECP_ZZZ *point)
 {
@@ -44,6 +298,44 @@ void ecp_ZZZ_serialize(uint8_t *buffer_out,
     ECP_ZZZ_toOctet(&as_oct, point);
 }
 
+void ecp_ZZZ_serialize_batch(uint8_t *buffer_out,
+                             ECP_ZZZ **points,
+                             size_t num_points)
+{
+    ECP_ZZZ copies[ECP_ZZZ_BATCH_AFFINE_MAX_POINTS];
+    ECP_ZZZ *copy_ptrs[ECP_ZZZ_BATCH_AFFINE_MAX_POINTS];
+
+    for (size_t begin = 0; begin < num_points; begin += ECP_ZZZ_BATCH_AFFINE_MAX_POINTS) {
+        size_t count = num_points - begin;
+        if (count > ECP_ZZZ_BATCH_AFFINE_MAX_POINTS)
+            count = ECP_ZZZ_BATCH_AFFINE_MAX_POINTS;
+
+        for (size_t i = 0; i < count; ++i) {
+            ECP_ZZZ_copy(&copies[i], points[begin + i]);
+            copy_ptrs[i] = &copies[i];
+        }
+
+        batch_affine_group_ZZZ(copy_ptrs, count);
+
+        // (Already affine, so these don't invert again)
+        for (size_t i = 0; i < count; ++i) {
+            ecp_ZZZ_serialize(buffer_out + (begin + i)*ECP_ZZZ_LENGTH, &copies[i]);
+        }
+    }
+}
+
+void ecp_ZZZ_batch_affine(ECP_ZZZ **points,
+                          size_t num_points)
+{
+    for (size_t begin = 0; begin < num_points; begin += ECP_ZZZ_BATCH_AFFINE_MAX_POINTS) {
+        size_t count = num_points - begin;
+        if (count > ECP_ZZZ_BATCH_AFFINE_MAX_POINTS)
+            count = ECP_ZZZ_BATCH_AFFINE_MAX_POINTS;
+
+        batch_affine_group_ZZZ(points + begin, count);
+    }
+}
+
 int ecp_ZZZ_deserialize(ECP_ZZZ *point_out,
                         uint8_t *buffer)
 {
@@ -86,7 +378,7 @@ int ecp_ZZZ_deserialize(ECP_ZZZ *point_out,
 
     BIG_XXX cof;
     BIG_XXX_rcopy(cof, CURVE_Cof_ZZZ);
-    ECP_ZZZ_mul(&point_copy, cof);
+    ecp_ZZZ_mul_vartime(&point_copy, cof);
 
     if (ECP_ZZZ_isinf(&point_copy)) {
         return -1;
@@ -123,6 +415,41 @@ int32_t ecp_ZZZ_fromhash(ECP_ZZZ *point_out, const uint8_t *message, uint32_t me
     return -1;
 }
 
+int ecp_ZZZ_fromhash_fouque_tibouchi(ECP_ZZZ *point_out, const uint8_t *message, uint32_t message_length)
+{
+    pthread_once(&fouque_tibouchi_once_ZZZ, fouque_tibouchi_constants_init_ZZZ);
+    if (!fouque_tibouchi_supported_ZZZ)
+        return -1;
+
+    // (Copies, as AMCL's field arithmetic may normalize its inputs in place.)
+    FP_YYY sqrt_neg3, b;
+    FP_YYY_copy(&sqrt_neg3, &fouque_tibouchi_sqrt_neg3_ZZZ);
+    FP_YYY_copy(&b, &fouque_tibouchi_b_ZZZ);
+
+    FP_YYY t1, t2;
+    hash_to_field_ZZZ(&t1, 0, message, message_length);
+    hash_to_field_ZZZ(&t2, 1, message, message_length);
+
+    ECP_ZZZ second;
+    int ret = 0;
+    ret |= fouque_tibouchi_map_ZZZ(point_out, &t1, &sqrt_neg3, &b);
+    ret |= fouque_tibouchi_map_ZZZ(&second, &t2, &sqrt_neg3, &b);
+    if (0 != ret)
+        return -1;
+
+    ECP_ZZZ_add(point_out, &second);
+
+    BIG_XXX cofactor;
+    BIG_XXX_rcopy(cofactor, CURVE_Cof_ZZZ);
+    if (!BIG_XXX_isunity(cofactor)) {
+        ECP_ZZZ_mul(point_out, cofactor);
+    }
+
+    ECP_ZZZ_affine(point_out);
+
+    return 0;
+}
+
 void ecp_ZZZ_random_mod_order(BIG_XXX *big_out,
                               void (*get_random)(void *buf, size_t buflen))
 {
@@ -157,3 +484,318 @@ void ecp_ZZZ_random_mod_order(BIG_XXX *big_out,
     BIG_XXX_dmod(*big_out,d,curve_order);
 }
 
+static void select_generator_multiple_ZZZ(ECP_ZZZ *point_out, int position, int digit)
+{
+    // Constant-time: every entry at this position is read, regardless of the digit.
+    int negative = (digit >> (8*sizeof(int) - 1)) & 1;
+    int magnitude = (digit ^ -negative) + negative;
+    unsigned index = (unsigned)(magnitude - 1) >> 1;
+
+    BIG_XXX x, y, entry;
+    BIG_XXX_zero(x);
+    BIG_XXX_zero(y);
+    for (unsigned j = 0; j < ECP_ZZZ_GENERATOR_TABLE_ENTRIES; ++j) {
+        int match = (int)(((j ^ index) - 1) >> (8*sizeof(unsigned) - 1));
+        BIG_XXX_rcopy(entry, ecp_ZZZ_generator_table[position][j][0]);
+        BIG_XXX_cmove(x, entry, match);
+        BIG_XXX_rcopy(entry, ecp_ZZZ_generator_table[position][j][1]);
+        BIG_XXX_cmove(y, entry, match);
+    }
+
+    // -(x, y) = (x, p - y)
+    BIG_XXX modulus, negative_y;
+    BIG_XXX_rcopy(modulus, Modulus_ZZZ);
+    BIG_XXX_sub(negative_y, modulus, y);
+    BIG_XXX_norm(negative_y);
+    BIG_XXX_cmove(y, negative_y, negative);
+
+    ECP_ZZZ_set(point_out, x, y);
+
+    explicit_bzero(x, sizeof(BIG_XXX));
+    explicit_bzero(y, sizeof(BIG_XXX));
+    explicit_bzero(entry, sizeof(BIG_XXX));
+    explicit_bzero(negative_y, sizeof(BIG_XXX));
+}
+
+static void select_fixed_base_multiple_ZZZ(ECP_ZZZ *point_out, ECP_ZZZ *row, unsigned num_entries, int digit)
+{
+    // Constant-time: every entry in the row is read, regardless of the digit.
+    int negative = (digit >> (8*sizeof(int) - 1)) & 1;
+    int magnitude = (digit ^ -negative) + negative;
+    unsigned index = (unsigned)(magnitude - 1) >> 1;
+
+    ECP_ZZZ_copy(point_out, &row[0]);
+    for (unsigned j = 1; j < num_entries; ++j) {
+        int match = (int)(((j ^ index) - 1) >> (8*sizeof(unsigned) - 1));
+        ecp_ZZZ_cmove(point_out, &row[j], match);
+    }
+
+    ECP_ZZZ negated;
+    ECP_ZZZ_copy(&negated, point_out);
+    ECP_ZZZ_neg(&negated);
+    ecp_ZZZ_cmove(point_out, &negated, negative);
+
+    explicit_bzero(&negated, sizeof(ECP_ZZZ));
+}
+
+static void batch_affine_group_ZZZ(ECP_ZZZ **points, size_t num_points)
+{
+    FP_YYY one;
+    FP_YYY_one(&one);
+
+    // 1) Collect the points needing conversion,
+    //      and the running products of their z-coordinates: products[i] = z_0 * ... * z_i
+    ECP_ZZZ *pending[ECP_ZZZ_BATCH_AFFINE_MAX_POINTS];
+    FP_YYY products[ECP_ZZZ_BATCH_AFFINE_MAX_POINTS];
+    size_t num_pending = 0;
+    for (size_t i = 0; i < num_points; ++i) {
+        if (ECP_ZZZ_isinf(points[i]) || FP_YYY_equals(&points[i]->z, &one))
+            continue;
+
+        if (0 == num_pending) {
+            FP_YYY_copy(&products[0], &points[i]->z);
+        } else {
+            FP_YYY_mul(&products[num_pending], &products[num_pending-1], &points[i]->z);
+        }
+        pending[num_pending++] = points[i];
+    }
+
+    if (0 == num_pending)
+        return;
+
+    // 2) The only inversion: inverse = (z_0 * ... * z_n)^-1
+    FP_YYY inverse;
+    FP_YYY_inv(&inverse, &products[num_pending-1]);
+
+    // 3) Peel off one point at a time, from the end:
+    //      z_i^-1 = (z_0 * ... * z_i)^-1 * (z_0 * ... * z_(i-1)),
+    //      and then (z_0 * ... * z_(i-1))^-1 = (z_0 * ... * z_i)^-1 * z_i
+    FP_YYY z_inverse;
+    for (size_t i = num_pending - 1; i > 0; --i) {
+        FP_YYY_mul(&z_inverse, &inverse, &products[i-1]);
+        FP_YYY_mul(&inverse, &inverse, &pending[i]->z);
+        scale_to_affine_ZZZ(pending[i], &z_inverse, &one);
+    }
+    scale_to_affine_ZZZ(pending[0], &inverse, &one);
+}
+
+static void scale_to_affine_ZZZ(ECP_ZZZ *point, FP_YYY *z_inverse, FP_YYY *one)
+{
+    // (Same as the end of ECP_ZZZ_affine, with z^-1 already known)
+    FP_YYY_mul(&point->x, &point->x, z_inverse);
+    FP_YYY_reduce(&point->x);
+    FP_YYY_mul(&point->y, &point->y, z_inverse);
+    FP_YYY_reduce(&point->y);
+    FP_YYY_copy(&point->z, one);
+}
+
+static void ecp_ZZZ_cmove(ECP_ZZZ *point, ECP_ZZZ *other, int move)
+{
+    // Byte-wise, so as not to depend on AMCL's representation of points.
+    unsigned char mask = (unsigned char)(-move);
+    unsigned char *dst = (unsigned char*)point;
+    const unsigned char *src = (const unsigned char*)other;
+    for (size_t i = 0; i < sizeof(ECP_ZZZ); ++i) {
+        dst[i] ^= mask & (dst[i] ^ src[i]);
+    }
+}
+
+static void mul_multi_batch_ecp_ZZZ(ECP_ZZZ *point_out, ECP_ZZZ **points, BIG_XXX *scalars, size_t count)
+{
+    // table[i][j] = j*points[i]
+    ECP_ZZZ table[MUL_MULTI_BATCH_SIZE][1 << ECP_ZZZ_MUL_MULTI_WINDOW_BITS];
+    // Normalized copies of the scalars (the caller's are left as they are)
+    BIG_XXX normalized[MUL_MULTI_BATCH_SIZE];
+    int max_bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        BIG_XXX_copy(normalized[i], scalars[i]);
+        BIG_XXX_norm(normalized[i]);
+        int bits = BIG_XXX_nbits(normalized[i]);
+        if (bits > max_bits)
+            max_bits = bits;
+
+        ECP_ZZZ_inf(&table[i][0]);
+        ECP_ZZZ_copy(&table[i][1], points[i]);
+        for (int j = 2; j < (1 << ECP_ZZZ_MUL_MULTI_WINDOW_BITS); ++j) {
+            ECP_ZZZ_copy(&table[i][j], &table[i][j-1]);
+            ECP_ZZZ_add(&table[i][j], points[i]);
+        }
+    }
+
+    // Process the windows of all scalars together, most-significant first.
+    ECP_ZZZ_inf(point_out);
+    int num_windows = (max_bits + ECP_ZZZ_MUL_MULTI_WINDOW_BITS - 1) / ECP_ZZZ_MUL_MULTI_WINDOW_BITS;
+    for (int window = num_windows - 1; window >= 0; --window) {
+        for (int k = 0; k < ECP_ZZZ_MUL_MULTI_WINDOW_BITS; ++k) {
+            ECP_ZZZ_dbl(point_out);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            int digit = 0;
+            for (int bit = ECP_ZZZ_MUL_MULTI_WINDOW_BITS - 1; bit >= 0; --bit) {
+                digit = 2*digit + BIG_XXX_bit(normalized[i], window*ECP_ZZZ_MUL_MULTI_WINDOW_BITS + bit);
+            }
+
+            if (0 != digit)
+                ECP_ZZZ_add(point_out, &table[i][digit]);
+        }
+    }
+}
+
+static void recode_signed_odd_ZZZ(signed char *digits_out, BIG_XXX t, int window_bits, int num_positions)
+{
+    // `t` must be odd. It's consumed.
+    //  Digits are signed, odd, and in [-(2^window_bits - 1), 2^window_bits - 1],
+    //  except the last (which holds whatever remains of t, and is non-negative).
+    //  Runs in constant time.
+    for (int i = 0; i < num_positions - 1; ++i) {
+        digits_out[i] = (signed char)(BIG_XXX_lastbits(t, window_bits + 1) - (1 << window_bits));
+        BIG_XXX_dec(t, digits_out[i]);
+        BIG_XXX_norm(t);
+        BIG_XXX_fshr(t, window_bits);
+    }
+    digits_out[num_positions - 1] = (signed char)BIG_XXX_lastbits(t, window_bits + 1);
+}
+
+void hash_to_field_ZZZ(FP_YYY *element_out, uint8_t index, const uint8_t *message, uint32_t message_length)
+{
+    // Two SHA-256 outputs (512 bits), so the reduction mod q is close to uniform.
+    static const char domain[] = "ECDAA Fouque-Tibouchi";
+
+    char wide_bytes[2*MODBYTES_XXX] = {0};
+    for (uint8_t half=0; half < 2; half++) {
+        uint8_t prefix[sizeof(domain) + 1];
+        memcpy(prefix, domain, sizeof(domain));
+        prefix[sizeof(domain) - 1] = index;
+        prefix[sizeof(domain)] = half;
+
+        BIG_XXX hashed;
+        big_XXX_from_two_message_hash(&hashed, prefix, sizeof(prefix), message, message_length);
+        BIG_XXX_toBytes(wide_bytes + half*MODBYTES_XXX, hashed);
+    }
+
+    DBIG_XXX wide;
+    BIG_XXX_dfromBytesLen(wide, wide_bytes, sizeof(wide_bytes));
+
+    BIG_XXX modulus, reduced;
+    BIG_XXX_rcopy(modulus, Modulus_YYY);
+    BIG_XXX_dmod(reduced, wide, modulus);
+
+    FP_YYY_nres(element_out, reduced);
+}
+
+void fouque_tibouchi_constants_init_ZZZ(void)
+{
+    // The map is only defined for curves y^2 = x^3 + b
+    if (0 != CURVE_A_ZZZ)
+        return;
+
+    FP_YYY one, neg3, check;
+    FP_YYY_one(&one);
+    FP_YYY_add(&neg3, &one, &one);
+    FP_YYY_add(&neg3, &neg3, &one);
+    FP_YYY_neg(&neg3, &neg3);
+    FP_YYY_sqrt(&fouque_tibouchi_sqrt_neg3_ZZZ, &neg3);
+    FP_YYY_sqr(&check, &fouque_tibouchi_sqrt_neg3_ZZZ);
+    if (!FP_YYY_equals(&check, &neg3))
+        return;
+
+    BIG_XXX b_big;
+    BIG_XXX_rcopy(b_big, CURVE_B_ZZZ);
+    FP_YYY_nres(&fouque_tibouchi_b_ZZZ, b_big);
+
+    BIG_XXX_rcopy(euler_exponent_YYY, Modulus_YYY);
+    BIG_XXX_dec(euler_exponent_YYY, 1);
+    BIG_XXX_norm(euler_exponent_YYY);
+    BIG_XXX_fshr(euler_exponent_YYY, 1);
+
+    fouque_tibouchi_supported_ZZZ = 1;
+}
+
+int fouque_tibouchi_map_ZZZ(ECP_ZZZ *point_out, FP_YYY *t, FP_YYY *sqrt_neg3, FP_YYY *b)
+{
+    // Every branch below is replaced by a conditional move, so the cost doesn't depend on t.
+
+    FP_YYY one, zero, tmp;
+    FP_YYY_one(&one);
+    FP_YYY_zero(&zero);
+
+    // w := sqrt(-3) * t / (1 + b + t^2)
+    //  (If the denominator is zero, set w := 0, as in the paper.)
+    FP_YYY denominator, w;
+    FP_YYY_sqr(&denominator, t);
+    FP_YYY_add(&denominator, &denominator, &one);
+    FP_YYY_add(&denominator, &denominator, b);
+    int denominator_is_zero = FP_YYY_iszilch(&denominator);
+    FP_YYY_cmove(&denominator, &one, denominator_is_zero);
+    FP_YYY_inv(&denominator, &denominator);
+    FP_YYY_mul(&w, sqrt_neg3, t);
+    FP_YYY_mul(&w, &w, &denominator);
+    FP_YYY_cmove(&w, &zero, denominator_is_zero);
+
+    // x1 := (-1 + sqrt(-3)) / 2 - t*w
+    FP_YYY x1;
+    FP_YYY_sub(&x1, sqrt_neg3, &one);
+    FP_YYY_div2(&x1, &x1);
+    FP_YYY_mul(&tmp, t, &w);
+    FP_YYY_sub(&x1, &x1, &tmp);
+
+    // x2 := -1 - x1
+    FP_YYY x2;
+    FP_YYY_neg(&x2, &x1);
+    FP_YYY_sub(&x2, &x2, &one);
+
+    // x3 := 1 + 1/w^2
+    //  (Only reached when w != 0, but computed regardless.)
+    FP_YYY x3;
+    FP_YYY_sqr(&tmp, &w);
+    FP_YYY_cmove(&tmp, &one, FP_YYY_iszilch(&tmp));
+    FP_YYY_inv(&tmp, &tmp);
+    FP_YYY_add(&x3, &one, &tmp);
+
+    // x := the first of x1, x2, x3 for which x^3 + b is square
+    //  (at least one is, for any t).
+    FP_YYY x, rhs;
+    FP_YYY_copy(&x, &x3);
+
+    FP_YYY_sqr(&rhs, &x2);
+    FP_YYY_mul(&rhs, &rhs, &x2);
+    FP_YYY_add(&rhs, &rhs, b);
+    FP_YYY_cmove(&x, &x2, fp_YYY_is_square(&rhs));
+
+    FP_YYY_sqr(&rhs, &x1);
+    FP_YYY_mul(&rhs, &rhs, &x1);
+    FP_YYY_add(&rhs, &rhs, b);
+    FP_YYY_cmove(&x, &x1, fp_YYY_is_square(&rhs));
+
+    // y := sqrt(x^3 + b), negated if t is not square
+    FP_YYY y;
+    FP_YYY_sqr(&rhs, &x);
+    FP_YYY_mul(&rhs, &rhs, &x);
+    FP_YYY_add(&rhs, &rhs, b);
+    FP_YYY_sqrt(&y, &rhs);
+    FP_YYY_neg(&tmp, &y);
+    FP_YYY_cmove(&y, &tmp, 1 - fp_YYY_is_square(t));
+
+    BIG_XXX x_big, y_big;
+    FP_YYY_redc(x_big, &x);
+    FP_YYY_redc(y_big, &y);
+    if (!ECP_ZZZ_set(point_out, x_big, y_big))
+        return -1;
+
+    return 0;
+}
+
+int fp_YYY_is_square(FP_YYY *x)
+{
+    // Euler's criterion: x^((q-1)/2) is 1 for a non-zero square, and -1 otherwise.
+    //  The exponent is fixed, so (unlike FP_YYY_qr, which uses the Jacobi symbol)
+    //  the cost doesn't depend on x.
+    //  Zero counts as square here (its square root is zero).
+    FP_YYY power;
+    BIG_XXX exponent;
+    BIG_XXX_copy(exponent, euler_exponent_YYY);
+    FP_YYY_pow(&power, x, exponent);
+
+    return FP_YYY_isunity(&power) | FP_YYY_iszilch(x);
+}
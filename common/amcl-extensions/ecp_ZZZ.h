@@ -37,6 +37,121 @@ size_t ecp_ZZZ_length(void);
  */
 void ecp_ZZZ_set_to_generator(ECP_ZZZ *point);
 
+/*
+ * Multiply a G1 point by a scalar (point = scalar*point),
+ *  using a width-ECP_ZZZ_MUL_VARTIME_WINDOW_BITS NAF of the scalar.
+ *
+ * NOT constant-time, so only use with public scalars and points (e.g. when verifying).
+ *  Anything multiplying by a secret (signing, credential issuance and randomization)
+ *  must use AMCL's `ECP_ZZZ_mul`, whose ladder runs in constant time.
+ *
+ * Output is affine.
+ */
+#define ECP_ZZZ_MUL_VARTIME_WINDOW_BITS 5
+void ecp_ZZZ_mul_vartime(ECP_ZZZ *point,
+                         BIG_XXX scalar);
+
+/*
+ * Fixed-base table for the G1 generator, generated at build time
+ *  (see generate_ecp_ZZZ_generator_table.c).
+ *
+ * Entry [i][j] holds the affine coordinates of (2j+1) * 16^i * G.
+ */
+#define ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS 4
+#define ECP_ZZZ_GENERATOR_TABLE_ENTRIES (1 << (ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS - 1))
+#define ECP_ZZZ_GENERATOR_TABLE_POSITIONS (2 + (8*MODBYTES_XXX + ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS - 1) / ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS)
+extern const BIG_XXX ecp_ZZZ_generator_table[ECP_ZZZ_GENERATOR_TABLE_POSITIONS][ECP_ZZZ_GENERATOR_TABLE_ENTRIES][2];
+
+/*
+ * Multiply the G1 generator by `scalar`, using the precomputed table.
+ *
+ * Equivalent to `ecp_ZZZ_set_to_generator` followed by `ECP_ZZZ_mul`,
+ *  but uses only point additions (no doublings).
+ *
+ * Runs in constant time, so `scalar` may be secret.
+ * `scalar` must be less than 2^(8*MODBYTES_XXX) (e.g. reduced modulo the group order).
+ */
+void ecp_ZZZ_mul_generator(ECP_ZZZ *point_out,
+                           BIG_XXX scalar);
+
+/*
+ * Fixed-base table for an arbitrary G1 point, built at run time.
+ *
+ * Entry [i][j] holds (2j+1) * 2^(w*i) * point, where w is ECP_ZZZ_FIXED_BASE_WINDOW_BITS
+ *  (which may be overridden at build time).
+ *
+ * Building the table costs about as much as three scalar multiplications.
+ *  After that, each `ecp_ZZZ_fixed_base_mul_vartime` costs only
+ *  ECP_ZZZ_FIXED_BASE_POSITIONS point additions (no doublings).
+ *  So, use it when multiplying one point by many scalars.
+ *
+ * The table is large (tens of kilobytes), so mind the stack.
+ */
+#ifndef ECP_ZZZ_FIXED_BASE_WINDOW_BITS
+#define ECP_ZZZ_FIXED_BASE_WINDOW_BITS 4
+#endif
+#define ECP_ZZZ_FIXED_BASE_ENTRIES (1 << (ECP_ZZZ_FIXED_BASE_WINDOW_BITS - 1))
+#define ECP_ZZZ_FIXED_BASE_POSITIONS (2 + (8*MODBYTES_XXX + ECP_ZZZ_FIXED_BASE_WINDOW_BITS - 1) / ECP_ZZZ_FIXED_BASE_WINDOW_BITS)
+struct ecp_ZZZ_fixed_base_table {
+    ECP_ZZZ entries[ECP_ZZZ_FIXED_BASE_POSITIONS][ECP_ZZZ_FIXED_BASE_ENTRIES];
+};
+
+/*
+ * Build the fixed-base table for `point`.
+ */
+void ecp_ZZZ_fixed_base_table_build(struct ecp_ZZZ_fixed_base_table *table_out,
+                                    ECP_ZZZ *point);
+
+/*
+ * Multiply the table's point by `scalar`, using the table.
+ *
+ * Runs in constant time (every entry at each position is read, regardless of the scalar),
+ *  so `scalar` may be secret.
+ * `scalar` must be less than 2^(8*MODBYTES_XXX) (e.g. reduced modulo the group order).
+ *
+ * Output is affine.
+ */
+void ecp_ZZZ_fixed_base_mul(ECP_ZZZ *point_out,
+                            struct ecp_ZZZ_fixed_base_table *table,
+                            BIG_XXX scalar);
+
+/*
+ * Same as `ecp_ZZZ_fixed_base_mul`, but skipping the table entries not needed.
+ *
+ * NOT constant-time, so only use with public scalars and points (e.g. when verifying).
+ * `scalar` must be less than 2^(8*MODBYTES_XXX) (e.g. reduced modulo the group order).
+ *
+ * Output is NOT affine.
+ */
+void ecp_ZZZ_fixed_base_mul_vartime(ECP_ZZZ *point_out,
+                                    struct ecp_ZZZ_fixed_base_table *table,
+                                    BIG_XXX scalar);
+
+/*
+ * Same as `ecp_ZZZ_fixed_base_table_build` and `ecp_ZZZ_fixed_base_mul`,
+ *  but with the window width chosen at run time
+ *  (from ECP_ZZZ_FIXED_BASE_MIN_WINDOW_BITS to ECP_ZZZ_FIXED_BASE_MAX_WINDOW_BITS),
+ *  and the table in caller-provided storage of ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(window_bits) points.
+ *
+ * Each extra bit of window roughly doubles the table's size,
+ *  but saves ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(w) - ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(w+1) additions per multiplication.
+ *
+ * `ecp_ZZZ_fixed_base_mul_window` runs in constant time, so `scalar` may be secret.
+ */
+#define ECP_ZZZ_FIXED_BASE_MIN_WINDOW_BITS 2
+#define ECP_ZZZ_FIXED_BASE_MAX_WINDOW_BITS 6
+#define ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(window_bits) (2 + (8*MODBYTES_XXX + (window_bits) - 1) / (window_bits))
+#define ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(window_bits) (ECP_ZZZ_FIXED_BASE_POSITIONS_FOR(window_bits) << ((window_bits) - 1))
+
+void ecp_ZZZ_fixed_base_table_build_window(ECP_ZZZ *table_out,
+                                           ECP_ZZZ *point,
+                                           int window_bits);
+
+void ecp_ZZZ_fixed_base_mul_window(ECP_ZZZ *point_out,
+                                   ECP_ZZZ *table,
+                                   int window_bits,
+                                   BIG_XXX scalar);
+
 /*
  * Serialize an ECP_ZZZ point.
  *
@@ -45,6 +160,34 @@ void ecp_ZZZ_set_to_generator(ECP_ZZZ *point);
 void ecp_ZZZ_serialize(uint8_t *buffer_out,
                        ECP_ZZZ *point);
 
+/*
+ * Serialize `num_points` points (as with `ecp_ZZZ_serialize`),
+ *  one after another in `buffer_out` (which must hold num_points*ECP_ZZZ_LENGTH bytes).
+ *
+ * The points are converted to affine with a single shared field inversion
+ *  (see `ecp_ZZZ_batch_affine`), rather than one inversion each.
+ *  That's done on copies, so `points` aren't modified.
+ *
+ * Whether that beats `ecp_ZZZ_serialize` per point depends on the cost of AMCL's
+ *  inversion (see serialize_batch_benchmark), so measure before using it on a hot path.
+ */
+void ecp_ZZZ_serialize_batch(uint8_t *buffer_out,
+                             ECP_ZZZ **points,
+                             size_t num_points);
+
+/*
+ * Convert points to affine coordinates, with one field inversion for up to
+ *  ECP_ZZZ_BATCH_AFFINE_MAX_POINTS points (rather than one inversion per point).
+ *
+ * Uses Montgomery's trick: invert the product of the points' z-coordinates,
+ *  then recover each point's inverse z from it with multiplications.
+ *
+ * Points at infinity, and points that are already affine, are left as they are.
+ */
+#define ECP_ZZZ_BATCH_AFFINE_MAX_POINTS 16
+void ecp_ZZZ_batch_affine(ECP_ZZZ **points,
+                          size_t num_points);
+
 /*
  * De-serialize an ECP_ZZZ point.
  *
@@ -75,6 +218,27 @@ int ecp_ZZZ_deserialize(ECP_ZZZ *point_out,
  */
 int32_t ecp_ZZZ_fromhash(ECP_ZZZ *point_out, const uint8_t *message, uint32_t message_length);
 
+/*
+ * Hash a message into an ECP_ZZZ point, in constant time.
+ *
+ * Uses the map of Fouque and Tibouchi ("Indifferentiable Hashing to Barreto-Naehrig Curves", 2012),
+ *  so the curve must be of the form y^2 = x^3 + b (as BN curves are):
+ *  1. Compute t1 := H(0, m) and t2 := H(1, m), each from 512 bits of hash output, reduced mod q.
+ *  2. Map each t to a point f(t): the x-coordinate is the first of three candidates
+ *      for which x**3 + b is square, and the sign of y is that of t (as a quadratic residue).
+ *  3. Output f(t1) + f(t2), multiplied by the cofactor.
+ *
+ * Unlike `ecp_ZZZ_fromhash`, the running time doesn't depend on the message.
+ *  The two give different points for the same message.
+ *
+ * Output is affine.
+ *
+ * Returns:
+ *  0 on success
+ *  -1 if the curve isn't supported
+ */
+int ecp_ZZZ_fromhash_fouque_tibouchi(ECP_ZZZ *point_out, const uint8_t *message, uint32_t message_length);
+
 /*
  * Generate a uniformly-distributed pseudo-random number,
  * between [0, n], where n is the order of the EC group.
@@ -84,6 +248,33 @@ int32_t ecp_ZZZ_fromhash(ECP_ZZZ *point_out, const uint8_t *message, uint32_t me
 void ecp_ZZZ_random_mod_order(BIG_XXX *big_out,
                               void (*get_random)(void *buf, size_t buflen));
 
+/*
+ * Compute sum(scalars[i] * points[i]).
+ *
+ * Uses Straus' method (with ECP_ZZZ_MUL_MULTI_WINDOW_BITS-bit windows):
+ *  the scalar multiplications are interleaved, so they share one chain of doublings.
+ *
+ * NOT constant-time, so only use with public scalars (e.g. when verifying).
+ *
+ * Output is affine. The points and scalars are not modified.
+ */
+#define ECP_ZZZ_MUL_MULTI_WINDOW_BITS 4
+void ecp_ZZZ_mul_multi(ECP_ZZZ *point_out,
+                       ECP_ZZZ **points,
+                       BIG_XXX *scalars,
+                       size_t num_points);
+
+/*
+ * Compute scalar1*point1 + scalar2*point2, as with `ecp_ZZZ_mul_multi`.
+ *
+ * NOT constant-time, so only use with public scalars (e.g. when verifying).
+ */
+void ecp_ZZZ_mul2(ECP_ZZZ *point_out,
+                  ECP_ZZZ *point1,
+                  BIG_XXX scalar1,
+                  ECP_ZZZ *point2,
+                  BIG_XXX scalar2);
+
 #ifdef __cplusplus
 }
 #endif
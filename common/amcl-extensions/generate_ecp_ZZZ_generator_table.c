@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+
+/*
+ * Build-time generator for the fixed-base table used by `ecp_ZZZ_mul_generator`.
+ *
+ * Usage: generate_ecp_ZZZ_generator_table <output-file>
+ *
+ * Writes a C source file defining `ecp_ZZZ_generator_table`, where
+ *  ecp_ZZZ_generator_table[i][j] = (2j+1) * 16^i * G (affine x and y coordinates).
+ */
+
+#include "./ecp_ZZZ.h"
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <stdio.h>
+
+static void print_big(FILE *out, BIG_XXX big);
+
+int main(int argc, char *argv[])
+{
+    if (2 != argc) {
+        fprintf(stderr, "usage: %s <output-file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (NULL == out) {
+        fprintf(stderr, "unable to open %s\n", argv[1]);
+        return 1;
+    }
+
+    BIG_XXX gx, gy;
+    BIG_XXX_rcopy(gx, CURVE_Gx_ZZZ);
+    BIG_XXX_rcopy(gy, CURVE_Gy_ZZZ);
+
+    ECP_ZZZ base;
+    if (!ECP_ZZZ_set(&base, gx, gy)) {
+        fprintf(stderr, "generator is not on the curve\n");
+        fclose(out);
+        return 1;
+    }
+
+    fprintf(out, "/* Generated by generate_ecp_ZZZ_generator_table. Do not edit. */\n\n");
+    fprintf(out, "#include \"./ecp_ZZZ.h\"\n\n");
+    fprintf(out, "const BIG_XXX ecp_ZZZ_generator_table[ECP_ZZZ_GENERATOR_TABLE_POSITIONS][ECP_ZZZ_GENERATOR_TABLE_ENTRIES][2] = {\n");
+
+    for (int i = 0; i < ECP_ZZZ_GENERATOR_TABLE_POSITIONS; ++i) {
+        // multiple = 16^i * G, twice_base = 2 * 16^i * G
+        ECP_ZZZ multiple, twice_base;
+        ECP_ZZZ_copy(&multiple, &base);
+        ECP_ZZZ_copy(&twice_base, &base);
+        ECP_ZZZ_dbl(&twice_base);
+
+        fprintf(out, "    {\n");
+        for (int j = 0; j < ECP_ZZZ_GENERATOR_TABLE_ENTRIES; ++j) {
+            BIG_XXX x, y;
+            ECP_ZZZ_affine(&multiple);
+            ECP_ZZZ_get(x, y, &multiple);
+
+            fprintf(out, "        {");
+            print_big(out, x);
+            fprintf(out, ", ");
+            print_big(out, y);
+            fprintf(out, "},\n");
+
+            ECP_ZZZ_add(&multiple, &twice_base);
+        }
+        fprintf(out, "    },\n");
+
+        for (int k = 0; k < ECP_ZZZ_GENERATOR_TABLE_WINDOW_BITS; ++k) {
+            ECP_ZZZ_dbl(&base);
+        }
+    }
+
+    fprintf(out, "};\n");
+
+    if (0 != fclose(out)) {
+        fprintf(stderr, "unable to write %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
+
+static void print_big(FILE *out, BIG_XXX big)
+{
+    BIG_XXX_norm(big);
+
+    fprintf(out, "{");
+    for (int i = 0; i < NLEN_XXX; ++i) {
+        fprintf(out, "%s0x%llx", (0 == i) ? "" : ",", (unsigned long long)big[i]);
+    }
+    fprintf(out, "}");
+}
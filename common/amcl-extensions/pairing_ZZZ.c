@@ -17,10 +17,51 @@
  *****************************************************************************/
 
 #include "./pairing_ZZZ.h"
+#include "./ecp_ZZZ.h"
+#include "./ecp2_ZZZ.h"
 
 #include <amcl/fp2_ZZZ.h>
+#include <amcl/fp4_ZZZ.h>
 #include <amcl/pair_ZZZ.h>
 
+/*
+ * Line functions can only be precomputed when we know the shape of the Miller loop
+ *  (BN or BLS12 curve, sign of the curve parameter, and type of sextic twist).
+ */
+#if defined(ECDAA_PAIRING_TYPE_ZZZ) && defined(SEXTIC_TWIST_ZZZ) && defined(SIGN_OF_X_ZZZ)
+#if (ECDAA_PAIRING_TYPE_ZZZ == BN || ECDAA_PAIRING_TYPE_ZZZ == BLS) \
+    && (SEXTIC_TWIST_ZZZ == M_TYPE || SEXTIC_TWIST_ZZZ == D_TYPE)
+#define ECDAA_PAIRING_LINES_ZZZ
+#endif
+#endif
+
+static void miller_loop_product_ZZZ(FP12_YYY *miller_out,
+                                    ECP_ZZZ **g1_points,
+                                    ECP2_ZZZ **g2_points,
+                                    FP2_YYY **g2_lines,
+                                    size_t num_pairings);
+
+#ifdef ECDAA_PAIRING_LINES_ZZZ
+static void miller_loop_length_ZZZ(BIG_XXX n, BIG_XXX n3);
+
+static void doubling_line_ZZZ(FP2_YYY *line_out, ECP2_ZZZ *A);
+
+static void addition_line_ZZZ(FP2_YYY *line_out, ECP2_ZZZ *A, ECP2_ZZZ *B);
+
+static void lines_miller_loop_ZZZ(FP12_YYY *miller_out,
+                                  ECP_ZZZ *g1_points,
+                                  FP2_YYY **g2_lines,
+                                  size_t num_pairings);
+
+static void multiply_by_line_ZZZ(FP12_YYY *f, FP2_YYY *line, FP_YYY *x, FP_YYY *y);
+#endif
+
+/*
+ * Pairings with precomputed lines share one Miller loop per group of this many
+ *  (the G1 points are normalized into copies, held on the stack).
+ */
+#define LINES_MILLER_LOOP_GROUP_SIZE 8
+
 void compute_pairing_ZZZ(FP12_YYY *pairing_out,
                          ECP_ZZZ *g1_point,
                          ECP2_ZZZ *g2_point)
@@ -28,3 +69,333 @@ void compute_pairing_ZZZ(FP12_YYY *pairing_out,
     PAIR_ZZZ_ate(pairing_out, g2_point, g1_point);
     PAIR_ZZZ_fexp(pairing_out);
 }
+
+void compute_pairing_product_ZZZ(FP12_YYY *pairing_out,
+                                 ECP_ZZZ **g1_points,
+                                 ECP2_ZZZ **g2_points,
+                                 size_t num_pairings)
+{
+    miller_loop_product_ZZZ(pairing_out, g1_points, g2_points, NULL, num_pairings);
+
+    PAIR_ZZZ_fexp(pairing_out);
+}
+
+void compute_pairing_product_with_lines_ZZZ(FP12_YYY *pairing_out,
+                                            ECP_ZZZ **g1_points,
+                                            ECP2_ZZZ **g2_points,
+                                            FP2_YYY **g2_lines,
+                                            size_t num_pairings)
+{
+    miller_loop_product_ZZZ(pairing_out, g1_points, g2_points, g2_lines, num_pairings);
+
+    PAIR_ZZZ_fexp(pairing_out);
+}
+
+size_t prepare_g2_lines_ZZZ(FP2_YYY *lines_out,
+                            size_t max_lines,
+                            ECP2_ZZZ *g2_point)
+{
+#ifndef ECDAA_PAIRING_LINES_ZZZ
+    (void)lines_out;
+    (void)max_lines;
+    (void)g2_point;
+    return 0;
+#else
+    BIG_XXX n, n3;
+    miller_loop_length_ZZZ(n, n3);
+
+    // All line coefficients are computed from affine points,
+    //  so they don't depend on AMCL's internal choice of coordinates.
+    ECP2_ZZZ P, negP, A;
+    ECP2_ZZZ_copy(&P, g2_point);
+    ECP2_ZZZ_affine(&P);
+    ECP2_ZZZ_copy(&negP, &P);
+    ECP2_ZZZ_neg(&negP);
+    ECP2_ZZZ_affine(&negP);
+    ECP2_ZZZ_copy(&A, &P);
+
+    size_t num_lines = 0;
+    for (int i = BIG_XXX_nbits(n3) - 2; i >= 1; --i) {
+        if (num_lines + 2 > max_lines)
+            return 0;
+
+        doubling_line_ZZZ(&lines_out[3*num_lines++], &A);
+        ECP2_ZZZ_dbl(&A);
+        ECP2_ZZZ_affine(&A);
+
+        int bit = BIG_XXX_bit(n3, i) - BIG_XXX_bit(n, i);
+        if (1 == bit || -1 == bit) {
+            ECP2_ZZZ *B = (1 == bit) ? &P : &negP;
+            addition_line_ZZZ(&lines_out[3*num_lines++], &A, B);
+            ECP2_ZZZ_add(&A, B);
+            ECP2_ZZZ_affine(&A);
+        }
+    }
+
+#if ECDAA_PAIRING_TYPE_ZZZ == BN
+    // R-ate correction, with Q1 = pi(Q) and Q2 = -pi^2(Q)
+    if (num_lines + 2 > max_lines)
+        return 0;
+
+#if SIGN_OF_X_ZZZ == NEGATIVEX
+    ECP2_ZZZ_neg(&A);
+    ECP2_ZZZ_affine(&A);
+#endif
+
+    ECP2_ZZZ K;
+    ECP2_ZZZ_copy(&K, &P);
+    ecp2_ZZZ_psi(&K);
+    ECP2_ZZZ_affine(&K);
+    addition_line_ZZZ(&lines_out[3*num_lines++], &A, &K);
+    ECP2_ZZZ_add(&A, &K);
+    ECP2_ZZZ_affine(&A);
+
+    ecp2_ZZZ_psi(&K);
+    ECP2_ZZZ_neg(&K);
+    ECP2_ZZZ_affine(&K);
+    addition_line_ZZZ(&lines_out[3*num_lines++], &A, &K);
+#endif
+
+    // Check the precomputed lines against the AMCL pairing,
+    //  in case this AMCL build arranges its tower or twist differently.
+    ECP_ZZZ generator;
+    ecp_ZZZ_set_to_generator(&generator);
+
+    FP12_YYY expected, actual;
+    compute_pairing_ZZZ(&expected, &generator, g2_point);
+
+    ECP_ZZZ *g1_points[1] = {&generator};
+    ECP2_ZZZ *g2_points[1] = {g2_point};
+    FP2_YYY *g2_lines[1] = {lines_out};
+    compute_pairing_product_with_lines_ZZZ(&actual, g1_points, g2_points, g2_lines, 1);
+
+    if (!FP12_YYY_equals(&expected, &actual))
+        return 0;
+
+    return num_lines;
+#endif
+}
+
+void miller_loop_product_ZZZ(FP12_YYY *miller_out,
+                             ECP_ZZZ **g1_points,
+                             ECP2_ZZZ **g2_points,
+                             FP2_YYY **g2_lines,
+                             size_t num_pairings)
+{
+    FP12_YYY_one(miller_out);
+
+    // First, G2 points without precomputed lines.
+    FP12_YYY miller;
+    ECP_ZZZ *pending_g1 = NULL;
+    ECP2_ZZZ *pending_g2 = NULL;
+    for (size_t i = 0; i < num_pairings; ++i) {
+        if (ECP_ZZZ_isinf(g1_points[i]))
+            continue;
+
+        if (NULL != g2_lines && NULL != g2_lines[i])
+            continue;
+
+        if (NULL == pending_g1) {
+            pending_g1 = g1_points[i];
+            pending_g2 = g2_points[i];
+            continue;
+        }
+
+        // Run two Miller loops at once, sharing their squarings.
+        PAIR_ZZZ_double_ate(&miller, pending_g2, pending_g1, g2_points[i], g1_points[i]);
+        FP12_YYY_mul(miller_out, &miller);
+        pending_g1 = NULL;
+        pending_g2 = NULL;
+    }
+
+    if (NULL != pending_g1) {
+        PAIR_ZZZ_ate(&miller, pending_g2, pending_g1);
+        FP12_YYY_mul(miller_out, &miller);
+    }
+
+    if (NULL == g2_lines)
+        return;
+
+#ifdef ECDAA_PAIRING_LINES_ZZZ
+    // Then, the G2 points with precomputed lines, sharing a Miller loop per group.
+    //  The line functions need affine G1 points, so normalize copies
+    //  (the caller's points are left as they are).
+    ECP_ZZZ affine_g1[LINES_MILLER_LOOP_GROUP_SIZE];
+    FP2_YYY *group_lines[LINES_MILLER_LOOP_GROUP_SIZE];
+    size_t count = 0;
+    for (size_t i = 0; i < num_pairings; ++i) {
+        if (NULL != g2_lines[i] && !ECP_ZZZ_isinf(g1_points[i])) {
+            ECP_ZZZ_copy(&affine_g1[count], g1_points[i]);
+            ECP_ZZZ_affine(&affine_g1[count]);
+            group_lines[count] = g2_lines[i];
+            ++count;
+        }
+
+        if (LINES_MILLER_LOOP_GROUP_SIZE == count || (num_pairings == i + 1 && 0 != count)) {
+            lines_miller_loop_ZZZ(&miller, affine_g1, group_lines, count);
+            FP12_YYY_mul(miller_out, &miller);
+            count = 0;
+        }
+    }
+#endif
+}
+
+#ifdef ECDAA_PAIRING_LINES_ZZZ
+void miller_loop_length_ZZZ(BIG_XXX n, BIG_XXX n3)
+{
+    // The loop runs over the non-adjacent form of n, given by the bits of 3n and n.
+    //  BN curves: n = 6u+2. BLS12 curves: n = u.
+    BIG_XXX_rcopy(n, CURVE_Bnx_ZZZ);
+#if ECDAA_PAIRING_TYPE_ZZZ == BN
+    BIG_XXX_pmul(n, n, 6);
+#if SIGN_OF_X_ZZZ == POSITIVEX
+    BIG_XXX_inc(n, 2);
+#else
+    BIG_XXX_dec(n, 2);
+#endif
+#endif
+    BIG_XXX_norm(n);
+
+    BIG_XXX_pmul(n3, n, 3);
+    BIG_XXX_norm(n3);
+}
+
+/*
+ * Each line is stored as the three coefficients multiplying, in order,
+ *  the G1 point's y-coordinate, its x-coordinate, and one.
+ */
+void doubling_line_ZZZ(FP2_YYY *line_out, ECP2_ZZZ *A)
+{
+    // Tangent at affine A=(x,y), scaled to: -4y*yQ + 6x^2*xQ + (4y^2 - 6x^3)
+    FP2_YYY x_squared, y_squared, t;
+
+    FP2_YYY_sqr(&x_squared, &A->x);
+    FP2_YYY_sqr(&y_squared, &A->y);
+
+    FP2_YYY_imul(&line_out[0], &A->y, 4);
+    FP2_YYY_neg(&line_out[0], &line_out[0]);
+
+    FP2_YYY_imul(&line_out[1], &x_squared, 6);
+
+    FP2_YYY_mul(&t, &x_squared, &A->x);
+    FP2_YYY_imul(&t, &t, 6);
+    FP2_YYY_imul(&line_out[2], &y_squared, 4);
+    FP2_YYY_sub(&line_out[2], &line_out[2], &t);
+
+#if SEXTIC_TWIST_ZZZ == M_TYPE
+    FP2_YYY_mul_ip(&line_out[0]);
+#endif
+
+    FP2_YYY_norm(&line_out[0]);
+    FP2_YYY_norm(&line_out[1]);
+    FP2_YYY_norm(&line_out[2]);
+}
+
+void addition_line_ZZZ(FP2_YYY *line_out, ECP2_ZZZ *A, ECP2_ZZZ *B)
+{
+    // Chord through affine A=(x1,y1) and B=(x2,y2), scaled to:
+    //  (x1-x2)*yQ - (y1-y2)*xQ + ((y1-y2)*x2 - (x1-x2)*y2)
+    FP2_YYY dy, dx, t;
+
+    FP2_YYY_sub(&dy, &A->y, &B->y);
+    FP2_YYY_sub(&dx, &A->x, &B->x);
+
+    FP2_YYY_copy(&line_out[0], &dx);
+
+    FP2_YYY_neg(&line_out[1], &dy);
+
+    FP2_YYY_mul(&line_out[2], &dy, &B->x);
+    FP2_YYY_mul(&t, &dx, &B->y);
+    FP2_YYY_sub(&line_out[2], &line_out[2], &t);
+
+#if SEXTIC_TWIST_ZZZ == M_TYPE
+    FP2_YYY_mul_ip(&line_out[0]);
+#endif
+
+    FP2_YYY_norm(&line_out[0]);
+    FP2_YYY_norm(&line_out[1]);
+    FP2_YYY_norm(&line_out[2]);
+}
+
+void lines_miller_loop_ZZZ(FP12_YYY *miller_out,
+                           ECP_ZZZ *g1_points,
+                           FP2_YYY **g2_lines,
+                           size_t num_pairings)
+{
+    // `g1_points` must be affine.
+    BIG_XXX n, n3;
+    miller_loop_length_ZZZ(n, n3);
+
+    FP12_YYY_one(miller_out);
+    size_t line = 0;
+    for (int i = BIG_XXX_nbits(n3) - 2; i >= 1; --i) {
+        FP12_YYY_sqr(miller_out, miller_out);
+
+        int bit = BIG_XXX_bit(n3, i) - BIG_XXX_bit(n, i);
+        size_t lines_this_step = (1 == bit || -1 == bit) ? 2 : 1;
+        for (size_t j = 0; j < num_pairings; ++j) {
+            for (size_t k = 0; k < lines_this_step; ++k) {
+                multiply_by_line_ZZZ(miller_out, &g2_lines[j][3*(line + k)], &g1_points[j].x, &g1_points[j].y);
+            }
+        }
+        line += lines_this_step;
+    }
+
+#if SIGN_OF_X_ZZZ == NEGATIVEX
+    FP12_YYY_conj(miller_out, miller_out);
+#endif
+
+#if ECDAA_PAIRING_TYPE_ZZZ == BN
+    for (size_t j = 0; j < num_pairings; ++j) {
+        multiply_by_line_ZZZ(miller_out, &g2_lines[j][3*line], &g1_points[j].x, &g1_points[j].y);
+        multiply_by_line_ZZZ(miller_out, &g2_lines[j][3*(line + 1)], &g1_points[j].x, &g1_points[j].y);
+    }
+#endif
+}
+
+void multiply_by_line_ZZZ(FP12_YYY *f, FP2_YYY *line, FP_YYY *x, FP_YYY *y)
+{
+    // As an element a + b*w + c*w^2 of FP12 (with w^3 = i, the generator of FP4 over FP2),
+    //  the line's value has a = y_term + line[2]*i, and only one more nonzero coefficient:
+    //  b = x_term for a D-type twist, or c = x_term*i for an M-type twist.
+    //  So multiply by it directly, rather than as a dense FP12.
+    FP2_YYY y_term, x_term;
+    FP2_YYY_pmul(&y_term, &line[0], y);
+    FP2_YYY_pmul(&x_term, &line[1], x);
+
+    FP4_YYY line_a;
+    FP4_YYY_from_FP2s(&line_a, &y_term, &line[2]);
+
+    FP4_YYY fa_a, fb_a, fc_a, fa_x, fb_x, fc_x;
+    FP4_YYY_mul(&fa_a, &f->a, &line_a);
+    FP4_YYY_mul(&fb_a, &f->b, &line_a);
+    FP4_YYY_mul(&fc_a, &f->c, &line_a);
+    FP4_YYY_pmul(&fa_x, &f->a, &x_term);
+    FP4_YYY_pmul(&fb_x, &f->b, &x_term);
+    FP4_YYY_pmul(&fc_x, &f->c, &x_term);
+
+#if SEXTIC_TWIST_ZZZ == M_TYPE
+    // (fa + fb*w + fc*w^2) * (a + x*i*w^2)
+    //  = (fa*a + fb*x*i^2) + (fb*a + fc*x*i^2)*w + (fc*a + fa*x*i)*w^2
+    FP4_YYY_times_i(&fb_x);
+    FP4_YYY_times_i(&fb_x);
+    FP4_YYY_times_i(&fc_x);
+    FP4_YYY_times_i(&fc_x);
+    FP4_YYY_times_i(&fa_x);
+    FP4_YYY_add(&f->a, &fa_a, &fb_x);
+    FP4_YYY_add(&f->b, &fb_a, &fc_x);
+    FP4_YYY_add(&f->c, &fc_a, &fa_x);
+#else
+    // (fa + fb*w + fc*w^2) * (a + x*w)
+    //  = (fa*a + fc*x*i) + (fb*a + fa*x)*w + (fc*a + fb*x)*w^2
+    FP4_YYY_times_i(&fc_x);
+    FP4_YYY_add(&f->a, &fa_a, &fc_x);
+    FP4_YYY_add(&f->b, &fb_a, &fa_x);
+    FP4_YYY_add(&f->c, &fc_a, &fb_x);
+#endif
+
+    FP4_YYY_norm(&f->a);
+    FP4_YYY_norm(&f->b);
+    FP4_YYY_norm(&f->c);
+}
+#endif
@@ -27,9 +27,19 @@ extern "C" {
 #include <amcl/ecp_ZZZ.h>
 #include <amcl/ecp2_ZZZ.h>
 #include <amcl/fp12_ZZZ.h>
+#include <amcl/config_curve_ZZZ.h>
 
 #include <stddef.h>
 
+/*
+ * AMCL releases disagree on the name of the macro giving the pairing type.
+ */
+#if defined(CURVE_PAIRING_TYPE_ZZZ)
+#define ECDAA_PAIRING_TYPE_ZZZ CURVE_PAIRING_TYPE_ZZZ
+#elif defined(PAIRING_FRIENDLY_ZZZ)
+#define ECDAA_PAIRING_TYPE_ZZZ PAIRING_FRIENDLY_ZZZ
+#endif
+
 /*
  * Compute the optimal Ate pairing.
  */
@@ -37,6 +47,51 @@ void compute_pairing_ZZZ(FP12_YYY *pairing_out,
                          ECP_ZZZ *g1_point,
                          ECP2_ZZZ *g2_point);
 
+/*
+ * Compute the product of optimal Ate pairings
+ *  e(g1_points[0], g2_points[0]) * ... * e(g1_points[n-1], g2_points[n-1]).
+ *
+ * The Miller loops are multiplied together,
+ *  and only a single final exponentiation is performed on their product.
+ *
+ * G1 points at infinity contribute a factor of 1, and are skipped.
+ */
+void compute_pairing_product_ZZZ(FP12_YYY *pairing_out,
+                                 ECP_ZZZ **g1_points,
+                                 ECP2_ZZZ **g2_points,
+                                 size_t num_pairings);
+
+/*
+ * Precompute the Miller-loop line functions for a fixed G2 point.
+ *
+ * Each line takes three FP2_YYY's, so `lines_out` must have room for `3*max_lines` FP2_YYY's.
+ *
+ * The precomputed lines are checked against the AMCL pairing before being accepted.
+ *
+ * Returns:
+ * the number of lines on success
+ * 0 if lines can't be precomputed for this curve (callers should then use the G2 point directly)
+ */
+size_t prepare_g2_lines_ZZZ(FP2_YYY *lines_out,
+                            size_t max_lines,
+                            ECP2_ZZZ *g2_point);
+
+/*
+ * Same as compute_pairing_product_ZZZ, but `g2_lines[i]` may hold
+ *  the lines precomputed for `g2_points[i]` by `prepare_g2_lines_ZZZ`.
+ *
+ * The Miller loops for G2 points with precomputed lines share their squarings
+ *  (in groups of up to eight), and do no G2 arithmetic.
+ *  G2 points whose `g2_lines[i]` is NULL are paired as usual.
+ *
+ * The G1 points are not modified.
+ */
+void compute_pairing_product_with_lines_ZZZ(FP12_YYY *pairing_out,
+                                            ECP_ZZZ **g1_points,
+                                            ECP2_ZZZ **g2_points,
+                                            FP2_YYY **g2_lines,
+                                            size_t num_pairings);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,618 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include "sha256.h"
+#include "explicit_bzero.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ECDAA_SHA256_HAVE_SHA_NI
+#define ECDAA_SHA256_HAVE_AVX2
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+typedef void (*compress_func)(uint32_t *state, const uint8_t *blocks, size_t num_blocks);
+
+static void compress_portable(uint32_t *state, const uint8_t *blocks, size_t num_blocks);
+
+#ifdef ECDAA_SHA256_HAVE_SHA_NI
+static void compress_sha_ni(uint32_t *state, const uint8_t *blocks, size_t num_blocks);
+
+static int cpu_has_sha_ni(void);
+#endif
+
+static int select_compress(enum ecdaa_sha256_implementation new_implementation);
+
+static compress_func get_compress(void);
+
+typedef void (*compress_multi_func)(uint32_t (*states)[8], const uint8_t *blocks);
+
+static void multi_serial(uint8_t *digests_out, const struct ecdaa_sha256_message *messages, size_t num_messages);
+
+static void multi_lanes(uint8_t *digests_out, const struct ecdaa_sha256_message *messages, size_t num_messages, compress_multi_func compress_lanes);
+
+static size_t message_length(const struct ecdaa_sha256_message *message);
+
+static void padded_block(uint8_t *block_out, const struct ecdaa_sha256_message *message, size_t length, size_t block_index);
+
+#ifdef ECDAA_SHA256_HAVE_AVX2
+static void compress_multi_avx2(uint32_t (*states)[8], const uint8_t *blocks);
+
+static int cpu_has_avx2(void);
+#endif
+
+static int select_compress_multi(enum ecdaa_sha256_multi_implementation new_implementation);
+
+static compress_multi_func get_compress_multi(void);
+
+static void choose_defaults(void);
+
+static const uint32_t initial_state[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Both chosen on first use, exactly once (by `choose_defaults`).
+static pthread_once_t defaults_once = PTHREAD_ONCE_INIT;
+
+static compress_func compress = NULL;
+static enum ecdaa_sha256_implementation implementation = ECDAA_SHA256_PORTABLE;
+
+// NULL means serial.
+static compress_multi_func compress_multi = NULL;
+
+void ecdaa_sha256_init(struct ecdaa_sha256 *ctx)
+{
+    memcpy(ctx->state, initial_state, sizeof(initial_state));
+    ctx->length = 0;
+    ctx->buffer_length = 0;
+}
+
+void ecdaa_sha256_update(struct ecdaa_sha256 *ctx,
+                         const uint8_t *data,
+                         size_t data_length)
+{
+    if (0 == data_length)
+        return;
+
+    compress_func compress_blocks = get_compress();
+
+    ctx->length += data_length;
+
+    // 1) Top up a partial block
+    if (0 != ctx->buffer_length) {
+        size_t needed = ECDAA_SHA256_BLOCK_LENGTH - ctx->buffer_length;
+        size_t taken = data_length < needed ? data_length : needed;
+        memcpy(ctx->buffer + ctx->buffer_length, data, taken);
+        ctx->buffer_length += taken;
+        data += taken;
+        data_length -= taken;
+
+        if (ECDAA_SHA256_BLOCK_LENGTH != ctx->buffer_length)
+            return;
+
+        compress_blocks(ctx->state, ctx->buffer, 1);
+        ctx->buffer_length = 0;
+    }
+
+    // 2) Whole blocks straight from the input
+    size_t num_blocks = data_length / ECDAA_SHA256_BLOCK_LENGTH;
+    if (0 != num_blocks) {
+        compress_blocks(ctx->state, data, num_blocks);
+        data += num_blocks * ECDAA_SHA256_BLOCK_LENGTH;
+        data_length -= num_blocks * ECDAA_SHA256_BLOCK_LENGTH;
+    }
+
+    // 3) Keep the rest for later
+    if (0 != data_length) {
+        memcpy(ctx->buffer, data, data_length);
+        ctx->buffer_length = data_length;
+    }
+}
+
+void ecdaa_sha256_final(struct ecdaa_sha256 *ctx,
+                        uint8_t *digest_out)
+{
+    compress_func compress_blocks = get_compress();
+
+    uint64_t bit_length = ctx->length * 8;
+
+    // Padding: 0x80, then zeros up to 8 bytes short of a block boundary, then the bit-length (big-endian).
+    uint8_t padding[2*ECDAA_SHA256_BLOCK_LENGTH] = {0};
+    size_t padded_length = (ctx->buffer_length < ECDAA_SHA256_BLOCK_LENGTH - 8) ? ECDAA_SHA256_BLOCK_LENGTH : 2*ECDAA_SHA256_BLOCK_LENGTH;
+    memcpy(padding, ctx->buffer, ctx->buffer_length);
+    padding[ctx->buffer_length] = 0x80;
+    for (size_t i = 0; i < 8; ++i) {
+        padding[padded_length - 1 - i] = (uint8_t)(bit_length >> (8*i));
+    }
+
+    compress_blocks(ctx->state, padding, padded_length / ECDAA_SHA256_BLOCK_LENGTH);
+
+    for (size_t i = 0; i < 8; ++i) {
+        digest_out[4*i] = (uint8_t)(ctx->state[i] >> 24);
+        digest_out[4*i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest_out[4*i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest_out[4*i + 3] = (uint8_t)(ctx->state[i]);
+    }
+
+    explicit_bzero(padding, sizeof(padding));
+    explicit_bzero(ctx, sizeof(struct ecdaa_sha256));
+}
+
+void ecdaa_sha256(uint8_t *digest_out,
+                  const uint8_t *data,
+                  size_t data_length)
+{
+    struct ecdaa_sha256 ctx;
+    ecdaa_sha256_init(&ctx);
+    ecdaa_sha256_update(&ctx, data, data_length);
+    ecdaa_sha256_final(&ctx, digest_out);
+}
+
+enum ecdaa_sha256_implementation ecdaa_sha256_get_implementation(void)
+{
+    get_compress();
+
+    return implementation;
+}
+
+int ecdaa_sha256_set_implementation(enum ecdaa_sha256_implementation new_implementation)
+{
+    // Choose the defaults first, so they can't later overwrite this choice.
+    pthread_once(&defaults_once, choose_defaults);
+
+    return select_compress(new_implementation);
+}
+
+int select_compress(enum ecdaa_sha256_implementation new_implementation)
+{
+    switch (new_implementation) {
+        case ECDAA_SHA256_PORTABLE:
+            compress = compress_portable;
+            implementation = ECDAA_SHA256_PORTABLE;
+            return 0;
+        case ECDAA_SHA256_SHA_NI:
+#ifdef ECDAA_SHA256_HAVE_SHA_NI
+            if (cpu_has_sha_ni()) {
+                compress = compress_sha_ni;
+                implementation = ECDAA_SHA256_SHA_NI;
+                return 0;
+            }
+#endif
+            return -1;
+    }
+
+    return -1;
+}
+
+void ecdaa_sha256_multi(uint8_t *digests_out,
+                        const struct ecdaa_sha256_message *messages,
+                        size_t num_messages)
+{
+    compress_multi_func compress_lanes = get_compress_multi();
+
+    // A single message gains nothing from the lanes.
+    if (NULL == compress_lanes || num_messages < 2) {
+        multi_serial(digests_out, messages, num_messages);
+        return;
+    }
+
+    for (size_t begin = 0; begin < num_messages; begin += ECDAA_SHA256_MULTI_LANES) {
+        size_t count = num_messages - begin;
+        if (count > ECDAA_SHA256_MULTI_LANES)
+            count = ECDAA_SHA256_MULTI_LANES;
+
+        multi_lanes(digests_out + begin*ECDAA_SHA256_DIGEST_LENGTH, messages + begin, count, compress_lanes);
+    }
+}
+
+enum ecdaa_sha256_multi_implementation ecdaa_sha256_multi_get_implementation(void)
+{
+    return (NULL == get_compress_multi()) ? ECDAA_SHA256_MULTI_SERIAL : ECDAA_SHA256_MULTI_AVX2;
+}
+
+int ecdaa_sha256_multi_set_implementation(enum ecdaa_sha256_multi_implementation new_implementation)
+{
+    pthread_once(&defaults_once, choose_defaults);
+
+    return select_compress_multi(new_implementation);
+}
+
+int select_compress_multi(enum ecdaa_sha256_multi_implementation new_implementation)
+{
+    switch (new_implementation) {
+        case ECDAA_SHA256_MULTI_SERIAL:
+            compress_multi = NULL;
+            return 0;
+        case ECDAA_SHA256_MULTI_AVX2:
+#ifdef ECDAA_SHA256_HAVE_AVX2
+            if (cpu_has_avx2()) {
+                compress_multi = compress_multi_avx2;
+                return 0;
+            }
+#endif
+            return -1;
+    }
+
+    return -1;
+}
+
+compress_func get_compress(void)
+{
+    pthread_once(&defaults_once, choose_defaults);
+
+    return compress;
+}
+
+compress_multi_func get_compress_multi(void)
+{
+    pthread_once(&defaults_once, choose_defaults);
+
+    return compress_multi;
+}
+
+void choose_defaults(void)
+{
+    if (0 != select_compress(ECDAA_SHA256_SHA_NI))
+        select_compress(ECDAA_SHA256_PORTABLE);
+
+    // One message at a time with SHA-NI beats eight at a time in AVX2 lanes,
+    //  so the lanes are only the default without SHA-NI.
+    if (ECDAA_SHA256_SHA_NI == implementation
+            || 0 != select_compress_multi(ECDAA_SHA256_MULTI_AVX2))
+        select_compress_multi(ECDAA_SHA256_MULTI_SERIAL);
+}
+
+void multi_serial(uint8_t *digests_out, const struct ecdaa_sha256_message *messages, size_t num_messages)
+{
+    for (size_t i = 0; i < num_messages; ++i) {
+        struct ecdaa_sha256 ctx;
+        ecdaa_sha256_init(&ctx);
+        for (size_t j = 0; j < ECDAA_SHA256_MESSAGE_MAX_SEGMENTS; ++j) {
+            ecdaa_sha256_update(&ctx, messages[i].segments[j], messages[i].segment_lengths[j]);
+        }
+        ecdaa_sha256_final(&ctx, digests_out + i*ECDAA_SHA256_DIGEST_LENGTH);
+    }
+}
+
+void multi_lanes(uint8_t *digests_out, const struct ecdaa_sha256_message *messages, size_t num_messages, compress_multi_func compress_lanes)
+{
+    uint32_t states[ECDAA_SHA256_MULTI_LANES][8];
+    uint32_t scratch_states[ECDAA_SHA256_MULTI_LANES][8];
+    uint8_t blocks[ECDAA_SHA256_MULTI_LANES * ECDAA_SHA256_BLOCK_LENGTH] = {0};
+    size_t lengths[ECDAA_SHA256_MULTI_LANES];
+    size_t num_blocks[ECDAA_SHA256_MULTI_LANES];
+
+    // Messages of different lengths take different numbers of blocks:
+    //  once a lane's message is done, its lane runs on (on a scratch copy), and the result is dropped.
+    size_t max_blocks = 0;
+    for (size_t lane = 0; lane < ECDAA_SHA256_MULTI_LANES; ++lane) {
+        memcpy(states[lane], initial_state, sizeof(initial_state));
+        if (lane < num_messages) {
+            lengths[lane] = message_length(&messages[lane]);
+            num_blocks[lane] = (lengths[lane] + 8) / ECDAA_SHA256_BLOCK_LENGTH + 1;
+        } else {
+            lengths[lane] = 0;
+            num_blocks[lane] = 0;
+        }
+        if (num_blocks[lane] > max_blocks)
+            max_blocks = num_blocks[lane];
+    }
+
+    for (size_t block = 0; block < max_blocks; ++block) {
+        for (size_t lane = 0; lane < num_messages; ++lane) {
+            if (block < num_blocks[lane])
+                padded_block(blocks + lane*ECDAA_SHA256_BLOCK_LENGTH, &messages[lane], lengths[lane], block);
+        }
+
+        memcpy(scratch_states, states, sizeof(states));
+        compress_lanes(scratch_states, blocks);
+        for (size_t lane = 0; lane < num_messages; ++lane) {
+            if (block < num_blocks[lane])
+                memcpy(states[lane], scratch_states[lane], sizeof(states[lane]));
+        }
+    }
+
+    for (size_t lane = 0; lane < num_messages; ++lane) {
+        uint8_t *digest = digests_out + lane*ECDAA_SHA256_DIGEST_LENGTH;
+        for (size_t i = 0; i < 8; ++i) {
+            digest[4*i] = (uint8_t)(states[lane][i] >> 24);
+            digest[4*i + 1] = (uint8_t)(states[lane][i] >> 16);
+            digest[4*i + 2] = (uint8_t)(states[lane][i] >> 8);
+            digest[4*i + 3] = (uint8_t)(states[lane][i]);
+        }
+    }
+
+    explicit_bzero(blocks, sizeof(blocks));
+    explicit_bzero(states, sizeof(states));
+    explicit_bzero(scratch_states, sizeof(scratch_states));
+}
+
+size_t message_length(const struct ecdaa_sha256_message *message)
+{
+    size_t length = 0;
+    for (size_t j = 0; j < ECDAA_SHA256_MESSAGE_MAX_SEGMENTS; ++j) {
+        length += message->segment_lengths[j];
+    }
+    return length;
+}
+
+void padded_block(uint8_t *block_out, const struct ecdaa_sha256_message *message, size_t length, size_t block_index)
+{
+    size_t begin = block_index * ECDAA_SHA256_BLOCK_LENGTH;
+    size_t end = begin + ECDAA_SHA256_BLOCK_LENGTH;
+
+    memset(block_out, 0, ECDAA_SHA256_BLOCK_LENGTH);
+
+    // Message bytes in [begin, end), from whichever segments they fall in
+    size_t segment_begin = 0;
+    for (size_t j = 0; j < ECDAA_SHA256_MESSAGE_MAX_SEGMENTS; ++j) {
+        size_t segment_end = segment_begin + message->segment_lengths[j];
+        size_t copy_begin = segment_begin > begin ? segment_begin : begin;
+        size_t copy_end = segment_end < end ? segment_end : end;
+        if (copy_begin < copy_end) {
+            memcpy(block_out + (copy_begin - begin),
+                   message->segments[j] + (copy_begin - segment_begin),
+                   copy_end - copy_begin);
+        }
+        segment_begin = segment_end;
+    }
+
+    // Padding, as in `ecdaa_sha256_final`
+    if (begin <= length && length < end)
+        block_out[length - begin] = 0x80;
+
+    if ((length + 8) / ECDAA_SHA256_BLOCK_LENGTH == block_index) {
+        uint64_t bit_length = (uint64_t)length * 8;
+        for (size_t i = 0; i < 8; ++i) {
+            block_out[ECDAA_SHA256_BLOCK_LENGTH - 1 - i] = (uint8_t)(bit_length >> (8*i));
+        }
+    }
+}
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+void compress_portable(uint32_t *state, const uint8_t *blocks, size_t num_blocks)
+{
+    uint32_t w[64];
+
+    for (size_t block = 0; block < num_blocks; ++block, blocks += ECDAA_SHA256_BLOCK_LENGTH) {
+        for (size_t t = 0; t < 16; ++t) {
+            w[t] = ((uint32_t)blocks[4*t] << 24)
+                 | ((uint32_t)blocks[4*t + 1] << 16)
+                 | ((uint32_t)blocks[4*t + 2] << 8)
+                 | (uint32_t)blocks[4*t + 3];
+        }
+        for (size_t t = 16; t < 64; ++t) {
+            uint32_t s0 = ROTR(w[t-15], 7) ^ ROTR(w[t-15], 18) ^ (w[t-15] >> 3);
+            uint32_t s1 = ROTR(w[t-2], 17) ^ ROTR(w[t-2], 19) ^ (w[t-2] >> 10);
+            w[t] = w[t-16] + s0 + w[t-7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (size_t t = 0; t < 64; ++t) {
+            uint32_t S1 = ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + S1 + ch + round_constants[t] + w[t];
+            uint32_t S0 = ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = S0 + maj;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+
+    explicit_bzero(w, sizeof(w));
+}
+
+#ifdef ECDAA_SHA256_HAVE_SHA_NI
+__attribute__((target("sha,sse4.1,ssse3")))
+void compress_sha_ni(uint32_t *state, const uint8_t *blocks, size_t num_blocks)
+{
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The SHA instructions keep the state as (A,B,E,F) and (C,D,G,H).
+    __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (size_t block = 0; block < num_blocks; ++block, blocks += ECDAA_SHA256_BLOCK_LENGTH) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+
+        // Four rounds at a time, keeping the last four groups of four message words
+        __m128i msg[4];
+        for (int i = 0; i < 16; ++i) {
+            __m128i words;
+            if (i < 4) {
+                words = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + 16*i)), byte_swap);
+            } else {
+                // W[t..t+3] from W[t-16..t-13], W[t-15..t-12], W[t-7..t-4], W[t-4..t-1]
+                words = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+                words = _mm_add_epi32(words, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+                words = _mm_sha256msg2_epu32(words, msg[(i + 3) & 3]);
+            }
+            msg[i & 3] = words;
+
+            __m128i scheduled = _mm_add_epi32(words, _mm_loadu_si128((const __m128i*)&round_constants[4*i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, scheduled);
+            scheduled = _mm_shuffle_epi32(scheduled, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, scheduled);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+int cpu_has_sha_ni(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) < 7)
+        return 0;
+
+    // SSSE3 and SSE4.1
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & (1u << 9)) || !(ecx & (1u << 19)))
+        return 0;
+
+    // SHA
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1u << 29)) ? 1 : 0;
+}
+#endif
+
+#ifdef ECDAA_SHA256_HAVE_AVX2
+#define ROTR_X8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+__attribute__((target("avx2")))
+void compress_multi_avx2(uint32_t (*states)[8], const uint8_t *blocks)
+{
+    // Lane l of each vector belongs to message l.
+    uint32_t transposed[8][ECDAA_SHA256_MULTI_LANES];
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t lane = 0; lane < ECDAA_SHA256_MULTI_LANES; ++lane) {
+            transposed[i][lane] = states[lane][i];
+        }
+    }
+
+    __m256i v[8];
+    for (size_t i = 0; i < 8; ++i) {
+        v[i] = _mm256_loadu_si256((const __m256i*)transposed[i]);
+    }
+    __m256i a = v[0], b = v[1], c = v[2], d = v[3];
+    __m256i e = v[4], f = v[5], g = v[6], h = v[7];
+
+    // The last 16 message words
+    __m256i w[16];
+    for (size_t t = 0; t < 16; ++t) {
+        uint32_t words[ECDAA_SHA256_MULTI_LANES];
+        for (size_t lane = 0; lane < ECDAA_SHA256_MULTI_LANES; ++lane) {
+            const uint8_t *word = blocks + lane*ECDAA_SHA256_BLOCK_LENGTH + 4*t;
+            words[lane] = ((uint32_t)word[0] << 24) | ((uint32_t)word[1] << 16) | ((uint32_t)word[2] << 8) | (uint32_t)word[3];
+        }
+        w[t] = _mm256_loadu_si256((const __m256i*)words);
+    }
+
+    for (size_t t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            __m256i w15 = w[(t + 1) & 15];
+            __m256i w2 = w[(t + 14) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(ROTR_X8(w15, 7), ROTR_X8(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(ROTR_X8(w2, 17), ROTR_X8(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t + 9) & 15], s1));
+        }
+
+        __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(ROTR_X8(e, 6), ROTR_X8(e, 11)), ROTR_X8(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, S1),
+                                         _mm256_add_epi32(_mm256_add_epi32(ch, _mm256_set1_epi32((int)round_constants[t])), w[t & 15]));
+        __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(ROTR_X8(a, 2), ROTR_X8(a, 13)), ROTR_X8(a, 22));
+        __m256i maj = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)), _mm256_and_si256(b, c));
+        __m256i temp2 = _mm256_add_epi32(S0, maj);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp1, temp2);
+    }
+
+    v[0] = _mm256_add_epi32(v[0], a);
+    v[1] = _mm256_add_epi32(v[1], b);
+    v[2] = _mm256_add_epi32(v[2], c);
+    v[3] = _mm256_add_epi32(v[3], d);
+    v[4] = _mm256_add_epi32(v[4], e);
+    v[5] = _mm256_add_epi32(v[5], f);
+    v[6] = _mm256_add_epi32(v[6], g);
+    v[7] = _mm256_add_epi32(v[7], h);
+
+    for (size_t i = 0; i < 8; ++i) {
+        _mm256_storeu_si256((__m256i*)transposed[i], v[i]);
+        for (size_t lane = 0; lane < ECDAA_SHA256_MULTI_LANES; ++lane) {
+            states[lane][i] = transposed[i][lane];
+        }
+    }
+}
+
+int cpu_has_avx2(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) < 7)
+        return 0;
+
+    // The OS must save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2)
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & (1u << 27)))
+        return 0;
+    unsigned int xcr0_low, xcr0_high;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    if (0x6 != (xcr0_low & 0x6))
+        return 0;
+
+    // AVX2
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1u << 5)) ? 1 : 0;
+}
+#endif
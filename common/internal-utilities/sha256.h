@@ -0,0 +1,134 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_COMMON_SHA256_H
+#define ECDAA_COMMON_SHA256_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ECDAA_SHA256_DIGEST_LENGTH 32
+#define ECDAA_SHA256_BLOCK_LENGTH 64
+
+/*
+ * SHA-256, processing whole 64-byte blocks at a time
+ *  (rather than AMCL's HASH256_process, which takes one byte per call).
+ *
+ * The block function is chosen at run time, from those the CPU supports
+ *  (see `enum ecdaa_sha256_implementation`).
+ */
+struct ecdaa_sha256 {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t buffer[ECDAA_SHA256_BLOCK_LENGTH];
+    size_t buffer_length;
+};
+
+void ecdaa_sha256_init(struct ecdaa_sha256 *ctx);
+
+void ecdaa_sha256_update(struct ecdaa_sha256 *ctx,
+                         const uint8_t *data,
+                         size_t data_length);
+
+/*
+ * Output the digest, and clear the context.
+ */
+void ecdaa_sha256_final(struct ecdaa_sha256 *ctx,
+                        uint8_t *digest_out);
+
+/*
+ * SHA-256 of one message.
+ */
+void ecdaa_sha256(uint8_t *digest_out,
+                  const uint8_t *data,
+                  size_t data_length);
+
+/*
+ * Block functions.
+ *
+ * ECDAA_SHA256_SHA_NI uses the x86 SHA extensions,
+ *  and is picked by default whenever the CPU has them.
+ */
+enum ecdaa_sha256_implementation {
+    ECDAA_SHA256_PORTABLE = 0,
+    ECDAA_SHA256_SHA_NI = 1
+};
+
+enum ecdaa_sha256_implementation ecdaa_sha256_get_implementation(void);
+
+/*
+ * Override the block function (e.g. for testing or benchmarking).
+ *
+ * Not thread-safe: only call before any hashing is in progress.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the CPU doesn't support `implementation`
+ */
+int ecdaa_sha256_set_implementation(enum ecdaa_sha256_implementation implementation);
+
+/*
+ * Multi-buffer SHA-256: hash several independent messages at once.
+ *
+ * Each message is the concatenation of up to ECDAA_SHA256_MESSAGE_MAX_SEGMENTS segments
+ *  (unused segments have length 0).
+ *
+ * With ECDAA_SHA256_MULTI_AVX2, ECDAA_SHA256_MULTI_LANES messages are hashed side-by-side,
+ *  one per 32-bit lane of the AVX2 registers.
+ *  Otherwise, they're hashed one after the other, as by `ecdaa_sha256`.
+ *  (That's the default when the CPU has SHA-NI, which is faster than the lanes.)
+ */
+#define ECDAA_SHA256_MESSAGE_MAX_SEGMENTS 3
+#define ECDAA_SHA256_MULTI_LANES 8
+
+struct ecdaa_sha256_message {
+    const uint8_t *segments[ECDAA_SHA256_MESSAGE_MAX_SEGMENTS];
+    size_t segment_lengths[ECDAA_SHA256_MESSAGE_MAX_SEGMENTS];
+};
+
+/*
+ * Hash `num_messages` messages.
+ *
+ * `digests_out` must have room for `num_messages*ECDAA_SHA256_DIGEST_LENGTH` bytes.
+ */
+void ecdaa_sha256_multi(uint8_t *digests_out,
+                        const struct ecdaa_sha256_message *messages,
+                        size_t num_messages);
+
+enum ecdaa_sha256_multi_implementation {
+    ECDAA_SHA256_MULTI_SERIAL = 0,
+    ECDAA_SHA256_MULTI_AVX2 = 1
+};
+
+enum ecdaa_sha256_multi_implementation ecdaa_sha256_multi_get_implementation(void);
+
+/*
+ * As `ecdaa_sha256_set_implementation`, for `ecdaa_sha256_multi`.
+ */
+int ecdaa_sha256_multi_set_implementation(enum ecdaa_sha256_multi_implementation implementation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
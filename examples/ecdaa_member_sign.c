@@ -26,7 +26,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
-#define MAX_MESSAGE_SIZE 1024
+#define MAX_BASENAME_SIZE 1024
 
 struct command_line_args {
     char *credential_file;
@@ -71,19 +71,10 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // Read message file
-    uint8_t message[MAX_MESSAGE_SIZE];
-    int read_ret = read_file_into_buffer(message, sizeof(message), args.message_file);
-    if (read_ret < 0) {
-        fprintf(stderr, "Error reading message file: \"%s\"\n", args.message_file);
-        return 1;
-    }
-    uint32_t msg_len = (uint32_t)read_ret;
-
     // Read basename file (if requested)
     uint8_t *basename = NULL;
     uint32_t basename_len = 0;
-    uint8_t basename_buffer[MAX_MESSAGE_SIZE];
+    uint8_t basename_buffer[MAX_BASENAME_SIZE];
     if (NULL != args.basename_file) {
         basename = basename_buffer;
 
@@ -95,11 +86,31 @@ int main(int argc, char *argv[])
         basename_len = (uint32_t)read_ret;
     }
 
-    // Create signature
+    // Create signature, hashing the message file as it's read
+    FILE *message_fp = fopen(args.message_file, "rb");
+    if (NULL == message_fp) {
+        fprintf(stderr, "Error reading message file: \"%s\"\n", args.message_file);
+        return 1;
+    }
+
+    struct ecdaa_signature_FP256BN_sign_ctx sign_ctx;
+    if (0 != ecdaa_signature_FP256BN_sign_begin(&sign_ctx, basename, basename_len, &sk, &cred, examples_rand)) {
+        fprintf(stderr, "Error signing message file: \"%s\"\n", args.message_file);
+        fclose(message_fp);
+        return 1;
+    }
+
+    size_t chunk_len;
+    while (0 != (chunk_len = fread(buffer, 1, sizeof(buffer), message_fp))) {
+        ecdaa_signature_FP256BN_sign_update(&sign_ctx, buffer, (uint32_t)chunk_len);
+    }
+    int read_error = ferror(message_fp);
+    fclose(message_fp);
+
     struct ecdaa_signature_FP256BN sig;
-    if (0 != ecdaa_signature_FP256BN_sign(&sig, message, msg_len, basename, basename_len, &sk, &cred, examples_rand)) {
-        message[msg_len] = 0;
-        fprintf(stderr, "Error signing message: \"%s\"\n", (char*)message);
+    ecdaa_signature_FP256BN_sign_finish(&sign_ctx, &sig);
+    if (read_error) {
+        fprintf(stderr, "Error reading message file: \"%s\"\n", args.message_file);
         return 1;
     }
 
@@ -128,8 +139,8 @@ void print_usage(const char *my_name)
                     "<signature-output-file> "
                     "<message-file> "
                     "[<basename-file>]\n"
-                    "\nNOTE: message must be smaller than %dbytes\n",
-           my_name, MAX_MESSAGE_SIZE);
+                    "\nNOTE: basename must be smaller than %dbytes\n",
+           my_name, MAX_BASENAME_SIZE);
 }
 
 int parse_args(struct command_line_args *args_out, int argc, char *argv[])
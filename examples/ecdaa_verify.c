@@ -25,7 +25,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 
-#define MAX_MESSAGE_SIZE 1024
+#define MAX_BASENAME_SIZE 1024
 
 struct command_line_args {
     char *message_file;
@@ -53,8 +53,7 @@ int main(int argc, char *argv[])
     uint8_t buffer[1024];
 
     struct ecdaa_revocations_FP256BN revocations;
-    revocations.sk_list = NULL;
-    revocations.bsn_list = NULL;
+    ecdaa_revocations_FP256BN_init(&revocations);
 
     // Parse command line
     struct command_line_args args;
@@ -66,7 +65,7 @@ int main(int argc, char *argv[])
     // Read basename file (if requested)
     uint8_t *basename = NULL;
     uint32_t basename_len = 0;
-    uint8_t basename_buffer[MAX_MESSAGE_SIZE];
+    uint8_t basename_buffer[MAX_BASENAME_SIZE];
     if (NULL != args.basename_file) {
         basename = basename_buffer;
 
@@ -125,18 +124,31 @@ int main(int argc, char *argv[])
         goto cleanup;
     }
 
-    // Read message from disk.
-    uint8_t message[MAX_MESSAGE_SIZE];
-    int read_ret = read_file_into_buffer(message, sizeof(message), args.message_file);
-    if (read_ret < 0) {
+    // Verify signature, hashing the message file as it's read
+    FILE *message_fp = fopen(args.message_file, "rb");
+    if (NULL == message_fp) {
         fprintf(stderr, "Error reading message file: \"%s\"\n", args.message_file);
         ret = 1;
         goto cleanup;
     }
-    uint32_t msg_len = (uint32_t)read_ret;
 
-    // Verify signature
-    if (0 != ecdaa_signature_FP256BN_verify(&sig, &gpk, &revocations, message, msg_len, basename, basename_len)) {
+    struct ecdaa_signature_FP256BN_verify_ctx verify_ctx;
+    ecdaa_signature_FP256BN_verify_begin(&verify_ctx, &sig, basename, basename_len);
+
+    size_t chunk_len;
+    while (0 != (chunk_len = fread(buffer, 1, sizeof(buffer), message_fp))) {
+        ecdaa_signature_FP256BN_verify_update(&verify_ctx, buffer, (uint32_t)chunk_len);
+    }
+    int read_error = ferror(message_fp);
+    fclose(message_fp);
+
+    int verify_ret = ecdaa_signature_FP256BN_verify_finish(&verify_ctx, &gpk, &revocations);
+    if (read_error) {
+        fprintf(stderr, "Error reading message file: \"%s\"\n", args.message_file);
+        ret = 1;
+        goto cleanup;
+    }
+    if (0 != verify_ret) {
         fprintf(stderr, "Signature not valid!\n");
         ret = 1;
         goto cleanup;
@@ -166,8 +178,8 @@ void print_usage(const char *my_name)
                     "<basename-signature-revocation-list-input-file> "
                     "<number-of-basename-signature-revocations-in-list> "
                     "[<basename-file>]\n"
-                    "\nNOTE: message must be smaller than %dbytes\n",
-           my_name, MAX_MESSAGE_SIZE);
+                    "\nNOTE: basename must be smaller than %dbytes\n",
+           my_name, MAX_BASENAME_SIZE);
 }
 
 int parse_args(struct command_line_args *args_out, int argc, char *argv[])
@@ -0,0 +1,294 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/accumulator_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "internal-utilities/explicit_bzero.h"
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+#include "amcl-extensions/pairing_ZZZ.h"
+
+#include <amcl/fp12_ZZZ.h>
+
+static const uint8_t accumulator_base_message[] = "ECDAA accumulator base";
+
+static
+void invert_sum_ZZZ(BIG_XXX inverse_out, BIG_XXX s, BIG_XXX e);
+
+static
+void put_uint64(uint8_t *buffer_out, uint64_t value);
+
+static
+uint64_t get_uint64(const uint8_t *buffer);
+
+size_t ecdaa_accumulator_public_key_ZZZ_length(void)
+{
+    return ECDAA_ACCUMULATOR_PUBLIC_KEY_ZZZ_LENGTH;
+}
+
+size_t ecdaa_accumulator_ZZZ_length(void)
+{
+    return ECDAA_ACCUMULATOR_ZZZ_LENGTH;
+}
+
+size_t ecdaa_accumulator_update_ZZZ_length(void)
+{
+    return ECDAA_ACCUMULATOR_UPDATE_ZZZ_LENGTH;
+}
+
+void ecdaa_accumulator_ZZZ_generate(struct ecdaa_accumulator_public_key_ZZZ *pk_out,
+                                    struct ecdaa_accumulator_secret_key_ZZZ *sk_out,
+                                    struct ecdaa_accumulator_ZZZ *accumulator_out,
+                                    ecdaa_rand_func get_random)
+{
+    ecp_ZZZ_random_mod_order(&sk_out->s, get_random);
+
+    ecp2_ZZZ_set_to_generator(&pk_out->S2);
+    ECP2_ZZZ_mul(&pk_out->S2, sk_out->s);
+
+    BIG_XXX v;
+    ecp_ZZZ_random_mod_order(&v, get_random);
+    accumulator_out->epoch = 0;
+    ecp_ZZZ_mul_generator(&accumulator_out->V, v);
+    ECP_ZZZ_affine(&accumulator_out->V);
+
+    explicit_bzero(v, sizeof(BIG_XXX));
+}
+
+void ecdaa_accumulator_ZZZ_issue_witness(struct ecdaa_accumulator_witness_ZZZ *witness_out,
+                                         struct ecdaa_accumulator_ZZZ *accumulator,
+                                         struct ecdaa_accumulator_secret_key_ZZZ *sk,
+                                         struct ecdaa_member_public_key_ZZZ *member_pk,
+                                         ecdaa_rand_func get_random)
+{
+    BIG_XXX inverse;
+    do {
+        ecp_ZZZ_random_mod_order(&witness_out->e, get_random);
+        invert_sum_ZZZ(inverse, sk->s, witness_out->e);
+    } while (BIG_XXX_iszilch(inverse));     // s + e == 0 (negligible)
+
+    // B = (G + Q) / (s + e)
+    ecdaa_accumulator_ZZZ_get_base(&witness_out->B);
+    ECP_ZZZ_add(&witness_out->B, &member_pk->Q);
+    ECP_ZZZ_mul(&witness_out->B, inverse);
+    ECP_ZZZ_affine(&witness_out->B);
+
+    // W = V / (s + e)
+    ECP_ZZZ_copy(&witness_out->W, &accumulator->V);
+    ECP_ZZZ_mul(&witness_out->W, inverse);
+    ECP_ZZZ_affine(&witness_out->W);
+
+    witness_out->epoch = accumulator->epoch;
+
+    explicit_bzero(inverse, sizeof(BIG_XXX));
+}
+
+void ecdaa_accumulator_ZZZ_revoke(struct ecdaa_accumulator_update_ZZZ *update_out,
+                                  struct ecdaa_accumulator_ZZZ *accumulator,
+                                  struct ecdaa_accumulator_secret_key_ZZZ *sk,
+                                  BIG_XXX e)
+{
+    BIG_XXX inverse;
+    invert_sum_ZZZ(inverse, sk->s, e);
+
+    // V' = V / (s + e)
+    ECP_ZZZ_mul(&accumulator->V, inverse);
+    ECP_ZZZ_affine(&accumulator->V);
+    accumulator->epoch += 1;
+
+    update_out->epoch = accumulator->epoch;
+    BIG_XXX_copy(update_out->e, e);
+    BIG_XXX_norm(update_out->e);
+    ECP_ZZZ_copy(&update_out->V, &accumulator->V);
+
+    explicit_bzero(inverse, sizeof(BIG_XXX));
+}
+
+int ecdaa_accumulator_witness_ZZZ_update(struct ecdaa_accumulator_witness_ZZZ *witness,
+                                         struct ecdaa_accumulator_update_ZZZ *update)
+{
+    if (update->epoch != witness->epoch + 1)
+        return -2;
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    // difference = e_j - e
+    BIG_XXX difference;
+    BIG_XXX_modneg(difference, witness->e, curve_order);
+    BIG_XXX_add(difference, difference, update->e);
+    BIG_XXX_mod(difference, curve_order);
+
+    if (BIG_XXX_iszilch(difference))
+        return -1;
+
+    BIG_XXX inverse;
+    BIG_XXX_invmodp(inverse, difference, curve_order);
+
+    // W' = (W - V') / (e_j - e)
+    //  (W - V' = V/(s+e) - V/(s+e_j) = (e_j - e) * V' / (s+e))
+    ECP_ZZZ_sub(&witness->W, &update->V);
+    ECP_ZZZ_mul(&witness->W, inverse);
+    ECP_ZZZ_affine(&witness->W);
+
+    witness->epoch = update->epoch;
+
+    explicit_bzero(difference, sizeof(BIG_XXX));
+    explicit_bzero(inverse, sizeof(BIG_XXX));
+
+    return 0;
+}
+
+int ecdaa_accumulator_witness_ZZZ_validate(struct ecdaa_accumulator_witness_ZZZ *witness,
+                                           struct ecdaa_accumulator_ZZZ *accumulator,
+                                           struct ecdaa_accumulator_public_key_ZZZ *pk,
+                                           struct ecdaa_member_public_key_ZZZ *member_pk)
+{
+    if (witness->epoch != accumulator->epoch)
+        return -1;
+
+    // e(B + W, S2 + e*P2) == e(V + G + Q, P2)
+    ECP_ZZZ sum;
+    ECP_ZZZ_copy(&sum, &witness->B);
+    ECP_ZZZ_add(&sum, &witness->W);
+    if (ECP_ZZZ_isinf(&sum))
+        return -1;
+
+    ECP_ZZZ neg_rhs;
+    ecdaa_accumulator_ZZZ_get_base(&neg_rhs);
+    ECP_ZZZ_add(&neg_rhs, &accumulator->V);
+    ECP_ZZZ_add(&neg_rhs, &member_pk->Q);
+    ECP_ZZZ_neg(&neg_rhs);
+
+    ECP2_ZZZ basepoint2;
+    ecp2_ZZZ_set_to_generator(&basepoint2);
+
+    ECP2_ZZZ shifted_pk;
+    ECP2_ZZZ_copy(&shifted_pk, &basepoint2);
+    ECP2_ZZZ_mul(&shifted_pk, witness->e);
+    ECP2_ZZZ_add(&shifted_pk, &pk->S2);
+
+    ECP_ZZZ *g1_points[] = {&sum, &neg_rhs};
+    ECP2_ZZZ *g2_points[] = {&shifted_pk, &basepoint2};
+    FP12_YYY product;
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 2);
+
+    if (!FP12_YYY_isunity(&product))
+        return -1;
+
+    return 0;
+}
+
+void ecdaa_accumulator_ZZZ_get_base(ECP_ZZZ *G_out)
+{
+    // The message is fixed, and hashes on the first few tries, so this can't fail.
+    ecp_ZZZ_fromhash(G_out, accumulator_base_message, sizeof(accumulator_base_message) - 1);
+}
+
+void ecdaa_accumulator_public_key_ZZZ_serialize(uint8_t *buffer_out,
+                                                struct ecdaa_accumulator_public_key_ZZZ *pk)
+{
+    ecp2_ZZZ_serialize(buffer_out, &pk->S2);
+}
+
+int ecdaa_accumulator_public_key_ZZZ_deserialize(struct ecdaa_accumulator_public_key_ZZZ *pk_out,
+                                                 uint8_t *buffer_in)
+{
+    if (0 != ecp2_ZZZ_deserialize(&pk_out->S2, buffer_in))
+        return -1;
+
+    return 0;
+}
+
+void ecdaa_accumulator_ZZZ_serialize(uint8_t *buffer_out,
+                                     struct ecdaa_accumulator_ZZZ *accumulator)
+{
+    put_uint64(buffer_out, accumulator->epoch);
+    ecp_ZZZ_serialize(buffer_out + 8, &accumulator->V);
+}
+
+int ecdaa_accumulator_ZZZ_deserialize(struct ecdaa_accumulator_ZZZ *accumulator_out,
+                                      uint8_t *buffer_in)
+{
+    accumulator_out->epoch = get_uint64(buffer_in);
+
+    if (0 != ecp_ZZZ_deserialize(&accumulator_out->V, buffer_in + 8))
+        return -1;
+
+    return 0;
+}
+
+void ecdaa_accumulator_update_ZZZ_serialize(uint8_t *buffer_out,
+                                            struct ecdaa_accumulator_update_ZZZ *update)
+{
+    put_uint64(buffer_out, update->epoch);
+    BIG_XXX_toBytes((char*)(buffer_out + 8), update->e);
+    ecp_ZZZ_serialize(buffer_out + 8 + MODBYTES_XXX, &update->V);
+}
+
+int ecdaa_accumulator_update_ZZZ_deserialize(struct ecdaa_accumulator_update_ZZZ *update_out,
+                                             uint8_t *buffer_in)
+{
+    update_out->epoch = get_uint64(buffer_in);
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+    BIG_XXX_fromBytes(update_out->e, (char*)(buffer_in + 8));
+    if (BIG_XXX_comp(update_out->e, curve_order) >= 0)
+        return -1;
+
+    if (0 != ecp_ZZZ_deserialize(&update_out->V, buffer_in + 8 + MODBYTES_XXX))
+        return -1;
+
+    return 0;
+}
+
+void invert_sum_ZZZ(BIG_XXX inverse_out, BIG_XXX s, BIG_XXX e)
+{
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    BIG_XXX sum;
+    BIG_XXX_add(sum, s, e);
+    BIG_XXX_mod(sum, curve_order);
+
+    if (BIG_XXX_iszilch(sum))
+        BIG_XXX_zero(inverse_out);
+    else
+        BIG_XXX_invmodp(inverse_out, sum, curve_order);
+
+    explicit_bzero(sum, sizeof(BIG_XXX));
+}
+
+void put_uint64(uint8_t *buffer_out, uint64_t value)
+{
+    for (int i = 7; i >= 0; --i) {
+        buffer_out[i] = (uint8_t)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+uint64_t get_uint64(const uint8_t *buffer)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value = (value << 8) | buffer[i];
+
+    return value;
+}
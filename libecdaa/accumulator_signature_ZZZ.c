@@ -0,0 +1,328 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/accumulator_signature_ZZZ.h>
+#include <ecdaa/accumulator_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "internal-utilities/explicit_bzero.h"
+#include "amcl-extensions/big_XXX.h"
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+#include "amcl-extensions/pairing_ZZZ.h"
+
+#include <amcl/fp12_ZZZ.h>
+
+#define PROOF_HASH_INPUT_LENGTH (9*ECP_ZZZ_LENGTH + 8 + MODBYTES_XXX)
+
+static
+void proof_challenge_ZZZ(BIG_XXX c_out,
+                         struct ecdaa_accumulator_signature_ZZZ *signature,
+                         ECP_ZZZ *T1,
+                         ECP_ZZZ *T2,
+                         ECP_ZZZ *T3,
+                         ECP_ZZZ *V);
+
+static
+void put_uint64(uint8_t *buffer_out, uint64_t value);
+
+static
+uint64_t get_uint64(const uint8_t *buffer);
+
+size_t ecdaa_accumulator_signature_ZZZ_length(void)
+{
+    return ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_LENGTH;
+}
+
+size_t ecdaa_accumulator_signature_ZZZ_with_nym_length(void)
+{
+    return ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_WITH_NYM_LENGTH;
+}
+
+int ecdaa_accumulator_signature_ZZZ_sign(struct ecdaa_accumulator_signature_ZZZ *signature_out,
+                                         const uint8_t* message,
+                                         uint32_t message_len,
+                                         const uint8_t* basename,
+                                         uint32_t basename_len,
+                                         struct ecdaa_member_secret_key_ZZZ *sk,
+                                         struct ecdaa_credential_ZZZ *cred,
+                                         struct ecdaa_accumulator_witness_ZZZ *witness,
+                                         struct ecdaa_accumulator_ZZZ *accumulator,
+                                         ecdaa_rand_func get_random)
+{
+    if (witness->epoch != accumulator->epoch)
+        return -2;
+
+    if (0 != ecdaa_signature_ZZZ_sign(&signature_out->signature, message, message_len, basename, basename_len, sk, cred, get_random))
+        return -1;
+
+    signature_out->epoch = accumulator->epoch;
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    // 1) Randomize the witness: X' = r * (B + W), for random (non-zero) r
+    BIG_XXX r;
+    do {
+        ecp_ZZZ_random_mod_order(&r, get_random);
+    } while (BIG_XXX_iszilch(r));
+    BIG_XXX r_inv;
+    BIG_XXX_invmodp(r_inv, r, curve_order);
+
+    ECP_ZZZ X;
+    ECP_ZZZ_copy(&X, &witness->B);
+    ECP_ZZZ_add(&X, &witness->W);
+    ECP_ZZZ_copy(&signature_out->X, &X);
+    ECP_ZZZ_mul(&signature_out->X, r);
+    ECP_ZZZ_affine(&signature_out->X);
+
+    // 2) d = r * (V + G + sk*P1)
+    ECP_ZZZ Y;
+    ecp_ZZZ_mul_generator(&Y, sk->sk);
+    ECP_ZZZ G;
+    ecdaa_accumulator_ZZZ_get_base(&G);
+    ECP_ZZZ_add(&Y, &G);
+    ECP_ZZZ_add(&Y, &accumulator->V);
+    ECP_ZZZ_copy(&signature_out->d, &Y);
+    ECP_ZZZ_mul(&signature_out->d, r);
+    ECP_ZZZ_affine(&signature_out->d);
+
+    // 3) A_bar = d - e*X' = r * (Y - e*X)
+    ECP_ZZZ_copy(&signature_out->A_bar, &X);
+    ECP_ZZZ_mul(&signature_out->A_bar, witness->e);
+    ECP_ZZZ_neg(&signature_out->A_bar);
+    ECP_ZZZ_add(&signature_out->A_bar, &Y);
+    ECP_ZZZ_mul(&signature_out->A_bar, r);
+    ECP_ZZZ_affine(&signature_out->A_bar);
+
+    // 4) Commitments
+    BIG_XXX k_e, k_r, k_sk;
+    ecp_ZZZ_random_mod_order(&k_e, get_random);
+    ecp_ZZZ_random_mod_order(&k_r, get_random);
+    ecp_ZZZ_random_mod_order(&k_sk, get_random);
+
+    //      T1 = -k_e * X'
+    ECP_ZZZ T1;
+    ECP_ZZZ_copy(&T1, &signature_out->X);
+    ECP_ZZZ_mul(&T1, k_e);
+    ECP_ZZZ_neg(&T1);
+
+    //      T2 = k_r * d - k_sk * P1
+    ECP_ZZZ T2;
+    ECP_ZZZ_copy(&T2, &signature_out->d);
+    ECP_ZZZ_mul(&T2, k_r);
+    ECP_ZZZ k_sk_P1;
+    ecp_ZZZ_mul_generator(&k_sk_P1, k_sk);
+    ECP_ZZZ_sub(&T2, &k_sk_P1);
+
+    //      T3 = k_sk * S_sig
+    ECP_ZZZ T3;
+    ECP_ZZZ_copy(&T3, &signature_out->signature.S);
+    ECP_ZZZ_mul(&T3, k_sk);
+
+    // 5) Challenge
+    proof_challenge_ZZZ(signature_out->c, signature_out, &T1, &T2, &T3, &accumulator->V);
+
+    // 6) Responses (s_r is for 1/r)
+    big_XXX_mod_mul_and_add(&signature_out->s_e, k_e, signature_out->c, witness->e, curve_order);
+    big_XXX_mod_mul_and_add(&signature_out->s_r, k_r, signature_out->c, r_inv, curve_order);
+    big_XXX_mod_mul_and_add(&signature_out->s_sk, k_sk, signature_out->c, sk->sk, curve_order);
+
+    // Clear sensitive intermediate memory.
+    explicit_bzero(r, sizeof(BIG_XXX));
+    explicit_bzero(r_inv, sizeof(BIG_XXX));
+    explicit_bzero(k_e, sizeof(BIG_XXX));
+    explicit_bzero(k_r, sizeof(BIG_XXX));
+    explicit_bzero(k_sk, sizeof(BIG_XXX));
+    explicit_bzero(&X, sizeof(ECP_ZZZ));
+    explicit_bzero(&Y, sizeof(ECP_ZZZ));
+    explicit_bzero(&k_sk_P1, sizeof(ECP_ZZZ));
+
+    return 0;
+}
+
+int ecdaa_accumulator_signature_ZZZ_verify(struct ecdaa_accumulator_signature_ZZZ *signature,
+                                           struct ecdaa_group_public_key_ZZZ *gpk,
+                                           struct ecdaa_accumulator_public_key_ZZZ *accumulator_pk,
+                                           struct ecdaa_accumulator_ZZZ *accumulator,
+                                           struct ecdaa_revocations_ZZZ *revocations,
+                                           uint8_t* message,
+                                           uint32_t message_len,
+                                           uint8_t *basename,
+                                           uint32_t basename_len)
+{
+    if (signature->epoch != accumulator->epoch)
+        return -2;
+
+    if (ECP_ZZZ_isinf(&signature->X))
+        return -2;
+
+    if (0 != ecdaa_signature_ZZZ_verify(&signature->signature, gpk, revocations, message, message_len, basename, basename_len))
+        return -1;
+
+    // 1) Re-compute the commitments
+    //      T1 = -s_e * X' + c * (d - A_bar)
+    ECP_ZZZ neg_X, neg_A_bar;
+    ECP_ZZZ_copy(&neg_X, &signature->X);
+    ECP_ZZZ_neg(&neg_X);
+    ECP_ZZZ_copy(&neg_A_bar, &signature->A_bar);
+    ECP_ZZZ_neg(&neg_A_bar);
+
+    ECP_ZZZ T1;
+    ECP_ZZZ *T1_points[] = {&neg_X, &signature->d, &neg_A_bar};
+    BIG_XXX T1_scalars[3];
+    BIG_XXX_copy(T1_scalars[0], signature->s_e);
+    BIG_XXX_copy(T1_scalars[1], signature->c);
+    BIG_XXX_copy(T1_scalars[2], signature->c);
+    ecp_ZZZ_mul_multi(&T1, T1_points, T1_scalars, 3);
+
+    //      T2 = s_r * d - s_sk * P1 - c * (V + G)
+    ECP_ZZZ neg_P1, neg_VG;
+    ecp_ZZZ_set_to_generator(&neg_P1);
+    ECP_ZZZ_neg(&neg_P1);
+    ecdaa_accumulator_ZZZ_get_base(&neg_VG);
+    ECP_ZZZ_add(&neg_VG, &accumulator->V);
+    ECP_ZZZ_neg(&neg_VG);
+
+    ECP_ZZZ T2;
+    ECP_ZZZ *T2_points[] = {&signature->d, &neg_P1, &neg_VG};
+    BIG_XXX T2_scalars[3];
+    BIG_XXX_copy(T2_scalars[0], signature->s_r);
+    BIG_XXX_copy(T2_scalars[1], signature->s_sk);
+    BIG_XXX_copy(T2_scalars[2], signature->c);
+    ecp_ZZZ_mul_multi(&T2, T2_points, T2_scalars, 3);
+
+    //      T3 = s_sk * S_sig - c * W_sig
+    ECP_ZZZ neg_W;
+    ECP_ZZZ_copy(&neg_W, &signature->signature.W);
+    ECP_ZZZ_neg(&neg_W);
+
+    ECP_ZZZ T3;
+    ecp_ZZZ_mul2(&T3, &signature->signature.S, signature->s_sk, &neg_W, signature->c);
+
+    // 2) Check the challenge
+    BIG_XXX c;
+    proof_challenge_ZZZ(c, signature, &T1, &T2, &T3, &accumulator->V);
+    if (0 != BIG_XXX_comp(c, signature->c))
+        return -2;
+
+    // 3) Check e(X', S2) == e(A_bar, P2)
+    ECP2_ZZZ basepoint2;
+    ecp2_ZZZ_set_to_generator(&basepoint2);
+
+    ECP_ZZZ *g1_points[] = {&signature->X, &neg_A_bar};
+    ECP2_ZZZ *g2_points[] = {&accumulator_pk->S2, &basepoint2};
+    FP12_YYY product;
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 2);
+    if (!FP12_YYY_isunity(&product))
+        return -2;
+
+    return 0;
+}
+
+void ecdaa_accumulator_signature_ZZZ_serialize(uint8_t *buffer_out,
+                                               struct ecdaa_accumulator_signature_ZZZ *signature,
+                                               int has_nym)
+{
+    ecdaa_signature_ZZZ_serialize(buffer_out, &signature->signature, has_nym);
+    uint8_t *proof = buffer_out + (has_nym ? ECDAA_SIGNATURE_ZZZ_WITH_NYM_LENGTH : ECDAA_SIGNATURE_ZZZ_LENGTH);
+
+    put_uint64(proof, signature->epoch);
+    proof += 8;
+    ecp_ZZZ_serialize(proof, &signature->X);
+    ecp_ZZZ_serialize(proof + ECP_ZZZ_LENGTH, &signature->A_bar);
+    ecp_ZZZ_serialize(proof + 2*ECP_ZZZ_LENGTH, &signature->d);
+    proof += 3*ECP_ZZZ_LENGTH;
+    BIG_XXX_toBytes((char*)proof, signature->c);
+    BIG_XXX_toBytes((char*)(proof + MODBYTES_XXX), signature->s_e);
+    BIG_XXX_toBytes((char*)(proof + 2*MODBYTES_XXX), signature->s_r);
+    BIG_XXX_toBytes((char*)(proof + 3*MODBYTES_XXX), signature->s_sk);
+}
+
+int ecdaa_accumulator_signature_ZZZ_deserialize(struct ecdaa_accumulator_signature_ZZZ *signature_out,
+                                                uint8_t *buffer_in,
+                                                int has_nym)
+{
+    int ret = 0;
+
+    if (0 != ecdaa_signature_ZZZ_deserialize(&signature_out->signature, buffer_in, has_nym))
+        ret = -1;
+    uint8_t *proof = buffer_in + (has_nym ? ECDAA_SIGNATURE_ZZZ_WITH_NYM_LENGTH : ECDAA_SIGNATURE_ZZZ_LENGTH);
+
+    signature_out->epoch = get_uint64(proof);
+    proof += 8;
+    if (0 != ecp_ZZZ_deserialize(&signature_out->X, proof))
+        ret = -1;
+    if (0 != ecp_ZZZ_deserialize(&signature_out->A_bar, proof + ECP_ZZZ_LENGTH))
+        ret = -1;
+    if (0 != ecp_ZZZ_deserialize(&signature_out->d, proof + 2*ECP_ZZZ_LENGTH))
+        ret = -1;
+    proof += 3*ECP_ZZZ_LENGTH;
+    BIG_XXX_fromBytes(signature_out->c, (char*)proof);
+    BIG_XXX_fromBytes(signature_out->s_e, (char*)(proof + MODBYTES_XXX));
+    BIG_XXX_fromBytes(signature_out->s_r, (char*)(proof + 2*MODBYTES_XXX));
+    BIG_XXX_fromBytes(signature_out->s_sk, (char*)(proof + 3*MODBYTES_XXX));
+
+    return ret;
+}
+
+void proof_challenge_ZZZ(BIG_XXX c_out,
+                         struct ecdaa_accumulator_signature_ZZZ *signature,
+                         ECP_ZZZ *T1,
+                         ECP_ZZZ *T2,
+                         ECP_ZZZ *T3,
+                         ECP_ZZZ *V)
+{
+    // c = H(X' | A_bar | d | T1 | T2 | T3 | V | S_sig | W_sig | epoch | c_sig)
+    uint8_t hash_input[PROOF_HASH_INPUT_LENGTH];
+    uint8_t *next = hash_input;
+    ECP_ZZZ *points[] = {&signature->X, &signature->A_bar, &signature->d, T1, T2, T3, V,
+                         &signature->signature.S, &signature->signature.W};
+    for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); ++i) {
+        ecp_ZZZ_serialize(next, points[i]);
+        next += ECP_ZZZ_LENGTH;
+    }
+    put_uint64(next, signature->epoch);
+    next += 8;
+    BIG_XXX_toBytes((char*)next, signature->signature.c);
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    BIG_XXX c;
+    big_XXX_from_hash(&c, hash_input, sizeof(hash_input));
+    BIG_XXX_mod(c, curve_order);
+    BIG_XXX_copy(c_out, c);
+}
+
+void put_uint64(uint8_t *buffer_out, uint64_t value)
+{
+    for (int i = 7; i >= 0; --i) {
+        buffer_out[i] = (uint8_t)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+uint64_t get_uint64(const uint8_t *buffer)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value = (value << 8) | buffer[i];
+
+    return value;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/basename_ctx_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "schnorr/schnorr_ZZZ.h"
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "internal-utilities/explicit_bzero.h"
+#include "internal-utilities/sha256.h"
+
+#include <string.h>
+
+// The public table in `ecdaa_basename_ctx_ZZZ` is used as an `ecp_ZZZ_fixed_base_table`,
+//  so must have the same layout.
+typedef char basename_ctx_table_matches_ZZZ[(sizeof(((struct ecdaa_basename_ctx_ZZZ*)0)->P2_table)
+                                             == sizeof(struct ecp_ZZZ_fixed_base_table)) ? 1 : -1];
+
+typedef char basename_ctx_fingerprint_fits_ZZZ[(ECDAA_BASENAME_CTX_ZZZ_FINGERPRINT_LENGTH
+                                                == ECDAA_SHA256_DIGEST_LENGTH) ? 1 : -1];
+
+static
+void sk_fingerprint_ZZZ(uint8_t *fingerprint_out,
+                        struct ecdaa_member_secret_key_ZZZ *sk);
+
+int ecdaa_basename_ctx_ZZZ_init(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                const uint8_t *basename,
+                                uint32_t basename_len)
+{
+    return ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(ctx, basename, basename_len, ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT);
+}
+
+int ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                                   const uint8_t *basename,
+                                                   uint32_t basename_len,
+                                                   enum ecdaa_hash_to_curve hash_to_curve)
+{
+    if (0 == basename_len)
+        return -1;
+
+    if (0 != schnorr_basename_point_ZZZ(&ctx->P2, basename, basename_len, hash_to_curve))
+        return -2;
+
+    ctx->basename = basename;
+    ctx->basename_len = basename_len;
+    ctx->hash_to_curve = hash_to_curve;
+
+    ecp_ZZZ_fixed_base_table_build((struct ecp_ZZZ_fixed_base_table*)ctx->P2_table, &ctx->P2);
+
+    ctx->has_pseudonym = 0;
+    memset(&ctx->K, 0, sizeof(ECP_ZZZ));
+    memset(ctx->sk_fingerprint, 0, sizeof(ctx->sk_fingerprint));
+
+    return 0;
+}
+
+void ecdaa_basename_ctx_ZZZ_set_secret_key(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                           struct ecdaa_member_secret_key_ZZZ *sk)
+{
+    ecp_ZZZ_fixed_base_mul(&ctx->K, (struct ecp_ZZZ_fixed_base_table*)ctx->P2_table, sk->sk);
+    sk_fingerprint_ZZZ(ctx->sk_fingerprint, sk);
+    ctx->has_pseudonym = 1;
+}
+
+int ecdaa_basename_ctx_ZZZ_check_secret_key(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                            struct ecdaa_member_secret_key_ZZZ *sk)
+{
+    if (!ctx->has_pseudonym)
+        return 0;
+
+    uint8_t fingerprint[ECDAA_BASENAME_CTX_ZZZ_FINGERPRINT_LENGTH];
+    sk_fingerprint_ZZZ(fingerprint, sk);
+
+    // Compare without branching on the contents
+    uint8_t difference = 0;
+    for (size_t i = 0; i < sizeof(fingerprint); ++i) {
+        difference |= fingerprint[i] ^ ctx->sk_fingerprint[i];
+    }
+
+    explicit_bzero(fingerprint, sizeof(fingerprint));
+
+    if (0 != difference)
+        return -1;
+
+    return 0;
+}
+
+void sk_fingerprint_ZZZ(uint8_t *fingerprint_out,
+                        struct ecdaa_member_secret_key_ZZZ *sk)
+{
+    // A hash, so the context doesn't hold (a copy of) the key itself
+    static const uint8_t tag[] = "ECDAA basename ctx secret key";
+    uint8_t sk_bytes[MODBYTES_XXX];
+    BIG_XXX_toBytes((char*)sk_bytes, sk->sk);
+
+    struct ecdaa_sha256 hash;
+    ecdaa_sha256_init(&hash);
+    ecdaa_sha256_update(&hash, tag, sizeof(tag) - 1);
+    ecdaa_sha256_update(&hash, sk_bytes, sizeof(sk_bytes));
+    ecdaa_sha256_final(&hash, fingerprint_out);
+
+    explicit_bzero(sk_bytes, sizeof(sk_bytes));
+}
@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "internal-utilities/sha256.h"
+
+#include <string.h>
+
+// Bits set in the Bloom filter per entry
+#define BLOOM_NUM_HASHES 4
+
+static
+void digest_ZZZ(uint8_t *digest_out, ECP_ZZZ *K);
+
+static
+uint32_t digest_word(const uint8_t *digest, size_t index);
+
+static
+int is_empty_slot(const uint8_t *slot);
+
+int ecdaa_bsn_revocation_set_ZZZ_init(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                      uint8_t *slot_storage,
+                                      size_t capacity,
+                                      uint8_t *bloom_storage,
+                                      size_t bloom_length)
+{
+    if (0 == capacity || 0 != (capacity & (capacity - 1)))
+        return -1;
+
+    if (NULL != bloom_storage && (0 == bloom_length || 0 != (bloom_length & (bloom_length - 1))))
+        return -1;
+
+    set->slots = slot_storage;
+    set->capacity = capacity;
+    set->count = 0;
+    memset(set->slots, 0, capacity * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH);
+
+    set->bloom = bloom_storage;
+    set->bloom_bits = 0;
+    if (NULL != bloom_storage) {
+        set->bloom_bits = 8 * bloom_length;
+        memset(set->bloom, 0, bloom_length);
+    }
+
+    return 0;
+}
+
+int ecdaa_bsn_revocation_set_ZZZ_insert(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                        ECP_ZZZ *K)
+{
+    uint8_t digest[ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    digest_ZZZ(digest, K);
+
+    // Find either this digest, or the first empty slot after its home slot.
+    size_t index = digest_word(digest, 0) & (set->capacity - 1);
+    uint8_t *slot;
+    for (;;) {
+        slot = set->slots + index * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH;
+        if (is_empty_slot(slot))
+            break;
+        if (0 == memcmp(slot, digest, sizeof(digest)))
+            return 0;
+        index = (index + 1) & (set->capacity - 1);
+    }
+
+    // Always leave one slot empty, so probing terminates.
+    if (set->count + 1 >= set->capacity)
+        return -1;
+
+    memcpy(slot, digest, sizeof(digest));
+    set->count++;
+
+    if (NULL != set->bloom) {
+        for (size_t i = 0; i < BLOOM_NUM_HASHES; ++i) {
+            uint32_t bit = digest_word(digest, i) & (set->bloom_bits - 1);
+            set->bloom[bit / 8] |= (uint8_t)(1 << (bit % 8));
+        }
+    }
+
+    return 0;
+}
+
+int ecdaa_bsn_revocation_set_ZZZ_contains(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                          ECP_ZZZ *K)
+{
+    if (0 == set->count)
+        return 0;
+
+    uint8_t digest[ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    digest_ZZZ(digest, K);
+
+    if (NULL != set->bloom) {
+        for (size_t i = 0; i < BLOOM_NUM_HASHES; ++i) {
+            uint32_t bit = digest_word(digest, i) & (set->bloom_bits - 1);
+            if (0 == (set->bloom[bit / 8] & (1 << (bit % 8))))
+                return 0;
+        }
+    }
+
+    size_t index = digest_word(digest, 0) & (set->capacity - 1);
+    for (;;) {
+        uint8_t *slot = set->slots + index * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH;
+        if (is_empty_slot(slot))
+            return 0;
+        if (0 == memcmp(slot, digest, sizeof(digest)))
+            return 1;
+        index = (index + 1) & (set->capacity - 1);
+    }
+}
+
+void digest_ZZZ(uint8_t *digest_out, ECP_ZZZ *K)
+{
+    // Serialization is of the affine coordinates, so it's unique per point.
+    uint8_t serialized[ECP_ZZZ_LENGTH];
+    ecp_ZZZ_serialize(serialized, K);
+
+    uint8_t hash_as_bytes[ECDAA_SHA256_DIGEST_LENGTH];
+    ecdaa_sha256(hash_as_bytes, serialized, sizeof(serialized));
+    memcpy(digest_out, hash_as_bytes, ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH);
+
+    // All-zero marks an empty slot, so make sure no digest is all-zero.
+    if (is_empty_slot(digest_out))
+        digest_out[0] = 1;
+}
+
+uint32_t digest_word(const uint8_t *digest, size_t index)
+{
+    // The digest is uniformly random, so any four bytes make a good hash.
+    const uint8_t *word = digest + 4*index;
+    return ((uint32_t)word[0] << 24) | ((uint32_t)word[1] << 16) | ((uint32_t)word[2] << 8) | (uint32_t)word[3];
+}
+
+int is_empty_slot(const uint8_t *slot)
+{
+    uint8_t any = 0;
+    for (size_t i = 0; i < ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH; ++i) {
+        any |= slot[i];
+    }
+    return 0 == any;
+}
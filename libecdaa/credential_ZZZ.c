@@ -29,6 +29,14 @@
 #include <ecdaa/member_keypair_ZZZ.h>
 #include <ecdaa/issuer_keypair_ZZZ.h>
 #include <ecdaa/group_public_key_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
+
+static
+int validate_ZZZ(struct ecdaa_credential_ZZZ *credential,
+                 struct ecdaa_credential_ZZZ_signature *credential_signature,
+                 struct ecdaa_member_public_key_ZZZ *member_pk,
+                 ECP2_ZZZ **g2_points,
+                 FP2_YYY **g2_lines);
 
 size_t ecdaa_credential_ZZZ_length(void)
 {
@@ -56,8 +64,7 @@ int ecdaa_credential_ZZZ_generate(struct ecdaa_credential_ZZZ *cred,
     ecp_ZZZ_random_mod_order(&l, get_random);
 
     // 2) Multiply generator by l and save to cred->A (A = l*P)
-    ecp_ZZZ_set_to_generator(&cred->A);
-    ECP_ZZZ_mul(&cred->A, l);
+    ecp_ZZZ_mul_generator(&cred->A, l);
 
     // 3) Multiply A by my secret y and save to cred->B (B = y*A)
     ECP_ZZZ_copy(&cred->B, &cred->A);
@@ -113,48 +120,27 @@ int ecdaa_credential_ZZZ_validate(struct ecdaa_credential_ZZZ *credential,
                                   struct ecdaa_member_public_key_ZZZ *member_pk,
                                   struct ecdaa_group_public_key_ZZZ *gpk)
 {
-    int ret = 0;
-
-    // 1) Check A,B,C,D for membership in group, and A for !=inf
-    // NOTE: We assume the credential was obtained from a call to `deserialize`,
-    //  which already checked the validity of the points A,B,C,D
-
-    // 2) Verify schnorr-like signature
-    int schnorr_ret = credential_schnorr_verify_ZZZ(credential_signature->c,
-                                                    credential_signature->s,
-                                                    &credential->B,
-                                                    &member_pk->Q,
-                                                    &credential->D);
-    if (0 != schnorr_ret)
-        ret = -1;
-
     ECP2_ZZZ basepoint2;
     ecp2_ZZZ_set_to_generator(&basepoint2);
 
-    // 3) Check e(A, Y) == e(B, P_2)
-    FP12_YYY pairing_one;
-    FP12_YYY pairing_one_prime;
-    compute_pairing_ZZZ(&pairing_one, &credential->A, &gpk->Y);
-    compute_pairing_ZZZ(&pairing_one_prime, &credential->B, &basepoint2);
-    if (!FP12_YYY_equals(&pairing_one, &pairing_one_prime))
-        ret = -1;
+    ECP2_ZZZ *g2_points[3] = {&gpk->Y, &basepoint2, &gpk->X};
 
-    // 4) Compute A+D
-    //      Nb. Add doesn't convert to affine, so do that explicitly
-    ECP_ZZZ AD;
-    ECP_ZZZ_copy(&AD, &credential->A);
-    ECP_ZZZ_add(&AD, &credential->D);
-    ECP_ZZZ_affine(&AD);
-
-    // 5) Check e(C, P_2) == e(A+D, X)
-    FP12_YYY pairing_two;
-    FP12_YYY pairing_two_prime;
-    compute_pairing_ZZZ(&pairing_two, &credential->C, &basepoint2);
-    compute_pairing_ZZZ(&pairing_two_prime, &AD, &gpk->X);
-    if (!FP12_YYY_equals(&pairing_two, &pairing_two_prime))
-        ret = -1;
+    return validate_ZZZ(credential, credential_signature, member_pk, g2_points, NULL);
+}
 
-    return ret;
+int ecdaa_credential_ZZZ_validate_prepared(struct ecdaa_credential_ZZZ *credential,
+                                           struct ecdaa_credential_ZZZ_signature *credential_signature,
+                                           struct ecdaa_member_public_key_ZZZ *member_pk,
+                                           struct ecdaa_prepared_gpk_ZZZ *prepared_gpk)
+{
+    ECP2_ZZZ *g2_points[3] = {&prepared_gpk->gpk.Y, &prepared_gpk->basepoint2, &prepared_gpk->gpk.X};
+    FP2_YYY *g2_lines[3] = {prepared_gpk->Y_lines, prepared_gpk->basepoint2_lines, prepared_gpk->X_lines};
+
+    return validate_ZZZ(credential,
+                        credential_signature,
+                        member_pk,
+                        g2_points,
+                        prepared_gpk->has_lines ? g2_lines : NULL);
 }
 
 void ecdaa_credential_ZZZ_serialize(uint8_t *buffer_out,
@@ -366,3 +352,66 @@ int ecdaa_credential_ZZZ_deserialize_fp(struct ecdaa_credential_ZZZ *credential_
     }
     return SUCCESS;
 }
+
+int validate_ZZZ(struct ecdaa_credential_ZZZ *credential,
+                 struct ecdaa_credential_ZZZ_signature *credential_signature,
+                 struct ecdaa_member_public_key_ZZZ *member_pk,
+                 ECP2_ZZZ **g2_points,
+                 FP2_YYY **g2_lines)
+{
+    int ret = 0;
+
+    // 1) Check A,B,C,D for membership in group, and A for !=inf
+    // NOTE: We assume the credential was obtained from a call to `deserialize`,
+    //  which already checked the validity of the points A,B,C,D
+
+    // 2) Verify schnorr-like signature
+    int schnorr_ret = credential_schnorr_verify_ZZZ(credential_signature->c,
+                                                    credential_signature->s,
+                                                    &credential->B,
+                                                    &member_pk->Q,
+                                                    &credential->D);
+    if (0 != schnorr_ret)
+        ret = -1;
+
+    // g2_points are (Y, P_2, X)
+    ECP2_ZZZ *Y_and_P2[2] = {g2_points[0], g2_points[1]};
+    ECP2_ZZZ *P2_and_X[2] = {g2_points[1], g2_points[2]};
+    FP2_YYY *Y_and_P2_lines[2] = {NULL, NULL};
+    FP2_YYY *P2_and_X_lines[2] = {NULL, NULL};
+    if (NULL != g2_lines) {
+        Y_and_P2_lines[0] = g2_lines[0];
+        Y_and_P2_lines[1] = g2_lines[1];
+        P2_and_X_lines[0] = g2_lines[1];
+        P2_and_X_lines[1] = g2_lines[2];
+    }
+
+    // 3) Check e(A, Y) == e(B, P_2), as e(A, Y) * e(-B, P_2) == 1
+    ECP_ZZZ negB;
+    ECP_ZZZ_copy(&negB, &credential->B);
+    ECP_ZZZ_neg(&negB);
+    ECP_ZZZ_affine(&negB);
+
+    ECP_ZZZ *A_and_negB[2] = {&credential->A, &negB};
+    FP12_YYY pairing_one;
+    compute_pairing_product_with_lines_ZZZ(&pairing_one, A_and_negB, Y_and_P2, Y_and_P2_lines, 2);
+    if (!FP12_YYY_isunity(&pairing_one))
+        ret = -1;
+
+    // 4) Compute -(A+D)
+    //      Nb. Add doesn't convert to affine, so do that explicitly
+    ECP_ZZZ negAD;
+    ECP_ZZZ_copy(&negAD, &credential->A);
+    ECP_ZZZ_add(&negAD, &credential->D);
+    ECP_ZZZ_neg(&negAD);
+    ECP_ZZZ_affine(&negAD);
+
+    // 5) Check e(C, P_2) == e(A+D, X), as e(C, P_2) * e(-(A+D), X) == 1
+    ECP_ZZZ *C_and_negAD[2] = {&credential->C, &negAD};
+    FP12_YYY pairing_two;
+    compute_pairing_product_with_lines_ZZZ(&pairing_two, C_and_negAD, P2_and_X, P2_and_X_lines, 2);
+    if (!FP12_YYY_isunity(&pairing_two))
+        ret = -1;
+
+    return ret;
+}
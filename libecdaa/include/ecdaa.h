@@ -20,13 +20,25 @@
 #define ECDAA_ECDAA_H
 #pragma once
 
+#include <ecdaa/accumulator_ZZZ.h>
+#include <ecdaa/accumulator_signature_ZZZ.h>
+#include <ecdaa/basename_ctx_ZZZ.h>
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
 #include <ecdaa/credential_ZZZ.h>
 #include <ecdaa/group_public_key_ZZZ.h>
+#include <ecdaa/hash_to_curve.h>
 #include <ecdaa/issuer_keypair_ZZZ.h>
 #include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/prepared_credential_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
+#include <ecdaa/presignature_pool_ZZZ.h>
+#include <ecdaa/pseudonym_index_ZZZ.h>
 #include <ecdaa/rand.h>
+#include <ecdaa/revocation_store_ZZZ.h>
 #include <ecdaa/revocations_ZZZ.h>
 #include <ecdaa/signature_ZZZ.h>
+#include <ecdaa/verify_policy.h>
+#include <ecdaa/verifier_pool_ZZZ.h>
 #include <ecdaa/util/file_io.h>
 #include <ecdaa/util/errors.h>
 
@@ -0,0 +1,227 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_ACCUMULATOR_ZZZ_H
+#define ECDAA_ACCUMULATOR_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/rand.h>
+
+#include <amcl/big_XXX.h>
+#include <amcl/ecp_ZZZ.h>
+#include <amcl/ecp2_ZZZ.h>
+
+#include <stdint.h>
+
+struct ecdaa_member_public_key_ZZZ;
+
+/*
+ * Dynamic accumulator, for revocation whose cost to a verifier
+ *  doesn't depend on the number of revoked members.
+ *
+ * The revocation authority holds a secret s, and publishes S2 = s*P2
+ *  and, per epoch, the accumulator value V.
+ *  Each member gets a value e (secret, until they're revoked) and a witness (B, W) with
+ *      (s + e) * B = G + Q
+ *      (s + e) * W = V
+ *  where Q = sk*P1 is the member's public key, and G is a fixed point (hashed from a constant).
+ *  B binds the witness to the member's secret key, and W to the current accumulator value.
+ *
+ * Revoking the member with value e_j divides the accumulator by (s + e_j) (V' = V / (s + e_j)),
+ *  and publishes an update (e_j, V').
+ *  Every other member can then update their W without any secret (W' = (W - V') / (e_j - e)),
+ *  but the revoked member can't (it would need V' / (s + e_j)).
+ *
+ * See `accumulator_signature_ZZZ.h` for signatures that prove the signer holds a current witness.
+ */
+
+/*
+ * Revocation authority's public key.
+ */
+struct ecdaa_accumulator_public_key_ZZZ {
+    ECP2_ZZZ S2;
+};
+
+#define ECDAA_ACCUMULATOR_PUBLIC_KEY_ZZZ_LENGTH (4*MODBYTES_XXX + 1)
+size_t ecdaa_accumulator_public_key_ZZZ_length(void);
+
+/*
+ * Revocation authority's secret key.
+ */
+struct ecdaa_accumulator_secret_key_ZZZ {
+    BIG_XXX s;
+};
+
+/*
+ * Accumulator value for an epoch.
+ */
+struct ecdaa_accumulator_ZZZ {
+    uint64_t epoch;
+    ECP_ZZZ V;
+};
+
+#define ECDAA_ACCUMULATOR_ZZZ_LENGTH (8 + 2*MODBYTES_XXX + 1)
+size_t ecdaa_accumulator_ZZZ_length(void);
+
+/*
+ * Published when a member is revoked (taking the accumulator to `epoch`).
+ */
+struct ecdaa_accumulator_update_ZZZ {
+    uint64_t epoch;
+    BIG_XXX e;
+    ECP_ZZZ V;
+};
+
+#define ECDAA_ACCUMULATOR_UPDATE_ZZZ_LENGTH (8 + MODBYTES_XXX + 2*MODBYTES_XXX + 1)
+size_t ecdaa_accumulator_update_ZZZ_length(void);
+
+/*
+ * Member's witness. Secret.
+ */
+struct ecdaa_accumulator_witness_ZZZ {
+    uint64_t epoch;
+    BIG_XXX e;
+    ECP_ZZZ B;
+    ECP_ZZZ W;
+};
+
+/*
+ * Generate a revocation authority's keypair, and the initial (epoch 0) accumulator.
+ */
+void ecdaa_accumulator_ZZZ_generate(struct ecdaa_accumulator_public_key_ZZZ *pk_out,
+                                    struct ecdaa_accumulator_secret_key_ZZZ *sk_out,
+                                    struct ecdaa_accumulator_ZZZ *accumulator_out,
+                                    ecdaa_rand_func get_random);
+
+/*
+ * Issue a witness, for the current epoch, to the member with public key `member_pk`.
+ *
+ * The authority must record `witness_out->e`, to be able to revoke the member later.
+ *  `member_pk` must have been checked (e.g. by `ecdaa_member_public_key_ZZZ_validate`).
+ */
+void ecdaa_accumulator_ZZZ_issue_witness(struct ecdaa_accumulator_witness_ZZZ *witness_out,
+                                         struct ecdaa_accumulator_ZZZ *accumulator,
+                                         struct ecdaa_accumulator_secret_key_ZZZ *sk,
+                                         struct ecdaa_member_public_key_ZZZ *member_pk,
+                                         ecdaa_rand_func get_random);
+
+/*
+ * Revoke the member with value `e`, taking `accumulator` to the next epoch.
+ *
+ * `update_out` must be published to all members.
+ */
+void ecdaa_accumulator_ZZZ_revoke(struct ecdaa_accumulator_update_ZZZ *update_out,
+                                  struct ecdaa_accumulator_ZZZ *accumulator,
+                                  struct ecdaa_accumulator_secret_key_ZZZ *sk,
+                                  BIG_XXX e);
+
+/*
+ * Apply an update to a member's witness.
+ *
+ * Updates must be applied in epoch order.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the update revokes this member (the witness is left unchanged)
+ * -2 if the update isn't for the witness's next epoch
+ */
+int ecdaa_accumulator_witness_ZZZ_update(struct ecdaa_accumulator_witness_ZZZ *witness,
+                                         struct ecdaa_accumulator_update_ZZZ *update);
+
+/*
+ * Check that a witness is valid for an accumulator and member.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the witness is invalid (or for a different epoch)
+ */
+int ecdaa_accumulator_witness_ZZZ_validate(struct ecdaa_accumulator_witness_ZZZ *witness,
+                                           struct ecdaa_accumulator_ZZZ *accumulator,
+                                           struct ecdaa_accumulator_public_key_ZZZ *pk,
+                                           struct ecdaa_member_public_key_ZZZ *member_pk);
+
+/*
+ * Get the fixed point G (the same for all authorities).
+ */
+void ecdaa_accumulator_ZZZ_get_base(ECP_ZZZ *G_out);
+
+/*
+ * Serialize an `ecdaa_accumulator_public_key_ZZZ`.
+ *
+ * Format: ( S2 ), as for `ecp2_ZZZ_serialize`.
+ */
+void ecdaa_accumulator_public_key_ZZZ_serialize(uint8_t *buffer_out,
+                                                struct ecdaa_accumulator_public_key_ZZZ *pk);
+
+/*
+ * De-serialize an `ecdaa_accumulator_public_key_ZZZ`, checking S2 is in G2.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if S2 is invalid
+ */
+int ecdaa_accumulator_public_key_ZZZ_deserialize(struct ecdaa_accumulator_public_key_ZZZ *pk_out,
+                                                 uint8_t *buffer_in);
+
+/*
+ * Serialize an `ecdaa_accumulator_ZZZ`.
+ *
+ * Format: ( epoch | V )
+ *  where epoch is 8 bytes, big-endian.
+ */
+void ecdaa_accumulator_ZZZ_serialize(uint8_t *buffer_out,
+                                     struct ecdaa_accumulator_ZZZ *accumulator);
+
+/*
+ * De-serialize an `ecdaa_accumulator_ZZZ`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if V is invalid
+ */
+int ecdaa_accumulator_ZZZ_deserialize(struct ecdaa_accumulator_ZZZ *accumulator_out,
+                                      uint8_t *buffer_in);
+
+/*
+ * Serialize an `ecdaa_accumulator_update_ZZZ`.
+ *
+ * Format: ( epoch | e | V )
+ *  where epoch is 8 bytes, and e is zero-padded, both big-endian.
+ */
+void ecdaa_accumulator_update_ZZZ_serialize(uint8_t *buffer_out,
+                                            struct ecdaa_accumulator_update_ZZZ *update);
+
+/*
+ * De-serialize an `ecdaa_accumulator_update_ZZZ`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if V is invalid
+ */
+int ecdaa_accumulator_update_ZZZ_deserialize(struct ecdaa_accumulator_update_ZZZ *update_out,
+                                             uint8_t *buffer_in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_H
+#define ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/rand.h>
+#include <ecdaa/signature_ZZZ.h>
+
+#include <amcl/big_XXX.h>
+#include <amcl/ecp_ZZZ.h>
+
+#include <stdint.h>
+
+struct ecdaa_accumulator_ZZZ;
+struct ecdaa_accumulator_public_key_ZZZ;
+struct ecdaa_accumulator_witness_ZZZ;
+
+/*
+ * ECDAA signature, plus a proof that the signer holds a witness for the current accumulator
+ *  (see `accumulator_ZZZ.h`).
+ *
+ * Checking the proof costs the same however many members have been revoked,
+ *  unlike a secret-key revocation list, whose check grows with the list.
+ *
+ * The proof is a Fiat-Shamir proof of knowledge of (e, sk, 1/r) such that
+ *      X' = r * (B + W)
+ *      d = r * (V + G + sk*P1)
+ *      A_bar = d - e*X'    (so, e(X', S2) == e(A_bar, P2) )
+ *  where sk is the same secret key as in the ECDAA signature (W_sig = sk * S_sig).
+ *  Its challenge includes the ECDAA signature's c, binding the proof to that signature.
+ *
+ * A signature is only valid for the accumulator epoch it was created in.
+ */
+struct ecdaa_accumulator_signature_ZZZ {
+    struct ecdaa_signature_ZZZ signature;
+    uint64_t epoch;
+    ECP_ZZZ X;
+    ECP_ZZZ A_bar;
+    ECP_ZZZ d;
+    BIG_XXX c;
+    BIG_XXX s_e;
+    BIG_XXX s_r;
+    BIG_XXX s_sk;
+};
+
+#define ECDAA_ACCUMULATOR_PROOF_ZZZ_LENGTH (8 + 3*(2*MODBYTES_XXX + 1) + 4*MODBYTES_XXX)
+
+#define ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_LENGTH (ECDAA_SIGNATURE_ZZZ_LENGTH + ECDAA_ACCUMULATOR_PROOF_ZZZ_LENGTH)
+size_t ecdaa_accumulator_signature_ZZZ_length(void);
+
+#define ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_WITH_NYM_LENGTH (ECDAA_SIGNATURE_ZZZ_WITH_NYM_LENGTH + ECDAA_ACCUMULATOR_PROOF_ZZZ_LENGTH)
+size_t ecdaa_accumulator_signature_ZZZ_with_nym_length(void);
+
+/*
+ * Create an ECDAA signature with a non-revocation proof.
+ *
+ * `witness` must be up-to-date with `accumulator`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if unable to create signature
+ * -2 if `witness` is for a different epoch than `accumulator`
+ */
+int ecdaa_accumulator_signature_ZZZ_sign(struct ecdaa_accumulator_signature_ZZZ *signature_out,
+                                         const uint8_t* message,
+                                         uint32_t message_len,
+                                         const uint8_t* basename,
+                                         uint32_t basename_len,
+                                         struct ecdaa_member_secret_key_ZZZ *sk,
+                                         struct ecdaa_credential_ZZZ *cred,
+                                         struct ecdaa_accumulator_witness_ZZZ *witness,
+                                         struct ecdaa_accumulator_ZZZ *accumulator,
+                                         ecdaa_rand_func get_random);
+
+/*
+ * Verify an ECDAA signature with a non-revocation proof.
+ *
+ * `revocations` may be NULL, in which case only the accumulator is used for revocation.
+ *  (A basename revocation list may still be useful, for linkable signatures.)
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the ECDAA signature is invalid
+ * -2 if the non-revocation proof is invalid, or is for a different epoch than `accumulator`
+ */
+int ecdaa_accumulator_signature_ZZZ_verify(struct ecdaa_accumulator_signature_ZZZ *signature,
+                                           struct ecdaa_group_public_key_ZZZ *gpk,
+                                           struct ecdaa_accumulator_public_key_ZZZ *accumulator_pk,
+                                           struct ecdaa_accumulator_ZZZ *accumulator,
+                                           struct ecdaa_revocations_ZZZ *revocations,
+                                           uint8_t* message,
+                                           uint32_t message_len,
+                                           uint8_t *basename,
+                                           uint32_t basename_len);
+
+/*
+ * Serialize an `ecdaa_accumulator_signature_ZZZ`.
+ *
+ * The serialized format is:
+ *  ( ECDAA signature (as for `ecdaa_signature_ZZZ_serialize`) |
+ *    epoch |
+ *    0x04 | X.x-coord | X.y-coord |
+ *    0x04 | A_bar.x-coord | A_bar.y-coord |
+ *    0x04 | d.x-coord | d.y-coord |
+ *    c | s_e | s_r | s_sk )
+ *  where epoch is 8 bytes, big-endian.
+ *
+ * The provided buffer is assumed to be large enough.
+ */
+void ecdaa_accumulator_signature_ZZZ_serialize(uint8_t *buffer_out,
+                                               struct ecdaa_accumulator_signature_ZZZ *signature,
+                                               int has_nym);
+
+/*
+ * De-serialize an `ecdaa_accumulator_signature_ZZZ`, but _don't_ verify it.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if signature is mal-formed
+ */
+int ecdaa_accumulator_signature_ZZZ_deserialize(struct ecdaa_accumulator_signature_ZZZ *signature_out,
+                                                uint8_t *buffer_in,
+                                                int has_nym);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_BASENAME_CTX_ZZZ_H
+#define ECDAA_BASENAME_CTX_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/hash_to_curve.h>
+
+#include <amcl/big_XXX.h>
+#include <amcl/ecp_ZZZ.h>
+
+#include <stdint.h>
+
+struct ecdaa_member_secret_key_ZZZ;
+
+/*
+ * Size of the fixed-base table for a basename's point P2
+ *  (odd multiples of P2, in 4-bit signed windows).
+ */
+#define ECDAA_BASENAME_CTX_ZZZ_TABLE_WINDOW_BITS 4
+#define ECDAA_BASENAME_CTX_ZZZ_TABLE_ENTRIES (1 << (ECDAA_BASENAME_CTX_ZZZ_TABLE_WINDOW_BITS - 1))
+#define ECDAA_BASENAME_CTX_ZZZ_TABLE_POSITIONS (2 + (8*MODBYTES_XXX + ECDAA_BASENAME_CTX_ZZZ_TABLE_WINDOW_BITS - 1) / ECDAA_BASENAME_CTX_ZZZ_TABLE_WINDOW_BITS)
+
+/*
+ * Size of the fingerprint (a hash) of the secret key behind a signer's pseudonym.
+ */
+#define ECDAA_BASENAME_CTX_ZZZ_FINGERPRINT_LENGTH 32
+
+/*
+ * Everything about a basename that doesn't change between signatures:
+ *  the point P2 hashed from the basename (by the context's `ecdaa_hash_to_curve` method),
+ *  a fixed-base table for P2,
+ *  and, for a signer, the pseudonym K = sk*P2.
+ *
+ * Hashing the basename takes a variable number of hash and square-root attempts,
+ *  and the table replaces the doublings in k*P2 (signing) and s*P2 (verifying).
+ *  So, build one context per basename used, and pass it to
+ *  `ecdaa_signature_ZZZ_sign_with_basename_ctx` and `ecdaa_signature_ZZZ_verify_with_basename_ctx`.
+ *
+ * The basename itself isn't copied, so must outlive the context.
+ *
+ * This struct is large (tens of kilobytes), so avoid putting it on the stack.
+ */
+struct ecdaa_basename_ctx_ZZZ {
+    const uint8_t *basename;
+    uint32_t basename_len;
+    enum ecdaa_hash_to_curve hash_to_curve;
+    ECP_ZZZ P2;
+    ECP_ZZZ P2_table[ECDAA_BASENAME_CTX_ZZZ_TABLE_POSITIONS][ECDAA_BASENAME_CTX_ZZZ_TABLE_ENTRIES];
+    int has_pseudonym;
+    ECP_ZZZ K;
+    uint8_t sk_fingerprint[ECDAA_BASENAME_CTX_ZZZ_FINGERPRINT_LENGTH];
+};
+
+/*
+ * Hash `basename` to P2, and build its table.
+ *
+ * Uses ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT, as plain signing and verifying do.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if basename_len is 0
+ * -2 if the basename fails to hash to a G1 point
+ */
+int ecdaa_basename_ctx_ZZZ_init(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                const uint8_t *basename,
+                                uint32_t basename_len);
+
+/*
+ * Same as `ecdaa_basename_ctx_ZZZ_init`, but hashing `basename` with the given method.
+ *
+ * Signatures made with the context only verify with a context using the same method.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if basename_len is 0
+ * -2 if the basename fails to hash to a G1 point
+ */
+int ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                                   const uint8_t *basename,
+                                                   uint32_t basename_len,
+                                                   enum ecdaa_hash_to_curve hash_to_curve);
+
+/*
+ * Signer only: compute the pseudonym K = sk*P2 once, for all signatures under this basename.
+ *
+ * The context then only signs with `sk`: it records a fingerprint of `sk`,
+ *  and signing with any other key fails (see `ecdaa_basename_ctx_ZZZ_check_secret_key`).
+ */
+void ecdaa_basename_ctx_ZZZ_set_secret_key(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                           struct ecdaa_member_secret_key_ZZZ *sk);
+
+/*
+ * Check that `sk` may sign with the context:
+ *  either no pseudonym has been set, or it was set for `sk`.
+ *
+ * Returns:
+ * 0 if `sk` may sign with the context
+ * -1 if the context's pseudonym belongs to another key
+ */
+int ecdaa_basename_ctx_ZZZ_check_secret_key(struct ecdaa_basename_ctx_ZZZ *ctx,
+                                            struct ecdaa_member_secret_key_ZZZ *sk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_BSN_REVOCATION_SET_ZZZ_H
+#define ECDAA_BSN_REVOCATION_SET_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Set of revoked basename pseudonyms (K), for constant-time lookup
+ *  (as an alternative to `bsn_list` in `ecdaa_revocations_ZZZ`).
+ *
+ * Each K is stored as a digest (a truncated SHA-256 hash of its serialization),
+ *  of ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH bytes,
+ *  in an open-addressing (linear-probing) hash table.
+ *
+ * Optionally, a Bloom filter is checked first,
+ *  so most lookups of unrevoked K's don't touch the (larger) table.
+ *
+ * All storage is provided by the caller. Treat the fields as private.
+ */
+#define ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH 16
+struct ecdaa_bsn_revocation_set_ZZZ {
+    uint8_t *slots;
+    size_t capacity;
+    size_t count;
+    uint8_t *bloom;
+    size_t bloom_bits;
+};
+
+/*
+ * Initialize an empty set.
+ *
+ * `slot_storage` must have room for `capacity` slots
+ *  (`capacity * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH` bytes).
+ *  `capacity` must be a power of two. The set can hold `capacity - 1` entries,
+ *  but lookups are fastest when it's kept at most half full.
+ *
+ * `bloom_storage` (of `bloom_length` bytes) is optional: pass NULL to not use a Bloom filter.
+ *  `bloom_length` must be a power of two. The filter uses 4 hash functions, so with n entries
+ *  in m = 8*`bloom_length` bits its false-positive rate is about (1 - e^(-4n/m))^4:
+ *  about 2.4% at 1 byte per entry, and about 0.24% at 2 bytes per entry.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `capacity` or `bloom_length` isn't a power of two
+ */
+int ecdaa_bsn_revocation_set_ZZZ_init(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                      uint8_t *slot_storage,
+                                      size_t capacity,
+                                      uint8_t *bloom_storage,
+                                      size_t bloom_length);
+
+/*
+ * Add a pseudonym to the set.
+ *
+ * Returns:
+ * 0 on success (including if already present)
+ * -1 if the set is full
+ */
+int ecdaa_bsn_revocation_set_ZZZ_insert(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                        ECP_ZZZ *K);
+
+/*
+ * Check whether a pseudonym is in the set.
+ *
+ * Returns:
+ * 1 if `K` is in the set
+ * 0 otherwise
+ */
+int ecdaa_bsn_revocation_set_ZZZ_contains(struct ecdaa_bsn_revocation_set_ZZZ *set,
+                                          ECP_ZZZ *K);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
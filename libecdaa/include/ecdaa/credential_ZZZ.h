@@ -29,6 +29,7 @@ extern "C" {
 struct ecdaa_member_public_key_ZZZ;
 struct ecdaa_issuer_secret_key_ZZZ;
 struct ecdaa_group_public_key_ZZZ;
+struct ecdaa_prepared_gpk_ZZZ;
 
 #include <amcl/ecp_ZZZ.h>
 #include <amcl/big_XXX.h>
@@ -83,6 +84,15 @@ int ecdaa_credential_ZZZ_validate(struct ecdaa_credential_ZZZ *credential,
                                   struct ecdaa_member_public_key_ZZZ *member_pk,
                                   struct ecdaa_group_public_key_ZZZ *gpk);
 
+/*
+ * Same as `ecdaa_credential_ZZZ_validate`, but using a prepared group public key
+ *  (see `ecdaa_prepared_gpk_ZZZ_prepare`).
+ */
+int ecdaa_credential_ZZZ_validate_prepared(struct ecdaa_credential_ZZZ *credential,
+                                           struct ecdaa_credential_ZZZ_signature *credential_signature,
+                                           struct ecdaa_member_public_key_ZZZ *member_pk,
+                                           struct ecdaa_prepared_gpk_ZZZ *prepared_gpk);
+
 /*
  * Serialize an `ecdaa_credential_ZZZ`
  *
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_HASH_TO_CURVE_H
+#define ECDAA_HASH_TO_CURVE_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * How a basename is hashed to its point P2 (and so to the pseudonym K = sk*P2).
+ *
+ * ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT is the default, and what plain signing and verifying use.
+ *  Its running time depends on the basename.
+ *
+ * ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI runs in constant time,
+ *  for when the basename itself should not leak through timing.
+ *
+ * The two give different points (and so different pseudonyms) for the same basename,
+ *  so the signer and all verifiers must agree on the method for each basename.
+ */
+enum ecdaa_hash_to_curve {
+    ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT = 0,
+    ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI = 1
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
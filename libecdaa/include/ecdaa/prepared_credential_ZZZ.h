@@ -0,0 +1,94 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_PREPARED_CREDENTIAL_ZZZ_H
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/credential_ZZZ.h>
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <stddef.h>
+
+/*
+ * Bounds on the window width of the prepared credential's tables.
+ *
+ * Each table for a window of w bits holds
+ *  ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_POSITIONS(w) * 2^(w-1) points,
+ *  and makes a multiplication cost ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_POSITIONS(w) point additions.
+ *  So, a wider window is faster, but takes more memory.
+ */
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS 2
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS 6
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_DEFAULT_WINDOW_BITS 4
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_POSITIONS(window_bits) (2 + (8*MODBYTES_XXX + (window_bits) - 1) / (window_bits))
+
+/*
+ * Number of points of table storage needed for a window of `window_bits` bits
+ *  (one table each for A, B, C, and D).
+ */
+#define ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits) \
+    (4 * (ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_POSITIONS(window_bits) << ((window_bits) - 1)))
+
+/*
+ * Member credential, along with fixed-base tables for A, B, C, and D.
+ *
+ * Build once (e.g. after `ecdaa_credential_ZZZ_deserialize_with_signature`),
+ *  then pass to the `_prepared` variants of signing.
+ *  These then randomize the credential with table look-ups and additions, rather than
+ *  four full scalar multiplications.
+ *
+ * The tables live in caller-provided storage (see `ecdaa_prepared_credential_ZZZ_prepare`),
+ *  which must outlive this struct.
+ *
+ * Treat the fields as private.
+ */
+struct ecdaa_prepared_credential_ZZZ {
+    struct ecdaa_credential_ZZZ cred;
+    int window_bits;
+    ECP_ZZZ *tables;
+};
+
+/*
+ * Build the tables for `cred`, with a window of `window_bits` bits,
+ *  in `table_storage` (which holds `table_storage_length` points).
+ *
+ * `table_storage_length` must be at least ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits).
+ *
+ * `cred` is assumed to be valid (e.g. obtained from `ecdaa_credential_ZZZ_deserialize_with_signature`).
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `window_bits` is out of range, or `table_storage` is too small
+ */
+int ecdaa_prepared_credential_ZZZ_prepare(struct ecdaa_prepared_credential_ZZZ *prepared_out,
+                                          struct ecdaa_credential_ZZZ *cred,
+                                          int window_bits,
+                                          ECP_ZZZ *table_storage,
+                                          size_t table_storage_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
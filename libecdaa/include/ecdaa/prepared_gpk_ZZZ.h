@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_PREPARED_GPK_ZZZ_H
+#define ECDAA_PREPARED_GPK_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/group_public_key_ZZZ.h>
+
+#include <amcl/ecp2_ZZZ.h>
+#include <amcl/fp2_YYY.h>
+
+/*
+ * Upper bound on the number of Miller-loop line functions for one G2 point.
+ */
+#define ECDAA_PREPARED_GPK_ZZZ_MAX_LINES (4*MODBYTES_XXX + 10)
+
+/*
+ * Group public key, along with the Miller-loop line functions
+ *  for X, Y, and the G2 generator.
+ *
+ * Build once (e.g. after de-serializing the group public key),
+ *  then pass to the `_prepared` variants of signature verification and credential validation.
+ *  These then do no G2 arithmetic.
+ *
+ * This struct is large (tens of kilobytes), so avoid putting it on the stack.
+ */
+struct ecdaa_prepared_gpk_ZZZ {
+    struct ecdaa_group_public_key_ZZZ gpk;
+    ECP2_ZZZ basepoint2;
+    int has_lines;
+    FP2_YYY X_lines[3*ECDAA_PREPARED_GPK_ZZZ_MAX_LINES];
+    FP2_YYY Y_lines[3*ECDAA_PREPARED_GPK_ZZZ_MAX_LINES];
+    FP2_YYY basepoint2_lines[3*ECDAA_PREPARED_GPK_ZZZ_MAX_LINES];
+};
+
+/*
+ * Precompute the line functions for `gpk`.
+ *
+ * `gpk` is assumed to be valid (e.g. obtained from `ecdaa_group_public_key_ZZZ_deserialize`).
+ *
+ * If line functions can't be precomputed for this curve,
+ *  `has_lines` is left 0 and the `_prepared` functions fall back to the usual pairings.
+ */
+void ecdaa_prepared_gpk_ZZZ_prepare(struct ecdaa_prepared_gpk_ZZZ *prepared_out,
+                                    struct ecdaa_group_public_key_ZZZ *gpk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+
+#ifndef ECDAA_PRESIGNATURE_POOL_ZZZ_H
+#define ECDAA_PRESIGNATURE_POOL_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/rand.h>
+#include <ecdaa/signature_ZZZ.h>
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct ecdaa_member_secret_key_ZZZ;
+struct ecdaa_credential_ZZZ;
+struct ecdaa_basename_ctx_ZZZ;
+
+/*
+ * A bounded pool of presignatures, for one member (secret key and credential) and basename.
+ *
+ * A presignature is a signature begun ahead of time (as by `ecdaa_signature_ZZZ_sign_begin`):
+ *  the randomized credential (four G1 multiplications), the Schnorr-type commitment,
+ *  and the hash of everything that precedes the message.
+ *  None of that depends on the message, so `ecdaa_presignature_pool_ZZZ_fill`
+ *  can do it while the signer is idle (or from a background thread).
+ *  Signing with a presignature then costs only hashing the message,
+ *  one more short hash, and a modular multiply-add.
+ *
+ * Each presignature is removed from the pool when taken, so is used only once.
+ *
+ * Filling and taking may happen concurrently from different threads
+ *  (the pool has a mutex, which isn't held while presignatures are computed).
+ *  In that case, `get_random` must be safe to call from several threads.
+ *
+ * All storage (the struct itself and the slots) is provided by the caller. Treat the fields as private.
+ *  The slots hold secrets, which are cleared when taken and by `ecdaa_presignature_pool_ZZZ_destroy`.
+ */
+struct ecdaa_presignature_pool_ZZZ {
+    struct ecdaa_member_secret_key_ZZZ *sk;
+    struct ecdaa_credential_ZZZ *cred;
+    const uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_basename_ctx_ZZZ *basename_ctx;
+    ecdaa_rand_func get_random;
+
+    pthread_mutex_t mutex;
+
+    struct ecdaa_signature_ZZZ_sign_ctx *slots;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t filling;     // Slots reserved by fills in progress
+};
+
+/*
+ * Start an (empty) presignature pool.
+ *
+ * `slots` must have room for `capacity` entries.
+ *  `sk`, `cred`, and `basename` (which may be NULL, if `basename_len` is 0) aren't copied,
+ *  so must outlive the pool.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the pool could not be started
+ */
+int ecdaa_presignature_pool_ZZZ_init(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ_sign_ctx *slots,
+                                     size_t capacity,
+                                     const uint8_t *basename,
+                                     uint32_t basename_len,
+                                     struct ecdaa_member_secret_key_ZZZ *sk,
+                                     struct ecdaa_credential_ZZZ *cred,
+                                     ecdaa_rand_func get_random);
+
+/*
+ * Same as `ecdaa_presignature_pool_ZZZ_init`, but with the basename taken from `basename_ctx`
+ *  (as for `ecdaa_signature_ZZZ_sign_begin_with_basename_ctx`), which also must outlive the pool.
+ */
+int ecdaa_presignature_pool_ZZZ_init_with_basename_ctx(struct ecdaa_presignature_pool_ZZZ *pool,
+                                                       struct ecdaa_signature_ZZZ_sign_ctx *slots,
+                                                       size_t capacity,
+                                                       struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                                       struct ecdaa_member_secret_key_ZZZ *sk,
+                                                       struct ecdaa_credential_ZZZ *cred,
+                                                       ecdaa_rand_func get_random);
+
+/*
+ * Compute up to `max_presignatures` presignatures, stopping early if the pool fills.
+ *
+ * Returns:
+ * the number of presignatures added, on success
+ * -1 if a presignature couldn't be created
+ */
+int ecdaa_presignature_pool_ZZZ_fill(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     size_t max_presignatures);
+
+/*
+ * Number of presignatures ready in the pool.
+ */
+size_t ecdaa_presignature_pool_ZZZ_count(struct ecdaa_presignature_pool_ZZZ *pool);
+
+/*
+ * Take a presignature from the pool, as a begun signature.
+ *
+ * Continue it with `ecdaa_signature_ZZZ_sign_update` (for messages hashed in pieces),
+ *  and complete it with `ecdaa_signature_ZZZ_sign_finish`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the pool is empty
+ */
+int ecdaa_presignature_pool_ZZZ_take(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ_sign_ctx *ctx_out);
+
+/*
+ * Create an ECDAA signature, using a presignature from the pool.
+ *
+ * If the pool is empty, the presignature is computed on the spot
+ *  (so the signature costs as much as `ecdaa_signature_ZZZ_sign`).
+ *
+ * Returns:
+ * 0 on success
+ * -1 if unable to create signature
+ */
+int ecdaa_presignature_pool_ZZZ_sign(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ *signature_out,
+                                     const uint8_t *message,
+                                     uint32_t message_len);
+
+/*
+ * Clear the remaining presignatures, and release the pool's mutex.
+ *
+ * No fill or take may be running.
+ */
+void ecdaa_presignature_pool_ZZZ_destroy(struct ecdaa_presignature_pool_ZZZ *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
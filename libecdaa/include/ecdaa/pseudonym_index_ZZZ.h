@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_PSEUDONYM_INDEX_ZZZ_H
+#define ECDAA_PSEUDONYM_INDEX_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+#include <ecdaa/hash_to_curve.h>
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct ecdaa_revocations_ZZZ;
+
+/*
+ * Index of the pseudonyms (K = sk*H(basename)) of revoked members, for one basename.
+ *
+ * A signature that uses this basename, and whose pseudonym is in the index,
+ *  was made by a member on the secret-key revocation list.
+ *  So, when verifying such a signature, looking up K in the index replaces
+ *  the scan of `sk_list` (one scalar multiplication per entry).
+ *
+ * Add indexes to `ecdaa_revocations_ZZZ.pseudonym_indexes` to have verification use them.
+ *  An index is only used while it covers the whole `sk_list`, at its current `sk_generation`
+ *  (i.e. after each change to the list, call `ecdaa_pseudonym_index_ZZZ_sync`);
+ *  otherwise, verification falls back to the scan.
+ *  Likewise, an index is only used for signatures whose basename was hashed
+ *  by the same `ecdaa_hash_to_curve` method as the index's.
+ *
+ * `basename` is NOT copied, so it must outlive the index.
+ *  All other storage is provided by the caller. Treat the fields as private.
+ */
+struct ecdaa_pseudonym_index_ZZZ {
+    const uint8_t *basename;
+    uint32_t basename_len;
+    enum ecdaa_hash_to_curve hash_to_curve;
+    ECP_ZZZ basepoint;
+    size_t sk_length;
+    uint64_t sk_generation;
+    struct ecdaa_bsn_revocation_set_ZZZ set;
+};
+
+/*
+ * Initialize an empty index for `basename`.
+ *
+ * Uses ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT, as plain signing and verifying do.
+ *
+ * `slot_storage`, `capacity`, `bloom_storage`, and `bloom_length`
+ *  are as for `ecdaa_bsn_revocation_set_ZZZ_init`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `capacity` or `bloom_length` isn't a power of two
+ * -2 if `basename` couldn't be hashed to a curve point
+ */
+int ecdaa_pseudonym_index_ZZZ_init(struct ecdaa_pseudonym_index_ZZZ *index,
+                                   const uint8_t *basename,
+                                   uint32_t basename_len,
+                                   uint8_t *slot_storage,
+                                   size_t capacity,
+                                   uint8_t *bloom_storage,
+                                   size_t bloom_length);
+
+/*
+ * Same as `ecdaa_pseudonym_index_ZZZ_init`, but hashing `basename` with the given method
+ *  (which must match that of the signers' `ecdaa_basename_ctx_ZZZ`).
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `capacity` or `bloom_length` isn't a power of two
+ * -2 if `basename` couldn't be hashed to a curve point
+ */
+int ecdaa_pseudonym_index_ZZZ_init_with_hash_to_curve(struct ecdaa_pseudonym_index_ZZZ *index,
+                                                      const uint8_t *basename,
+                                                      uint32_t basename_len,
+                                                      enum ecdaa_hash_to_curve hash_to_curve,
+                                                      uint8_t *slot_storage,
+                                                      size_t capacity,
+                                                      uint8_t *bloom_storage,
+                                                      size_t bloom_length);
+
+/*
+ * Bring the index up-to-date with `revocations->sk_list`.
+ *
+ * If `revocations->sk_generation` is unchanged since the last sync, only the entries
+ *  appended since then are indexed. Otherwise (or if the list has shrunk),
+ *  the index is rebuilt from scratch.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the index is full (it's then left stale, so isn't used by verification)
+ */
+int ecdaa_pseudonym_index_ZZZ_sync(struct ecdaa_pseudonym_index_ZZZ *index,
+                                   struct ecdaa_revocations_ZZZ *revocations);
+
+/*
+ * Check whether a pseudonym is in the index.
+ *
+ * Returns:
+ * 1 if `K` is in the index
+ * 0 otherwise
+ */
+int ecdaa_pseudonym_index_ZZZ_contains(struct ecdaa_pseudonym_index_ZZZ *index,
+                                       ECP_ZZZ *K);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
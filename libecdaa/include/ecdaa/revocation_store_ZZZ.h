@@ -0,0 +1,210 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_REVOCATION_STORE_ZZZ_H
+#define ECDAA_REVOCATION_STORE_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/revocations_ZZZ.h>
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct ecdaa_member_secret_key_ZZZ;
+
+/*
+ * A change to a revocation list.
+ *
+ * Takes a list at epoch `base_epoch` to epoch `epoch` (which must be greater),
+ *  by removing the `*_removed` entries and appending the `*_added` entries.
+ */
+struct ecdaa_revocation_delta_ZZZ {
+    uint64_t base_epoch;
+    uint64_t epoch;
+    size_t sk_added_length;
+    struct ecdaa_member_secret_key_ZZZ *sk_added;
+    size_t sk_removed_length;
+    struct ecdaa_member_secret_key_ZZZ *sk_removed;
+    size_t bsn_added_length;
+    ECP_ZZZ *bsn_added;
+    size_t bsn_removed_length;
+    ECP_ZZZ *bsn_removed;
+};
+
+/*
+ * Serialized delta.
+ *
+ * Format: ( "ECDAADLT" | version (4 bytes) | curve name (16 bytes) | base_epoch (8 bytes) | epoch (8 bytes)
+ *          | sk_added_length | sk_removed_length | bsn_added_length | bsn_removed_length (4 bytes each)
+ *          | serialized secret keys (sk_added, then sk_removed) | serialized points (bsn_added, then bsn_removed) )
+ *  with all integers big-endian.
+ */
+#define ECDAA_REVOCATION_DELTA_VERSION 1
+#define ECDAA_REVOCATION_DELTA_ZZZ_HEADER_LENGTH (8 + 4 + 16 + 8 + 8 + 4*4)
+
+/*
+ * Length of the serialized `delta`.
+ *
+ * Returns 0 if that length doesn't fit in a size_t.
+ */
+size_t ecdaa_revocation_delta_ZZZ_length(struct ecdaa_revocation_delta_ZZZ *delta);
+
+/*
+ * Serialize a delta.
+ *
+ * `buffer_out` must have room for `ecdaa_revocation_delta_ZZZ_length(delta)` bytes.
+ */
+void ecdaa_revocation_delta_ZZZ_serialize(uint8_t *buffer_out,
+                                          struct ecdaa_revocation_delta_ZZZ *delta);
+
+/*
+ * De-serialize a delta, checking each entry as `ecdaa_member_secret_key_ZZZ_deserialize`
+ *  and `ecp_ZZZ_deserialize` would.
+ *
+ * The entry arrays are allocated, and must be freed with `ecdaa_revocation_delta_ZZZ_free`
+ *  (on success only).
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the buffer is malformed (or of an unsupported version or different curve)
+ * -2 if an entry is invalid
+ * -3 on allocation failure
+ */
+int ecdaa_revocation_delta_ZZZ_deserialize(struct ecdaa_revocation_delta_ZZZ *delta_out,
+                                           uint8_t *buffer,
+                                           size_t buffer_length);
+
+/*
+ * Free the entry arrays of a delta from `ecdaa_revocation_delta_ZZZ_deserialize`.
+ */
+void ecdaa_revocation_delta_ZZZ_free(struct ecdaa_revocation_delta_ZZZ *delta);
+
+/*
+ * An immutable version of the revocation list.
+ *
+ * Verify against `revocations` while holding a reference
+ *  (from `ecdaa_revocation_store_ZZZ_acquire`).
+ *
+ * `revocations.sk_generation` is the epoch at which `sk_list` last had entries removed
+ *  (or was replaced outright). Between such epochs, the list is only appended to,
+ *  so pseudonym indexes synced against one snapshot are brought up-to-date incrementally.
+ */
+struct ecdaa_revocation_snapshot_ZZZ {
+    uint64_t epoch;
+    struct ecdaa_revocations_ZZZ revocations;
+    size_t refcount;
+};
+
+/*
+ * Revocation list that can be updated while in use.
+ *
+ * Readers take a reference to the current snapshot, and verify against it.
+ *  An update builds a new snapshot (off to the side), then swaps it in as current.
+ *  So, readers never wait for an update (beyond the brief swap),
+ *  and keep using a consistent list until they release it.
+ *  A snapshot is freed once it's no longer current and its last reference is released.
+ *
+ * Updates are applied one at a time, and only in epoch order.
+ *
+ * Unlike most of the library, the store allocates its snapshots.
+ *  Treat the fields as private.
+ */
+struct ecdaa_revocation_store_ZZZ {
+    pthread_mutex_t mutex;          // Guards `current` and all snapshots' refcounts
+    pthread_mutex_t update_mutex;   // Serializes updates
+    struct ecdaa_revocation_snapshot_ZZZ *current;
+    size_t sk_scan_threads;
+};
+
+/*
+ * Initialize a store, with an empty list at epoch 0.
+ *
+ * Every snapshot's `revocations.sk_scan_threads` is set to `sk_scan_threads`.
+ *
+ * Returns:
+ * 0 on success
+ * -1 on error
+ */
+int ecdaa_revocation_store_ZZZ_init(struct ecdaa_revocation_store_ZZZ *store,
+                                    size_t sk_scan_threads);
+
+/*
+ * Free a store.
+ *
+ * All references must have been released.
+ */
+void ecdaa_revocation_store_ZZZ_destroy(struct ecdaa_revocation_store_ZZZ *store);
+
+/*
+ * Take a reference to the current snapshot.
+ *
+ * Never returns NULL.
+ */
+struct ecdaa_revocation_snapshot_ZZZ *ecdaa_revocation_store_ZZZ_acquire(struct ecdaa_revocation_store_ZZZ *store);
+
+/*
+ * Release a reference taken by `ecdaa_revocation_store_ZZZ_acquire`.
+ */
+void ecdaa_revocation_store_ZZZ_release(struct ecdaa_revocation_store_ZZZ *store,
+                                        struct ecdaa_revocation_snapshot_ZZZ *snapshot);
+
+/*
+ * Current epoch.
+ */
+uint64_t ecdaa_revocation_store_ZZZ_epoch(struct ecdaa_revocation_store_ZZZ *store);
+
+/*
+ * Apply a delta, making a new current snapshot.
+ *
+ * Removed entries that aren't on the list are ignored.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `delta->base_epoch` isn't the current epoch, or `delta->epoch` isn't greater
+ * -2 on allocation failure
+ *  (on failure, the store is unchanged)
+ */
+int ecdaa_revocation_store_ZZZ_apply(struct ecdaa_revocation_store_ZZZ *store,
+                                     struct ecdaa_revocation_delta_ZZZ *delta);
+
+/*
+ * Replace the whole list (e.g. from a full revocation-list file), making a new current snapshot.
+ *
+ * The lists in `revocations` are copied.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if `epoch` isn't greater than the current epoch
+ * -2 on allocation failure
+ */
+int ecdaa_revocation_store_ZZZ_replace(struct ecdaa_revocation_store_ZZZ *store,
+                                       struct ecdaa_revocations_ZZZ *revocations,
+                                       uint64_t epoch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -25,10 +25,13 @@ extern "C" {
 #endif
 
 struct ecdaa_member_secret_key_ZZZ;
+struct ecdaa_bsn_revocation_set_ZZZ;
+struct ecdaa_pseudonym_index_ZZZ;
 
 #include <amcl/ecp_ZZZ.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 /*
  * Secret-key revocation list and
@@ -36,14 +39,134 @@ struct ecdaa_member_secret_key_ZZZ;
  *
  * `list` is an array of `ecdaa_member_secret_key_ZZZ`s.
  * `length` is the size of `list`.
+ *
+ * `sk_scan_threads` is the number of threads (including the calling one)
+ *  that verification may split the scan of `sk_list` across.
+ *  0 or 1 means the calling thread scans it alone.
+ *  Extra threads are only used for long lists.
+ *
+ * `bsn_set` is optional (NULL if unused): a hashed set of revoked K's,
+ *  checked in addition to `bsn_list`. Prefer it over `bsn_list` for long lists.
+ *
+ * `pseudonym_indexes` is an optional (NULL if unused) array of
+ *  `num_pseudonym_indexes` per-basename indexes of the pseudonyms of `sk_list`.
+ *  A signature with a basename that has an up-to-date index is checked
+ *  against the index instead of by scanning `sk_list`.
+ *
+ * `sk_generation` identifies the contents of `sk_list`, up to appends:
+ *  change it whenever entries are removed, replaced, or reordered
+ *  (the revocation store and the file loader set it for you).
+ *  Pseudonym indexes built under another generation aren't used.
+ *
+ * Always initialize with `ecdaa_revocations_ZZZ_init` before setting any fields:
+ *  fields may be added in later versions, and verification reads all of them.
  */
 struct ecdaa_revocations_ZZZ {
     size_t sk_length;
     struct ecdaa_member_secret_key_ZZZ *sk_list;
     size_t bsn_length;
     ECP_ZZZ *bsn_list;
+    size_t sk_scan_threads;
+    struct ecdaa_bsn_revocation_set_ZZZ *bsn_set;
+    size_t num_pseudonym_indexes;
+    struct ecdaa_pseudonym_index_ZZZ *pseudonym_indexes;
+    uint64_t sk_generation;
 };
 
+/*
+ * Initialize to empty lists, with all optional fields unused.
+ */
+void ecdaa_revocations_ZZZ_init(struct ecdaa_revocations_ZZZ *revocations_out);
+
+/*
+ * Binary revocation-list file.
+ *
+ * Format (all integers in host byte order):
+ *  ( header | sk_list entries | bsn_list entries ),
+ *  where the header records the format version, the curve,
+ *  the sizes and counts of the entries, and a checksum over the whole file.
+ *  The entries are stored in the library's in-memory representation
+ *  (`struct ecdaa_member_secret_key_ZZZ` and `ECP_ZZZ`),
+ *  each list starting at an ECDAA_REVOCATIONS_FILE_ALIGNMENT-byte aligned offset.
+ *
+ * So, a file can be used in-place (e.g. after mmap'ing it), with no parsing.
+ *  However, it's only portable between builds with the same curve, word size, and byte order
+ *  (which the header records, and the loader checks).
+ *
+ * The entries are NOT validated on loading (only the checksum is checked),
+ *  so only load files written by `ecdaa_revocations_ZZZ_write_file` from a trusted source.
+ */
+#define ECDAA_REVOCATIONS_FILE_VERSION 1
+#define ECDAA_REVOCATIONS_FILE_ALIGNMENT 64
+#define ECDAA_REVOCATIONS_FILE_HEADER_LENGTH 128
+
+/*
+ * Check whether a buffer starts like a binary revocation-list file
+ *  (needs at least 8 bytes).
+ *
+ * Returns:
+ * 1 if it does
+ * 0 otherwise
+ */
+int ecdaa_revocations_ZZZ_is_file(const uint8_t *buffer, size_t buffer_length);
+
+/*
+ * Write `revocations->sk_list` and `revocations->bsn_list` to a binary revocation-list file.
+ *
+ * Returns:
+ * 0 on success
+ * -1 on error
+ */
+int ecdaa_revocations_ZZZ_write_file(const char *filename,
+                                     struct ecdaa_revocations_ZZZ *revocations);
+
+/*
+ * Point `revocations_out->sk_list` and `revocations_out->bsn_list`
+ *  (and their lengths) at the entries of a binary revocation-list file in memory,
+ *  and set `revocations_out->sk_generation` from the file's checksum
+ *  (so a reloaded file with other contents gets a new generation).
+ *  Other fields are left unchanged.
+ *
+ * `buffer` must be ECDAA_REVOCATIONS_FILE_ALIGNMENT-byte aligned,
+ *  must outlive `revocations_out`, and must not be modified.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the buffer isn't a revocation-list file of a supported version
+ * -2 if the file was written for a different curve or build
+ * -3 if the file is truncated or its checksum doesn't match
+ */
+int ecdaa_revocations_ZZZ_from_buffer(struct ecdaa_revocations_ZZZ *revocations_out,
+                                      const uint8_t *buffer,
+                                      size_t buffer_length);
+
+/*
+ * A binary revocation-list file mapped into memory (read-only).
+ */
+struct ecdaa_revocations_file_ZZZ {
+    void *map;
+    size_t map_length;
+};
+
+/*
+ * Map a binary revocation-list file into memory, and load it as for `ecdaa_revocations_ZZZ_from_buffer`.
+ *
+ * `revocations_out` is usable until `ecdaa_revocations_ZZZ_unmap_file` is called on `file_out`.
+ *
+ * Returns:
+ * 0 on success
+ * -4 if the file can't be opened or mapped
+ * Otherwise, as for `ecdaa_revocations_ZZZ_from_buffer`
+ */
+int ecdaa_revocations_ZZZ_map_file(struct ecdaa_revocations_ZZZ *revocations_out,
+                                   struct ecdaa_revocations_file_ZZZ *file_out,
+                                   const char *filename);
+
+/*
+ * Unmap a file mapped by `ecdaa_revocations_ZZZ_map_file`.
+ */
+void ecdaa_revocations_ZZZ_unmap_file(struct ecdaa_revocations_file_ZZZ *file);
+
 #ifdef __cplusplus
 }
 #endif
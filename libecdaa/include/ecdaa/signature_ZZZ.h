@@ -24,15 +24,24 @@
 extern "C" {
 #endif
 
+#include <ecdaa/hash_to_curve.h>
 #include <ecdaa/rand.h>
+#include <ecdaa/verify_policy.h>
 
 #include <amcl/big_XXX.h>
 #include <amcl/ecp_ZZZ.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
 struct ecdaa_credential_ZZZ;
+struct ecdaa_prepared_credential_ZZZ;
 struct ecdaa_member_secret_key_ZZZ;
 struct ecdaa_revocations_ZZZ;
 struct ecdaa_group_public_key_ZZZ;
+struct ecdaa_prepared_gpk_ZZZ;
+struct ecdaa_revocation_delta_ZZZ;
+struct ecdaa_basename_ctx_ZZZ;
 
 /*
  * ECDAA signature.
@@ -70,6 +79,36 @@ int ecdaa_signature_ZZZ_sign(struct ecdaa_signature_ZZZ *signature_out,
                              struct ecdaa_credential_ZZZ *cred,
                              ecdaa_rand_func get_random);
 
+/*
+ * Same as `ecdaa_signature_ZZZ_sign`, but with the basename (and its precomputation)
+ *  taken from `basename_ctx` (see `ecdaa_basename_ctx_ZZZ_init`).
+ *
+ * If `ecdaa_basename_ctx_ZZZ_set_secret_key` was called on `basename_ctx`,
+ *  it must have been with `sk` (otherwise, returns -1).
+ */
+int ecdaa_signature_ZZZ_sign_with_basename_ctx(struct ecdaa_signature_ZZZ *signature_out,
+                                               const uint8_t* message,
+                                               uint32_t message_len,
+                                               struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                               struct ecdaa_member_secret_key_ZZZ *sk,
+                                               struct ecdaa_credential_ZZZ *cred,
+                                               ecdaa_rand_func get_random);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_sign`, but using a prepared credential
+ *  (see `ecdaa_prepared_credential_ZZZ_prepare`).
+ *
+ * Creates the same kind of signature, verified the same way.
+ */
+int ecdaa_signature_ZZZ_sign_prepared(struct ecdaa_signature_ZZZ *signature_out,
+                                      const uint8_t* message,
+                                      uint32_t message_len,
+                                      const uint8_t* basename,
+                                      uint32_t basename_len,
+                                      struct ecdaa_member_secret_key_ZZZ *sk,
+                                      struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                      ecdaa_rand_func get_random);
+
 /*
  * Verify an ECDAA signature.
  *
@@ -85,6 +124,363 @@ int ecdaa_signature_ZZZ_verify(struct ecdaa_signature_ZZZ *signature,
                                uint8_t *basename,
                                uint32_t basename_len);
 
+/*
+ * Same as `ecdaa_signature_ZZZ_verify`, but using a prepared group public key
+ *  (see `ecdaa_prepared_gpk_ZZZ_prepare`).
+ */
+int ecdaa_signature_ZZZ_verify_prepared(struct ecdaa_signature_ZZZ *signature,
+                                        struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                        struct ecdaa_revocations_ZZZ *revocations,
+                                        uint8_t* message,
+                                        uint32_t message_len,
+                                        uint8_t *basename,
+                                        uint32_t basename_len);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify`, but with the basename (and its precomputation)
+ *  taken from `basename_ctx` (see `ecdaa_basename_ctx_ZZZ_init`).
+ */
+int ecdaa_signature_ZZZ_verify_with_basename_ctx(struct ecdaa_signature_ZZZ *signature,
+                                                 struct ecdaa_group_public_key_ZZZ *gpk,
+                                                 struct ecdaa_revocations_ZZZ *revocations,
+                                                 uint8_t* message,
+                                                 uint32_t message_len,
+                                                 struct ecdaa_basename_ctx_ZZZ *basename_ctx);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify_with_basename_ctx`, but using a prepared group public key.
+ */
+int ecdaa_signature_ZZZ_verify_prepared_with_basename_ctx(struct ecdaa_signature_ZZZ *signature,
+                                                          struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                          struct ecdaa_revocations_ZZZ *revocations,
+                                                          uint8_t* message,
+                                                          uint32_t message_len,
+                                                          struct ecdaa_basename_ctx_ZZZ *basename_ctx);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify`, but with the checks run according to `policy`
+ *  (see `enum ecdaa_verify_policy`).
+ *
+ * If `rejected_stage_out` isn't NULL, it's set to the check that rejected the signature
+ *  (ECDAA_VERIFY_STAGE_NONE if the signature is valid).
+ */
+int ecdaa_signature_ZZZ_verify_with_policy(struct ecdaa_signature_ZZZ *signature,
+                                           struct ecdaa_group_public_key_ZZZ *gpk,
+                                           struct ecdaa_revocations_ZZZ *revocations,
+                                           uint8_t* message,
+                                           uint32_t message_len,
+                                           uint8_t *basename,
+                                           uint32_t basename_len,
+                                           enum ecdaa_verify_policy policy,
+                                           enum ecdaa_verify_stage *rejected_stage_out);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify_with_policy`, but using a prepared group public key.
+ */
+int ecdaa_signature_ZZZ_verify_prepared_with_policy(struct ecdaa_signature_ZZZ *signature,
+                                                    struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                    struct ecdaa_revocations_ZZZ *revocations,
+                                                    uint8_t* message,
+                                                    uint32_t message_len,
+                                                    uint8_t *basename,
+                                                    uint32_t basename_len,
+                                                    enum ecdaa_verify_policy policy,
+                                                    enum ecdaa_verify_stage *rejected_stage_out);
+
+/*
+ * Check only the cryptographic validity of an ECDAA signature
+ *  (the Schnorr-type signature and the pairing equations), not the revocation lists.
+ *
+ * A valid signature can only later be rejected by its revocation checks
+ *  (see `ecdaa_signature_ZZZ_check_revocations`).
+ *  `ecdaa_signature_ZZZ_verify` is this followed by those.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if signature is invalid
+ */
+int ecdaa_signature_ZZZ_verify_crypto(struct ecdaa_signature_ZZZ *signature,
+                                      struct ecdaa_group_public_key_ZZZ *gpk,
+                                      uint8_t* message,
+                                      uint32_t message_len,
+                                      uint8_t *basename,
+                                      uint32_t basename_len);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify_crypto`, but using a prepared group public key.
+ */
+int ecdaa_signature_ZZZ_verify_crypto_prepared(struct ecdaa_signature_ZZZ *signature,
+                                               struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                               uint8_t* message,
+                                               uint32_t message_len,
+                                               uint8_t *basename,
+                                               uint32_t basename_len);
+
+/*
+ * Check a signature against the revocation lists only.
+ *
+ * Only meaningful for a signature that passed `ecdaa_signature_ZZZ_verify_crypto`
+ *  (with the same basename).
+ *
+ * If `rejected_stage_out` isn't NULL, it's set as for `ecdaa_signature_ZZZ_verify_with_policy`.
+ *
+ * Returns:
+ * 0 if the signature isn't revoked
+ * -1 if it is
+ */
+int ecdaa_signature_ZZZ_check_revocations(struct ecdaa_signature_ZZZ *signature,
+                                          struct ecdaa_revocations_ZZZ *revocations,
+                                          uint8_t *basename,
+                                          uint32_t basename_len,
+                                          enum ecdaa_verify_stage *rejected_stage_out);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_check_revocations`, for a signature whose basename was hashed
+ *  with `hash_to_curve` (which picks the pseudonym index to use, if any).
+ */
+int ecdaa_signature_ZZZ_check_revocations_with_hash_to_curve(struct ecdaa_signature_ZZZ *signature,
+                                                             struct ecdaa_revocations_ZZZ *revocations,
+                                                             uint8_t *basename,
+                                                             uint32_t basename_len,
+                                                             enum ecdaa_hash_to_curve hash_to_curve,
+                                                             enum ecdaa_verify_stage *rejected_stage_out);
+
+/*
+ * Re-check signatures that were valid under some revocation list,
+ *  after `delta` was applied to that list.
+ *
+ * Only the entries added by `delta` are checked, so this costs far less than re-verifying.
+ *  (Removed entries can't make a signature invalid.)
+ *  Each signature must have passed `ecdaa_signature_ZZZ_verify_crypto`
+ *  (or its basename-context equivalent, under either hash-to-curve method).
+ *
+ * `results_out` must have room for `num_signatures` entries.
+ *  `results_out[i]` is set to 0 if signature `i` is still valid, else -1.
+ *
+ * `sk_scan_threads` is as for `ecdaa_revocations_ZZZ`.
+ *
+ * Returns:
+ * 0 if all signatures are still valid
+ * -1 otherwise
+ */
+int ecdaa_signature_ZZZ_recheck_revocations(int *results_out,
+                                            struct ecdaa_signature_ZZZ *signatures,
+                                            size_t num_signatures,
+                                            struct ecdaa_revocation_delta_ZZZ *delta,
+                                            size_t sk_scan_threads);
+
+/*
+ * Verify a batch of ECDAA signatures, all created under the same group public key.
+ *
+ * Signature `i` is over the message `messages[i]` (of length `message_lengths[i]`),
+ *  and the basename `basenames[i]` (of length `basename_lengths[i]`).
+ *  If none of the signatures use a basename, `basenames` and `basename_lengths` may be NULL.
+ *
+ * The pairing checks of all signatures are combined into one random linear combination
+ *  (with 128-bit randomizers),
+ *  costing three Miller loops and one final exponentiation for the whole batch.
+ *  If that combined check fails, the batch is bisected to find the invalid signatures.
+ *
+ * On return, `results[i]` is 0 if signature `i` is valid, and -1 if it's invalid.
+ *
+ * Returns:
+ * 0 if all signatures are valid
+ * -1 if any signature is invalid
+ */
+int ecdaa_signature_ZZZ_batch_verify(struct ecdaa_signature_ZZZ *signatures,
+                                     uint8_t **messages,
+                                     uint32_t *message_lengths,
+                                     uint8_t **basenames,
+                                     uint32_t *basename_lengths,
+                                     size_t num_signatures,
+                                     struct ecdaa_group_public_key_ZZZ *gpk,
+                                     struct ecdaa_revocations_ZZZ *revocations,
+                                     int *results);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_batch_verify`, but using a prepared group public key
+ *  (see `ecdaa_prepared_gpk_ZZZ_prepare`).
+ */
+int ecdaa_signature_ZZZ_batch_verify_prepared(struct ecdaa_signature_ZZZ *signatures,
+                                              uint8_t **messages,
+                                              uint32_t *message_lengths,
+                                              uint8_t **basenames,
+                                              uint32_t *basename_lengths,
+                                              size_t num_signatures,
+                                              struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                              struct ecdaa_revocations_ZZZ *revocations,
+                                              int *results);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_batch_verify` (or `..._batch_verify_prepared`),
+ *  for signatures whose basenames were all hashed with `hash_to_curve`
+ *  (e.g. signed with a basename context made by `ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve`).
+ */
+int ecdaa_signature_ZZZ_batch_verify_with_hash_to_curve(struct ecdaa_signature_ZZZ *signatures,
+                                                        uint8_t **messages,
+                                                        uint32_t *message_lengths,
+                                                        uint8_t **basenames,
+                                                        uint32_t *basename_lengths,
+                                                        enum ecdaa_hash_to_curve hash_to_curve,
+                                                        size_t num_signatures,
+                                                        struct ecdaa_group_public_key_ZZZ *gpk,
+                                                        struct ecdaa_revocations_ZZZ *revocations,
+                                                        int *results);
+
+int ecdaa_signature_ZZZ_batch_verify_prepared_with_hash_to_curve(struct ecdaa_signature_ZZZ *signatures,
+                                                                 uint8_t **messages,
+                                                                 uint32_t *message_lengths,
+                                                                 uint8_t **basenames,
+                                                                 uint32_t *basename_lengths,
+                                                                 enum ecdaa_hash_to_curve hash_to_curve,
+                                                                 size_t num_signatures,
+                                                                 struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                                 struct ecdaa_revocations_ZZZ *revocations,
+                                                                 int *results);
+
+
+/*
+ * Room for the running message hash of a streaming sign or verify (see below).
+ *  (Checked at compile time to be large enough.)
+ */
+#define ECDAA_SIGNATURE_ZZZ_HASH_STATE_WORDS 16
+
+/*
+ * Incremental signing, for messages that are large, arrive in pieces, or are scattered in memory.
+ *
+ * 1. `ecdaa_signature_ZZZ_sign_begin` does everything that doesn't depend on the message:
+ *     randomizing the credential, the Schnorr-type commitment,
+ *     and hashing the points and basename that precede the message.
+ * 2. `ecdaa_signature_ZZZ_sign_update` (or `..._sign_updatev`, for several buffers at once)
+ *     hashes the next piece of the message. Call it as many times as needed.
+ * 3. `ecdaa_signature_ZZZ_sign_finish` completes the signature.
+ *
+ * The signature is the same as `ecdaa_signature_ZZZ_sign` would create over the concatenated pieces,
+ *  and is verified the same way.
+ *
+ * The context holds the secret key and the commitment's secret until `finish` clears them,
+ *  so a context that's abandoned should be cleared by the caller.
+ */
+struct ecdaa_signature_ZZZ_sign_ctx {
+    struct ecdaa_signature_ZZZ signature;
+    uint64_t hash_state[ECDAA_SIGNATURE_ZZZ_HASH_STATE_WORDS];
+    BIG_XXX k;
+    BIG_XXX sk;
+    ecdaa_rand_func get_random;
+};
+
+/*
+ * Returns:
+ * 0 on success
+ * -1 if unable to create signature
+ */
+int ecdaa_signature_ZZZ_sign_begin(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                   const uint8_t* basename,
+                                   uint32_t basename_len,
+                                   struct ecdaa_member_secret_key_ZZZ *sk,
+                                   struct ecdaa_credential_ZZZ *cred,
+                                   ecdaa_rand_func get_random);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_sign_begin`, but with the basename taken from `basename_ctx`
+ *  (as for `ecdaa_signature_ZZZ_sign_with_basename_ctx`).
+ */
+int ecdaa_signature_ZZZ_sign_begin_with_basename_ctx(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                                     struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                                     struct ecdaa_member_secret_key_ZZZ *sk,
+                                                     struct ecdaa_credential_ZZZ *cred,
+                                                     ecdaa_rand_func get_random);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_sign_begin`, but using a prepared credential
+ *  (as for `ecdaa_signature_ZZZ_sign_prepared`).
+ */
+int ecdaa_signature_ZZZ_sign_begin_prepared(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                            const uint8_t* basename,
+                                            uint32_t basename_len,
+                                            struct ecdaa_member_secret_key_ZZZ *sk,
+                                            struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                            ecdaa_rand_func get_random);
+
+void ecdaa_signature_ZZZ_sign_update(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                     const uint8_t *message_chunk,
+                                     uint32_t message_chunk_len);
+
+/*
+ * Hash `num_chunks` pieces of the message, in order
+ *  (piece `i` is `message_chunks[i]`, of length `message_chunk_lengths[i]`).
+ */
+void ecdaa_signature_ZZZ_sign_updatev(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                      const uint8_t **message_chunks,
+                                      const uint32_t *message_chunk_lengths,
+                                      size_t num_chunks);
+
+void ecdaa_signature_ZZZ_sign_finish(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                     struct ecdaa_signature_ZZZ *signature_out);
+
+/*
+ * Incremental verification, likewise.
+ *
+ * 1. `ecdaa_signature_ZZZ_verify_begin` recomputes the Schnorr-type commitments
+ *     and hashes the points and basename that precede the message.
+ * 2. `ecdaa_signature_ZZZ_verify_update` (or `..._verify_updatev`) hashes the next piece of the message.
+ * 3. `ecdaa_signature_ZZZ_verify_finish` (or `..._verify_finish_prepared`) completes the Schnorr-type check,
+ *     and runs the remaining checks of `ecdaa_signature_ZZZ_verify`.
+ *
+ * `signature` (and `basename`, or `basename_ctx`) aren't copied,
+ *  so must be unchanged until `finish`.
+ */
+struct ecdaa_signature_ZZZ_verify_ctx {
+    struct ecdaa_signature_ZZZ *signature;
+    uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_basename_ctx_ZZZ *basename_ctx;
+    enum ecdaa_hash_to_curve hash_to_curve;
+    uint64_t hash_state[ECDAA_SIGNATURE_ZZZ_HASH_STATE_WORDS];
+    int begin_ret;
+};
+
+void ecdaa_signature_ZZZ_verify_begin(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                      struct ecdaa_signature_ZZZ *signature,
+                                      uint8_t *basename,
+                                      uint32_t basename_len);
+
+/*
+ * Same as `ecdaa_signature_ZZZ_verify_begin`, hashing `basename` with `hash_to_curve`
+ *  (the plain version uses ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT).
+ */
+void ecdaa_signature_ZZZ_verify_begin_with_hash_to_curve(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                                         struct ecdaa_signature_ZZZ *signature,
+                                                         uint8_t *basename,
+                                                         uint32_t basename_len,
+                                                         enum ecdaa_hash_to_curve hash_to_curve);
+
+void ecdaa_signature_ZZZ_verify_begin_with_basename_ctx(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                                        struct ecdaa_signature_ZZZ *signature,
+                                                        struct ecdaa_basename_ctx_ZZZ *basename_ctx);
+
+void ecdaa_signature_ZZZ_verify_update(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                       const uint8_t *message_chunk,
+                                       uint32_t message_chunk_len);
+
+void ecdaa_signature_ZZZ_verify_updatev(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                        const uint8_t **message_chunks,
+                                        const uint32_t *message_chunk_lengths,
+                                        size_t num_chunks);
+
+/*
+ * Returns:
+ * 0 on success
+ * -1 if signature is invalid
+ */
+int ecdaa_signature_ZZZ_verify_finish(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                      struct ecdaa_group_public_key_ZZZ *gpk,
+                                      struct ecdaa_revocations_ZZZ *revocations);
+
+int ecdaa_signature_ZZZ_verify_finish_prepared(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                               struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                               struct ecdaa_revocations_ZZZ *revocations);
+
 
 /*
  * Serialize an `ecdaa_signature_ZZZ`
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_VERIFIER_POOL_ZZZ_H
+#define ECDAA_VERIFIER_POOL_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ecdaa/verify_policy.h>
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct ecdaa_signature_ZZZ;
+struct ecdaa_prepared_gpk_ZZZ;
+struct ecdaa_revocations_ZZZ;
+struct ecdaa_verifier_pool_job_ZZZ;
+
+/*
+ * Called (from a worker thread) when a job completes.
+ */
+typedef void (*ecdaa_verifier_pool_ZZZ_callback)(struct ecdaa_verifier_pool_job_ZZZ *job);
+
+/*
+ * One signature to verify.
+ *
+ * The caller owns the job, and everything it points to,
+ *  and must keep them valid and unmodified until the job completes.
+ */
+struct ecdaa_verifier_pool_job_ZZZ {
+    // Inputs
+    struct ecdaa_signature_ZZZ *signature;
+    uint8_t *message;
+    uint32_t message_len;
+    uint8_t *basename;
+    uint32_t basename_len;
+    ecdaa_verifier_pool_ZZZ_callback callback;  // If NULL, the job goes on the completion queue
+    void *user_data;                            // Not used by the pool
+
+    // Outputs (set before the job completes)
+    int result;                                 // As from `ecdaa_signature_ZZZ_verify`
+    enum ecdaa_verify_stage rejected_stage;
+};
+
+/*
+ * A fixed set of worker threads, verifying signatures against one
+ *  (read-only) prepared group public key and revocation list.
+ *
+ * Jobs are submitted to a queue, from which idle workers take them.
+ *  When a job completes, its callback is called from the worker thread;
+ *  jobs without a callback go on a completion queue instead,
+ *  to be collected with `ecdaa_verifier_pool_ZZZ_poll` or `ecdaa_verifier_pool_ZZZ_wait`.
+ *
+ * On Linux, the pool also has an eventfd that becomes readable whenever
+ *  a job is put on the completion queue, for use with epoll/poll/select.
+ *
+ * Each verification takes far longer than a queue operation,
+ *  so the queues are simple mutex-protected rings.
+ *
+ * All storage (the struct itself, the thread handles, and the queues)
+ *  is provided by the caller. Treat the fields as private.
+ */
+struct ecdaa_verifier_pool_ZZZ {
+    struct ecdaa_prepared_gpk_ZZZ *prepared_gpk;
+    struct ecdaa_revocations_ZZZ *revocations;
+    enum ecdaa_verify_policy policy;
+
+    pthread_t *threads;
+    size_t num_threads;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t submitted_cond;
+    pthread_cond_t completed_cond;
+
+    struct ecdaa_verifier_pool_job_ZZZ **submitted;
+    size_t submitted_head;
+    size_t submitted_count;
+
+    struct ecdaa_verifier_pool_job_ZZZ **completed;
+    size_t completed_head;
+    size_t completed_count;
+
+    size_t queue_capacity;
+    size_t in_flight;
+    int shutting_down;
+    int event_fd;
+};
+
+/*
+ * Start a verifier pool with `num_threads` worker threads.
+ *
+ * `threads` must have room for `num_threads` entries,
+ *  and `submitted_storage` and `completed_storage` for `queue_capacity` entries each.
+ *  At most `queue_capacity` jobs can be in the pool at once
+ *  (submitted, but not yet completed and collected).
+ *
+ * `prepared_gpk` and `revocations` are shared by all workers,
+ *  so must not be modified until the pool is destroyed.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the pool could not be started (nothing is left running)
+ */
+int ecdaa_verifier_pool_ZZZ_init(struct ecdaa_verifier_pool_ZZZ *pool,
+                                 struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                 struct ecdaa_revocations_ZZZ *revocations,
+                                 enum ecdaa_verify_policy policy,
+                                 pthread_t *threads,
+                                 size_t num_threads,
+                                 struct ecdaa_verifier_pool_job_ZZZ **submitted_storage,
+                                 struct ecdaa_verifier_pool_job_ZZZ **completed_storage,
+                                 size_t queue_capacity);
+
+/*
+ * Submit a job for verification. Doesn't block.
+ *
+ * Returns:
+ * 0 on success
+ * -1 if the pool is full (or being destroyed)
+ */
+int ecdaa_verifier_pool_ZZZ_submit(struct ecdaa_verifier_pool_ZZZ *pool,
+                                   struct ecdaa_verifier_pool_job_ZZZ *job);
+
+/*
+ * Collect up to `max_jobs` completed jobs from the completion queue. Doesn't block.
+ *
+ * Returns the number of jobs written to `jobs_out`.
+ */
+size_t ecdaa_verifier_pool_ZZZ_poll(struct ecdaa_verifier_pool_ZZZ *pool,
+                                    struct ecdaa_verifier_pool_job_ZZZ **jobs_out,
+                                    size_t max_jobs);
+
+/*
+ * Same as `ecdaa_verifier_pool_ZZZ_poll`,
+ *  but blocks until at least one job is on the completion queue.
+ *
+ * Returns 0 (without blocking) if no jobs are left in the pool.
+ */
+size_t ecdaa_verifier_pool_ZZZ_wait(struct ecdaa_verifier_pool_ZZZ *pool,
+                                    struct ecdaa_verifier_pool_job_ZZZ **jobs_out,
+                                    size_t max_jobs);
+
+/*
+ * File descriptor that becomes readable when jobs are put on the completion queue.
+ *
+ * After it becomes readable, read 8 bytes from it (to reset it),
+ *  then collect jobs with `ecdaa_verifier_pool_ZZZ_poll`.
+ *
+ * Returns -1 if not supported on this platform.
+ */
+int ecdaa_verifier_pool_ZZZ_event_fd(struct ecdaa_verifier_pool_ZZZ *pool);
+
+/*
+ * Stop the pool.
+ *
+ * Blocks until every submitted job has completed (with callbacks called as usual),
+ *  then stops the worker threads.
+ *  Jobs still on the completion queue are dropped (their outputs are still set).
+ *
+ * Must not be called from a callback.
+ */
+void ecdaa_verifier_pool_ZZZ_destroy(struct ecdaa_verifier_pool_ZZZ *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
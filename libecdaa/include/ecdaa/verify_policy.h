@@ -0,0 +1,60 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_VERIFY_POLICY_H
+#define ECDAA_VERIFY_POLICY_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * How to run the checks when verifying a signature.
+ *
+ * ECDAA_VERIFY_POLICY_COMPLETE runs every check, even after one has failed.
+ *
+ * ECDAA_VERIFY_POLICY_FAIL_FAST runs the checks cheapest-first
+ *  (basename revocation lookup, Schnorr check, pairings, secret-key revocation scan),
+ *  and stops at the first failure.
+ *  Use this to reject forged signatures cheaply, e.g. under load.
+ */
+enum ecdaa_verify_policy {
+    ECDAA_VERIFY_POLICY_COMPLETE = 0,
+    ECDAA_VERIFY_POLICY_FAIL_FAST = 1
+};
+
+/*
+ * The check that rejected a signature.
+ *
+ * If several checks failed, this is the first of them in the
+ *  order listed here (which is the order used by ECDAA_VERIFY_POLICY_FAIL_FAST).
+ */
+enum ecdaa_verify_stage {
+    ECDAA_VERIFY_STAGE_NONE = 0,            // Signature is valid
+    ECDAA_VERIFY_STAGE_BSN_REVOCATION = 1,  // Pseudonym K is on the basename revocation list
+    ECDAA_VERIFY_STAGE_SCHNORR = 2,         // Schnorr-type signature is invalid
+    ECDAA_VERIFY_STAGE_PAIRING = 3,         // Randomized credential is invalid
+    ECDAA_VERIFY_STAGE_SK_REVOCATION = 4    // Signer's secret key is on the secret-key revocation list
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/prepared_credential_ZZZ.h>
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+// The public sizes must agree with the fixed-base code's.
+typedef char prepared_credential_window_bounds_match_ZZZ[(ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS >= ECP_ZZZ_FIXED_BASE_MIN_WINDOW_BITS
+                                                          && ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS <= ECP_ZZZ_FIXED_BASE_MAX_WINDOW_BITS) ? 1 : -1];
+typedef char prepared_credential_table_length_matches_ZZZ[(ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(ECDAA_PREPARED_CREDENTIAL_ZZZ_DEFAULT_WINDOW_BITS)
+                                                           == 4*ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(ECDAA_PREPARED_CREDENTIAL_ZZZ_DEFAULT_WINDOW_BITS)) ? 1 : -1];
+
+int ecdaa_prepared_credential_ZZZ_prepare(struct ecdaa_prepared_credential_ZZZ *prepared_out,
+                                          struct ecdaa_credential_ZZZ *cred,
+                                          int window_bits,
+                                          ECP_ZZZ *table_storage,
+                                          size_t table_storage_length)
+{
+    if (window_bits < ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS
+            || window_bits > ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS)
+        return -1;
+
+    if (NULL == table_storage || table_storage_length < (size_t)ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits))
+        return -1;
+
+    ECP_ZZZ_copy(&prepared_out->cred.A, &cred->A);
+    ECP_ZZZ_copy(&prepared_out->cred.B, &cred->B);
+    ECP_ZZZ_copy(&prepared_out->cred.C, &cred->C);
+    ECP_ZZZ_copy(&prepared_out->cred.D, &cred->D);
+    prepared_out->window_bits = window_bits;
+    prepared_out->tables = table_storage;
+
+    size_t table_length = ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(window_bits);
+    ecp_ZZZ_fixed_base_table_build_window(&table_storage[0*table_length], &prepared_out->cred.A, window_bits);
+    ecp_ZZZ_fixed_base_table_build_window(&table_storage[1*table_length], &prepared_out->cred.B, window_bits);
+    ecp_ZZZ_fixed_base_table_build_window(&table_storage[2*table_length], &prepared_out->cred.C, window_bits);
+    ecp_ZZZ_fixed_base_table_build_window(&table_storage[3*table_length], &prepared_out->cred.D, window_bits);
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+
+#include <ecdaa/prepared_gpk_ZZZ.h>
+
+#include "amcl-extensions/ecp2_ZZZ.h"
+#include "amcl-extensions/pairing_ZZZ.h"
+
+void ecdaa_prepared_gpk_ZZZ_prepare(struct ecdaa_prepared_gpk_ZZZ *prepared_out,
+                                    struct ecdaa_group_public_key_ZZZ *gpk)
+{
+    ECP2_ZZZ_copy(&prepared_out->gpk.X, &gpk->X);
+    ECP2_ZZZ_copy(&prepared_out->gpk.Y, &gpk->Y);
+    ecp2_ZZZ_set_to_generator(&prepared_out->basepoint2);
+
+    prepared_out->has_lines = 0;
+
+    if (0 == prepare_g2_lines_ZZZ(prepared_out->X_lines, ECDAA_PREPARED_GPK_ZZZ_MAX_LINES, &prepared_out->gpk.X))
+        return;
+
+    if (0 == prepare_g2_lines_ZZZ(prepared_out->Y_lines, ECDAA_PREPARED_GPK_ZZZ_MAX_LINES, &prepared_out->gpk.Y))
+        return;
+
+    if (0 == prepare_g2_lines_ZZZ(prepared_out->basepoint2_lines, ECDAA_PREPARED_GPK_ZZZ_MAX_LINES, &prepared_out->basepoint2))
+        return;
+
+    prepared_out->has_lines = 1;
+}
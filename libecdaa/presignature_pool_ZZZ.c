@@ -0,0 +1,173 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+
+#include <ecdaa/presignature_pool_ZZZ.h>
+
+#include "internal-utilities/explicit_bzero.h"
+
+static
+int begin_presignature_ZZZ(struct ecdaa_presignature_pool_ZZZ *pool,
+                           struct ecdaa_signature_ZZZ_sign_ctx *ctx_out);
+
+int ecdaa_presignature_pool_ZZZ_init(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ_sign_ctx *slots,
+                                     size_t capacity,
+                                     const uint8_t *basename,
+                                     uint32_t basename_len,
+                                     struct ecdaa_member_secret_key_ZZZ *sk,
+                                     struct ecdaa_credential_ZZZ *cred,
+                                     ecdaa_rand_func get_random)
+{
+    if (0 == capacity)
+        return -1;
+
+    pool->sk = sk;
+    pool->cred = cred;
+    pool->basename = basename;
+    pool->basename_len = basename_len;
+    pool->basename_ctx = NULL;
+    pool->get_random = get_random;
+    pool->slots = slots;
+    pool->capacity = capacity;
+    pool->head = 0;
+    pool->count = 0;
+    pool->filling = 0;
+
+    if (0 != pthread_mutex_init(&pool->mutex, NULL))
+        return -1;
+
+    return 0;
+}
+
+int ecdaa_presignature_pool_ZZZ_init_with_basename_ctx(struct ecdaa_presignature_pool_ZZZ *pool,
+                                                       struct ecdaa_signature_ZZZ_sign_ctx *slots,
+                                                       size_t capacity,
+                                                       struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                                       struct ecdaa_member_secret_key_ZZZ *sk,
+                                                       struct ecdaa_credential_ZZZ *cred,
+                                                       ecdaa_rand_func get_random)
+{
+    if (0 != ecdaa_presignature_pool_ZZZ_init(pool, slots, capacity, NULL, 0, sk, cred, get_random))
+        return -1;
+
+    pool->basename_ctx = basename_ctx;
+
+    return 0;
+}
+
+int ecdaa_presignature_pool_ZZZ_fill(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     size_t max_presignatures)
+{
+    int num_added = 0;
+
+    for (size_t i = 0; i < max_presignatures; ++i) {
+        // Reserve a slot, so concurrent fills don't overfill the pool.
+        pthread_mutex_lock(&pool->mutex);
+        int has_room = (pool->count + pool->filling < pool->capacity);
+        if (has_room)
+            pool->filling++;
+        pthread_mutex_unlock(&pool->mutex);
+        if (!has_room)
+            break;
+
+        // The expensive part, done without holding the mutex.
+        struct ecdaa_signature_ZZZ_sign_ctx ctx;
+        int begin_ret = begin_presignature_ZZZ(pool, &ctx);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->filling--;
+        if (0 == begin_ret) {
+            size_t tail = (pool->head + pool->count) % pool->capacity;
+            pool->slots[tail] = ctx;
+            pool->count++;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+
+        explicit_bzero(&ctx, sizeof(ctx));
+
+        if (0 != begin_ret)
+            return -1;
+
+        num_added++;
+    }
+
+    return num_added;
+}
+
+size_t ecdaa_presignature_pool_ZZZ_count(struct ecdaa_presignature_pool_ZZZ *pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    size_t count = pool->count;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return count;
+}
+
+int ecdaa_presignature_pool_ZZZ_take(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ_sign_ctx *ctx_out)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->count > 0) {
+        *ctx_out = pool->slots[pool->head];
+        explicit_bzero(&pool->slots[pool->head], sizeof(struct ecdaa_signature_ZZZ_sign_ctx));
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+        ret = 0;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ret;
+}
+
+int ecdaa_presignature_pool_ZZZ_sign(struct ecdaa_presignature_pool_ZZZ *pool,
+                                     struct ecdaa_signature_ZZZ *signature_out,
+                                     const uint8_t *message,
+                                     uint32_t message_len)
+{
+    struct ecdaa_signature_ZZZ_sign_ctx ctx;
+    if (0 != ecdaa_presignature_pool_ZZZ_take(pool, &ctx)) {
+        if (0 != begin_presignature_ZZZ(pool, &ctx))
+            return -1;
+    }
+
+    // (finish clears the secrets in ctx)
+    ecdaa_signature_ZZZ_sign_update(&ctx, message, message_len);
+    ecdaa_signature_ZZZ_sign_finish(&ctx, signature_out);
+
+    return 0;
+}
+
+void ecdaa_presignature_pool_ZZZ_destroy(struct ecdaa_presignature_pool_ZZZ *pool)
+{
+    explicit_bzero(pool->slots, pool->capacity * sizeof(struct ecdaa_signature_ZZZ_sign_ctx));
+    pool->count = 0;
+
+    pthread_mutex_destroy(&pool->mutex);
+}
+
+int begin_presignature_ZZZ(struct ecdaa_presignature_pool_ZZZ *pool,
+                           struct ecdaa_signature_ZZZ_sign_ctx *ctx_out)
+{
+    if (NULL != pool->basename_ctx)
+        return ecdaa_signature_ZZZ_sign_begin_with_basename_ctx(ctx_out, pool->basename_ctx, pool->sk, pool->cred, pool->get_random);
+
+    return ecdaa_signature_ZZZ_sign_begin(ctx_out, pool->basename, pool->basename_len, pool->sk, pool->cred, pool->get_random);
+}
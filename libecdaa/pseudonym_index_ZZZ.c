@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/pseudonym_index_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "schnorr/schnorr_ZZZ.h"
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "revocations/sk_revocation_scan_ZZZ.h"
+
+#include <string.h>
+
+int ecdaa_pseudonym_index_ZZZ_init(struct ecdaa_pseudonym_index_ZZZ *index,
+                                   const uint8_t *basename,
+                                   uint32_t basename_len,
+                                   uint8_t *slot_storage,
+                                   size_t capacity,
+                                   uint8_t *bloom_storage,
+                                   size_t bloom_length)
+{
+    return ecdaa_pseudonym_index_ZZZ_init_with_hash_to_curve(index,
+                                                             basename,
+                                                             basename_len,
+                                                             ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                                                             slot_storage,
+                                                             capacity,
+                                                             bloom_storage,
+                                                             bloom_length);
+}
+
+int ecdaa_pseudonym_index_ZZZ_init_with_hash_to_curve(struct ecdaa_pseudonym_index_ZZZ *index,
+                                                      const uint8_t *basename,
+                                                      uint32_t basename_len,
+                                                      enum ecdaa_hash_to_curve hash_to_curve,
+                                                      uint8_t *slot_storage,
+                                                      size_t capacity,
+                                                      uint8_t *bloom_storage,
+                                                      size_t bloom_length)
+{
+    if (0 != ecdaa_bsn_revocation_set_ZZZ_init(&index->set, slot_storage, capacity, bloom_storage, bloom_length))
+        return -1;
+
+    // Same basepoint as the signers use.
+    if (0 != schnorr_basename_point_ZZZ(&index->basepoint, basename, basename_len, hash_to_curve))
+        return -2;
+
+    index->basename = basename;
+    index->basename_len = basename_len;
+    index->hash_to_curve = hash_to_curve;
+    index->sk_length = 0;
+    index->sk_generation = 0;
+
+    return 0;
+}
+
+int ecdaa_pseudonym_index_ZZZ_sync(struct ecdaa_pseudonym_index_ZZZ *index,
+                                   struct ecdaa_revocations_ZZZ *revocations)
+{
+    // Entries may have been removed or replaced, so the old ones can't be trusted.
+    if (revocations->sk_generation != index->sk_generation || revocations->sk_length < index->sk_length) {
+        if (0 != ecdaa_bsn_revocation_set_ZZZ_init(&index->set,
+                                                   index->set.slots,
+                                                   index->set.capacity,
+                                                   index->set.bloom,
+                                                   index->set.bloom_bits / 8))
+            return -1;
+        index->sk_length = 0;
+        index->sk_generation = revocations->sk_generation;
+    }
+
+    size_t num_new = revocations->sk_length - index->sk_length;
+    if (0 == num_new)
+        return 0;
+
+    // The revoked secret keys are public, so variable-time multiplication is fine.
+    //  For more than a few new entries, build a fixed-base table for the basepoint first.
+    struct ecp_ZZZ_fixed_base_table table;
+    int use_table = (num_new >= SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD);
+    if (use_table)
+        ecp_ZZZ_fixed_base_table_build(&table, &index->basepoint);
+
+    for (size_t i = index->sk_length; i < revocations->sk_length; ++i) {
+        ECP_ZZZ K;
+        if (use_table) {
+            ecp_ZZZ_fixed_base_mul_vartime(&K, &table, revocations->sk_list[i].sk);
+        } else {
+            ECP_ZZZ_copy(&K, &index->basepoint);
+            ecp_ZZZ_mul_vartime(&K, revocations->sk_list[i].sk);
+        }
+
+        if (0 != ecdaa_bsn_revocation_set_ZZZ_insert(&index->set, &K))
+            return -1;
+
+        // Only count it as indexed once it's really in the set,
+        //  so a failed sync leaves the index stale.
+        index->sk_length = i + 1;
+    }
+
+    return 0;
+}
+
+int ecdaa_pseudonym_index_ZZZ_contains(struct ecdaa_pseudonym_index_ZZZ *index,
+                                       ECP_ZZZ *K)
+{
+    return ecdaa_bsn_revocation_set_ZZZ_contains(&index->set, K);
+}
@@ -0,0 +1,524 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/revocation_store_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t delta_magic[8] = {'E', 'C', 'D', 'A', 'A', 'D', 'L', 'T'};
+
+#define CURVE_NAME_LENGTH 16
+
+static
+struct ecdaa_revocation_snapshot_ZZZ *snapshot_new_ZZZ(size_t sk_length,
+                                                       size_t bsn_length,
+                                                       uint64_t epoch,
+                                                       size_t sk_scan_threads);
+
+static
+void snapshot_free_ZZZ(struct ecdaa_revocation_snapshot_ZZZ *snapshot);
+
+static
+void swap_current_ZZZ(struct ecdaa_revocation_store_ZZZ *store,
+                      struct ecdaa_revocation_snapshot_ZZZ *snapshot);
+
+static
+int sk_is_removed_ZZZ(struct ecdaa_member_secret_key_ZZZ *sk,
+                      struct ecdaa_revocation_delta_ZZZ *delta);
+
+static
+int bsn_is_removed_ZZZ(ECP_ZZZ *bsn,
+                       struct ecdaa_revocation_delta_ZZZ *delta);
+
+static
+int checked_add(size_t *sum_out, size_t lhs, size_t rhs);
+
+static
+int checked_mul(size_t *product_out, size_t count, size_t entry_size);
+
+static
+void *malloc_array(size_t count, size_t entry_size);
+
+static
+void put_uint32(uint8_t *buffer_out, uint32_t value);
+
+static
+void put_uint64(uint8_t *buffer_out, uint64_t value);
+
+static
+uint32_t get_uint32(const uint8_t *buffer);
+
+static
+uint64_t get_uint64(const uint8_t *buffer);
+
+size_t ecdaa_revocation_delta_ZZZ_length(struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    // Four entry counts, of up to 2^32 - 1 entries each, can overflow a 32-bit size_t,
+    //  so check every step (and return 0, which no valid delta has, if one overflows).
+    size_t length = ECDAA_REVOCATION_DELTA_ZZZ_HEADER_LENGTH;
+    size_t part;
+    if (0 != checked_mul(&part, delta->sk_added_length, ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH)
+            || 0 != checked_add(&length, length, part))
+        return 0;
+    if (0 != checked_mul(&part, delta->sk_removed_length, ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH)
+            || 0 != checked_add(&length, length, part))
+        return 0;
+    if (0 != checked_mul(&part, delta->bsn_added_length, ECP_ZZZ_LENGTH)
+            || 0 != checked_add(&length, length, part))
+        return 0;
+    if (0 != checked_mul(&part, delta->bsn_removed_length, ECP_ZZZ_LENGTH)
+            || 0 != checked_add(&length, length, part))
+        return 0;
+
+    return length;
+}
+
+void ecdaa_revocation_delta_ZZZ_serialize(uint8_t *buffer_out,
+                                          struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    memcpy(buffer_out, delta_magic, sizeof(delta_magic));
+    put_uint32(buffer_out + 8, ECDAA_REVOCATION_DELTA_VERSION);
+    memset(buffer_out + 12, 0, CURVE_NAME_LENGTH);
+    strncpy((char*)buffer_out + 12, "ZZZ", CURVE_NAME_LENGTH - 1);
+    put_uint64(buffer_out + 28, delta->base_epoch);
+    put_uint64(buffer_out + 36, delta->epoch);
+    put_uint32(buffer_out + 44, (uint32_t)delta->sk_added_length);
+    put_uint32(buffer_out + 48, (uint32_t)delta->sk_removed_length);
+    put_uint32(buffer_out + 52, (uint32_t)delta->bsn_added_length);
+    put_uint32(buffer_out + 56, (uint32_t)delta->bsn_removed_length);
+
+    uint8_t *current = buffer_out + ECDAA_REVOCATION_DELTA_ZZZ_HEADER_LENGTH;
+    for (size_t i = 0; i < delta->sk_added_length; ++i, current += ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH)
+        ecdaa_member_secret_key_ZZZ_serialize(current, &delta->sk_added[i]);
+    for (size_t i = 0; i < delta->sk_removed_length; ++i, current += ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH)
+        ecdaa_member_secret_key_ZZZ_serialize(current, &delta->sk_removed[i]);
+    for (size_t i = 0; i < delta->bsn_added_length; ++i, current += ECP_ZZZ_LENGTH)
+        ecp_ZZZ_serialize(current, &delta->bsn_added[i]);
+    for (size_t i = 0; i < delta->bsn_removed_length; ++i, current += ECP_ZZZ_LENGTH)
+        ecp_ZZZ_serialize(current, &delta->bsn_removed[i]);
+}
+
+int ecdaa_revocation_delta_ZZZ_deserialize(struct ecdaa_revocation_delta_ZZZ *delta_out,
+                                           uint8_t *buffer,
+                                           size_t buffer_length)
+{
+    if (buffer_length < ECDAA_REVOCATION_DELTA_ZZZ_HEADER_LENGTH)
+        return -1;
+
+    if (0 != memcmp(buffer, delta_magic, sizeof(delta_magic)))
+        return -1;
+    if (ECDAA_REVOCATION_DELTA_VERSION != get_uint32(buffer + 8))
+        return -1;
+    char curve[CURVE_NAME_LENGTH] = {0};
+    strncpy(curve, "ZZZ", sizeof(curve) - 1);
+    if (0 != memcmp(curve, buffer + 12, sizeof(curve)))
+        return -1;
+
+    struct ecdaa_revocation_delta_ZZZ delta;
+    memset(&delta, 0, sizeof(delta));
+    delta.base_epoch = get_uint64(buffer + 28);
+    delta.epoch = get_uint64(buffer + 36);
+    delta.sk_added_length = get_uint32(buffer + 44);
+    delta.sk_removed_length = get_uint32(buffer + 48);
+    delta.bsn_added_length = get_uint32(buffer + 52);
+    delta.bsn_removed_length = get_uint32(buffer + 56);
+
+    // A length that overflows a size_t comes back as 0, which can't match.
+    if (buffer_length != ecdaa_revocation_delta_ZZZ_length(&delta))
+        return -1;
+
+    // Allocate everything, then fill it in.
+    int ret = 0;
+    if (0 != delta.sk_added_length)
+        delta.sk_added = malloc_array(delta.sk_added_length, sizeof(struct ecdaa_member_secret_key_ZZZ));
+    if (0 != delta.sk_removed_length)
+        delta.sk_removed = malloc_array(delta.sk_removed_length, sizeof(struct ecdaa_member_secret_key_ZZZ));
+    if (0 != delta.bsn_added_length)
+        delta.bsn_added = malloc_array(delta.bsn_added_length, sizeof(ECP_ZZZ));
+    if (0 != delta.bsn_removed_length)
+        delta.bsn_removed = malloc_array(delta.bsn_removed_length, sizeof(ECP_ZZZ));
+    if ((0 != delta.sk_added_length && NULL == delta.sk_added)
+            || (0 != delta.sk_removed_length && NULL == delta.sk_removed)
+            || (0 != delta.bsn_added_length && NULL == delta.bsn_added)
+            || (0 != delta.bsn_removed_length && NULL == delta.bsn_removed)) {
+        ret = -3;
+        goto cleanup;
+    }
+
+    uint8_t *current = buffer + ECDAA_REVOCATION_DELTA_ZZZ_HEADER_LENGTH;
+    for (size_t i = 0; i < delta.sk_added_length; ++i, current += ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH) {
+        if (0 != ecdaa_member_secret_key_ZZZ_deserialize(&delta.sk_added[i], current))
+            ret = -2;
+    }
+    for (size_t i = 0; i < delta.sk_removed_length; ++i, current += ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH) {
+        if (0 != ecdaa_member_secret_key_ZZZ_deserialize(&delta.sk_removed[i], current))
+            ret = -2;
+    }
+    for (size_t i = 0; i < delta.bsn_added_length; ++i, current += ECP_ZZZ_LENGTH) {
+        if (0 != ecp_ZZZ_deserialize(&delta.bsn_added[i], current))
+            ret = -2;
+    }
+    for (size_t i = 0; i < delta.bsn_removed_length; ++i, current += ECP_ZZZ_LENGTH) {
+        if (0 != ecp_ZZZ_deserialize(&delta.bsn_removed[i], current))
+            ret = -2;
+    }
+
+cleanup:
+    if (0 != ret) {
+        ecdaa_revocation_delta_ZZZ_free(&delta);
+        return ret;
+    }
+
+    *delta_out = delta;
+
+    return 0;
+}
+
+void ecdaa_revocation_delta_ZZZ_free(struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    free(delta->sk_added);
+    free(delta->sk_removed);
+    free(delta->bsn_added);
+    free(delta->bsn_removed);
+
+    delta->sk_added = NULL;
+    delta->sk_added_length = 0;
+    delta->sk_removed = NULL;
+    delta->sk_removed_length = 0;
+    delta->bsn_added = NULL;
+    delta->bsn_added_length = 0;
+    delta->bsn_removed = NULL;
+    delta->bsn_removed_length = 0;
+}
+
+int ecdaa_revocation_store_ZZZ_init(struct ecdaa_revocation_store_ZZZ *store,
+                                    size_t sk_scan_threads)
+{
+    store->sk_scan_threads = sk_scan_threads;
+
+    store->current = snapshot_new_ZZZ(0, 0, 0, sk_scan_threads);
+    if (NULL == store->current)
+        goto fail;
+
+    if (0 != pthread_mutex_init(&store->mutex, NULL))
+        goto fail_snapshot;
+    if (0 != pthread_mutex_init(&store->update_mutex, NULL))
+        goto fail_mutex;
+
+    return 0;
+
+fail_mutex:
+    pthread_mutex_destroy(&store->mutex);
+fail_snapshot:
+    snapshot_free_ZZZ(store->current);
+    store->current = NULL;
+fail:
+    return -1;
+}
+
+void ecdaa_revocation_store_ZZZ_destroy(struct ecdaa_revocation_store_ZZZ *store)
+{
+    snapshot_free_ZZZ(store->current);
+    store->current = NULL;
+
+    pthread_mutex_destroy(&store->update_mutex);
+    pthread_mutex_destroy(&store->mutex);
+}
+
+struct ecdaa_revocation_snapshot_ZZZ *ecdaa_revocation_store_ZZZ_acquire(struct ecdaa_revocation_store_ZZZ *store)
+{
+    pthread_mutex_lock(&store->mutex);
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = store->current;
+    snapshot->refcount++;
+    pthread_mutex_unlock(&store->mutex);
+
+    return snapshot;
+}
+
+void ecdaa_revocation_store_ZZZ_release(struct ecdaa_revocation_store_ZZZ *store,
+                                        struct ecdaa_revocation_snapshot_ZZZ *snapshot)
+{
+    // The store itself holds a reference to the current snapshot,
+    //  so only a replaced snapshot can reach zero here.
+    pthread_mutex_lock(&store->mutex);
+    int last_reference = (0 == --snapshot->refcount);
+    pthread_mutex_unlock(&store->mutex);
+
+    if (last_reference)
+        snapshot_free_ZZZ(snapshot);
+}
+
+uint64_t ecdaa_revocation_store_ZZZ_epoch(struct ecdaa_revocation_store_ZZZ *store)
+{
+    pthread_mutex_lock(&store->mutex);
+    uint64_t epoch = store->current->epoch;
+    pthread_mutex_unlock(&store->mutex);
+
+    return epoch;
+}
+
+int ecdaa_revocation_store_ZZZ_apply(struct ecdaa_revocation_store_ZZZ *store,
+                                     struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&store->update_mutex);
+
+    // Only updates replace `current`, and we hold the update lock,
+    //  so it's safe to read without a reference.
+    struct ecdaa_revocation_snapshot_ZZZ *old = store->current;
+    struct ecdaa_revocations_ZZZ *old_revs = &old->revocations;
+
+    if (delta->base_epoch != old->epoch || delta->epoch <= delta->base_epoch) {
+        ret = -1;
+        goto cleanup;
+    }
+
+    size_t sk_capacity, bsn_capacity;
+    if (0 != checked_add(&sk_capacity, old_revs->sk_length, delta->sk_added_length)
+            || 0 != checked_add(&bsn_capacity, old_revs->bsn_length, delta->bsn_added_length)) {
+        ret = -2;
+        goto cleanup;
+    }
+
+    struct ecdaa_revocation_snapshot_ZZZ *next = snapshot_new_ZZZ(sk_capacity,
+                                                                 bsn_capacity,
+                                                                 delta->epoch,
+                                                                 store->sk_scan_threads);
+    if (NULL == next) {
+        ret = -2;
+        goto cleanup;
+    }
+    struct ecdaa_revocations_ZZZ *next_revs = &next->revocations;
+
+    // Surviving entries keep their order, and added ones go at the end.
+    //  So, if nothing was removed, the new list just extends the old one,
+    //  and keeps its generation (letting pseudonym indexes sync incrementally).
+    //  Any removal compacts the list, which changes entries in place
+    //  (even if as many are added, leaving the length unchanged),
+    //  so it starts a new generation, stamped with the (strictly increasing) epoch.
+    next_revs->sk_length = 0;
+    for (size_t i = 0; i < old_revs->sk_length; ++i) {
+        if (!sk_is_removed_ZZZ(&old_revs->sk_list[i], delta))
+            next_revs->sk_list[next_revs->sk_length++] = old_revs->sk_list[i];
+    }
+    if (next_revs->sk_length == old_revs->sk_length)
+        next_revs->sk_generation = old_revs->sk_generation;
+    else
+        next_revs->sk_generation = delta->epoch;
+    for (size_t i = 0; i < delta->sk_added_length; ++i) {
+        next_revs->sk_list[next_revs->sk_length++] = delta->sk_added[i];
+    }
+
+    next_revs->bsn_length = 0;
+    for (size_t i = 0; i < old_revs->bsn_length; ++i) {
+        if (!bsn_is_removed_ZZZ(&old_revs->bsn_list[i], delta))
+            ECP_ZZZ_copy(&next_revs->bsn_list[next_revs->bsn_length++], &old_revs->bsn_list[i]);
+    }
+    for (size_t i = 0; i < delta->bsn_added_length; ++i) {
+        ECP_ZZZ_copy(&next_revs->bsn_list[next_revs->bsn_length++], &delta->bsn_added[i]);
+    }
+
+    swap_current_ZZZ(store, next);
+
+cleanup:
+    pthread_mutex_unlock(&store->update_mutex);
+
+    return ret;
+}
+
+int ecdaa_revocation_store_ZZZ_replace(struct ecdaa_revocation_store_ZZZ *store,
+                                       struct ecdaa_revocations_ZZZ *revocations,
+                                       uint64_t epoch)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&store->update_mutex);
+
+    if (epoch <= store->current->epoch) {
+        ret = -1;
+        goto cleanup;
+    }
+
+    struct ecdaa_revocation_snapshot_ZZZ *next = snapshot_new_ZZZ(revocations->sk_length,
+                                                                 revocations->bsn_length,
+                                                                 epoch,
+                                                                 store->sk_scan_threads);
+    if (NULL == next) {
+        ret = -2;
+        goto cleanup;
+    }
+
+    if (0 != revocations->sk_length)
+        memcpy(next->revocations.sk_list, revocations->sk_list, revocations->sk_length * sizeof(struct ecdaa_member_secret_key_ZZZ));
+    // An entirely new list
+    next->revocations.sk_generation = epoch;
+    if (0 != revocations->bsn_length)
+        memcpy(next->revocations.bsn_list, revocations->bsn_list, revocations->bsn_length * sizeof(ECP_ZZZ));
+
+    swap_current_ZZZ(store, next);
+
+cleanup:
+    pthread_mutex_unlock(&store->update_mutex);
+
+    return ret;
+}
+
+struct ecdaa_revocation_snapshot_ZZZ *snapshot_new_ZZZ(size_t sk_length,
+                                                       size_t bsn_length,
+                                                       uint64_t epoch,
+                                                       size_t sk_scan_threads)
+{
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = malloc(sizeof(struct ecdaa_revocation_snapshot_ZZZ));
+    if (NULL == snapshot)
+        return NULL;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->epoch = epoch;
+    snapshot->refcount = 1;     // The store's reference
+    snapshot->revocations.sk_length = sk_length;
+    snapshot->revocations.bsn_length = bsn_length;
+    snapshot->revocations.sk_scan_threads = sk_scan_threads;
+
+    if (0 != sk_length)
+        snapshot->revocations.sk_list = malloc_array(sk_length, sizeof(struct ecdaa_member_secret_key_ZZZ));
+    if (0 != bsn_length)
+        snapshot->revocations.bsn_list = malloc_array(bsn_length, sizeof(ECP_ZZZ));
+
+    if ((0 != sk_length && NULL == snapshot->revocations.sk_list)
+            || (0 != bsn_length && NULL == snapshot->revocations.bsn_list)) {
+        snapshot_free_ZZZ(snapshot);
+        return NULL;
+    }
+
+    return snapshot;
+}
+
+void snapshot_free_ZZZ(struct ecdaa_revocation_snapshot_ZZZ *snapshot)
+{
+    if (NULL == snapshot)
+        return;
+
+    free(snapshot->revocations.sk_list);
+    free(snapshot->revocations.bsn_list);
+    free(snapshot);
+}
+
+void swap_current_ZZZ(struct ecdaa_revocation_store_ZZZ *store,
+                      struct ecdaa_revocation_snapshot_ZZZ *snapshot)
+{
+    pthread_mutex_lock(&store->mutex);
+    struct ecdaa_revocation_snapshot_ZZZ *old = store->current;
+    store->current = snapshot;
+    // Drop the store's reference to the old snapshot.
+    int last_reference = (0 == --old->refcount);
+    pthread_mutex_unlock(&store->mutex);
+
+    if (last_reference)
+        snapshot_free_ZZZ(old);
+}
+
+int sk_is_removed_ZZZ(struct ecdaa_member_secret_key_ZZZ *sk,
+                      struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    for (size_t i = 0; i < delta->sk_removed_length; ++i) {
+        if (0 == BIG_XXX_comp(sk->sk, delta->sk_removed[i].sk))
+            return 1;
+    }
+
+    return 0;
+}
+
+int bsn_is_removed_ZZZ(ECP_ZZZ *bsn,
+                       struct ecdaa_revocation_delta_ZZZ *delta)
+{
+    for (size_t i = 0; i < delta->bsn_removed_length; ++i) {
+        if (ECP_ZZZ_equals(bsn, &delta->bsn_removed[i]))
+            return 1;
+    }
+
+    return 0;
+}
+
+int checked_add(size_t *sum_out, size_t lhs, size_t rhs)
+{
+    if (lhs > SIZE_MAX - rhs)
+        return -1;
+
+    *sum_out = lhs + rhs;
+
+    return 0;
+}
+
+int checked_mul(size_t *product_out, size_t count, size_t entry_size)
+{
+    if (0 != entry_size && count > SIZE_MAX / entry_size)
+        return -1;
+
+    *product_out = count * entry_size;
+
+    return 0;
+}
+
+void *malloc_array(size_t count, size_t entry_size)
+{
+    size_t size;
+    if (0 != checked_mul(&size, count, entry_size))
+        return NULL;
+
+    return malloc(size);
+}
+
+void put_uint32(uint8_t *buffer_out, uint32_t value)
+{
+    for (int i = 3; i >= 0; --i) {
+        buffer_out[i] = (uint8_t)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+void put_uint64(uint8_t *buffer_out, uint64_t value)
+{
+    for (int i = 7; i >= 0; --i) {
+        buffer_out[i] = (uint8_t)(value & 0xff);
+        value >>= 8;
+    }
+}
+
+uint32_t get_uint32(const uint8_t *buffer)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value = (value << 8) | buffer[i];
+
+    return value;
+}
+
+uint64_t get_uint64(const uint8_t *buffer)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value = (value << 8) | buffer[i];
+
+    return value;
+}
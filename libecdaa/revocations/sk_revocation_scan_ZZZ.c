@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include "sk_revocation_scan_ZZZ.h"
+
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <pthread.h>
+
+// How often (in entries) a shard checks whether another has found a match.
+#define EARLY_EXIT_CHECK_INTERVAL 32
+
+struct sk_scan_shared_ZZZ {
+    struct ecp_ZZZ_fixed_base_table *table;
+    ECP_ZZZ *W;
+    struct ecdaa_member_secret_key_ZZZ *sk_list;
+    int threaded;   // If not, `mutex` isn't used
+    pthread_mutex_t mutex;
+    int found;
+};
+
+struct sk_scan_shard_ZZZ {
+    struct sk_scan_shared_ZZZ *shared;
+    size_t begin;
+    size_t end;
+};
+
+static
+int table_scan_ZZZ(ECP_ZZZ *S,
+                   ECP_ZZZ *W,
+                   struct ecdaa_member_secret_key_ZZZ *sk_list,
+                   size_t sk_length,
+                   size_t num_threads);
+
+static
+void *scan_shard_ZZZ(void *shard_in);
+
+int sk_revocation_scan_ZZZ(ECP_ZZZ *S,
+                           ECP_ZZZ *W,
+                           struct ecdaa_member_secret_key_ZZZ *sk_list,
+                           size_t sk_length,
+                           size_t num_threads)
+{
+    if (sk_length >= SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD)
+        return table_scan_ZZZ(S, W, sk_list, sk_length, num_threads);
+
+    ECP_ZZZ Wcheck;
+    for (size_t i = 0; i < sk_length; ++i) {
+        ECP_ZZZ_copy(&Wcheck, S);
+        ecp_ZZZ_mul_vartime(&Wcheck, sk_list[i].sk);
+        if (ECP_ZZZ_equals(&Wcheck, W))
+            return -1;
+    }
+
+    return 0;
+}
+
+int table_scan_ZZZ(ECP_ZZZ *S,
+                   ECP_ZZZ *W,
+                   struct ecdaa_member_secret_key_ZZZ *sk_list,
+                   size_t sk_length,
+                   size_t num_threads)
+{
+    // 1) Build the table for S once, to be shared (read-only) by all shards.
+    struct ecp_ZZZ_fixed_base_table table;
+    ecp_ZZZ_fixed_base_table_build(&table, S);
+
+    struct sk_scan_shared_ZZZ shared = {.table=&table, .W=W, .sk_list=sk_list, .threaded=0, .found=0};
+
+    // 2) Decide how many shards to use.
+    size_t num_shards = sk_length / SK_REVOCATION_SCAN_ZZZ_MIN_ENTRIES_PER_THREAD;
+    if (num_shards > num_threads)
+        num_shards = num_threads;
+    if (num_shards > SK_REVOCATION_SCAN_ZZZ_MAX_THREADS)
+        num_shards = SK_REVOCATION_SCAN_ZZZ_MAX_THREADS;
+    if (num_shards > 1 && 0 == pthread_mutex_init(&shared.mutex, NULL))
+        shared.threaded = 1;
+
+    if (!shared.threaded) {
+        struct sk_scan_shard_ZZZ shard = {.shared=&shared, .begin=0, .end=sk_length};
+        scan_shard_ZZZ(&shard);
+        return shared.found ? -1 : 0;
+    }
+
+    // 3) Start a thread for every shard but the first, which the calling thread scans.
+    //      If a thread can't be started, its shard is scanned by the calling thread, too.
+    struct sk_scan_shard_ZZZ shards[SK_REVOCATION_SCAN_ZZZ_MAX_THREADS];
+    pthread_t threads[SK_REVOCATION_SCAN_ZZZ_MAX_THREADS];
+    int started[SK_REVOCATION_SCAN_ZZZ_MAX_THREADS] = {0};
+    for (size_t i = 0; i < num_shards; ++i) {
+        shards[i].shared = &shared;
+        shards[i].begin = i * sk_length / num_shards;
+        shards[i].end = (i + 1) * sk_length / num_shards;
+        if (i > 0)
+            started[i] = (0 == pthread_create(&threads[i], NULL, scan_shard_ZZZ, &shards[i]));
+    }
+
+    for (size_t i = 0; i < num_shards; ++i) {
+        if (!started[i])
+            scan_shard_ZZZ(&shards[i]);
+    }
+
+    for (size_t i = 1; i < num_shards; ++i) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&shared.mutex);
+
+    return shared.found ? -1 : 0;
+}
+
+void *scan_shard_ZZZ(void *shard_in)
+{
+    struct sk_scan_shard_ZZZ *shard = shard_in;
+    struct sk_scan_shared_ZZZ *shared = shard->shared;
+
+    ECP_ZZZ Wcheck;
+    for (size_t i = shard->begin; i < shard->end; ++i) {
+        // Stop early if another shard has found a match.
+        if (shared->threaded && 0 == (i - shard->begin) % EARLY_EXIT_CHECK_INTERVAL) {
+            pthread_mutex_lock(&shared->mutex);
+            int found = shared->found;
+            pthread_mutex_unlock(&shared->mutex);
+            if (found)
+                break;
+        }
+
+        ecp_ZZZ_fixed_base_mul_vartime(&Wcheck, shared->table, shared->sk_list[i].sk);
+        if (ECP_ZZZ_equals(&Wcheck, shared->W)) {
+            if (shared->threaded)
+                pthread_mutex_lock(&shared->mutex);
+            shared->found = 1;
+            if (shared->threaded)
+                pthread_mutex_unlock(&shared->mutex);
+            break;
+        }
+    }
+
+    return NULL;
+}
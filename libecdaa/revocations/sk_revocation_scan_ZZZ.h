@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#ifndef ECDAA_SK_REVOCATION_SCAN_ZZZ_H
+#define ECDAA_SK_REVOCATION_SCAN_ZZZ_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <amcl/ecp_ZZZ.h>
+
+#include <stddef.h>
+
+struct ecdaa_member_secret_key_ZZZ;
+
+/*
+ * Below this many entries, each sk*S is computed directly.
+ *  At or above it, a fixed-base table for S is built first
+ *  (see `ecp_ZZZ_fixed_base_table_build`).
+ */
+#define SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD 8
+
+/*
+ * Each extra thread must have at least this many entries to scan,
+ *  else its start-up cost isn't worth it.
+ */
+#define SK_REVOCATION_SCAN_ZZZ_MIN_ENTRIES_PER_THREAD 256
+
+#define SK_REVOCATION_SCAN_ZZZ_MAX_THREADS 64
+
+/*
+ * Check whether W == sk*S for any sk in `sk_list`.
+ *
+ * The scan is split across up to `num_threads` threads (including the calling thread),
+ *  and stops as soon as a match is found.
+ *
+ * Returns:
+ * 0 if there's no match
+ * -1 if there's a match
+ */
+int sk_revocation_scan_ZZZ(ECP_ZZZ *S,
+                           ECP_ZZZ *W,
+                           struct ecdaa_member_secret_key_ZZZ *sk_list,
+                           size_t sk_length,
+                           size_t num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,298 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include <amcl/big_XXX.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint8_t file_magic[8] = {'E', 'C', 'D', 'A', 'A', 'R', 'E', 'V'};
+
+// Lets a reader detect a file written on a machine with the other byte order.
+#define BYTE_ORDER_MARK 0x01020304
+
+#define CURVE_NAME_LENGTH 16
+
+// FNV-1a (64-bit)
+#define CHECKSUM_INITIAL 0xcbf29ce484222325ULL
+#define CHECKSUM_PRIME 0x100000001b3ULL
+
+/*
+ * On-disk header.
+ *  All fields are naturally aligned, so there's no padding.
+ */
+struct file_header_ZZZ {
+    uint8_t magic[8];
+    uint32_t version;
+    uint32_t byte_order_mark;
+    char curve[CURVE_NAME_LENGTH];
+    uint32_t chunk_bits;
+    uint32_t base_bits;
+    uint32_t sk_entry_length;
+    uint32_t bsn_entry_length;
+    uint64_t sk_length;
+    uint64_t sk_offset;
+    uint64_t bsn_length;
+    uint64_t bsn_offset;
+    uint64_t file_length;
+    uint64_t checksum;
+    uint8_t reserved[ECDAA_REVOCATIONS_FILE_HEADER_LENGTH - 96];
+};
+_Static_assert(sizeof(struct file_header_ZZZ) == ECDAA_REVOCATIONS_FILE_HEADER_LENGTH,
+               "file_header_ZZZ must fill exactly ECDAA_REVOCATIONS_FILE_HEADER_LENGTH bytes");
+
+static
+void header_init_ZZZ(struct file_header_ZZZ *header_out,
+                     size_t sk_length,
+                     size_t bsn_length);
+
+static
+uint64_t checksum_update(uint64_t checksum, const uint8_t *data, size_t data_length);
+
+static
+uint64_t header_checksum_ZZZ(const struct file_header_ZZZ *header);
+
+static
+uint64_t align_up(uint64_t offset);
+
+static
+int write_padded(FILE *file_ptr, const void *data, size_t data_length, size_t padded_length);
+
+void ecdaa_revocations_ZZZ_init(struct ecdaa_revocations_ZZZ *revocations_out)
+{
+    revocations_out->sk_length = 0;
+    revocations_out->sk_list = NULL;
+    revocations_out->bsn_length = 0;
+    revocations_out->bsn_list = NULL;
+    revocations_out->sk_scan_threads = 0;
+    revocations_out->bsn_set = NULL;
+    revocations_out->num_pseudonym_indexes = 0;
+    revocations_out->pseudonym_indexes = NULL;
+    revocations_out->sk_generation = 0;
+}
+
+int ecdaa_revocations_ZZZ_is_file(const uint8_t *buffer, size_t buffer_length)
+{
+    if (buffer_length < sizeof(file_magic))
+        return 0;
+
+    return 0 == memcmp(buffer, file_magic, sizeof(file_magic));
+}
+
+int ecdaa_revocations_ZZZ_write_file(const char *filename,
+                                     struct ecdaa_revocations_ZZZ *revocations)
+{
+    struct file_header_ZZZ header;
+    header_init_ZZZ(&header, revocations->sk_length, revocations->bsn_length);
+
+    size_t sk_bytes = revocations->sk_length * sizeof(struct ecdaa_member_secret_key_ZZZ);
+    size_t bsn_bytes = revocations->bsn_length * sizeof(ECP_ZZZ);
+
+    // The checksum covers the header (with a zero checksum field) and all entries,
+    //  so compute it before writing anything.
+    uint64_t checksum = header_checksum_ZZZ(&header);
+    checksum = checksum_update(checksum, (const uint8_t*)revocations->sk_list, sk_bytes);
+    uint8_t zeros[ECDAA_REVOCATIONS_FILE_ALIGNMENT] = {0};
+    checksum = checksum_update(checksum, zeros, header.bsn_offset - header.sk_offset - sk_bytes);
+    checksum = checksum_update(checksum, (const uint8_t*)revocations->bsn_list, bsn_bytes);
+    checksum = checksum_update(checksum, zeros, header.file_length - header.bsn_offset - bsn_bytes);
+    header.checksum = checksum;
+
+    FILE *file_ptr = fopen(filename, "wb");
+    if (NULL == file_ptr)
+        return -1;
+
+    int ret = 0;
+    if (0 != write_padded(file_ptr, &header, sizeof(header), header.sk_offset)
+            || 0 != write_padded(file_ptr, revocations->sk_list, sk_bytes, header.bsn_offset - header.sk_offset)
+            || 0 != write_padded(file_ptr, revocations->bsn_list, bsn_bytes, header.file_length - header.bsn_offset))
+        ret = -1;
+
+    if (0 != fclose(file_ptr))
+        ret = -1;
+
+    return ret;
+}
+
+int ecdaa_revocations_ZZZ_from_buffer(struct ecdaa_revocations_ZZZ *revocations_out,
+                                      const uint8_t *buffer,
+                                      size_t buffer_length)
+{
+    if (buffer_length < sizeof(struct file_header_ZZZ) || !ecdaa_revocations_ZZZ_is_file(buffer, buffer_length))
+        return -1;
+
+    struct file_header_ZZZ header;
+    memcpy(&header, buffer, sizeof(header));
+    if (ECDAA_REVOCATIONS_FILE_VERSION != header.version)
+        return -1;
+
+    // What we'd have written, for the same list lengths.
+    struct file_header_ZZZ expected;
+    header_init_ZZZ(&expected, header.sk_length, header.bsn_length);
+    if (expected.byte_order_mark != header.byte_order_mark
+            || 0 != memcmp(expected.curve, header.curve, sizeof(header.curve))
+            || expected.chunk_bits != header.chunk_bits
+            || expected.base_bits != header.base_bits
+            || expected.sk_entry_length != header.sk_entry_length
+            || expected.bsn_entry_length != header.bsn_entry_length)
+        return -2;
+
+    // Guard against lengths so large the offsets overflowed.
+    if (header.sk_length > buffer_length / sizeof(struct ecdaa_member_secret_key_ZZZ)
+            || header.bsn_length > buffer_length / sizeof(ECP_ZZZ)
+            || expected.sk_offset != header.sk_offset
+            || expected.bsn_offset != header.bsn_offset
+            || expected.file_length != header.file_length
+            || header.file_length > buffer_length)
+        return -3;
+
+    uint64_t checksum = header_checksum_ZZZ(&header);
+    checksum = checksum_update(checksum,
+                               buffer + ECDAA_REVOCATIONS_FILE_HEADER_LENGTH,
+                               header.file_length - ECDAA_REVOCATIONS_FILE_HEADER_LENGTH);
+    if (checksum != header.checksum)
+        return -3;
+
+    // The library only ever reads through these pointers.
+    revocations_out->sk_length = header.sk_length;
+    revocations_out->sk_list = (struct ecdaa_member_secret_key_ZZZ*)(uintptr_t)(buffer + header.sk_offset);
+    revocations_out->bsn_length = header.bsn_length;
+    revocations_out->bsn_list = (ECP_ZZZ*)(uintptr_t)(buffer + header.bsn_offset);
+    revocations_out->sk_generation = header.checksum;
+    if (0 == header.sk_length)
+        revocations_out->sk_list = NULL;
+    if (0 == header.bsn_length)
+        revocations_out->bsn_list = NULL;
+
+    return 0;
+}
+
+int ecdaa_revocations_ZZZ_map_file(struct ecdaa_revocations_ZZZ *revocations_out,
+                                   struct ecdaa_revocations_file_ZZZ *file_out,
+                                   const char *filename)
+{
+    file_out->map = NULL;
+    file_out->map_length = 0;
+
+    int fd = open(filename, O_RDONLY);
+    if (-1 == fd)
+        return -4;
+
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat)) {
+        close(fd);
+        return -4;
+    }
+
+    if ((size_t)file_stat.st_size < sizeof(struct file_header_ZZZ)) {
+        close(fd);
+        return -1;
+    }
+
+    // mmap'd memory is page-aligned, so the entries are aligned, too.
+    void *map = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+        return -4;
+
+    int ret = ecdaa_revocations_ZZZ_from_buffer(revocations_out, map, (size_t)file_stat.st_size);
+    if (0 != ret) {
+        munmap(map, (size_t)file_stat.st_size);
+        return ret;
+    }
+
+    file_out->map = map;
+    file_out->map_length = (size_t)file_stat.st_size;
+
+    return 0;
+}
+
+void ecdaa_revocations_ZZZ_unmap_file(struct ecdaa_revocations_file_ZZZ *file)
+{
+    if (NULL != file->map)
+        munmap(file->map, file->map_length);
+
+    file->map = NULL;
+    file->map_length = 0;
+}
+
+void header_init_ZZZ(struct file_header_ZZZ *header_out,
+                     size_t sk_length,
+                     size_t bsn_length)
+{
+    memset(header_out, 0, sizeof(*header_out));
+
+    memcpy(header_out->magic, file_magic, sizeof(file_magic));
+    header_out->version = ECDAA_REVOCATIONS_FILE_VERSION;
+    header_out->byte_order_mark = BYTE_ORDER_MARK;
+    strncpy(header_out->curve, "ZZZ", sizeof(header_out->curve) - 1);
+    header_out->chunk_bits = 8 * sizeof(chunk);
+    header_out->base_bits = BASEBITS_XXX;
+    header_out->sk_entry_length = sizeof(struct ecdaa_member_secret_key_ZZZ);
+    header_out->bsn_entry_length = sizeof(ECP_ZZZ);
+
+    header_out->sk_length = sk_length;
+    header_out->sk_offset = align_up(ECDAA_REVOCATIONS_FILE_HEADER_LENGTH);
+    header_out->bsn_length = bsn_length;
+    header_out->bsn_offset = align_up(header_out->sk_offset + sk_length * sizeof(struct ecdaa_member_secret_key_ZZZ));
+    header_out->file_length = align_up(header_out->bsn_offset + bsn_length * sizeof(ECP_ZZZ));
+}
+
+uint64_t checksum_update(uint64_t checksum, const uint8_t *data, size_t data_length)
+{
+    for (size_t i = 0; i < data_length; ++i) {
+        checksum ^= data[i];
+        checksum *= CHECKSUM_PRIME;
+    }
+
+    return checksum;
+}
+
+uint64_t header_checksum_ZZZ(const struct file_header_ZZZ *header)
+{
+    struct file_header_ZZZ zeroed;
+    memcpy(&zeroed, header, sizeof(zeroed));
+    zeroed.checksum = 0;
+
+    return checksum_update(CHECKSUM_INITIAL, (const uint8_t*)&zeroed, sizeof(zeroed));
+}
+
+uint64_t align_up(uint64_t offset)
+{
+    return (offset + ECDAA_REVOCATIONS_FILE_ALIGNMENT - 1) & ~(uint64_t)(ECDAA_REVOCATIONS_FILE_ALIGNMENT - 1);
+}
+
+int write_padded(FILE *file_ptr, const void *data, size_t data_length, size_t padded_length)
+{
+    if (0 != data_length && data_length != fwrite(data, 1, data_length, file_ptr))
+        return -1;
+
+    static const uint8_t zeros[ECDAA_REVOCATIONS_FILE_ALIGNMENT] = {0};
+    size_t padding = padded_length - data_length;
+    if (0 != padding && padding != fwrite(zeros, 1, padding, file_ptr))
+        return -1;
+
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "amcl-extensions/big_XXX.h"
 #include "amcl-extensions/ecp_ZZZ.h"
 #include "amcl-extensions/ecp2_ZZZ.h"
+#include "internal-utilities/sha256.h"
 
 #include <amcl/ecp_ZZZ.h>
 #include <amcl/amcl.h>
@@ -35,16 +36,16 @@ enum {
 };
 
 static
-int commit(ECP_ZZZ *P1,
-           BIG_XXX private_key,
-           const uint8_t *s2,
-           uint32_t s2_length,
-           BIG_XXX *k,
-           ECP_ZZZ *P2,
-           ECP_ZZZ *K,
-           ECP_ZZZ *L,
-           ECP_ZZZ *E,
-           ecdaa_rand_func get_random);
+void commit(ECP_ZZZ *P1,
+            BIG_XXX private_key,
+            ECP_ZZZ *P2,
+            struct ecp_ZZZ_fixed_base_table *P2_table,
+            ECP_ZZZ *K_in,
+            BIG_XXX *k,
+            ECP_ZZZ *K,
+            ECP_ZZZ *L,
+            ECP_ZZZ *E,
+            ecdaa_rand_func get_random);
 
 void schnorr_keygen_ZZZ(ECP_ZZZ *public_out,
                         BIG_XXX *private_out,
@@ -52,9 +53,7 @@ void schnorr_keygen_ZZZ(ECP_ZZZ *public_out,
 {
     ecp_ZZZ_random_mod_order(private_out, get_random);
 
-    ecp_ZZZ_set_to_generator(public_out);
-
-    ECP_ZZZ_mul(public_out, *private_out);
+    ecp_ZZZ_mul_generator(public_out, *private_out);
 }
 
 int schnorr_sign_ZZZ(BIG_XXX *c_out,
@@ -70,36 +69,136 @@ int schnorr_sign_ZZZ(BIG_XXX *c_out,
                      uint32_t basename_len,
                      ecdaa_rand_func get_random)
 {
-    // 1) (Commit)
-    ECP_ZZZ R, L, P2;
+    if (NULL == basename && 0 == basename_len) {
+        return schnorr_sign_with_basename_point_ZZZ(c_out, s_out, n_out, K_out, msg_in, msg_len, basepoint, public_key, private_key,
+                                                    NULL, 0, NULL, NULL, NULL, get_random);
+    }
+
+    // If any of these is non-zero, ALL must be non-zero.
+    if (NULL == basename || 0 == basename_len || NULL == K_out)
+        return -1;
+
+    // Find P2 by hashing basename
+    ECP_ZZZ P2;
+    int32_t hash_ret = ecp_ZZZ_fromhash(&P2, basename, basename_len);
+    if (hash_ret < 0)
+        return -1;
+
+    return schnorr_sign_with_basename_point_ZZZ(c_out, s_out, n_out, K_out, msg_in, msg_len, basepoint, public_key, private_key,
+                                                basename, basename_len, &P2, NULL, NULL, get_random);
+}
+
+int schnorr_basename_point_ZZZ(ECP_ZZZ *P2_out,
+                               const uint8_t *basename,
+                               uint32_t basename_len,
+                               enum ecdaa_hash_to_curve hash_to_curve)
+{
+    switch (hash_to_curve) {
+        case ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT:
+            if (ecp_ZZZ_fromhash(P2_out, basename, basename_len) < 0)
+                return -1;
+            return 0;
+        case ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI:
+            if (0 != ecp_ZZZ_fromhash_fouque_tibouchi(P2_out, basename, basename_len))
+                return -1;
+            return 0;
+    }
+
+    return -1;
+}
+
+int schnorr_sign_with_basename_point_ZZZ(BIG_XXX *c_out,
+                                         BIG_XXX *s_out,
+                                         BIG_XXX *n_out,
+                                         ECP_ZZZ *K_out,
+                                         const uint8_t *msg_in,
+                                         uint32_t msg_len,
+                                         ECP_ZZZ *basepoint,
+                                         ECP_ZZZ *public_key,
+                                         BIG_XXX private_key,
+                                         const uint8_t *basename,
+                                         uint32_t basename_len,
+                                         ECP_ZZZ *P2,
+                                         struct ecp_ZZZ_fixed_base_table *P2_table,
+                                         ECP_ZZZ *K_in,
+                                         ecdaa_rand_func get_random)
+{
+    // 1-2) Commit, and start the first hash
+    struct ecdaa_sha256 hash;
     BIG_XXX k;
-    int commit_ret = commit(basepoint, private_key, basename, basename_len, &k, &P2, K_out, &L, &R, get_random);
-    if (0 != commit_ret)
+    if (0 != schnorr_sign_begin_ZZZ(&hash, &k, K_out, basepoint, public_key, private_key,
+                                    basename, basename_len, P2, P2_table, K_in, get_random))
         return -1;
 
-    // 2) (Sign 1) Compute first hash
-    //      (modular-reduce c', too).
-    BIG_XXX c_prime;
+    ecdaa_sha256_update(&hash, msg_in, msg_len);
+
+    // 3-5) Finish the first hash, and sign
+    schnorr_sign_finish_ZZZ(c_out, s_out, n_out, &hash, &k, private_key, get_random);
+
+    return 0;
+}
+
+int schnorr_sign_begin_ZZZ(struct ecdaa_sha256 *hash_out,
+                           BIG_XXX *k_out,
+                           ECP_ZZZ *K_out,
+                           ECP_ZZZ *basepoint,
+                           ECP_ZZZ *public_key,
+                           BIG_XXX private_key,
+                           const uint8_t *basename,
+                           uint32_t basename_len,
+                           ECP_ZZZ *P2,
+                           struct ecp_ZZZ_fixed_base_table *P2_table,
+                           ECP_ZZZ *K_in,
+                           ecdaa_rand_func get_random)
+{
+    if (0 != basename_len && (NULL == basename || NULL == P2 || NULL == K_out))
+        return -1;
+    if (0 == basename_len)
+        P2 = NULL;
+
+    // 1) (Commit)
+    ECP_ZZZ R, L;
+    commit(basepoint, private_key, P2, P2_table, K_in, k_out, K_out, &L, &R, get_random);
+
+    // 2) (Sign 1) Start first hash
+    ecdaa_sha256_init(hash_out);
     if (basename_len != 0) {
-        // Compute c' = Hash( R | basepoint | public_key | L | P2 | K_out | basename | msg_in )
+        // c' = Hash( R | basepoint | public_key | L | P2 | K_out | basename | msg_in )
         uint8_t hash_input_begin[SIX_ECP_LENGTH];
         assert(6*ECP_ZZZ_LENGTH == sizeof(hash_input_begin));
         ecp_ZZZ_serialize(hash_input_begin, &R);
         ecp_ZZZ_serialize(hash_input_begin+ECP_ZZZ_LENGTH, basepoint);
         ecp_ZZZ_serialize(hash_input_begin+2*ECP_ZZZ_LENGTH, public_key);
         ecp_ZZZ_serialize(hash_input_begin+3*ECP_ZZZ_LENGTH, &L);
-        ecp_ZZZ_serialize(hash_input_begin+4*ECP_ZZZ_LENGTH, &P2);
+        ecp_ZZZ_serialize(hash_input_begin+4*ECP_ZZZ_LENGTH, P2);
         ecp_ZZZ_serialize(hash_input_begin+5*ECP_ZZZ_LENGTH, K_out);
-        big_XXX_from_three_message_hash(&c_prime, hash_input_begin, sizeof(hash_input_begin), basename, basename_len, msg_in, msg_len);
+        ecdaa_sha256_update(hash_out, hash_input_begin, sizeof(hash_input_begin));
+        ecdaa_sha256_update(hash_out, basename, basename_len);
     } else {
-        // Compute c' = Hash( R | basepoint | public_key | msg_in )
+        // c' = Hash( R | basepoint | public_key | msg_in )
         uint8_t hash_input_begin[THREE_ECP_LENGTH];
         assert(3*ECP_ZZZ_LENGTH == sizeof(hash_input_begin));
         ecp_ZZZ_serialize(hash_input_begin, &R);
         ecp_ZZZ_serialize(hash_input_begin+ECP_ZZZ_LENGTH, basepoint);
         ecp_ZZZ_serialize(hash_input_begin+2*ECP_ZZZ_LENGTH, public_key);
-        big_XXX_from_two_message_hash(&c_prime, hash_input_begin, sizeof(hash_input_begin), msg_in, msg_len);
+        ecdaa_sha256_update(hash_out, hash_input_begin, sizeof(hash_input_begin));
     }
+
+    return 0;
+}
+
+void schnorr_sign_finish_ZZZ(BIG_XXX *c_out,
+                             BIG_XXX *s_out,
+                             BIG_XXX *n_out,
+                             struct ecdaa_sha256 *hash,
+                             BIG_XXX *k,
+                             BIG_XXX private_key,
+                             ecdaa_rand_func get_random)
+{
+    // 2) (Sign 1) Finish first hash
+    //      (modular-reduce c', too).
+    BIG_XXX c_prime;
+    big_XXX_from_sha256(&c_prime, hash);
     BIG_XXX curve_order;
     BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
     BIG_XXX_mod(c_prime, curve_order);
@@ -115,12 +214,10 @@ int schnorr_sign_ZZZ(BIG_XXX *c_out,
     big_XXX_from_hash(c_out, final_hash_input_begin, sizeof(final_hash_input_begin));
 
     // 5) (Sign 4) Compute s = k + c_out * private_key
-    big_XXX_mod_mul_and_add(s_out, k, *c_out, private_key, curve_order);    // normalizes and mod-reduces s_out and c_out
+    big_XXX_mod_mul_and_add(s_out, *k, *c_out, private_key, curve_order);    // normalizes and mod-reduces s_out and c_out
 
     // Clear intermediate, sensitive memory.
-    explicit_bzero(&k, sizeof(BIG_XXX));
-
-    return 0;
+    explicit_bzero(k, sizeof(BIG_XXX));
 }
 
 int schnorr_verify_ZZZ(BIG_XXX c,
@@ -134,82 +231,174 @@ int schnorr_verify_ZZZ(BIG_XXX c,
                        const uint8_t *basename,
                        uint32_t basename_len)
 {
+    if (0 == basename_len) {
+        return schnorr_verify_with_basename_point_ZZZ(c, s, n, K, msg_in, msg_len, basepoint, public_key,
+                                                      basename, basename_len, NULL, NULL);
+    }
+
+    // 1ii) Find P2 by hashing basename
+    ECP_ZZZ P2;
+    int32_t hash_ret = ecp_ZZZ_fromhash(&P2, basename, basename_len);
+    if (hash_ret < 0)
+        return -2;
+
+    return schnorr_verify_with_basename_point_ZZZ(c, s, n, K, msg_in, msg_len, basepoint, public_key,
+                                                  basename, basename_len, &P2, NULL);
+}
+
+int schnorr_verify_with_basename_point_ZZZ(BIG_XXX c,
+                                           BIG_XXX s,
+                                           BIG_XXX n,
+                                           ECP_ZZZ *K,
+                                           const uint8_t *msg_in,
+                                           uint32_t msg_len,
+                                           ECP_ZZZ *basepoint,
+                                           ECP_ZZZ *public_key,
+                                           const uint8_t *basename,
+                                           uint32_t basename_len,
+                                           ECP_ZZZ *P2,
+                                           struct ecp_ZZZ_fixed_base_table *P2_table)
+{
+    // 1-4) Compute R (and L), and start the inner hash
+    struct ecdaa_sha256 hash;
+    if (0 != schnorr_verify_begin_ZZZ(&hash, c, s, K, basepoint, public_key, basename, basename_len, P2, P2_table))
+        return -2;
+
+    ecdaa_sha256_update(&hash, msg_in, msg_len);
+
+    // 5-7) Finish the inner hash, and check c
+    return schnorr_verify_finish_ZZZ(c, n, &hash);
+}
+
+int schnorr_verify_begin_ZZZ(struct ecdaa_sha256 *hash_out,
+                             BIG_XXX c,
+                             BIG_XXX s,
+                             ECP_ZZZ *K,
+                             ECP_ZZZ *basepoint,
+                             ECP_ZZZ *public_key,
+                             const uint8_t *basename,
+                             uint32_t basename_len,
+                             ECP_ZZZ *P2,
+                             struct ecp_ZZZ_fixed_base_table *P2_table)
+{
+    // 1-4) Compute R (and L), and serialize the points
+    uint8_t transcript[SCHNORR_ZZZ_TRANSCRIPT_MAX_LENGTH];
+    uint32_t transcript_length;
+    if (0 != schnorr_verify_transcript_ZZZ(transcript, &transcript_length, c, s, K, basepoint, public_key, basename_len, P2, P2_table))
+        return -2;
+
+    // 5) Start inner hash
+    //  c'' = Hash( R | basepoint | public_key | L | P2 | K | basename | msg_in )
+    //   or Hash( R | basepoint | public_key | msg_in ), without a basename
+    ecdaa_sha256_init(hash_out);
+    ecdaa_sha256_update(hash_out, transcript, transcript_length);
+    ecdaa_sha256_update(hash_out, basename, basename_len);
+
+    return 0;
+}
+
+int schnorr_verify_finish_ZZZ(BIG_XXX c,
+                              BIG_XXX n,
+                              struct ecdaa_sha256 *hash)
+{
+    // 5) Finish inner hash
+    BIG_XXX c_dbl_prime;
+    big_XXX_from_sha256(&c_dbl_prime, hash);
+
+    // 6) Compute final hash c' = Hash(n | c'')
+    BIG_XXX c_prime;
+    uint8_t final_hash_input[SCHNORR_ZZZ_CHALLENGE_INPUT_LENGTH];
+    schnorr_verify_challenge_input_ZZZ(final_hash_input, n, c_dbl_prime);
+    big_XXX_from_hash(&c_prime, final_hash_input, sizeof(final_hash_input));
+
+    // 7) Compare c' and c
+    return schnorr_verify_challenge_ZZZ(c, c_prime);
+}
+
+int schnorr_verify_transcript_ZZZ(uint8_t *transcript_out,
+                                  uint32_t *transcript_length_out,
+                                  BIG_XXX c,
+                                  BIG_XXX s,
+                                  ECP_ZZZ *K,
+                                  ECP_ZZZ *basepoint,
+                                  ECP_ZZZ *public_key,
+                                  uint32_t basename_len,
+                                  ECP_ZZZ *P2,
+                                  struct ecp_ZZZ_fixed_base_table *P2_table)
+{
+    if (0 != basename_len && NULL == P2)
+        return -2;
+
     // 1) Check public key for validity
     // NOTE: We assume the public key was obtained from `deserialize`,
     //  which checked its validity.
 
-    // 2) Multiply basepoint by s (R = s*P)
+    // 2-4) Compute R = s*P - c*public_key,
+    //  as one double-scalar multiplication (sharing the doublings).
+    ECP_ZZZ neg_public_key;
+    ECP_ZZZ_copy(&neg_public_key, public_key);
+    ECP_ZZZ_neg(&neg_public_key);
+
     ECP_ZZZ R;
-    ECP_ZZZ_copy(&R, basepoint);
-    ECP_ZZZ_mul(&R, s);
+    ecp_ZZZ_mul2(&R, basepoint, s, &neg_public_key, c);
 
-    // 3) Multiply public_key by c (Q_c = c *public_key)
-    ECP_ZZZ Q_c;
-    ECP_ZZZ_copy(&Q_c, public_key);
-    ECP_ZZZ_mul(&Q_c, c);
+    ecp_ZZZ_serialize(transcript_out, &R);
+    ecp_ZZZ_serialize(transcript_out+ECP_ZZZ_LENGTH, basepoint);
+    ecp_ZZZ_serialize(transcript_out+2*ECP_ZZZ_LENGTH, public_key);
 
-    // 4) Compute difference of R and c*Q, and save to R (R = s*P - c*public_key)
-    ECP_ZZZ_sub(&R, &Q_c);
-    // Nb. No need to call ECP_ZZZ_affine here,
-    // as R gets passed to ECP_ZZZ_toOctet in a minute (which implicitly converts to affine)
+    if (0 == basename_len) {
+        *transcript_length_out = THREE_ECP_LENGTH;
+        return 0;
+    }
 
-    // 5) Compute inner hash
-    //      (modular-reduce c'', too)
-    BIG_XXX c_dbl_prime;
-    if (0 != basename_len) {
-        // 1,2,3,4 part ii) If checking a basename signature:
-        ECP_ZZZ P2;
-        ECP_ZZZ L;
-        // 1ii) Find P2 by hashing basename
-        int32_t hash_ret = ecp_ZZZ_fromhash(&P2, basename, basename_len);
-        if (hash_ret < 0)
-            return -2;
-
-        // 2ii) Multiply P2 by s (L = s*P2)
-        ECP_ZZZ_copy(&L, &P2);
-        ECP_ZZZ_mul(&L, s);
-
-        // 3) Multiply K by c (K_c = c *K)
-        ECP_ZZZ K_c;
-        ECP_ZZZ_copy(&K_c, K);
-        ECP_ZZZ_mul(&K_c, c);
-
-        // 4) Compute difference of L and c*K, and save to L (L = s*P2 - c*K)
-        ECP_ZZZ_sub(&L, &K_c);
-
-        // c'' = Hash( R | basepoint | public_key | L | P2 | K | basename | msg_in )
-        uint8_t hash_input_begin[SIX_ECP_LENGTH];
-        assert(6*ECP_ZZZ_LENGTH == sizeof(hash_input_begin));
-        ecp_ZZZ_serialize(hash_input_begin, &R);
-        ecp_ZZZ_serialize(hash_input_begin+ECP_ZZZ_LENGTH, basepoint);
-        ecp_ZZZ_serialize(hash_input_begin+2*ECP_ZZZ_LENGTH, public_key);
-        ecp_ZZZ_serialize(hash_input_begin+3*ECP_ZZZ_LENGTH, &L);
-        ecp_ZZZ_serialize(hash_input_begin+4*ECP_ZZZ_LENGTH, &P2);
-        ecp_ZZZ_serialize(hash_input_begin+5*ECP_ZZZ_LENGTH, K);
-        big_XXX_from_three_message_hash(&c_dbl_prime, hash_input_begin, sizeof(hash_input_begin), basename, basename_len, msg_in, msg_len);
+    // 2,3,4 part ii) If checking a basename signature:
+    ECP_ZZZ L;
+    ECP_ZZZ neg_K;
+    ECP_ZZZ_copy(&neg_K, K);
+    ECP_ZZZ_neg(&neg_K);
+    if (NULL != P2_table) {
+        // 2ii-4ii) Compute L = s*P2 - c*K,
+        //  with s*P2 from the table (no doublings).
+        ECP_ZZZ cK;
+        ecp_ZZZ_fixed_base_mul_vartime(&L, P2_table, s);
+        ECP_ZZZ_copy(&cK, &neg_K);
+        ecp_ZZZ_mul_vartime(&cK, c);
+        ECP_ZZZ_add(&L, &cK);
     } else {
-        // c'' = Hash( R | basepoint | public_key | msg_in )
-        uint8_t hash_input_begin[THREE_ECP_LENGTH];
-        assert(3*ECP_ZZZ_LENGTH == sizeof(hash_input_begin));
-        ecp_ZZZ_serialize(hash_input_begin, &R);
-        ecp_ZZZ_serialize(hash_input_begin+ECP_ZZZ_LENGTH, basepoint);
-        ecp_ZZZ_serialize(hash_input_begin+2*ECP_ZZZ_LENGTH, public_key);
-        big_XXX_from_two_message_hash(&c_dbl_prime, hash_input_begin, sizeof(hash_input_begin), msg_in, msg_len);
+        // 2ii-4ii) Compute L = s*P2 - c*K,
+        //  as one double-scalar multiplication.
+        ecp_ZZZ_mul2(&L, P2, s, &neg_K, c);
     }
+
+    ecp_ZZZ_serialize(transcript_out+3*ECP_ZZZ_LENGTH, &L);
+    ecp_ZZZ_serialize(transcript_out+4*ECP_ZZZ_LENGTH, P2);
+    ecp_ZZZ_serialize(transcript_out+5*ECP_ZZZ_LENGTH, K);
+    *transcript_length_out = SIX_ECP_LENGTH;
+
+    return 0;
+}
+
+void schnorr_verify_challenge_input_ZZZ(uint8_t *input_out,
+                                        BIG_XXX n,
+                                        BIG_XXX c_dbl_prime)
+{
+    // (modular-reduce c'', first)
     BIG_XXX curve_order;
     BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
     BIG_XXX_mod(c_dbl_prime, curve_order);
 
-    // 6) Compute final hash c' = Hash(n | c'')
-    //      (modular-reduce c', too).
-    BIG_XXX c_prime;
-    uint8_t final_hash_input_begin[2*MODBYTES_XXX];
-    BIG_XXX_toBytes((char*)final_hash_input_begin, n);
-    BIG_XXX_toBytes((char*)(final_hash_input_begin+MODBYTES_XXX), c_dbl_prime);
-    big_XXX_from_hash(&c_prime, final_hash_input_begin, sizeof(final_hash_input_begin));
+    BIG_XXX_toBytes((char*)input_out, n);
+    BIG_XXX_toBytes((char*)(input_out+MODBYTES_XXX), c_dbl_prime);
+}
+
+int schnorr_verify_challenge_ZZZ(BIG_XXX c,
+                                 BIG_XXX c_prime)
+{
+    // (modular-reduce c', too)
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
     BIG_XXX_mod(c_prime, curve_order);
 
-    // 6) Compare c' and c
     if (0 != BIG_XXX_comp(c_prime, c)) {
         return -1;
     }
@@ -236,8 +425,7 @@ int credential_schnorr_sign_ZZZ(BIG_XXX *c_out,
 
     // 3) Multiply generator by r: U = r*generator
     ECP_ZZZ U;
-    ECP_ZZZ_copy(&U, &generator);
-    ECP_ZZZ_mul(&U, r);
+    ecp_ZZZ_mul_generator(&U, r);
 
     // 4) Multiply member_public_key by r: V = r*member_public_key
     ECP_ZZZ V;
@@ -280,35 +468,22 @@ int credential_schnorr_verify_ZZZ(BIG_XXX c,
     ECP_ZZZ generator;
     ecp_ZZZ_set_to_generator(&generator);
 
-    // 2) Multiply generator by s (R1 = s*P)
-    ECP_ZZZ R1;
-    ECP_ZZZ_copy(&R1, &generator);
-    ECP_ZZZ_mul(&R1, s);
+    // 2-4) Compute R1 = s*P - c*B,
+    //  as one double-scalar multiplication (sharing the doublings).
+    ECP_ZZZ neg_B;
+    ECP_ZZZ_copy(&neg_B, B);
+    ECP_ZZZ_neg(&neg_B);
 
-    // 3) Multiply B by c (B_c = c*B)
-    ECP_ZZZ B_c;
-    ECP_ZZZ_copy(&B_c, B);
-    ECP_ZZZ_mul(&B_c, c);
+    ECP_ZZZ R1;
+    ecp_ZZZ_mul2(&R1, &generator, s, &neg_B, c);
 
-    // 4) Compute difference of R1 and c*B, and save to R1 (R1 = s*P - c*B)
-    ECP_ZZZ_sub(&R1, &B_c);
-    // Nb. No need to call ECP_ZZZ_affine here,
-    // as R1 gets passed to ECP_ZZZ_toOctet in a minute (which implicitly converts to affine)
+    // 5-7) Compute R2 = s*member_public_key - c*D, likewise.
+    ECP_ZZZ neg_D;
+    ECP_ZZZ_copy(&neg_D, D);
+    ECP_ZZZ_neg(&neg_D);
 
-    // 5) Multiply member_public_key by s (R2 = s*member_public_key)
     ECP_ZZZ R2;
-    ECP_ZZZ_copy(&R2, member_public_key);
-    ECP_ZZZ_mul(&R2, s);
-
-    // 6) Multiply D by c (D_c = c*D)
-    ECP_ZZZ D_c;
-    ECP_ZZZ_copy(&D_c, D);
-    ECP_ZZZ_mul(&D_c, c);
-
-    // 7) Compute difference of R2 and c*D, and save to R2 (R2 = s*member_public_key - c*D)
-    ECP_ZZZ_sub(&R2, &D_c);
-    // Nb. No need to call ECP_ZZZ_affine here,
-    // as R2 gets passed to ECP_ZZZ_toOctet in a minute (which implicitly converts to affine)
+    ecp_ZZZ_mul2(&R2, member_public_key, s, &neg_D, c);
 
     // 8) Compute c' = Hash( R1 | R2 | generator | B | member_public_key | D )
     //      (modular-reduce c', too).
@@ -397,35 +572,22 @@ int issuer_schnorr_verify_ZZZ(BIG_XXX c,
     ECP2_ZZZ generator_2;
     ecp2_ZZZ_set_to_generator(&generator_2);
 
-    // 2) Multiply generator_2 by sx (R1 = sx*P2)
-    ECP2_ZZZ R1;
-    ECP2_ZZZ_copy(&R1, &generator_2);
-    ECP2_ZZZ_mul(&R1, sx);
+    // 2-4) Compute R1 = sx*P2 - c*X,
+    //  as one double-scalar multiplication (sharing the doublings).
+    ECP2_ZZZ neg_X;
+    ECP2_ZZZ_copy(&neg_X, X);
+    ECP2_ZZZ_neg(&neg_X);
 
-    // 3) Multiply X by c (X_c = c*X)
-    ECP2_ZZZ X_c;
-    ECP2_ZZZ_copy(&X_c, X);
-    ECP2_ZZZ_mul(&X_c, c);
+    ECP2_ZZZ R1;
+    ecp2_ZZZ_mul2(&R1, &generator_2, sx, &neg_X, c);
 
-    // 4) Compute difference of R1 and c*X, and save to R1 (R1 = sx*P2 - c*X)
-    ECP2_ZZZ_sub(&R1, &X_c);
-    // Nb. No need to call ECP2_ZZZ_affine here,
-    // as R1 gets passed to ECP2_ZZZ_toOctet in a minute (which implicitly converts to affine)
+    // 5-7) Compute R2 = sy*P2 - c*Y, likewise.
+    ECP2_ZZZ neg_Y;
+    ECP2_ZZZ_copy(&neg_Y, Y);
+    ECP2_ZZZ_neg(&neg_Y);
 
-    // 5) Multiply generator_2 by sy (R2 = sy*P2)
     ECP2_ZZZ R2;
-    ECP2_ZZZ_copy(&R2, &generator_2);
-    ECP2_ZZZ_mul(&R2, sy);
-
-    // 6) Multiply Y by c (Y_c = c*Y)
-    ECP2_ZZZ Y_c;
-    ECP2_ZZZ_copy(&Y_c, Y);
-    ECP2_ZZZ_mul(&Y_c, c);
-
-    // 7) Compute difference of R2 and c*Y, and save to R2 (R2 = sy*P2 - c*Y)
-    ECP2_ZZZ_sub(&R2, &Y_c);
-    // Nb. No need to call ECP2_ZZZ_affine here,
-    // as R2 gets passed to ECP2_ZZZ_toOctet in a minute (which implicitly converts to affine)
+    ecp2_ZZZ_mul2(&R2, &generator_2, sy, &neg_Y, c);
 
     // 8) Compute c' = Hash( R1 | R2 | generator_2 | X | Y )
     //      (modular-reduce c', too).
@@ -450,16 +612,16 @@ int issuer_schnorr_verify_ZZZ(BIG_XXX c,
     return 0;
 }
 
-int commit(ECP_ZZZ *P1,
-           BIG_XXX private_key,
-           const uint8_t *s2,
-           uint32_t s2_length,
-           BIG_XXX *k,
-           ECP_ZZZ *P2,
-           ECP_ZZZ *K,
-           ECP_ZZZ *L,
-           ECP_ZZZ *E,
-           ecdaa_rand_func get_random)
+void commit(ECP_ZZZ *P1,
+            BIG_XXX private_key,
+            ECP_ZZZ *P2,
+            struct ecp_ZZZ_fixed_base_table *P2_table,
+            ECP_ZZZ *K_in,
+            BIG_XXX *k,
+            ECP_ZZZ *K,
+            ECP_ZZZ *L,
+            ECP_ZZZ *E,
+            ecdaa_rand_func get_random)
 {
     // 1) Verify P1 belongs to group
     // NOTE: We assume the P1 was obtained from a call to set_to_generator,
@@ -468,28 +630,26 @@ int commit(ECP_ZZZ *P1,
     // 2) Choose random k <- Z_n
     ecp_ZZZ_random_mod_order(k, get_random);
 
-    // 3) If s2 is provided,
-    //  3i) Do K = [private_key](x2,y2),
-    //  3ii) Do [k](x2,y2)
-    if (NULL != s2 || 0 != s2_length) {
-        // If any of these is non-zero, ALL must be non-zero.
-        if (NULL == s2 || 0 == s2_length || NULL == K)
-            return -1;
-
-        int32_t hash_ret = ecp_ZZZ_fromhash(P2, s2, s2_length);
-        if (hash_ret < 0)
-            return -1;
-        ECP_ZZZ_copy(L, P2);
-        ECP_ZZZ_copy(K, P2);
-
-        ECP_ZZZ_mul(K, private_key);
-
-        ECP_ZZZ_mul(L, *k);
+    // 3) If P2 is provided,
+    //  3i) Do K = [private_key]P2 (unless it's already known),
+    //  3ii) Do L = [k]P2 (using P2's table, if provided)
+    if (NULL != P2) {
+        if (NULL != K_in) {
+            ECP_ZZZ_copy(K, K_in);
+        } else {
+            ECP_ZZZ_copy(K, P2);
+            ECP_ZZZ_mul(K, private_key);
+        }
+
+        if (NULL != P2_table) {
+            ecp_ZZZ_fixed_base_mul(L, P2_table, *k);
+        } else {
+            ECP_ZZZ_copy(L, P2);
+            ECP_ZZZ_mul(L, *k);
+        }
     }
 
     // 4) Multiply P1 by k: E = k*P1
     ECP_ZZZ_copy(E, P1);
     ECP_ZZZ_mul(E, *k);
-
-    return 0;
 }
@@ -24,8 +24,12 @@
 extern "C" {
 #endif
 
+#include <ecdaa/hash_to_curve.h>
 #include <ecdaa/rand.h>
 
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "internal-utilities/sha256.h"
+
 #include <amcl/big_XXX.h>
 #include <amcl/ecp_ZZZ.h>
 #include <amcl/ecp2_ZZZ.h>
@@ -75,6 +79,83 @@ int schnorr_sign_ZZZ(BIG_XXX *c_out,
                      uint32_t basename_len,
                      ecdaa_rand_func get_random);
 
+/*
+ * Hash a basename to its point P2, using the given method.
+ *
+ *  Returns:
+ *   0 on success
+ *   -1 if the basename couldn't be hashed
+ */
+int schnorr_basename_point_ZZZ(ECP_ZZZ *P2_out,
+                               const uint8_t *basename,
+                               uint32_t basename_len,
+                               enum ecdaa_hash_to_curve hash_to_curve);
+
+/*
+ * Same as `schnorr_sign_ZZZ`, but with the basename already hashed to P2
+ *  (as by `ecp_ZZZ_fromhash`), for signing repeatedly under the same basename.
+ *
+ * If basename_len != 0, P2 and K_out must not be NULL.
+ *  If P2_table isn't NULL, it must be the fixed-base table for P2 (and is used for k*P2).
+ *  If K_in isn't NULL, it must be private_key*P2 (and is copied to K_out, rather than re-computed).
+ *
+ *  Returns:
+ *   0 on success
+ *   -1 if the basename arguments are inconsistent
+ */
+int schnorr_sign_with_basename_point_ZZZ(BIG_XXX *c_out,
+                                         BIG_XXX *s_out,
+                                         BIG_XXX *n_out,
+                                         ECP_ZZZ *K_out,
+                                         const uint8_t *msg_in,
+                                         uint32_t msg_len,
+                                         ECP_ZZZ *basepoint,
+                                         ECP_ZZZ *public_key,
+                                         BIG_XXX private_key,
+                                         const uint8_t *basename,
+                                         uint32_t basename_len,
+                                         ECP_ZZZ *P2,
+                                         struct ecp_ZZZ_fixed_base_table *P2_table,
+                                         ECP_ZZZ *K_in,
+                                         ecdaa_rand_func get_random);
+
+/*
+ * `schnorr_sign_with_basename_point_ZZZ`, split around the message,
+ *  so the message can be hashed in pieces:
+ *
+ *  1. `schnorr_sign_begin_ZZZ` makes the commitment (k_out, K_out),
+ *      and starts c' = Hash( R | basepoint | public_key [| L | P2 | K | basename] | msg_in ) in `hash_out`.
+ *  2. The caller hashes the message, with `ecdaa_sha256_update(hash_out, ...)`.
+ *  3. `schnorr_sign_finish_ZZZ` finishes c', and computes n_out, c_out, and s_out.
+ *      It clears `k` and `hash`.
+ *
+ * Other arguments are as for `schnorr_sign_with_basename_point_ZZZ`.
+ *
+ * `schnorr_sign_begin_ZZZ` returns:
+ *  0 on success
+ *  -1 if the basename arguments are inconsistent
+ */
+int schnorr_sign_begin_ZZZ(struct ecdaa_sha256 *hash_out,
+                           BIG_XXX *k_out,
+                           ECP_ZZZ *K_out,
+                           ECP_ZZZ *basepoint,
+                           ECP_ZZZ *public_key,
+                           BIG_XXX private_key,
+                           const uint8_t *basename,
+                           uint32_t basename_len,
+                           ECP_ZZZ *P2,
+                           struct ecp_ZZZ_fixed_base_table *P2_table,
+                           ECP_ZZZ *K_in,
+                           ecdaa_rand_func get_random);
+
+void schnorr_sign_finish_ZZZ(BIG_XXX *c_out,
+                             BIG_XXX *s_out,
+                             BIG_XXX *n_out,
+                             struct ecdaa_sha256 *hash,
+                             BIG_XXX *k,
+                             BIG_XXX private_key,
+                             ecdaa_rand_func get_random);
+
 /*
  * Verify that (c, s, n) is a valid Schnorr signature of msg_in, allowing for a non-standard basepoint.
  *
@@ -100,6 +181,102 @@ int schnorr_verify_ZZZ(BIG_XXX c,
                        const uint8_t *basename,
                        uint32_t basename_len);
 
+/*
+ * Same as `schnorr_verify_ZZZ`, but with the basename already hashed to P2.
+ *
+ * If basename_len != 0, P2 must not be NULL.
+ *  If P2_table isn't NULL, it must be the fixed-base table for P2 (and is used for s*P2).
+ *
+ * Returns:
+ *  0 on success
+ *  -1 if (c, s) is not a valid signature
+ *  -2 if basename_len != 0 and P2 is NULL
+ */
+int schnorr_verify_with_basename_point_ZZZ(BIG_XXX c,
+                                           BIG_XXX s,
+                                           BIG_XXX n,
+                                           ECP_ZZZ *K,
+                                           const uint8_t *msg_in,
+                                           uint32_t msg_len,
+                                           ECP_ZZZ *basepoint,
+                                           ECP_ZZZ *public_key,
+                                           const uint8_t *basename,
+                                           uint32_t basename_len,
+                                           ECP_ZZZ *P2,
+                                           struct ecp_ZZZ_fixed_base_table *P2_table);
+
+/*
+ * `schnorr_verify_with_basename_point_ZZZ`, split around the message, likewise:
+ *  `schnorr_verify_begin_ZZZ` computes R (and L),
+ *  and starts c'' = Hash( R | basepoint | public_key [| L | P2 | K | basename] | msg_in ) in `hash_out`;
+ *  the caller hashes the message;
+ *  then `schnorr_verify_finish_ZZZ` finishes c'' (clearing `hash`), and checks c.
+ *
+ * `schnorr_verify_begin_ZZZ` returns:
+ *  0 on success
+ *  -2 if basename_len != 0 and P2 is NULL
+ *
+ * `schnorr_verify_finish_ZZZ` returns:
+ *  0 if the signature is valid
+ *  -1 otherwise
+ */
+int schnorr_verify_begin_ZZZ(struct ecdaa_sha256 *hash_out,
+                             BIG_XXX c,
+                             BIG_XXX s,
+                             ECP_ZZZ *K,
+                             ECP_ZZZ *basepoint,
+                             ECP_ZZZ *public_key,
+                             const uint8_t *basename,
+                             uint32_t basename_len,
+                             ECP_ZZZ *P2,
+                             struct ecp_ZZZ_fixed_base_table *P2_table);
+
+int schnorr_verify_finish_ZZZ(BIG_XXX c,
+                              BIG_XXX n,
+                              struct ecdaa_sha256 *hash);
+
+/*
+ * `schnorr_verify_with_basename_point_ZZZ`, in two steps,
+ *  so the hashes of many verifications can be computed together
+ *  (with `big_XXX_from_three_message_hash_batch` and `big_XXX_from_hash_batch`):
+ *
+ *  1. `schnorr_verify_transcript_ZZZ` serializes the points hashed into c''
+ *      (R | basepoint | public_key, then L | P2 | K if there's a basename).
+ *      Then c'' = Hash(transcript | basename | msg_in).
+ *  2. `schnorr_verify_challenge_input_ZZZ` gives the input for c' = Hash(n | c'').
+ *  3. `schnorr_verify_challenge_ZZZ` compares c' and c.
+ *
+ * `transcript_out` must have room for SCHNORR_ZZZ_TRANSCRIPT_MAX_LENGTH bytes.
+ *
+ * `schnorr_verify_transcript_ZZZ` returns:
+ *  0 on success (with the transcript length in `transcript_length_out`)
+ *  -2 if basename_len != 0 and P2 is NULL
+ *
+ * `schnorr_verify_challenge_ZZZ` returns:
+ *  0 if the signature is valid
+ *  -1 otherwise
+ */
+#define SCHNORR_ZZZ_TRANSCRIPT_MAX_LENGTH (6*ECP_ZZZ_LENGTH)
+#define SCHNORR_ZZZ_CHALLENGE_INPUT_LENGTH (2*MODBYTES_XXX)
+
+int schnorr_verify_transcript_ZZZ(uint8_t *transcript_out,
+                                  uint32_t *transcript_length_out,
+                                  BIG_XXX c,
+                                  BIG_XXX s,
+                                  ECP_ZZZ *K,
+                                  ECP_ZZZ *basepoint,
+                                  ECP_ZZZ *public_key,
+                                  uint32_t basename_len,
+                                  ECP_ZZZ *P2,
+                                  struct ecp_ZZZ_fixed_base_table *P2_table);
+
+void schnorr_verify_challenge_input_ZZZ(uint8_t *input_out,
+                                        BIG_XXX n,
+                                        BIG_XXX c_dbl_prime);
+
+int schnorr_verify_challenge_ZZZ(BIG_XXX c,
+                                 BIG_XXX c_prime);
+
 /*
  * Perform an 'credential-Schnorr' signature, used by an Issuer when signing credentials.
  *
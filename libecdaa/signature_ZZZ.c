@@ -20,25 +20,163 @@
 
 #include <ecdaa/member_keypair_ZZZ.h>
 #include <ecdaa/group_public_key_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
 #include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+#include <ecdaa/pseudonym_index_ZZZ.h>
+#include <ecdaa/revocation_store_ZZZ.h>
+#include <ecdaa/basename_ctx_ZZZ.h>
 #include <ecdaa/credential_ZZZ.h>
+#include <ecdaa/prepared_credential_ZZZ.h>
 #include <ecdaa/util/errors.h>
 #include <ecdaa/util/file_io.h>
 
 #include "schnorr/schnorr_ZZZ.h"
+#include "revocations/sk_revocation_scan_ZZZ.h"
 #include "amcl-extensions/big_XXX.h"
 #include "amcl-extensions/ecp_ZZZ.h"
 #include "amcl-extensions/ecp2_ZZZ.h"
 #include "amcl-extensions/pairing_ZZZ.h"
+#include "internal-utilities/explicit_bzero.h"
+#include "internal-utilities/sha256.h"
 
 #include <amcl/pair_ZZZ.h>
 #include <amcl/fp12_ZZZ.h>
 
+#include <string.h>
+
+// Batch verification randomizers are this many bits (a forged batch passes with probability 2^-128).
+#define BATCH_RANDOMIZER_BITS 128
+
+// Signatures whose pairing-check terms are accumulated by one multi-scalar multiplication.
+#define BATCH_PAIRING_GROUP_SIZE 8
+
+// The opaque hash state in the streaming contexts is used as an `ecdaa_sha256`.
+typedef char signature_hash_state_fits_ZZZ[(sizeof(((struct ecdaa_signature_ZZZ_sign_ctx*)0)->hash_state)
+                                            >= sizeof(struct ecdaa_sha256)) ? 1 : -1];
+
 static
 void randomize_credential_ZZZ(struct ecdaa_credential_ZZZ *cred,
                               ecdaa_rand_func get_random,
                               struct ecdaa_signature_ZZZ *signature_out);
 
+static
+void randomize_prepared_credential_ZZZ(struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                       ecdaa_rand_func get_random,
+                                       struct ecdaa_signature_ZZZ *signature_out);
+
+static
+int sign_begin_ZZZ(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                   const uint8_t* basename,
+                   uint32_t basename_len,
+                   struct ecdaa_member_secret_key_ZZZ *sk,
+                   struct ecdaa_credential_ZZZ *cred,
+                   struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                   ecdaa_rand_func get_random);
+
+static
+int verify_ZZZ(struct ecdaa_signature_ZZZ *signature,
+               ECP2_ZZZ **g2_points,
+               FP2_YYY **g2_lines,
+               struct ecdaa_revocations_ZZZ *revocations,
+               uint8_t* message,
+               uint32_t message_len,
+               uint8_t *basename,
+               uint32_t basename_len,
+               struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+               enum ecdaa_hash_to_curve hash_to_curve,
+               int *streamed_schnorr_ret,
+               enum ecdaa_verify_policy policy,
+               enum ecdaa_verify_stage *rejected_stage_out);
+
+static
+int verify_finish_ZZZ(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                      ECP2_ZZZ **g2_points,
+                      FP2_YYY **g2_lines,
+                      struct ecdaa_revocations_ZZZ *revocations);
+
+static
+int check_pairings_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                       ECP2_ZZZ **g2_points,
+                       FP2_YYY **g2_lines);
+
+static
+int check_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                          struct ecdaa_revocations_ZZZ *revocations,
+                          uint8_t *basename,
+                          uint32_t basename_len,
+                          enum ecdaa_hash_to_curve hash_to_curve);
+
+static
+int check_sk_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                             struct ecdaa_revocations_ZZZ *revocations,
+                             uint8_t *basename,
+                             uint32_t basename_len,
+                             enum ecdaa_hash_to_curve hash_to_curve);
+
+static
+struct ecdaa_pseudonym_index_ZZZ *find_pseudonym_index_ZZZ(struct ecdaa_revocations_ZZZ *revocations,
+                                                           uint8_t *basename,
+                                                           uint32_t basename_len,
+                                                           enum ecdaa_hash_to_curve hash_to_curve);
+
+static
+int check_bsn_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                              struct ecdaa_revocations_ZZZ *revocations);
+
+static
+void check_schnorr_batch_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                             uint8_t **messages,
+                             uint32_t *message_lengths,
+                             uint8_t **basenames,
+                             uint32_t *basename_lengths,
+                             enum ecdaa_hash_to_curve hash_to_curve,
+                             size_t count,
+                             int *results);
+
+static
+void batch_seed_ZZZ(uint8_t *seed_out,
+                    struct ecdaa_signature_ZZZ *signatures,
+                    size_t num_signatures);
+
+static
+void batch_randomizer_ZZZ(BIG_XXX *randomizer_out,
+                          uint8_t *seed,
+                          size_t index,
+                          uint8_t which);
+
+static
+int check_pairings_batch_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                             size_t begin,
+                             size_t end,
+                             int *results,
+                             uint8_t *seed,
+                             ECP2_ZZZ **g2_points,
+                             FP2_YYY **g2_lines);
+
+static
+int bisect_pairings_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                        size_t begin,
+                        size_t end,
+                        int known_invalid,
+                        int *results,
+                        uint8_t *seed,
+                        ECP2_ZZZ **g2_points,
+                        FP2_YYY **g2_lines);
+
+static
+int batch_verify_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                     uint8_t **messages,
+                     uint32_t *message_lengths,
+                     uint8_t **basenames,
+                     uint32_t *basename_lengths,
+                     enum ecdaa_hash_to_curve hash_to_curve,
+                     size_t num_signatures,
+                     ECP2_ZZZ **g2_points,
+                     FP2_YYY **g2_lines,
+                     struct ecdaa_revocations_ZZZ *revocations,
+                     int *results);
+
 size_t ecdaa_signature_ZZZ_length(void)
 {
     return ECDAA_SIGNATURE_ZZZ_LENGTH;
@@ -79,6 +217,260 @@ int ecdaa_signature_ZZZ_sign(struct ecdaa_signature_ZZZ *signature_out,
     return sign_ret;
 }
 
+int ecdaa_signature_ZZZ_sign_with_basename_ctx(struct ecdaa_signature_ZZZ *signature_out,
+                                               const uint8_t* message,
+                                               uint32_t message_len,
+                                               struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                               struct ecdaa_member_secret_key_ZZZ *sk,
+                                               struct ecdaa_credential_ZZZ *cred,
+                                               ecdaa_rand_func get_random)
+{
+    // K (if set) must be this key's pseudonym
+    if (0 != ecdaa_basename_ctx_ZZZ_check_secret_key(basename_ctx, sk))
+        return -1;
+
+    // 1) Randomize credential
+    randomize_credential_ZZZ(cred, get_random, signature_out);
+
+    // 2) Create a Schnorr-like signature, as in `ecdaa_signature_ZZZ_sign`,
+    //  but with P2 (and, if set, K) from the basename context.
+    int sign_ret = schnorr_sign_with_basename_point_ZZZ(&signature_out->c,
+                                                        &signature_out->s,
+                                                        &signature_out->n,
+                                                        &signature_out->K,
+                                                        message,
+                                                        message_len,
+                                                        &signature_out->S,
+                                                        &signature_out->W,
+                                                        sk->sk,
+                                                        basename_ctx->basename,
+                                                        basename_ctx->basename_len,
+                                                        &basename_ctx->P2,
+                                                        (struct ecp_ZZZ_fixed_base_table*)basename_ctx->P2_table,
+                                                        basename_ctx->has_pseudonym ? &basename_ctx->K : NULL,
+                                                        get_random);
+
+    return sign_ret;
+}
+
+int ecdaa_signature_ZZZ_sign_prepared(struct ecdaa_signature_ZZZ *signature_out,
+                                      const uint8_t* message,
+                                      uint32_t message_len,
+                                      const uint8_t* basename,
+                                      uint32_t basename_len,
+                                      struct ecdaa_member_secret_key_ZZZ *sk,
+                                      struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                      ecdaa_rand_func get_random)
+{
+    // 1) Randomize credential, using its tables
+    randomize_prepared_credential_ZZZ(prepared_cred, get_random, signature_out);
+
+    // 2) Create a Schnorr-like signature, as in `ecdaa_signature_ZZZ_sign`
+    int sign_ret = schnorr_sign_ZZZ(&signature_out->c,
+                                    &signature_out->s,
+                                    &signature_out->n,
+                                    &signature_out->K,
+                                    message,
+                                    message_len,
+                                    &signature_out->S,
+                                    &signature_out->W,
+                                    sk->sk,
+                                    basename,
+                                    basename_len,
+                                    get_random);
+
+    return sign_ret;
+}
+
+int ecdaa_signature_ZZZ_sign_begin(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                   const uint8_t* basename,
+                                   uint32_t basename_len,
+                                   struct ecdaa_member_secret_key_ZZZ *sk,
+                                   struct ecdaa_credential_ZZZ *cred,
+                                   ecdaa_rand_func get_random)
+{
+    return sign_begin_ZZZ(ctx, basename, basename_len, sk, cred, NULL, get_random);
+}
+
+int ecdaa_signature_ZZZ_sign_begin_prepared(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                            const uint8_t* basename,
+                                            uint32_t basename_len,
+                                            struct ecdaa_member_secret_key_ZZZ *sk,
+                                            struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                            ecdaa_rand_func get_random)
+{
+    return sign_begin_ZZZ(ctx, basename, basename_len, sk, NULL, prepared_cred, get_random);
+}
+
+int ecdaa_signature_ZZZ_sign_begin_with_basename_ctx(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                                     struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+                                                     struct ecdaa_member_secret_key_ZZZ *sk,
+                                                     struct ecdaa_credential_ZZZ *cred,
+                                                     ecdaa_rand_func get_random)
+{
+    // K (if set) must be this key's pseudonym
+    if (0 != ecdaa_basename_ctx_ZZZ_check_secret_key(basename_ctx, sk))
+        return -1;
+
+    // 1) Randomize credential
+    randomize_credential_ZZZ(cred, get_random, &ctx->signature);
+
+    // 2) Commit, with P2 (and, if set, K) from the basename context
+    int begin_ret = schnorr_sign_begin_ZZZ((struct ecdaa_sha256*)ctx->hash_state,
+                                           &ctx->k,
+                                           &ctx->signature.K,
+                                           &ctx->signature.S,
+                                           &ctx->signature.W,
+                                           sk->sk,
+                                           basename_ctx->basename,
+                                           basename_ctx->basename_len,
+                                           &basename_ctx->P2,
+                                           (struct ecp_ZZZ_fixed_base_table*)basename_ctx->P2_table,
+                                           basename_ctx->has_pseudonym ? &basename_ctx->K : NULL,
+                                           get_random);
+    if (0 != begin_ret)
+        return -1;
+
+    BIG_XXX_copy(ctx->sk, sk->sk);
+    ctx->get_random = get_random;
+
+    return 0;
+}
+
+void ecdaa_signature_ZZZ_sign_update(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                     const uint8_t *message_chunk,
+                                     uint32_t message_chunk_len)
+{
+    ecdaa_sha256_update((struct ecdaa_sha256*)ctx->hash_state, message_chunk, message_chunk_len);
+}
+
+void ecdaa_signature_ZZZ_sign_updatev(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                      const uint8_t **message_chunks,
+                                      const uint32_t *message_chunk_lengths,
+                                      size_t num_chunks)
+{
+    for (size_t i = 0; i < num_chunks; ++i)
+        ecdaa_sha256_update((struct ecdaa_sha256*)ctx->hash_state, message_chunks[i], message_chunk_lengths[i]);
+}
+
+void ecdaa_signature_ZZZ_sign_finish(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                                     struct ecdaa_signature_ZZZ *signature_out)
+{
+    // (Clears k and the hash state)
+    schnorr_sign_finish_ZZZ(&ctx->signature.c,
+                            &ctx->signature.s,
+                            &ctx->signature.n,
+                            (struct ecdaa_sha256*)ctx->hash_state,
+                            &ctx->k,
+                            ctx->sk,
+                            ctx->get_random);
+
+    *signature_out = ctx->signature;
+
+    // Clear sensitive memory.
+    explicit_bzero(&ctx->sk, sizeof(BIG_XXX));
+}
+
+void ecdaa_signature_ZZZ_verify_begin(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                      struct ecdaa_signature_ZZZ *signature,
+                                      uint8_t *basename,
+                                      uint32_t basename_len)
+{
+    ecdaa_signature_ZZZ_verify_begin_with_hash_to_curve(ctx, signature, basename, basename_len, ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT);
+}
+
+void ecdaa_signature_ZZZ_verify_begin_with_hash_to_curve(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                                         struct ecdaa_signature_ZZZ *signature,
+                                                         uint8_t *basename,
+                                                         uint32_t basename_len,
+                                                         enum ecdaa_hash_to_curve hash_to_curve)
+{
+    ctx->signature = signature;
+    ctx->basename = basename;
+    ctx->basename_len = basename_len;
+    ctx->basename_ctx = NULL;
+    ctx->hash_to_curve = hash_to_curve;
+
+    // (Same as `schnorr_verify_ZZZ`)
+    ECP_ZZZ P2;
+    if (0 != basename_len && 0 != schnorr_basename_point_ZZZ(&P2, basename, basename_len, hash_to_curve)) {
+        ctx->begin_ret = -2;
+        ecdaa_sha256_init((struct ecdaa_sha256*)ctx->hash_state);
+        return;
+    }
+
+    ctx->begin_ret = schnorr_verify_begin_ZZZ((struct ecdaa_sha256*)ctx->hash_state,
+                                              signature->c,
+                                              signature->s,
+                                              &signature->K,
+                                              &signature->S,
+                                              &signature->W,
+                                              basename,
+                                              basename_len,
+                                              &P2,
+                                              NULL);
+}
+
+void ecdaa_signature_ZZZ_verify_begin_with_basename_ctx(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                                        struct ecdaa_signature_ZZZ *signature,
+                                                        struct ecdaa_basename_ctx_ZZZ *basename_ctx)
+{
+    ctx->signature = signature;
+    ctx->basename = (uint8_t*)basename_ctx->basename;
+    ctx->basename_len = basename_ctx->basename_len;
+    ctx->basename_ctx = basename_ctx;
+    ctx->hash_to_curve = basename_ctx->hash_to_curve;
+
+    ctx->begin_ret = schnorr_verify_begin_ZZZ((struct ecdaa_sha256*)ctx->hash_state,
+                                              signature->c,
+                                              signature->s,
+                                              &signature->K,
+                                              &signature->S,
+                                              &signature->W,
+                                              basename_ctx->basename,
+                                              basename_ctx->basename_len,
+                                              &basename_ctx->P2,
+                                              (struct ecp_ZZZ_fixed_base_table*)basename_ctx->P2_table);
+}
+
+void ecdaa_signature_ZZZ_verify_update(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                       const uint8_t *message_chunk,
+                                       uint32_t message_chunk_len)
+{
+    ecdaa_sha256_update((struct ecdaa_sha256*)ctx->hash_state, message_chunk, message_chunk_len);
+}
+
+void ecdaa_signature_ZZZ_verify_updatev(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                        const uint8_t **message_chunks,
+                                        const uint32_t *message_chunk_lengths,
+                                        size_t num_chunks)
+{
+    for (size_t i = 0; i < num_chunks; ++i)
+        ecdaa_sha256_update((struct ecdaa_sha256*)ctx->hash_state, message_chunks[i], message_chunk_lengths[i]);
+}
+
+int ecdaa_signature_ZZZ_verify_finish(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                      struct ecdaa_group_public_key_ZZZ *gpk,
+                                      struct ecdaa_revocations_ZZZ *revocations)
+{
+    ECP2_ZZZ basepoint2;
+    ecp2_ZZZ_set_to_generator(&basepoint2);
+
+    ECP2_ZZZ *g2_points[3] = {&gpk->Y, &basepoint2, &gpk->X};
+
+    return verify_finish_ZZZ(ctx, g2_points, NULL, revocations);
+}
+
+int ecdaa_signature_ZZZ_verify_finish_prepared(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                                               struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                               struct ecdaa_revocations_ZZZ *revocations)
+{
+    ECP2_ZZZ *g2_points[3] = {&prepared_gpk->gpk.Y, &prepared_gpk->basepoint2, &prepared_gpk->gpk.X};
+    FP2_YYY *g2_lines[3] = {prepared_gpk->Y_lines, prepared_gpk->basepoint2_lines, prepared_gpk->X_lines};
+
+    return verify_finish_ZZZ(ctx, g2_points, prepared_gpk->has_lines ? g2_lines : NULL, revocations);
+}
+
 int ecdaa_signature_ZZZ_verify(struct ecdaa_signature_ZZZ *signature,
                                struct ecdaa_group_public_key_ZZZ *gpk,
                                struct ecdaa_revocations_ZZZ *revocations,
@@ -87,70 +479,351 @@ int ecdaa_signature_ZZZ_verify(struct ecdaa_signature_ZZZ *signature,
                                uint8_t *basename,
                                uint32_t basename_len)
 {
-    int ret = 0;
+    return ecdaa_signature_ZZZ_verify_with_policy(signature,
+                                                  gpk,
+                                                  revocations,
+                                                  message,
+                                                  message_len,
+                                                  basename,
+                                                  basename_len,
+                                                  ECDAA_VERIFY_POLICY_COMPLETE,
+                                                  NULL);
+}
 
-    // 1) Check R,S,T,W for membership in group, and R and S for !=inf
-    // NOTE: We assume the signature was obtained from a call to `deserialize`,
-    //  which already checked the validity of the points R,S,T,W
+int ecdaa_signature_ZZZ_verify_prepared(struct ecdaa_signature_ZZZ *signature,
+                                        struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                        struct ecdaa_revocations_ZZZ *revocations,
+                                        uint8_t* message,
+                                        uint32_t message_len,
+                                        uint8_t *basename,
+                                        uint32_t basename_len)
+{
+    return ecdaa_signature_ZZZ_verify_prepared_with_policy(signature,
+                                                           prepared_gpk,
+                                                           revocations,
+                                                           message,
+                                                           message_len,
+                                                           basename,
+                                                           basename_len,
+                                                           ECDAA_VERIFY_POLICY_COMPLETE,
+                                                           NULL);
+}
 
-    // 2) Check Schnorr-type signature
-    int schnorr_ret = schnorr_verify_ZZZ(signature->c,
-                                         signature->s,
-                                         signature->n,
-                                         &signature->K,
-                                         message,
-                                         message_len,
-                                         &signature->S,
-                                         &signature->W,
-                                         basename,
-                                         basename_len);
-    if (0 != schnorr_ret)
-        ret = -1;
+int ecdaa_signature_ZZZ_verify_with_basename_ctx(struct ecdaa_signature_ZZZ *signature,
+                                                 struct ecdaa_group_public_key_ZZZ *gpk,
+                                                 struct ecdaa_revocations_ZZZ *revocations,
+                                                 uint8_t* message,
+                                                 uint32_t message_len,
+                                                 struct ecdaa_basename_ctx_ZZZ *basename_ctx)
+{
+    ECP2_ZZZ basepoint2;
+    ecp2_ZZZ_set_to_generator(&basepoint2);
+
+    ECP2_ZZZ *g2_points[3] = {&gpk->Y, &basepoint2, &gpk->X};
 
+    return verify_ZZZ(signature,
+                      g2_points,
+                      NULL,
+                      revocations,
+                      message,
+                      message_len,
+                      (uint8_t*)basename_ctx->basename,
+                      basename_ctx->basename_len,
+                      basename_ctx,
+                      basename_ctx->hash_to_curve,
+                      NULL,
+                      ECDAA_VERIFY_POLICY_COMPLETE,
+                      NULL);
+}
+
+int ecdaa_signature_ZZZ_verify_prepared_with_basename_ctx(struct ecdaa_signature_ZZZ *signature,
+                                                          struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                          struct ecdaa_revocations_ZZZ *revocations,
+                                                          uint8_t* message,
+                                                          uint32_t message_len,
+                                                          struct ecdaa_basename_ctx_ZZZ *basename_ctx)
+{
+    ECP2_ZZZ *g2_points[3] = {&prepared_gpk->gpk.Y, &prepared_gpk->basepoint2, &prepared_gpk->gpk.X};
+    FP2_YYY *g2_lines[3] = {prepared_gpk->Y_lines, prepared_gpk->basepoint2_lines, prepared_gpk->X_lines};
+
+    return verify_ZZZ(signature,
+                      g2_points,
+                      prepared_gpk->has_lines ? g2_lines : NULL,
+                      revocations,
+                      message,
+                      message_len,
+                      (uint8_t*)basename_ctx->basename,
+                      basename_ctx->basename_len,
+                      basename_ctx,
+                      basename_ctx->hash_to_curve,
+                      NULL,
+                      ECDAA_VERIFY_POLICY_COMPLETE,
+                      NULL);
+}
+
+int ecdaa_signature_ZZZ_verify_with_policy(struct ecdaa_signature_ZZZ *signature,
+                                           struct ecdaa_group_public_key_ZZZ *gpk,
+                                           struct ecdaa_revocations_ZZZ *revocations,
+                                           uint8_t* message,
+                                           uint32_t message_len,
+                                           uint8_t *basename,
+                                           uint32_t basename_len,
+                                           enum ecdaa_verify_policy policy,
+                                           enum ecdaa_verify_stage *rejected_stage_out)
+{
     ECP2_ZZZ basepoint2;
     ecp2_ZZZ_set_to_generator(&basepoint2);
 
-    // 3) Check e(R, Y) == e(S, P_2)
-    FP12_YYY pairing_one;
-    FP12_YYY pairing_one_prime;
-    compute_pairing_ZZZ(&pairing_one, &signature->R, &gpk->Y);
-    compute_pairing_ZZZ(&pairing_one_prime, &signature->S, &basepoint2);
-    if (!FP12_YYY_equals(&pairing_one, &pairing_one_prime))
-        ret = -1;
+    ECP2_ZZZ *g2_points[3] = {&gpk->Y, &basepoint2, &gpk->X};
 
-    // 4) Compute R+W
-    //      Nb. Add doesn't convert to affine, so do that explicitly
-    ECP_ZZZ RW;
-    ECP_ZZZ_copy(&RW, &signature->R);
-    ECP_ZZZ_add(&RW, &signature->W);
-    ECP_ZZZ_affine(&RW);
-
-    // 5) Check e(T, P_2) == e(R+W, X)
-    FP12_YYY pairing_two;
-    FP12_YYY pairing_two_prime;
-    compute_pairing_ZZZ(&pairing_two, &signature->T, &basepoint2);
-    compute_pairing_ZZZ(&pairing_two_prime, &RW, &gpk->X);
-    if (!FP12_YYY_equals(&pairing_two, &pairing_two_prime))
-        ret = -1;
+    return verify_ZZZ(signature,
+                      g2_points,
+                      NULL,
+                      revocations,
+                      message,
+                      message_len,
+                      basename,
+                      basename_len,
+                      NULL,
+                      ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                      NULL,
+                      policy,
+                      rejected_stage_out);
+}
 
-    // 6) Check W against sk_revocation_list
-    ECP_ZZZ Wcheck;
-    for (size_t i = 0; i < revocations->sk_length; ++i) {
-        ECP_ZZZ_copy(&Wcheck, &signature->S);
-        ECP_ZZZ_mul(&Wcheck, revocations->sk_list[i].sk);
-        if (ECP_ZZZ_equals(&Wcheck, &signature->W))
-            ret = -1;
-    }
+int ecdaa_signature_ZZZ_verify_prepared_with_policy(struct ecdaa_signature_ZZZ *signature,
+                                                    struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                    struct ecdaa_revocations_ZZZ *revocations,
+                                                    uint8_t* message,
+                                                    uint32_t message_len,
+                                                    uint8_t *basename,
+                                                    uint32_t basename_len,
+                                                    enum ecdaa_verify_policy policy,
+                                                    enum ecdaa_verify_stage *rejected_stage_out)
+{
+    ECP2_ZZZ *g2_points[3] = {&prepared_gpk->gpk.Y, &prepared_gpk->basepoint2, &prepared_gpk->gpk.X};
+    FP2_YYY *g2_lines[3] = {prepared_gpk->Y_lines, prepared_gpk->basepoint2_lines, prepared_gpk->X_lines};
 
-    // 7) Check K against bsn_revocation_list
-    for (size_t i = 0; i < revocations->bsn_length; ++i) {
-        if (ECP_ZZZ_equals(&revocations->bsn_list[i], &signature->K))
+    return verify_ZZZ(signature,
+                      g2_points,
+                      prepared_gpk->has_lines ? g2_lines : NULL,
+                      revocations,
+                      message,
+                      message_len,
+                      basename,
+                      basename_len,
+                      NULL,
+                      ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                      NULL,
+                      policy,
+                      rejected_stage_out);
+}
+
+int ecdaa_signature_ZZZ_verify_crypto(struct ecdaa_signature_ZZZ *signature,
+                                      struct ecdaa_group_public_key_ZZZ *gpk,
+                                      uint8_t* message,
+                                      uint32_t message_len,
+                                      uint8_t *basename,
+                                      uint32_t basename_len)
+{
+    return ecdaa_signature_ZZZ_verify_with_policy(signature,
+                                                  gpk,
+                                                  NULL,
+                                                  message,
+                                                  message_len,
+                                                  basename,
+                                                  basename_len,
+                                                  ECDAA_VERIFY_POLICY_COMPLETE,
+                                                  NULL);
+}
+
+int ecdaa_signature_ZZZ_verify_crypto_prepared(struct ecdaa_signature_ZZZ *signature,
+                                               struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                               uint8_t* message,
+                                               uint32_t message_len,
+                                               uint8_t *basename,
+                                               uint32_t basename_len)
+{
+    return ecdaa_signature_ZZZ_verify_prepared_with_policy(signature,
+                                                           prepared_gpk,
+                                                           NULL,
+                                                           message,
+                                                           message_len,
+                                                           basename,
+                                                           basename_len,
+                                                           ECDAA_VERIFY_POLICY_COMPLETE,
+                                                           NULL);
+}
+
+int ecdaa_signature_ZZZ_check_revocations(struct ecdaa_signature_ZZZ *signature,
+                                          struct ecdaa_revocations_ZZZ *revocations,
+                                          uint8_t *basename,
+                                          uint32_t basename_len,
+                                          enum ecdaa_verify_stage *rejected_stage_out)
+{
+    return ecdaa_signature_ZZZ_check_revocations_with_hash_to_curve(signature,
+                                                                    revocations,
+                                                                    basename,
+                                                                    basename_len,
+                                                                    ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                                                                    rejected_stage_out);
+}
+
+int ecdaa_signature_ZZZ_check_revocations_with_hash_to_curve(struct ecdaa_signature_ZZZ *signature,
+                                                             struct ecdaa_revocations_ZZZ *revocations,
+                                                             uint8_t *basename,
+                                                             uint32_t basename_len,
+                                                             enum ecdaa_hash_to_curve hash_to_curve,
+                                                             enum ecdaa_verify_stage *rejected_stage_out)
+{
+    enum ecdaa_verify_stage rejected_stage = ECDAA_VERIFY_STAGE_NONE;
+
+    // Same order as in `verify_ZZZ`.
+    if (0 != check_bsn_revocations_ZZZ(signature, revocations))
+        rejected_stage = ECDAA_VERIFY_STAGE_BSN_REVOCATION;
+    else if (0 != check_sk_revocations_ZZZ(signature, revocations, basename, basename_len, hash_to_curve))
+        rejected_stage = ECDAA_VERIFY_STAGE_SK_REVOCATION;
+
+    if (NULL != rejected_stage_out)
+        *rejected_stage_out = rejected_stage;
+
+    if (ECDAA_VERIFY_STAGE_NONE != rejected_stage)
+        return -1;
+
+    return 0;
+}
+
+int ecdaa_signature_ZZZ_recheck_revocations(int *results_out,
+                                            struct ecdaa_signature_ZZZ *signatures,
+                                            size_t num_signatures,
+                                            struct ecdaa_revocation_delta_ZZZ *delta,
+                                            size_t sk_scan_threads)
+{
+    // Only the added entries can newly revoke a signature.
+    struct ecdaa_revocations_ZZZ added = {.sk_length=delta->sk_added_length,
+                                          .sk_list=delta->sk_added,
+                                          .bsn_length=delta->bsn_added_length,
+                                          .bsn_list=delta->bsn_added,
+                                          .sk_scan_threads=sk_scan_threads,
+                                          .bsn_set=NULL,
+                                          .num_pseudonym_indexes=0,
+                                          .pseudonym_indexes=NULL,
+                                          .sk_generation=0};
+
+    int ret = 0;
+
+    // With no basename (and no pseudonym indexes), neither check hashes a basename:
+    //  K is compared as-is, and W against sk*S.
+    //  So this holds for signatures made under either hash-to-curve method.
+    for (size_t i = 0; i < num_signatures; ++i) {
+        results_out[i] = ecdaa_signature_ZZZ_check_revocations(&signatures[i], &added, NULL, 0, NULL);
+        if (0 != results_out[i])
             ret = -1;
     }
 
     return ret;
 }
 
+int ecdaa_signature_ZZZ_batch_verify(struct ecdaa_signature_ZZZ *signatures,
+                                     uint8_t **messages,
+                                     uint32_t *message_lengths,
+                                     uint8_t **basenames,
+                                     uint32_t *basename_lengths,
+                                     size_t num_signatures,
+                                     struct ecdaa_group_public_key_ZZZ *gpk,
+                                     struct ecdaa_revocations_ZZZ *revocations,
+                                     int *results)
+{
+    return ecdaa_signature_ZZZ_batch_verify_with_hash_to_curve(signatures,
+                                                               messages,
+                                                               message_lengths,
+                                                               basenames,
+                                                               basename_lengths,
+                                                               ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                                                               num_signatures,
+                                                               gpk,
+                                                               revocations,
+                                                               results);
+}
+
+int ecdaa_signature_ZZZ_batch_verify_with_hash_to_curve(struct ecdaa_signature_ZZZ *signatures,
+                                                        uint8_t **messages,
+                                                        uint32_t *message_lengths,
+                                                        uint8_t **basenames,
+                                                        uint32_t *basename_lengths,
+                                                        enum ecdaa_hash_to_curve hash_to_curve,
+                                                        size_t num_signatures,
+                                                        struct ecdaa_group_public_key_ZZZ *gpk,
+                                                        struct ecdaa_revocations_ZZZ *revocations,
+                                                        int *results)
+{
+    ECP2_ZZZ basepoint2;
+    ecp2_ZZZ_set_to_generator(&basepoint2);
+
+    ECP2_ZZZ *g2_points[3] = {&gpk->Y, &basepoint2, &gpk->X};
+
+    return batch_verify_ZZZ(signatures,
+                            messages,
+                            message_lengths,
+                            basenames,
+                            basename_lengths,
+                            hash_to_curve,
+                            num_signatures,
+                            g2_points,
+                            NULL,
+                            revocations,
+                            results);
+}
+
+int ecdaa_signature_ZZZ_batch_verify_prepared(struct ecdaa_signature_ZZZ *signatures,
+                                              uint8_t **messages,
+                                              uint32_t *message_lengths,
+                                              uint8_t **basenames,
+                                              uint32_t *basename_lengths,
+                                              size_t num_signatures,
+                                              struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                              struct ecdaa_revocations_ZZZ *revocations,
+                                              int *results)
+{
+    return ecdaa_signature_ZZZ_batch_verify_prepared_with_hash_to_curve(signatures,
+                                                                        messages,
+                                                                        message_lengths,
+                                                                        basenames,
+                                                                        basename_lengths,
+                                                                        ECDAA_HASH_TO_CURVE_TRY_AND_INCREMENT,
+                                                                        num_signatures,
+                                                                        prepared_gpk,
+                                                                        revocations,
+                                                                        results);
+}
+
+int ecdaa_signature_ZZZ_batch_verify_prepared_with_hash_to_curve(struct ecdaa_signature_ZZZ *signatures,
+                                                                 uint8_t **messages,
+                                                                 uint32_t *message_lengths,
+                                                                 uint8_t **basenames,
+                                                                 uint32_t *basename_lengths,
+                                                                 enum ecdaa_hash_to_curve hash_to_curve,
+                                                                 size_t num_signatures,
+                                                                 struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                                                 struct ecdaa_revocations_ZZZ *revocations,
+                                                                 int *results)
+{
+    ECP2_ZZZ *g2_points[3] = {&prepared_gpk->gpk.Y, &prepared_gpk->basepoint2, &prepared_gpk->gpk.X};
+    FP2_YYY *g2_lines[3] = {prepared_gpk->Y_lines, prepared_gpk->basepoint2_lines, prepared_gpk->X_lines};
+
+    return batch_verify_ZZZ(signatures,
+                            messages,
+                            message_lengths,
+                            basenames,
+                            basename_lengths,
+                            hash_to_curve,
+                            num_signatures,
+                            g2_points,
+                            prepared_gpk->has_lines ? g2_lines : NULL,
+                            revocations,
+                            results);
+}
+
 void ecdaa_signature_ZZZ_serialize(uint8_t *buffer_out,
                                    struct ecdaa_signature_ZZZ *signature,
                                    int has_nym)
@@ -358,3 +1031,610 @@ void randomize_credential_ZZZ(struct ecdaa_credential_ZZZ *cred,
     // Clear sensitive intermediate memory.
     BIG_XXX_zero(l);
 }
+
+void randomize_prepared_credential_ZZZ(struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                                       ecdaa_rand_func get_random,
+                                       struct ecdaa_signature_ZZZ *signature_out)
+{
+    // Same as `randomize_credential_ZZZ`, but each multiplication is by a fixed base.
+    BIG_XXX l;
+    ecp_ZZZ_random_mod_order(&l, get_random);
+
+    int window_bits = prepared_cred->window_bits;
+    size_t table_length = ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(window_bits);
+
+    // R = l*A, S = l*B, T = l*C, W = l*D
+    ecp_ZZZ_fixed_base_mul_window(&signature_out->R, &prepared_cred->tables[0*table_length], window_bits, l);
+    ecp_ZZZ_fixed_base_mul_window(&signature_out->S, &prepared_cred->tables[1*table_length], window_bits, l);
+    ecp_ZZZ_fixed_base_mul_window(&signature_out->T, &prepared_cred->tables[2*table_length], window_bits, l);
+    ecp_ZZZ_fixed_base_mul_window(&signature_out->W, &prepared_cred->tables[3*table_length], window_bits, l);
+
+    // Clear sensitive intermediate memory.
+    BIG_XXX_zero(l);
+}
+
+int sign_begin_ZZZ(struct ecdaa_signature_ZZZ_sign_ctx *ctx,
+                   const uint8_t* basename,
+                   uint32_t basename_len,
+                   struct ecdaa_member_secret_key_ZZZ *sk,
+                   struct ecdaa_credential_ZZZ *cred,
+                   struct ecdaa_prepared_credential_ZZZ *prepared_cred,
+                   ecdaa_rand_func get_random)
+{
+    // (Same checks as `schnorr_sign_ZZZ`)
+    ECP_ZZZ P2;
+    if (NULL != basename || 0 != basename_len) {
+        if (NULL == basename || 0 == basename_len)
+            return -1;
+
+        if (ecp_ZZZ_fromhash(&P2, basename, basename_len) < 0)
+            return -1;
+    }
+
+    // 1) Randomize credential (using its tables, if prepared)
+    if (NULL != prepared_cred)
+        randomize_prepared_credential_ZZZ(prepared_cred, get_random, &ctx->signature);
+    else
+        randomize_credential_ZZZ(cred, get_random, &ctx->signature);
+
+    // 2) Commit, and hash everything that precedes the message
+    int begin_ret = schnorr_sign_begin_ZZZ((struct ecdaa_sha256*)ctx->hash_state,
+                                           &ctx->k,
+                                           &ctx->signature.K,
+                                           &ctx->signature.S,
+                                           &ctx->signature.W,
+                                           sk->sk,
+                                           basename,
+                                           basename_len,
+                                           &P2,
+                                           NULL,
+                                           NULL,
+                                           get_random);
+    if (0 != begin_ret)
+        return -1;
+
+    BIG_XXX_copy(ctx->sk, sk->sk);
+    ctx->get_random = get_random;
+
+    return 0;
+}
+
+int verify_ZZZ(struct ecdaa_signature_ZZZ *signature,
+               ECP2_ZZZ **g2_points,
+               FP2_YYY **g2_lines,
+               struct ecdaa_revocations_ZZZ *revocations,
+               uint8_t* message,
+               uint32_t message_len,
+               uint8_t *basename,
+               uint32_t basename_len,
+               struct ecdaa_basename_ctx_ZZZ *basename_ctx,
+               enum ecdaa_hash_to_curve hash_to_curve,
+               int *streamed_schnorr_ret,
+               enum ecdaa_verify_policy policy,
+               enum ecdaa_verify_stage *rejected_stage_out)
+{
+    // The checks are run cheapest-first, so a fail-fast verification
+    //  can stop as soon as one fails.
+    //  `rejected_stage` records the first check that failed.
+    enum ecdaa_verify_stage rejected_stage = ECDAA_VERIFY_STAGE_NONE;
+    int fail_fast = (ECDAA_VERIFY_POLICY_FAIL_FAST == policy);
+
+    // 1) Check R,S,T,W for membership in group, and R and S for !=inf
+    // NOTE: We assume the signature was obtained from a call to `deserialize`,
+    //  which already checked the validity of the points R,S,T,W
+
+    // `revocations` is NULL when only checking cryptographic validity
+    //  (steps 3 and 4), with the revocation checks (steps 2 and 5) done separately.
+
+    // 2) Check K against bsn_revocation_list (only point comparisons)
+    if (NULL != revocations && 0 != check_bsn_revocations_ZZZ(signature, revocations)) {
+        rejected_stage = ECDAA_VERIFY_STAGE_BSN_REVOCATION;
+    }
+
+    // 3) Check Schnorr-type signature (one hash, a few scalar multiplications)
+    if (!(fail_fast && ECDAA_VERIFY_STAGE_NONE != rejected_stage)) {
+        int schnorr_ret;
+        if (NULL != streamed_schnorr_ret) {
+            // (Already checked, as the message was streamed)
+            schnorr_ret = *streamed_schnorr_ret;
+        } else if (NULL != basename_ctx) {
+            // (The basename has already been hashed, and has a table)
+            schnorr_ret = schnorr_verify_with_basename_point_ZZZ(signature->c,
+                                                                 signature->s,
+                                                                 signature->n,
+                                                                 &signature->K,
+                                                                 message,
+                                                                 message_len,
+                                                                 &signature->S,
+                                                                 &signature->W,
+                                                                 basename,
+                                                                 basename_len,
+                                                                 &basename_ctx->P2,
+                                                                 (struct ecp_ZZZ_fixed_base_table*)basename_ctx->P2_table);
+        } else {
+            schnorr_ret = schnorr_verify_ZZZ(signature->c,
+                                             signature->s,
+                                             signature->n,
+                                             &signature->K,
+                                             message,
+                                             message_len,
+                                             &signature->S,
+                                             &signature->W,
+                                             basename,
+                                             basename_len);
+        }
+        if (0 != schnorr_ret && ECDAA_VERIFY_STAGE_NONE == rejected_stage)
+            rejected_stage = ECDAA_VERIFY_STAGE_SCHNORR;
+    }
+
+    // 4) Check e(R, Y) == e(S, P_2) and e(T, P_2) == e(R+W, X),
+    //  as the single randomized equation
+    //      e(rho*R, Y) * e(T - rho*S, P_2) * e(-(R+W), X) == 1
+    //  (three Miller loops, one final exponentiation).
+    if (!(fail_fast && ECDAA_VERIFY_STAGE_NONE != rejected_stage)) {
+        if (0 != check_pairings_ZZZ(signature, g2_points, g2_lines) && ECDAA_VERIFY_STAGE_NONE == rejected_stage)
+            rejected_stage = ECDAA_VERIFY_STAGE_PAIRING;
+    }
+
+    // 5) Check W against sk_revocation_list (one scalar multiplication per entry,
+    //  or one lookup if there's a pseudonym index for this basename)
+    if (NULL != revocations && !(fail_fast && ECDAA_VERIFY_STAGE_NONE != rejected_stage)) {
+        if (0 != check_sk_revocations_ZZZ(signature, revocations, basename, basename_len, hash_to_curve) && ECDAA_VERIFY_STAGE_NONE == rejected_stage)
+            rejected_stage = ECDAA_VERIFY_STAGE_SK_REVOCATION;
+    }
+
+    if (NULL != rejected_stage_out)
+        *rejected_stage_out = rejected_stage;
+
+    if (ECDAA_VERIFY_STAGE_NONE != rejected_stage)
+        return -1;
+
+    return 0;
+}
+
+int verify_finish_ZZZ(struct ecdaa_signature_ZZZ_verify_ctx *ctx,
+                      ECP2_ZZZ **g2_points,
+                      FP2_YYY **g2_lines,
+                      struct ecdaa_revocations_ZZZ *revocations)
+{
+    // Finish the Schnorr-type check (clearing the hash state),
+    //  then run the rest of the checks as usual.
+    int schnorr_ret = schnorr_verify_finish_ZZZ(ctx->signature->c, ctx->signature->n, (struct ecdaa_sha256*)ctx->hash_state);
+    if (0 != ctx->begin_ret)
+        schnorr_ret = ctx->begin_ret;
+
+    return verify_ZZZ(ctx->signature,
+                      g2_points,
+                      g2_lines,
+                      revocations,
+                      NULL,
+                      0,
+                      ctx->basename,
+                      ctx->basename_len,
+                      ctx->basename_ctx,
+                      ctx->hash_to_curve,
+                      &schnorr_ret,
+                      ECDAA_VERIFY_POLICY_COMPLETE,
+                      NULL);
+}
+
+int check_pairings_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                       ECP2_ZZZ **g2_points,
+                       FP2_YYY **g2_lines)
+{
+    // The randomizer rho is bound to the signature itself (R,S,T,W),
+    //  so a signer can't choose points that fail the two pairing checks
+    //  individually but cancel out in the combined equation.
+    uint8_t points[4*ECP_ZZZ_LENGTH];
+    ecp_ZZZ_serialize(points, &signature->R);
+    ecp_ZZZ_serialize(points + ECP_ZZZ_LENGTH, &signature->S);
+    ecp_ZZZ_serialize(points + 2*ECP_ZZZ_LENGTH, &signature->T);
+    ecp_ZZZ_serialize(points + 3*ECP_ZZZ_LENGTH, &signature->W);
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    BIG_XXX rho;
+    big_XXX_from_hash(&rho, points, sizeof(points));
+    BIG_XXX_mod(rho, curve_order);
+    if (BIG_XXX_iszilch(rho))
+        BIG_XXX_one(rho);
+
+    // rho*R
+    ECP_ZZZ rhoR;
+    ECP_ZZZ_copy(&rhoR, &signature->R);
+    ecp_ZZZ_mul_vartime(&rhoR, rho);
+
+    // T - rho*S
+    ECP_ZZZ T_minus_rhoS;
+    ECP_ZZZ_copy(&T_minus_rhoS, &signature->S);
+    ecp_ZZZ_mul_vartime(&T_minus_rhoS, rho);
+    ECP_ZZZ_neg(&T_minus_rhoS);
+    ECP_ZZZ_add(&T_minus_rhoS, &signature->T);
+    ECP_ZZZ_affine(&T_minus_rhoS);
+
+    // -(R+W)
+    //      Nb. Add doesn't convert to affine, so do that explicitly
+    ECP_ZZZ negRW;
+    ECP_ZZZ_copy(&negRW, &signature->R);
+    ECP_ZZZ_add(&negRW, &signature->W);
+    ECP_ZZZ_neg(&negRW);
+    ECP_ZZZ_affine(&negRW);
+
+    ECP_ZZZ *g1_points[3] = {&rhoR, &T_minus_rhoS, &negRW};
+
+    FP12_YYY product;
+    compute_pairing_product_with_lines_ZZZ(&product, g1_points, g2_points, g2_lines, 3);
+
+    if (!FP12_YYY_isunity(&product))
+        return -1;
+
+    return 0;
+}
+
+int check_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                          struct ecdaa_revocations_ZZZ *revocations,
+                          uint8_t *basename,
+                          uint32_t basename_len,
+                          enum ecdaa_hash_to_curve hash_to_curve)
+{
+    int ret = 0;
+
+    // Check W against sk_revocation_list
+    if (0 != check_sk_revocations_ZZZ(signature, revocations, basename, basename_len, hash_to_curve))
+        ret = -1;
+
+    // Check K against bsn_revocation_list
+    if (0 != check_bsn_revocations_ZZZ(signature, revocations))
+        ret = -1;
+
+    return ret;
+}
+
+int check_sk_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                             struct ecdaa_revocations_ZZZ *revocations,
+                             uint8_t *basename,
+                             uint32_t basename_len,
+                             enum ecdaa_hash_to_curve hash_to_curve)
+{
+    // The Schnorr signature proves K and W have the same discrete log (w.r.t. H(basename) and S),
+    //  so K == sk*H(basename) iff W == sk*S.
+    //  Thus, if K is indexed (under the same H), a lookup replaces the scan.
+    struct ecdaa_pseudonym_index_ZZZ *index = find_pseudonym_index_ZZZ(revocations, basename, basename_len, hash_to_curve);
+    if (NULL != index)
+        return ecdaa_pseudonym_index_ZZZ_contains(index, &signature->K) ? -1 : 0;
+
+    // Check whether W == sk*S for any sk on the list.
+    return sk_revocation_scan_ZZZ(&signature->S,
+                                  &signature->W,
+                                  revocations->sk_list,
+                                  revocations->sk_length,
+                                  revocations->sk_scan_threads);
+}
+
+struct ecdaa_pseudonym_index_ZZZ *find_pseudonym_index_ZZZ(struct ecdaa_revocations_ZZZ *revocations,
+                                                           uint8_t *basename,
+                                                           uint32_t basename_len,
+                                                           enum ecdaa_hash_to_curve hash_to_curve)
+{
+    if (0 == basename_len || NULL == revocations->pseudonym_indexes)
+        return NULL;
+
+    for (size_t i = 0; i < revocations->num_pseudonym_indexes; ++i) {
+        struct ecdaa_pseudonym_index_ZZZ *index = &revocations->pseudonym_indexes[i];
+        // A stale index might be missing some revoked members, so can't be used.
+        if (index->sk_length != revocations->sk_length || index->sk_generation != revocations->sk_generation)
+            continue;
+        // An index under another hash-to-curve method holds other pseudonyms.
+        if (index->hash_to_curve != hash_to_curve)
+            continue;
+        if (index->basename_len == basename_len && 0 == memcmp(index->basename, basename, basename_len))
+            return index;
+    }
+
+    return NULL;
+}
+
+int check_bsn_revocations_ZZZ(struct ecdaa_signature_ZZZ *signature,
+                              struct ecdaa_revocations_ZZZ *revocations)
+{
+    int ret = 0;
+
+    if (NULL != revocations->bsn_set && ecdaa_bsn_revocation_set_ZZZ_contains(revocations->bsn_set, &signature->K))
+        ret = -1;
+
+    for (size_t i = 0; i < revocations->bsn_length; ++i) {
+        if (ECP_ZZZ_equals(&revocations->bsn_list[i], &signature->K))
+            ret = -1;
+    }
+
+    return ret;
+}
+
+void check_schnorr_batch_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                             uint8_t **messages,
+                             uint32_t *message_lengths,
+                             uint8_t **basenames,
+                             uint32_t *basename_lengths,
+                             enum ecdaa_hash_to_curve hash_to_curve,
+                             size_t count,
+                             int *results)
+{
+    // As `schnorr_verify_ZZZ`, but with each step done for all `count` (<= ECDAA_SHA256_MULTI_LANES) signatures,
+    //  so the hashes can be computed side-by-side.
+    uint8_t transcripts[ECDAA_SHA256_MULTI_LANES][SCHNORR_ZZZ_TRANSCRIPT_MAX_LENGTH];
+    const uint8_t *transcript_ptrs[ECDAA_SHA256_MULTI_LANES];
+    uint32_t transcript_lengths[ECDAA_SHA256_MULTI_LANES];
+    const uint8_t *basename_ptrs[ECDAA_SHA256_MULTI_LANES];
+    uint32_t basename_lens[ECDAA_SHA256_MULTI_LANES];
+    const uint8_t *message_ptrs[ECDAA_SHA256_MULTI_LANES];
+
+    // 1) Compute the points hashed into c''
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = 0;
+        transcript_ptrs[i] = transcripts[i];
+        transcript_lengths[i] = 0;
+        basename_ptrs[i] = (NULL != basenames) ? basenames[i] : NULL;
+        basename_lens[i] = (NULL != basenames) ? basename_lengths[i] : 0;
+        message_ptrs[i] = messages[i];
+
+        ECP_ZZZ P2;
+        if (0 != basename_lens[i] && 0 != schnorr_basename_point_ZZZ(&P2, basename_ptrs[i], basename_lens[i], hash_to_curve)) {
+            results[i] = -1;
+            continue;
+        }
+
+        if (0 != schnorr_verify_transcript_ZZZ(transcripts[i],
+                                               &transcript_lengths[i],
+                                               signatures[i].c,
+                                               signatures[i].s,
+                                               &signatures[i].K,
+                                               &signatures[i].S,
+                                               &signatures[i].W,
+                                               basename_lens[i],
+                                               &P2,
+                                               NULL))
+            results[i] = -1;
+    }
+
+    // 2) c'' = Hash(transcript | basename | message)
+    BIG_XXX c_dbl_primes[ECDAA_SHA256_MULTI_LANES];
+    big_XXX_from_three_message_hash_batch(c_dbl_primes,
+                                          transcript_ptrs,
+                                          transcript_lengths,
+                                          basename_ptrs,
+                                          basename_lens,
+                                          message_ptrs,
+                                          message_lengths,
+                                          count);
+
+    // 3) c' = Hash(n | c'')
+    uint8_t challenge_inputs[ECDAA_SHA256_MULTI_LANES][SCHNORR_ZZZ_CHALLENGE_INPUT_LENGTH];
+    const uint8_t *challenge_input_ptrs[ECDAA_SHA256_MULTI_LANES];
+    uint32_t challenge_input_lengths[ECDAA_SHA256_MULTI_LANES];
+    for (size_t i = 0; i < count; ++i) {
+        schnorr_verify_challenge_input_ZZZ(challenge_inputs[i], signatures[i].n, c_dbl_primes[i]);
+        challenge_input_ptrs[i] = challenge_inputs[i];
+        challenge_input_lengths[i] = SCHNORR_ZZZ_CHALLENGE_INPUT_LENGTH;
+    }
+
+    BIG_XXX c_primes[ECDAA_SHA256_MULTI_LANES];
+    big_XXX_from_hash_batch(c_primes, challenge_input_ptrs, challenge_input_lengths, count);
+
+    // 4) Compare c' and c
+    for (size_t i = 0; i < count; ++i) {
+        if (0 != schnorr_verify_challenge_ZZZ(signatures[i].c, c_primes[i]))
+            results[i] = -1;
+    }
+}
+
+int batch_verify_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                     uint8_t **messages,
+                     uint32_t *message_lengths,
+                     uint8_t **basenames,
+                     uint32_t *basename_lengths,
+                     enum ecdaa_hash_to_curve hash_to_curve,
+                     size_t num_signatures,
+                     ECP2_ZZZ **g2_points,
+                     FP2_YYY **g2_lines,
+                     struct ecdaa_revocations_ZZZ *revocations,
+                     int *results)
+{
+    // 1) Check the Schnorr-type signatures and revocation lists individually
+    //  (these don't involve any pairings).
+    //  The Schnorr hashes are computed a group of signatures at a time.
+    for (size_t begin = 0; begin < num_signatures; begin += ECDAA_SHA256_MULTI_LANES) {
+        size_t count = num_signatures - begin;
+        if (count > ECDAA_SHA256_MULTI_LANES)
+            count = ECDAA_SHA256_MULTI_LANES;
+
+        check_schnorr_batch_ZZZ(signatures + begin,
+                                messages + begin,
+                                message_lengths + begin,
+                                (NULL != basenames) ? basenames + begin : NULL,
+                                (NULL != basenames) ? basename_lengths + begin : NULL,
+                                hash_to_curve,
+                                count,
+                                results + begin);
+    }
+
+    for (size_t i = 0; i < num_signatures; ++i) {
+        uint8_t *basename = NULL;
+        uint32_t basename_len = 0;
+        if (NULL != basenames) {
+            basename = basenames[i];
+            basename_len = basename_lengths[i];
+        }
+
+        if (0 != check_revocations_ZZZ(&signatures[i], revocations, basename, basename_len, hash_to_curve))
+            results[i] = -1;
+    }
+
+    // 2) Check the pairing equations of all remaining signatures at once,
+    //  bisecting to find the invalid ones if the combined check fails.
+    uint8_t seed[MODBYTES_XXX];
+    batch_seed_ZZZ(seed, signatures, num_signatures);
+
+    bisect_pairings_ZZZ(signatures, 0, num_signatures, 0, results, seed, g2_points, g2_lines);
+
+    for (size_t i = 0; i < num_signatures; ++i) {
+        if (0 != results[i])
+            return -1;
+    }
+
+    return 0;
+}
+
+void batch_seed_ZZZ(uint8_t *seed_out,
+                    struct ecdaa_signature_ZZZ *signatures,
+                    size_t num_signatures)
+{
+    // Hash-chain over the points of every signature in the batch,
+    //  so each randomizer depends on the whole batch.
+    uint8_t points[4*ECP_ZZZ_LENGTH];
+    BIG_XXX digest;
+
+    memset(seed_out, 0, MODBYTES_XXX);
+    for (size_t i = 0; i < num_signatures; ++i) {
+        ecp_ZZZ_serialize(points, &signatures[i].R);
+        ecp_ZZZ_serialize(points + ECP_ZZZ_LENGTH, &signatures[i].S);
+        ecp_ZZZ_serialize(points + 2*ECP_ZZZ_LENGTH, &signatures[i].T);
+        ecp_ZZZ_serialize(points + 3*ECP_ZZZ_LENGTH, &signatures[i].W);
+
+        big_XXX_from_two_message_hash(&digest, seed_out, MODBYTES_XXX, points, sizeof(points));
+        BIG_XXX_toBytes((char*)seed_out, digest);
+    }
+}
+
+void batch_randomizer_ZZZ(BIG_XXX *randomizer_out,
+                          uint8_t *seed,
+                          size_t index,
+                          uint8_t which)
+{
+    // H(seed | index | which), truncated to BATCH_RANDOMIZER_BITS
+    //  (which halves the doublings of the multi-scalar multiplications).
+    uint8_t tag[5];
+    tag[0] = (uint8_t)(index >> 24);
+    tag[1] = (uint8_t)(index >> 16);
+    tag[2] = (uint8_t)(index >> 8);
+    tag[3] = (uint8_t)index;
+    tag[4] = which;
+    big_XXX_from_two_message_hash(randomizer_out, seed, MODBYTES_XXX, tag, sizeof(tag));
+    BIG_XXX_mod2m(*randomizer_out, BATCH_RANDOMIZER_BITS);
+
+    // A zero randomizer would drop that signature from the check.
+    if (BIG_XXX_iszilch(*randomizer_out))
+        BIG_XXX_one(*randomizer_out);
+}
+
+int check_pairings_batch_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                             size_t begin,
+                             size_t end,
+                             int *results,
+                             uint8_t *seed,
+                             ECP2_ZZZ **g2_points,
+                             FP2_YYY **g2_lines)
+{
+    // For randomizers rho_i and sigma_i, check
+    //  e(sum(rho_i*R_i), Y) * e(sum(sigma_i*T_i - rho_i*S_i), P_2) * e(-sum(sigma_i*(R_i+W_i)), X) == 1
+    //  Each sum is one multi-scalar multiplication per group of BATCH_PAIRING_GROUP_SIZE signatures.
+    ECP_ZZZ sum_Y, sum_P2, sum_X;
+    ECP_ZZZ_inf(&sum_Y);
+    ECP_ZZZ_inf(&sum_P2);
+    ECP_ZZZ_inf(&sum_X);
+
+    ECP_ZZZ neg_S[BATCH_PAIRING_GROUP_SIZE];
+    ECP_ZZZ neg_RW[BATCH_PAIRING_GROUP_SIZE];
+    ECP_ZZZ *Y_points[BATCH_PAIRING_GROUP_SIZE];
+    ECP_ZZZ *P2_points[2*BATCH_PAIRING_GROUP_SIZE];
+    ECP_ZZZ *X_points[BATCH_PAIRING_GROUP_SIZE];
+    BIG_XXX Y_scalars[BATCH_PAIRING_GROUP_SIZE];
+    BIG_XXX P2_scalars[2*BATCH_PAIRING_GROUP_SIZE];
+    BIG_XXX X_scalars[BATCH_PAIRING_GROUP_SIZE];
+
+    ECP_ZZZ partial;
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (0 == results[i]) {
+            // rho_i = H(seed | i | 0), sigma_i = H(seed | i | 1)
+            batch_randomizer_ZZZ(&Y_scalars[count], seed, i, 0);
+            batch_randomizer_ZZZ(&X_scalars[count], seed, i, 1);
+
+            Y_points[count] = &signatures[i].R;
+
+            ECP_ZZZ_copy(&neg_S[count], &signatures[i].S);
+            ECP_ZZZ_neg(&neg_S[count]);
+            P2_points[2*count] = &signatures[i].T;
+            BIG_XXX_copy(P2_scalars[2*count], X_scalars[count]);
+            P2_points[2*count + 1] = &neg_S[count];
+            BIG_XXX_copy(P2_scalars[2*count + 1], Y_scalars[count]);
+
+            ECP_ZZZ_copy(&neg_RW[count], &signatures[i].R);
+            ECP_ZZZ_add(&neg_RW[count], &signatures[i].W);
+            ECP_ZZZ_neg(&neg_RW[count]);
+            X_points[count] = &neg_RW[count];
+
+            ++count;
+        }
+
+        if (BATCH_PAIRING_GROUP_SIZE == count || (end == i + 1 && 0 != count)) {
+            ecp_ZZZ_mul_multi(&partial, Y_points, Y_scalars, count);
+            ECP_ZZZ_add(&sum_Y, &partial);
+            ecp_ZZZ_mul_multi(&partial, P2_points, P2_scalars, 2*count);
+            ECP_ZZZ_add(&sum_P2, &partial);
+            ecp_ZZZ_mul_multi(&partial, X_points, X_scalars, count);
+            ECP_ZZZ_add(&sum_X, &partial);
+
+            count = 0;
+        }
+    }
+
+    ECP_ZZZ *g1_points[3] = {&sum_Y, &sum_P2, &sum_X};
+
+    FP12_YYY product;
+    compute_pairing_product_with_lines_ZZZ(&product, g1_points, g2_points, g2_lines, 3);
+
+    if (!FP12_YYY_isunity(&product))
+        return -1;
+
+    return 0;
+}
+
+int bisect_pairings_ZZZ(struct ecdaa_signature_ZZZ *signatures,
+                        size_t begin,
+                        size_t end,
+                        int known_invalid,
+                        int *results,
+                        uint8_t *seed,
+                        ECP2_ZZZ **g2_points,
+                        FP2_YYY **g2_lines)
+{
+    size_t count = 0;
+    size_t last = begin;
+    for (size_t i = begin; i < end; ++i) {
+        if (0 == results[i]) {
+            ++count;
+            last = i;
+        }
+    }
+
+    if (0 == count)
+        return 0;
+
+    if (!known_invalid && 0 == check_pairings_batch_ZZZ(signatures, begin, end, results, seed, g2_points, g2_lines))
+        return 0;
+
+    if (1 == count) {
+        results[last] = -1;
+        return -1;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    int left_ret = bisect_pairings_ZZZ(signatures, begin, middle, 0, results, seed, g2_points, g2_lines);
+
+    // The randomizers don't change between halves, so if the left half is valid
+    //  the right half must contain the invalid signature(s).
+    bisect_pairings_ZZZ(signatures, middle, end, 0 == left_ret, results, seed, g2_points, g2_lines);
+
+    return -1;
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include <ecdaa/verifier_pool_ZZZ.h>
+
+#include <ecdaa/signature_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+static
+void *worker_ZZZ(void *pool_in);
+
+static
+void stop_workers_ZZZ(struct ecdaa_verifier_pool_ZZZ *pool, size_t num_started);
+
+static
+void signal_event_fd_ZZZ(struct ecdaa_verifier_pool_ZZZ *pool);
+
+int ecdaa_verifier_pool_ZZZ_init(struct ecdaa_verifier_pool_ZZZ *pool,
+                                 struct ecdaa_prepared_gpk_ZZZ *prepared_gpk,
+                                 struct ecdaa_revocations_ZZZ *revocations,
+                                 enum ecdaa_verify_policy policy,
+                                 pthread_t *threads,
+                                 size_t num_threads,
+                                 struct ecdaa_verifier_pool_job_ZZZ **submitted_storage,
+                                 struct ecdaa_verifier_pool_job_ZZZ **completed_storage,
+                                 size_t queue_capacity)
+{
+    if (0 == num_threads || 0 == queue_capacity)
+        return -1;
+
+    pool->prepared_gpk = prepared_gpk;
+    pool->revocations = revocations;
+    pool->policy = policy;
+    pool->threads = threads;
+    pool->num_threads = num_threads;
+    pool->submitted = submitted_storage;
+    pool->submitted_head = 0;
+    pool->submitted_count = 0;
+    pool->completed = completed_storage;
+    pool->completed_head = 0;
+    pool->completed_count = 0;
+    pool->queue_capacity = queue_capacity;
+    pool->in_flight = 0;
+    pool->shutting_down = 0;
+    pool->event_fd = -1;
+
+#ifdef __linux__
+    pool->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (pool->event_fd < 0)
+        return -1;
+#endif
+
+    if (0 != pthread_mutex_init(&pool->mutex, NULL))
+        goto close_event_fd;
+    if (0 != pthread_cond_init(&pool->submitted_cond, NULL))
+        goto destroy_mutex;
+    if (0 != pthread_cond_init(&pool->completed_cond, NULL))
+        goto destroy_submitted_cond;
+
+    for (size_t i = 0; i < num_threads; ++i) {
+        if (0 != pthread_create(&threads[i], NULL, worker_ZZZ, pool)) {
+            stop_workers_ZZZ(pool, i);
+            goto destroy_completed_cond;
+        }
+    }
+
+    return 0;
+
+destroy_completed_cond:
+    pthread_cond_destroy(&pool->completed_cond);
+destroy_submitted_cond:
+    pthread_cond_destroy(&pool->submitted_cond);
+destroy_mutex:
+    pthread_mutex_destroy(&pool->mutex);
+close_event_fd:
+#ifdef __linux__
+    close(pool->event_fd);
+#endif
+    pool->event_fd = -1;
+    return -1;
+}
+
+int ecdaa_verifier_pool_ZZZ_submit(struct ecdaa_verifier_pool_ZZZ *pool,
+                                   struct ecdaa_verifier_pool_job_ZZZ *job)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (!pool->shutting_down && pool->in_flight < pool->queue_capacity) {
+        size_t tail = (pool->submitted_head + pool->submitted_count) % pool->queue_capacity;
+        pool->submitted[tail] = job;
+        pool->submitted_count++;
+        pool->in_flight++;
+        pthread_cond_signal(&pool->submitted_cond);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ret;
+}
+
+size_t ecdaa_verifier_pool_ZZZ_poll(struct ecdaa_verifier_pool_ZZZ *pool,
+                                    struct ecdaa_verifier_pool_job_ZZZ **jobs_out,
+                                    size_t max_jobs)
+{
+    size_t num_jobs = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (num_jobs < max_jobs && pool->completed_count > 0) {
+        jobs_out[num_jobs++] = pool->completed[pool->completed_head];
+        pool->completed_head = (pool->completed_head + 1) % pool->queue_capacity;
+        pool->completed_count--;
+        pool->in_flight--;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return num_jobs;
+}
+
+size_t ecdaa_verifier_pool_ZZZ_wait(struct ecdaa_verifier_pool_ZZZ *pool,
+                                    struct ecdaa_verifier_pool_job_ZZZ **jobs_out,
+                                    size_t max_jobs)
+{
+    pthread_mutex_lock(&pool->mutex);
+    // Jobs with callbacks never reach the completion queue,
+    //  so stop waiting once nothing is left in the pool.
+    while (0 == pool->completed_count && pool->in_flight > 0) {
+        pthread_cond_wait(&pool->completed_cond, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ecdaa_verifier_pool_ZZZ_poll(pool, jobs_out, max_jobs);
+}
+
+int ecdaa_verifier_pool_ZZZ_event_fd(struct ecdaa_verifier_pool_ZZZ *pool)
+{
+    return pool->event_fd;
+}
+
+void ecdaa_verifier_pool_ZZZ_destroy(struct ecdaa_verifier_pool_ZZZ *pool)
+{
+    stop_workers_ZZZ(pool, pool->num_threads);
+
+    pthread_cond_destroy(&pool->completed_cond);
+    pthread_cond_destroy(&pool->submitted_cond);
+    pthread_mutex_destroy(&pool->mutex);
+
+#ifdef __linux__
+    close(pool->event_fd);
+#endif
+    pool->event_fd = -1;
+}
+
+void *worker_ZZZ(void *pool_in)
+{
+    struct ecdaa_verifier_pool_ZZZ *pool = pool_in;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (0 == pool->submitted_count && !pool->shutting_down) {
+            pthread_cond_wait(&pool->submitted_cond, &pool->mutex);
+        }
+
+        // Finish every submitted job before exiting.
+        if (0 == pool->submitted_count)
+            break;
+
+        struct ecdaa_verifier_pool_job_ZZZ *job = pool->submitted[pool->submitted_head];
+        pool->submitted_head = (pool->submitted_head + 1) % pool->queue_capacity;
+        pool->submitted_count--;
+        pthread_mutex_unlock(&pool->mutex);
+
+        job->result = ecdaa_signature_ZZZ_verify_prepared_with_policy(job->signature,
+                                                                      pool->prepared_gpk,
+                                                                      pool->revocations,
+                                                                      job->message,
+                                                                      job->message_len,
+                                                                      job->basename,
+                                                                      job->basename_len,
+                                                                      pool->policy,
+                                                                      &job->rejected_stage);
+
+        if (NULL != job->callback) {
+            job->callback(job);
+
+            pthread_mutex_lock(&pool->mutex);
+            pool->in_flight--;
+            pthread_cond_broadcast(&pool->completed_cond);
+        } else {
+            pthread_mutex_lock(&pool->mutex);
+            size_t tail = (pool->completed_head + pool->completed_count) % pool->queue_capacity;
+            pool->completed[tail] = job;
+            pool->completed_count++;
+            pthread_cond_broadcast(&pool->completed_cond);
+            signal_event_fd_ZZZ(pool);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+void stop_workers_ZZZ(struct ecdaa_verifier_pool_ZZZ *pool, size_t num_started)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutting_down = 1;
+    pthread_cond_broadcast(&pool->submitted_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < num_started; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+void signal_event_fd_ZZZ(struct ecdaa_verifier_pool_ZZZ *pool)
+{
+#ifdef __linux__
+    // Only fails if the counter would overflow, in which case it's already readable.
+    uint64_t one = 1;
+    ssize_t ret = write(pool->event_fd, &one, sizeof(one));
+    (void)ret;
+#else
+    (void)pool;
+#endif
+}
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <ecdaa/accumulator_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include <string.h>
+
+static void issued_witness_is_valid();
+static void update_keeps_witness_valid();
+static void revoked_member_cannot_update();
+static void update_out_of_order_fails();
+static void serialize_deserialize();
+
+typedef struct accumulator_fixture {
+    struct ecdaa_accumulator_public_key_ZZZ pk;
+    struct ecdaa_accumulator_secret_key_ZZZ sk;
+    struct ecdaa_accumulator_ZZZ accumulator;
+    struct ecdaa_member_public_key_ZZZ member_pk[2];
+    struct ecdaa_accumulator_witness_ZZZ witness[2];
+} accumulator_fixture;
+
+static void setup(accumulator_fixture *fixture);
+
+int main()
+{
+    issued_witness_is_valid();
+    update_keeps_witness_valid();
+    revoked_member_cannot_update();
+    update_out_of_order_fails();
+    serialize_deserialize();
+}
+
+static void setup(accumulator_fixture *fixture)
+{
+    ecdaa_accumulator_ZZZ_generate(&fixture->pk, &fixture->sk, &fixture->accumulator, test_randomness);
+
+    for (size_t i = 0; i < 2; ++i) {
+        BIG_XXX member_sk;
+        ecp_ZZZ_random_mod_order(&member_sk, test_randomness);
+        ecp_ZZZ_set_to_generator(&fixture->member_pk[i].Q);
+        ECP_ZZZ_mul(&fixture->member_pk[i].Q, member_sk);
+
+        ecdaa_accumulator_ZZZ_issue_witness(&fixture->witness[i], &fixture->accumulator, &fixture->sk, &fixture->member_pk[i], test_randomness);
+    }
+}
+
+static void issued_witness_is_valid()
+{
+    printf("Starting accumulator::issued_witness_is_valid...\n");
+
+    accumulator_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &fixture.accumulator, &fixture.pk, &fixture.member_pk[0]));
+
+    // Wrong member
+    TEST_ASSERT(-1 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &fixture.accumulator, &fixture.pk, &fixture.member_pk[1]));
+
+    printf("\tsuccess\n");
+}
+
+static void update_keeps_witness_valid()
+{
+    printf("Starting accumulator::update_keeps_witness_valid...\n");
+
+    accumulator_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_update_ZZZ update;
+    ecdaa_accumulator_ZZZ_revoke(&update, &fixture.accumulator, &fixture.sk, fixture.witness[1].e);
+    TEST_ASSERT(1 == fixture.accumulator.epoch);
+
+    // Stale witness
+    TEST_ASSERT(-1 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &fixture.accumulator, &fixture.pk, &fixture.member_pk[0]));
+
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[0], &update));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &fixture.accumulator, &fixture.pk, &fixture.member_pk[0]));
+
+    printf("\tsuccess\n");
+}
+
+static void revoked_member_cannot_update()
+{
+    printf("Starting accumulator::revoked_member_cannot_update...\n");
+
+    accumulator_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_update_ZZZ update;
+    ecdaa_accumulator_ZZZ_revoke(&update, &fixture.accumulator, &fixture.sk, fixture.witness[1].e);
+
+    TEST_ASSERT(-1 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[1], &update));
+    TEST_ASSERT(0 == fixture.witness[1].epoch);
+
+    // Even pretending the witness is current doesn't help
+    fixture.witness[1].epoch = fixture.accumulator.epoch;
+    TEST_ASSERT(-1 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[1], &fixture.accumulator, &fixture.pk, &fixture.member_pk[1]));
+
+    printf("\tsuccess\n");
+}
+
+static void update_out_of_order_fails()
+{
+    printf("Starting accumulator::update_out_of_order_fails...\n");
+
+    accumulator_fixture fixture;
+    setup(&fixture);
+
+    // Revoke twice (the second value isn't held by either member)
+    BIG_XXX e;
+    ecp_ZZZ_random_mod_order(&e, test_randomness);
+
+    struct ecdaa_accumulator_update_ZZZ first, second;
+    ecdaa_accumulator_ZZZ_revoke(&first, &fixture.accumulator, &fixture.sk, fixture.witness[1].e);
+    ecdaa_accumulator_ZZZ_revoke(&second, &fixture.accumulator, &fixture.sk, e);
+
+    TEST_ASSERT(-2 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[0], &second));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[0], &first));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[0], &second));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &fixture.accumulator, &fixture.pk, &fixture.member_pk[0]));
+
+    printf("\tsuccess\n");
+}
+
+static void serialize_deserialize()
+{
+    printf("Starting accumulator::serialize_deserialize...\n");
+
+    accumulator_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_update_ZZZ update;
+    ecdaa_accumulator_ZZZ_revoke(&update, &fixture.accumulator, &fixture.sk, fixture.witness[1].e);
+
+    uint8_t pk_buffer[ECDAA_ACCUMULATOR_PUBLIC_KEY_ZZZ_LENGTH];
+    TEST_ASSERT(sizeof(pk_buffer) == ecdaa_accumulator_public_key_ZZZ_length());
+    ecdaa_accumulator_public_key_ZZZ_serialize(pk_buffer, &fixture.pk);
+    struct ecdaa_accumulator_public_key_ZZZ pk;
+    TEST_ASSERT(0 == ecdaa_accumulator_public_key_ZZZ_deserialize(&pk, pk_buffer));
+    TEST_ASSERT(ECP2_ZZZ_equals(&pk.S2, &fixture.pk.S2));
+
+    uint8_t accumulator_buffer[ECDAA_ACCUMULATOR_ZZZ_LENGTH];
+    TEST_ASSERT(sizeof(accumulator_buffer) == ecdaa_accumulator_ZZZ_length());
+    ecdaa_accumulator_ZZZ_serialize(accumulator_buffer, &fixture.accumulator);
+    struct ecdaa_accumulator_ZZZ accumulator;
+    TEST_ASSERT(0 == ecdaa_accumulator_ZZZ_deserialize(&accumulator, accumulator_buffer));
+    TEST_ASSERT(1 == accumulator.epoch);
+    TEST_ASSERT(ECP_ZZZ_equals(&accumulator.V, &fixture.accumulator.V));
+
+    uint8_t update_buffer[ECDAA_ACCUMULATOR_UPDATE_ZZZ_LENGTH];
+    TEST_ASSERT(sizeof(update_buffer) == ecdaa_accumulator_update_ZZZ_length());
+    ecdaa_accumulator_update_ZZZ_serialize(update_buffer, &update);
+    struct ecdaa_accumulator_update_ZZZ update_in;
+    TEST_ASSERT(0 == ecdaa_accumulator_update_ZZZ_deserialize(&update_in, update_buffer));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness[0], &update_in));
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_validate(&fixture.witness[0], &accumulator, &pk, &fixture.member_pk[0]));
+
+    // Corrupt V
+    update_buffer[8 + MODBYTES_XXX] = 0;
+    TEST_ASSERT(-1 == ecdaa_accumulator_update_ZZZ_deserialize(&update_in, update_buffer));
+
+    printf("\tsuccess\n");
+}
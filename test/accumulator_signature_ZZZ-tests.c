@@ -0,0 +1,236 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+
+#include <ecdaa/accumulator_ZZZ.h>
+#include <ecdaa/accumulator_signature_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/credential_ZZZ.h>
+#include <ecdaa/issuer_keypair_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+
+#include <string.h>
+
+static void sign_then_verify_good();
+static void sign_then_verify_with_revocations();
+static void revoked_member_fails();
+static void old_epoch_fails();
+static void modified_proof_fails();
+static void serialize_deserialize();
+
+typedef struct accumulator_signature_fixture {
+    uint8_t *msg;
+    uint32_t msg_len;
+    uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_member_public_key_ZZZ pk;
+    struct ecdaa_member_secret_key_ZZZ sk;
+    struct ecdaa_issuer_public_key_ZZZ ipk;
+    struct ecdaa_issuer_secret_key_ZZZ isk;
+    struct ecdaa_credential_ZZZ cred;
+    struct ecdaa_accumulator_public_key_ZZZ accumulator_pk;
+    struct ecdaa_accumulator_secret_key_ZZZ accumulator_sk;
+    struct ecdaa_accumulator_ZZZ accumulator;
+    struct ecdaa_accumulator_witness_ZZZ witness;
+} accumulator_signature_fixture;
+
+static void setup(accumulator_signature_fixture* fixture);
+
+int main()
+{
+    sign_then_verify_good();
+    sign_then_verify_with_revocations();
+    revoked_member_fails();
+    old_epoch_fails();
+    modified_proof_fails();
+    serialize_deserialize();
+}
+
+static void setup(accumulator_signature_fixture* fixture)
+{
+    ecp_ZZZ_random_mod_order(&fixture->isk.x, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.X);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.X, fixture->isk.x);
+
+    ecp_ZZZ_random_mod_order(&fixture->isk.y, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.Y);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.Y, fixture->isk.y);
+
+    ecp_ZZZ_set_to_generator(&fixture->pk.Q);
+    ecp_ZZZ_random_mod_order(&fixture->sk.sk, test_randomness);
+    ECP_ZZZ_mul(&fixture->pk.Q, fixture->sk.sk);
+
+    struct ecdaa_credential_ZZZ_signature cred_sig;
+    ecdaa_credential_ZZZ_generate(&fixture->cred, &cred_sig, &fixture->isk, &fixture->pk, test_randomness);
+
+    ecdaa_accumulator_ZZZ_generate(&fixture->accumulator_pk, &fixture->accumulator_sk, &fixture->accumulator, test_randomness);
+    ecdaa_accumulator_ZZZ_issue_witness(&fixture->witness, &fixture->accumulator, &fixture->accumulator_sk, &fixture->pk, test_randomness);
+
+    fixture->msg = (uint8_t*) "Test message";
+    fixture->msg_len = (uint32_t)strlen((char*)fixture->msg);
+
+    fixture->basename = (uint8_t*) "BASENAME";
+    fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
+}
+
+static void sign_then_verify_good()
+{
+    printf("Starting accumulator_signature::sign_then_verify_good...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    // Wrong message
+    uint8_t *other_msg = (uint8_t*) "Other message";
+    TEST_ASSERT(-1 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, other_msg, (uint32_t)strlen((char*)other_msg), NULL, 0));
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_with_revocations()
+{
+    printf("Starting accumulator_signature::sign_then_verify_with_revocations...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    struct ecdaa_revocations_ZZZ revocations;
+    ecdaa_revocations_ZZZ_init(&revocations);
+    revocations.bsn_length = 1;
+    revocations.bsn_list = &sig.signature.K;
+    TEST_ASSERT(-1 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, &revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    revocations.bsn_length = 0;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, &revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    printf("\tsuccess\n");
+}
+
+static void revoked_member_fails()
+{
+    printf("Starting accumulator_signature::revoked_member_fails...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_update_ZZZ update;
+    ecdaa_accumulator_ZZZ_revoke(&update, &fixture.accumulator, &fixture.accumulator_sk, fixture.witness.e);
+    TEST_ASSERT(-1 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness, &update));
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    // Signing anyway, with the stale witness
+    fixture.witness.epoch = fixture.accumulator.epoch;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    printf("\tsuccess\n");
+}
+
+static void old_epoch_fails()
+{
+    printf("Starting accumulator_signature::old_epoch_fails...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    // Revoke someone else
+    BIG_XXX e;
+    ecp_ZZZ_random_mod_order(&e, test_randomness);
+    struct ecdaa_accumulator_update_ZZZ update;
+    ecdaa_accumulator_ZZZ_revoke(&update, &fixture.accumulator, &fixture.accumulator_sk, e);
+
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    // Claiming the new epoch doesn't help
+    sig.epoch = fixture.accumulator.epoch;
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    // After updating, the member can sign again
+    TEST_ASSERT(0 == ecdaa_accumulator_witness_ZZZ_update(&fixture.witness, &update));
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    printf("\tsuccess\n");
+}
+
+static void modified_proof_fails()
+{
+    printf("Starting accumulator_signature::modified_proof_fails...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    struct ecdaa_accumulator_signature_ZZZ modified = sig;
+    ECP_ZZZ_add(&modified.A_bar, &modified.X);
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&modified, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    modified = sig;
+    BIG_XXX_inc(modified.s_sk, 1);
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&modified, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    // A proof can't be moved to another signature
+    modified = sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&modified.signature, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(-2 == ecdaa_accumulator_signature_ZZZ_verify(&modified, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, NULL, 0));
+
+    printf("\tsuccess\n");
+}
+
+static void serialize_deserialize()
+{
+    printf("Starting accumulator_signature::serialize_deserialize...\n");
+
+    accumulator_signature_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_accumulator_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, &fixture.witness, &fixture.accumulator, test_randomness));
+
+    uint8_t buffer[ECDAA_ACCUMULATOR_SIGNATURE_ZZZ_WITH_NYM_LENGTH];
+    TEST_ASSERT(sizeof(buffer) == ecdaa_accumulator_signature_ZZZ_with_nym_length());
+    ecdaa_accumulator_signature_ZZZ_serialize(buffer, &sig, 1);
+
+    struct ecdaa_accumulator_signature_ZZZ sig_in;
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_deserialize(&sig_in, buffer, 1));
+    TEST_ASSERT(0 == ecdaa_accumulator_signature_ZZZ_verify(&sig_in, &fixture.ipk.gpk, &fixture.accumulator_pk, &fixture.accumulator, NULL, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Corrupt X
+    buffer[ECDAA_SIGNATURE_ZZZ_WITH_NYM_LENGTH + 8] = 0;
+    TEST_ASSERT(-1 == ecdaa_accumulator_signature_ZZZ_deserialize(&sig_in, buffer, 1));
+
+    printf("\tsuccess\n");
+}
@@ -37,6 +37,8 @@ static void mul_and_add_modulus_two();
 static void mul_and_add_normalization_works();
 static void mul_and_add_greater_than_modulus_ok();
 static void mul_and_add_small_sanity_check();
+static void wnaf_recodes_correctly();
+static void hash_batch_matches_single();
 
 int main()
 {
@@ -51,6 +53,8 @@ int main()
     mul_and_add_normalization_works();
     mul_and_add_greater_than_modulus_ok();
     mul_and_add_small_sanity_check();
+    wnaf_recodes_correctly();
+    hash_batch_matches_single();
 }
 
 void hash_not_zero()
@@ -323,3 +327,94 @@ void mul_and_add_small_sanity_check()
     printf("\tsuccess\n");
 }
 
+static void wnaf_recodes_correctly()
+{
+    printf("Starting mpi_utils::wnaf_recodes_correctly...\n");
+
+    uint8_t msg[] = "wnaf";
+    BIG_XXX scalars[3];
+    BIG_XXX_zero(scalars[0]);
+    BIG_XXX_zero(scalars[1]);
+    scalars[1][0] = 0x5F;
+    big_XXX_from_hash(&scalars[2], msg, sizeof(msg));
+    BIG_XXX_norm(scalars[2]);
+
+    for (int s = 0; s < 3; ++s) {
+        for (int w = 2; w <= 7; ++w) {
+            signed char digits[BIG_XXX_WNAF_MAX_DIGITS];
+            int num_digits = big_XXX_to_wnaf(digits, scalars[s], w);
+            TEST_ASSERT(num_digits <= BIG_XXX_WNAF_MAX_DIGITS);
+            if (0 == s)
+                TEST_ASSERT(0 == num_digits);
+
+            int last_nonzero = -w;
+            BIG_XXX reconstructed;
+            BIG_XXX_zero(reconstructed);
+            for (int i = num_digits - 1; i >= 0; --i) {
+                if (0 != digits[i]) {
+                    TEST_ASSERT(1 == (digits[i] & 1));
+                    TEST_ASSERT(digits[i] < (1 << (w - 1)) && -digits[i] < (1 << (w - 1)));
+                    TEST_ASSERT(num_digits - 1 == i || last_nonzero - i >= w);
+                    last_nonzero = i;
+                }
+
+                BIG_XXX_shl(reconstructed, 1);
+                if (digits[i] > 0)
+                    BIG_XXX_inc(reconstructed, digits[i]);
+                else
+                    BIG_XXX_dec(reconstructed, -digits[i]);
+                BIG_XXX_norm(reconstructed);
+            }
+
+            TEST_ASSERT(0 == BIG_XXX_comp(reconstructed, scalars[s]));
+        }
+    }
+
+    printf("\tsuccess\n");
+}
+
+void hash_batch_matches_single()
+{
+    printf("Starting mpi_utils::hash_batch_matches_single...\n");
+
+    enum { NUM_HASHES = 11 };
+    uint8_t msgs[NUM_HASHES][150];
+    const uint8_t *msg_ptrs[NUM_HASHES];
+    uint32_t msg_lens[NUM_HASHES];
+    for (size_t i = 0; i < NUM_HASHES; ++i) {
+        memset(msgs[i], (int)i, sizeof(msgs[i]));
+        msg_ptrs[i] = msgs[i];
+        msg_lens[i] = (uint32_t)(13 * i);
+    }
+
+    BIG_XXX batch[NUM_HASHES];
+    BIG_XXX single;
+
+    big_XXX_from_hash_batch(batch, msg_ptrs, msg_lens, NUM_HASHES);
+    for (size_t i = 0; i < NUM_HASHES; ++i) {
+        big_XXX_from_hash(&single, msg_ptrs[i], msg_lens[i]);
+        TEST_ASSERT(0 == BIG_XXX_comp(single, batch[i]));
+    }
+
+    // Second and third messages: the same ones, in reverse order
+    const uint8_t *msg2_ptrs[NUM_HASHES];
+    uint32_t msg2_lens[NUM_HASHES];
+    for (size_t i = 0; i < NUM_HASHES; ++i) {
+        msg2_ptrs[i] = msg_ptrs[NUM_HASHES - 1 - i];
+        msg2_lens[i] = msg_lens[NUM_HASHES - 1 - i];
+    }
+
+    big_XXX_from_two_message_hash_batch(batch, msg_ptrs, msg_lens, msg2_ptrs, msg2_lens, NUM_HASHES);
+    for (size_t i = 0; i < NUM_HASHES; ++i) {
+        big_XXX_from_two_message_hash(&single, msg_ptrs[i], msg_lens[i], msg2_ptrs[i], msg2_lens[i]);
+        TEST_ASSERT(0 == BIG_XXX_comp(single, batch[i]));
+    }
+
+    big_XXX_from_three_message_hash_batch(batch, msg_ptrs, msg_lens, msg2_ptrs, msg2_lens, msg_ptrs, msg_lens, NUM_HASHES);
+    for (size_t i = 0; i < NUM_HASHES; ++i) {
+        big_XXX_from_three_message_hash(&single, msg_ptrs[i], msg_lens[i], msg2_ptrs[i], msg2_lens[i], msg_ptrs[i], msg_lens[i]);
+        TEST_ASSERT(0 == BIG_XXX_comp(single, batch[i]));
+    }
+
+    printf("\tsuccess!\n");
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+
+#define CAPACITY 64
+#define NUM_POINTS 40
+
+static void init_bad_capacity_fails();
+static void inserted_points_contained();
+static void insert_fails_when_full();
+static void insert_duplicate_is_noop();
+
+static void random_points(ECP_ZZZ *points_out, size_t num_points);
+
+int main()
+{
+    init_bad_capacity_fails();
+    inserted_points_contained();
+    insert_fails_when_full();
+    insert_duplicate_is_noop();
+}
+
+static void init_bad_capacity_fails()
+{
+    printf("Starting bsn_revocation_set::init_bad_capacity_fails...\n");
+
+    uint8_t slots[CAPACITY * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    uint8_t bloom[64];
+    struct ecdaa_bsn_revocation_set_ZZZ set;
+
+    TEST_ASSERT(0 != ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, 0, NULL, 0));
+    TEST_ASSERT(0 != ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY - 1, NULL, 0));
+    TEST_ASSERT(0 != ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, bloom, 0));
+    TEST_ASSERT(0 != ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, bloom, 63));
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, bloom, 64));
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, NULL, 0));
+
+    printf("\tsuccess\n");
+}
+
+static void inserted_points_contained()
+{
+    printf("Starting bsn_revocation_set::inserted_points_contained...\n");
+
+    ECP_ZZZ points[2*NUM_POINTS];
+    random_points(points, 2*NUM_POINTS);
+
+    uint8_t slots[CAPACITY * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    uint8_t bloom[64];
+
+    // Once without, once with, the Bloom filter
+    for (int use_bloom = 0; use_bloom < 2; ++use_bloom) {
+        struct ecdaa_bsn_revocation_set_ZZZ set;
+        TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, use_bloom ? bloom : NULL, sizeof(bloom)));
+
+        for (size_t i = 0; i < NUM_POINTS; ++i) {
+            TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&set, &points[i]));
+        }
+
+        for (size_t i = 0; i < NUM_POINTS; ++i) {
+            TEST_ASSERT(1 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &points[i]));
+        }
+
+        for (size_t i = NUM_POINTS; i < 2*NUM_POINTS; ++i) {
+            TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &points[i]));
+        }
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void insert_fails_when_full()
+{
+    printf("Starting bsn_revocation_set::insert_fails_when_full...\n");
+
+    ECP_ZZZ points[CAPACITY];
+    random_points(points, CAPACITY);
+
+    uint8_t slots[CAPACITY * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_bsn_revocation_set_ZZZ set;
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, NULL, 0));
+
+    // One slot is always left empty
+    for (size_t i = 0; i < CAPACITY - 1; ++i) {
+        TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&set, &points[i]));
+    }
+    TEST_ASSERT(0 != ecdaa_bsn_revocation_set_ZZZ_insert(&set, &points[CAPACITY - 1]));
+
+    for (size_t i = 0; i < CAPACITY - 1; ++i) {
+        TEST_ASSERT(1 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &points[i]));
+    }
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &points[CAPACITY - 1]));
+
+    printf("\tsuccess\n");
+}
+
+static void insert_duplicate_is_noop()
+{
+    printf("Starting bsn_revocation_set::insert_duplicate_is_noop...\n");
+
+    ECP_ZZZ points[1];
+    random_points(points, 1);
+
+    // Same point, but not in affine coordinates
+    ECP_ZZZ doubled, same;
+    ECP_ZZZ_copy(&doubled, &points[0]);
+    ECP_ZZZ_dbl(&doubled);
+    ECP_ZZZ_copy(&same, &doubled);
+    ECP_ZZZ_sub(&same, &points[0]);
+
+    uint8_t slots[CAPACITY * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_bsn_revocation_set_ZZZ set;
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&set, slots, CAPACITY, NULL, 0));
+
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&set, &points[0]));
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&set, &same));
+    TEST_ASSERT(1 == set.count);
+    TEST_ASSERT(1 == ecdaa_bsn_revocation_set_ZZZ_contains(&set, &same));
+
+    printf("\tsuccess\n");
+}
+
+static void random_points(ECP_ZZZ *points_out, size_t num_points)
+{
+    for (size_t i = 0; i < num_points; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ecp_ZZZ_mul_generator(&points_out[i], scalar);
+    }
+}
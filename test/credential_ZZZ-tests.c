@@ -21,6 +21,7 @@
 #include <ecdaa/credential_ZZZ.h>
 #include <ecdaa/member_keypair_ZZZ.h>
 #include <ecdaa/issuer_keypair_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
 
 #include "amcl-extensions/big_XXX.h"
 #include "amcl-extensions/ecp_ZZZ.h"
@@ -43,6 +44,7 @@ static void setup(credential_test_fixture* fixture);
 static void teardown(credential_test_fixture* fixture);
 
 static void cred_generate_then_validate();
+static void cred_generate_then_validate_prepared();
 static void lengths_same();
 static void cred_generate_then_serialize_deserialize();
 static void cred_generate_then_serialize_deserialize_file();
@@ -51,6 +53,7 @@ static void cred_generate_then_serialize_deserialize_fp();
 int main()
 {
     cred_generate_then_validate();
+    cred_generate_then_validate_prepared();
     lengths_same();
     cred_generate_then_serialize_deserialize();
     cred_generate_then_serialize_deserialize_file();
@@ -95,6 +98,37 @@ static void cred_generate_then_validate()
     printf("\tsuccess\n");
 }
 
+static struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+
+static void cred_generate_then_validate_prepared()
+{
+    printf("Starting credential::cred_generate_then_validate_prepared...\n");
+
+    credential_test_fixture fixture;
+    setup(&fixture);
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    struct ecdaa_credential_ZZZ cred;
+    struct ecdaa_credential_ZZZ_signature cred_sig;
+    TEST_ASSERT(0 == ecdaa_credential_ZZZ_generate(&cred, &cred_sig, &fixture.isk, &fixture.pk, test_randomness));
+
+    // Validating doesn't modify the credential
+    struct ecdaa_credential_ZZZ cred_before;
+    memcpy(&cred_before, &cred, sizeof(cred));
+    TEST_ASSERT(0 == ecdaa_credential_ZZZ_validate_prepared(&cred, &cred_sig, &fixture.pk, &prepared_gpk));
+    TEST_ASSERT(0 == memcmp(&cred_before, &cred, sizeof(cred)));
+
+    // Modified C
+    ECP_ZZZ_add(&cred.C, &cred.A);
+    ECP_ZZZ_affine(&cred.C);
+    TEST_ASSERT(0 != ecdaa_credential_ZZZ_validate_prepared(&cred, &cred_sig, &fixture.pk, &prepared_gpk));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
 static void lengths_same()
 {
     printf("Starting credential::lengths_same...\n");
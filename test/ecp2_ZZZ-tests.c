@@ -19,6 +19,7 @@
 #include "ecdaa-test-utils.h"
 
 #include "amcl-extensions/ecp2_ZZZ.h"
+#include "amcl-extensions/ecp_ZZZ.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -28,6 +29,9 @@ static void g2_serialize_then_deserialize_basepoint();
 static void g2_lengths_same();
 static void g2_deserialize_badformat_fails();
 static void g2_deserialize_badcoords_fails();
+static void g2_mul_multi_matches_mul();
+static void g2_subgroup_check_matches_order_check();
+static void g2_mul_vartime_matches_mul();
 
 int main()
 {
@@ -36,6 +40,9 @@ int main()
     g2_lengths_same();
     g2_deserialize_badformat_fails();
     g2_deserialize_badcoords_fails();
+    g2_mul_multi_matches_mul();
+    g2_subgroup_check_matches_order_check();
+    g2_mul_vartime_matches_mul();
 
     return 0;
 }
@@ -106,3 +113,131 @@ static void g2_deserialize_badcoords_fails()
 
     printf("\tsuccess\n");
 }
+
+static void g2_mul_multi_matches_mul()
+{
+    printf("Starting ecp2_ZZZ::g2_mul_multi_matches_mul...\n");
+
+    // More points than fit in one batch, including a zero scalar.
+    ECP2_ZZZ points[6];
+    ECP2_ZZZ *point_ptrs[6];
+    BIG_XXX scalars[6];
+    ECP2_ZZZ expected, term;
+    ECP2_ZZZ_inf(&expected);
+    for (int i = 0; i < 6; ++i) {
+        BIG_XXX point_scalar;
+        ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+        ecp2_ZZZ_set_to_generator(&points[i]);
+        ECP2_ZZZ_mul(&points[i], point_scalar);
+        point_ptrs[i] = &points[i];
+
+        if (3 == i)
+            BIG_XXX_zero(scalars[i]);
+        else
+            ecp_ZZZ_random_mod_order(&scalars[i], test_randomness);
+
+        ECP2_ZZZ_copy(&term, &points[i]);
+        ECP2_ZZZ_mul(&term, scalars[i]);
+        ECP2_ZZZ_add(&expected, &term);
+    }
+
+    ECP2_ZZZ actual;
+    ecp2_ZZZ_mul_multi(&actual, point_ptrs, scalars, 6);
+    TEST_ASSERT(ECP2_ZZZ_equals(&expected, &actual));
+
+    // scalar1*point1 + scalar2*point2
+    ECP2_ZZZ_copy(&expected, &points[0]);
+    ECP2_ZZZ_mul(&expected, scalars[0]);
+    ECP2_ZZZ_copy(&term, &points[1]);
+    ECP2_ZZZ_mul(&term, scalars[1]);
+    ECP2_ZZZ_add(&expected, &term);
+    ecp2_ZZZ_mul2(&actual, &points[0], scalars[0], &points[1], scalars[1]);
+    TEST_ASSERT(ECP2_ZZZ_equals(&expected, &actual));
+
+    // No points
+    ecp2_ZZZ_mul_multi(&actual, point_ptrs, scalars, 0);
+    TEST_ASSERT(ECP2_ZZZ_isinf(&actual));
+
+    printf("\tsuccess\n");
+}
+
+static void g2_subgroup_check_matches_order_check()
+{
+    printf("Starting ecp2_ZZZ::g2_subgroup_check_matches_order_check...\n");
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    // Points in G2 pass.
+    for (int i = 0; i < 4; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ECP2_ZZZ point;
+        ecp2_ZZZ_set_to_generator(&point);
+        ECP2_ZZZ_mul(&point, scalar);
+
+        TEST_ASSERT(ecp2_ZZZ_in_subgroup(&point));
+
+        uint8_t buffer[ECP2_ZZZ_LENGTH];
+        ecp2_ZZZ_serialize(buffer, &point);
+        ECP2_ZZZ deserialized_point;
+        TEST_ASSERT(0 == ecp2_ZZZ_deserialize(&deserialized_point, buffer));
+    }
+
+    // Points on the twist, but without the cofactor cleared, fail.
+    int num_checked = 0;
+    for (int i = 0; num_checked < 4 && i < 64; ++i) {
+        BIG_XXX a, b;
+        ecp_ZZZ_random_mod_order(&a, test_randomness);
+        ecp_ZZZ_random_mod_order(&b, test_randomness);
+        FP2_YYY x;
+        FP2_YYY_from_BIGs(&x, a, b);
+
+        ECP2_ZZZ point;
+        if (!ECP2_ZZZ_setx(&point, &x))
+            continue;
+        ++num_checked;
+
+        ECP2_ZZZ order_multiple;
+        ECP2_ZZZ_copy(&order_multiple, &point);
+        ECP2_ZZZ_mul(&order_multiple, curve_order);
+        TEST_ASSERT(!ECP2_ZZZ_isinf(&order_multiple));
+
+        TEST_ASSERT(!ecp2_ZZZ_in_subgroup(&point));
+
+        uint8_t buffer[ECP2_ZZZ_LENGTH];
+        ecp2_ZZZ_serialize(buffer, &point);
+        ECP2_ZZZ deserialized_point;
+        TEST_ASSERT(-1 == ecp2_ZZZ_deserialize(&deserialized_point, buffer));
+    }
+    TEST_ASSERT(num_checked > 0);
+
+    printf("\tsuccess\n");
+}
+
+static void g2_mul_vartime_matches_mul()
+{
+    printf("Starting ecp2_ZZZ::g2_mul_vartime_matches_mul...\n");
+
+    for (int i = 0; i < 4; ++i) {
+        BIG_XXX point_scalar, scalar;
+        ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        if (0 == i)
+            BIG_XXX_zero(scalar);
+        if (1 == i)
+            BIG_XXX_one(scalar);
+
+        ECP2_ZZZ expected, actual;
+        ecp2_ZZZ_set_to_generator(&expected);
+        ECP2_ZZZ_mul(&expected, point_scalar);
+        ECP2_ZZZ_copy(&actual, &expected);
+
+        ECP2_ZZZ_mul(&expected, scalar);
+        ecp2_ZZZ_mul_vartime(&actual, scalar);
+
+        TEST_ASSERT(ECP2_ZZZ_equals(&expected, &actual));
+    }
+
+    printf("\tsuccess\n");
+}
@@ -29,6 +29,14 @@ static void g1_lengths_same();
 static void g1_deserialize_badformat_fails();
 static void g1_deserialize_badcoords_fails();
 static void random_num_mod_order_is_valid();
+static void g1_mul_multi_matches_mul();
+static void mul_generator_matches_mul();
+static void mul_vartime_matches_mul();
+static void fixed_base_mul_matches_mul();
+static void fixed_base_mul_window_matches_mul();
+static void fromhash_fouque_tibouchi_is_valid();
+static void batch_affine_matches_affine();
+static void serialize_batch_matches_serialize();
 
 int main()
 {
@@ -38,6 +46,14 @@ int main()
     g1_deserialize_badformat_fails();
     g1_deserialize_badcoords_fails();
     random_num_mod_order_is_valid();
+    g1_mul_multi_matches_mul();
+    mul_generator_matches_mul();
+    mul_vartime_matches_mul();
+    fixed_base_mul_matches_mul();
+    fixed_base_mul_window_matches_mul();
+    fromhash_fouque_tibouchi_is_valid();
+    batch_affine_matches_affine();
+    serialize_batch_matches_serialize();
 
     return 0;
 }
@@ -133,3 +149,339 @@ void random_num_mod_order_is_valid()
 
     printf("\tsuccess\n");
 }
+
+static void mul_generator_matches_mul()
+{
+    printf("Starting ecp_ZZZ::mul_generator_matches_mul...\n");
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    BIG_XXX scalars[8];
+    BIG_XXX_zero(scalars[0]);
+    BIG_XXX_one(scalars[1]);
+    BIG_XXX_one(scalars[2]);
+    BIG_XXX_inc(scalars[2], 1);
+    BIG_XXX_copy(scalars[3], curve_order);
+    BIG_XXX_dec(scalars[3], 1);
+    BIG_XXX_norm(scalars[3]);
+    for (int i = 4; i < 8; ++i) {
+        ecp_ZZZ_random_mod_order(&scalars[i], test_randomness);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        ECP_ZZZ expected, actual;
+        ecp_ZZZ_set_to_generator(&expected);
+        ECP_ZZZ_mul(&expected, scalars[i]);
+
+        ecp_ZZZ_mul_generator(&actual, scalars[i]);
+
+        TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void g1_mul_multi_matches_mul()
+{
+    printf("Starting ecp_ZZZ::g1_mul_multi_matches_mul...\n");
+
+    // More points than fit in one batch, including a zero scalar.
+    ECP_ZZZ points[6];
+    ECP_ZZZ *point_ptrs[6];
+    BIG_XXX scalars[6];
+    ECP_ZZZ expected, term;
+    ECP_ZZZ_inf(&expected);
+    for (int i = 0; i < 6; ++i) {
+        BIG_XXX point_scalar;
+        ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+        ecp_ZZZ_set_to_generator(&points[i]);
+        ECP_ZZZ_mul(&points[i], point_scalar);
+        point_ptrs[i] = &points[i];
+
+        if (3 == i)
+            BIG_XXX_zero(scalars[i]);
+        else
+            ecp_ZZZ_random_mod_order(&scalars[i], test_randomness);
+
+        ECP_ZZZ_copy(&term, &points[i]);
+        ECP_ZZZ_mul(&term, scalars[i]);
+        ECP_ZZZ_add(&expected, &term);
+    }
+
+    BIG_XXX scalars_before[6];
+    memcpy(scalars_before, scalars, sizeof(scalars));
+
+    ECP_ZZZ actual;
+    ecp_ZZZ_mul_multi(&actual, point_ptrs, scalars, 6);
+    TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+
+    // The scalars are left as they are
+    TEST_ASSERT(0 == memcmp(scalars_before, scalars, sizeof(scalars)));
+
+    // scalar1*point1 + scalar2*point2
+    ECP_ZZZ_copy(&expected, &points[0]);
+    ECP_ZZZ_mul(&expected, scalars[0]);
+    ECP_ZZZ_copy(&term, &points[1]);
+    ECP_ZZZ_mul(&term, scalars[1]);
+    ECP_ZZZ_add(&expected, &term);
+    ecp_ZZZ_mul2(&actual, &points[0], scalars[0], &points[1], scalars[1]);
+    TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+
+    // No points
+    ecp_ZZZ_mul_multi(&actual, point_ptrs, scalars, 0);
+    TEST_ASSERT(ECP_ZZZ_isinf(&actual));
+
+    printf("\tsuccess\n");
+}
+
+static void mul_vartime_matches_mul()
+{
+    printf("Starting ecp_ZZZ::mul_vartime_matches_mul...\n");
+
+    for (int i = 0; i < 4; ++i) {
+        BIG_XXX point_scalar, scalar;
+        ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        if (0 == i)
+            BIG_XXX_zero(scalar);
+        if (1 == i)
+            BIG_XXX_one(scalar);
+
+        ECP_ZZZ expected, actual;
+        ecp_ZZZ_set_to_generator(&expected);
+        ECP_ZZZ_mul(&expected, point_scalar);
+        ECP_ZZZ_copy(&actual, &expected);
+
+        ECP_ZZZ_mul(&expected, scalar);
+        ecp_ZZZ_mul_vartime(&actual, scalar);
+
+        TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+    }
+
+    printf("\tsuccess\n");
+}
+
+static struct ecp_ZZZ_fixed_base_table fixed_base_table;
+
+static void fixed_base_mul_matches_mul()
+{
+    printf("Starting ecp_ZZZ::fixed_base_mul_matches_mul...\n");
+
+    BIG_XXX point_scalar;
+    ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+    ECP_ZZZ point;
+    ecp_ZZZ_set_to_generator(&point);
+    ECP_ZZZ_mul(&point, point_scalar);
+
+    ecp_ZZZ_fixed_base_table_build(&fixed_base_table, &point);
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    for (int i = 0; i < 6; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        if (0 == i)
+            BIG_XXX_zero(scalar);
+        if (1 == i)
+            BIG_XXX_one(scalar);
+        if (2 == i) {
+            // Largest scalar mod order (even, since the order is odd)
+            BIG_XXX_copy(scalar, curve_order);
+            BIG_XXX_dec(scalar, 1);
+            BIG_XXX_norm(scalar);
+        }
+
+        ECP_ZZZ expected, actual;
+        ECP_ZZZ_copy(&expected, &point);
+        ECP_ZZZ_mul(&expected, scalar);
+
+        ecp_ZZZ_fixed_base_mul_vartime(&actual, &fixed_base_table, scalar);
+
+        TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+
+        ecp_ZZZ_fixed_base_mul(&actual, &fixed_base_table, scalar);
+
+        TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+    }
+
+    printf("\tsuccess\n");
+}
+
+static ECP_ZZZ fixed_base_window_table[ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(ECP_ZZZ_FIXED_BASE_MAX_WINDOW_BITS)];
+
+static void fixed_base_mul_window_matches_mul()
+{
+    printf("Starting ecp_ZZZ::fixed_base_mul_window_matches_mul...\n");
+
+    BIG_XXX point_scalar;
+    ecp_ZZZ_random_mod_order(&point_scalar, test_randomness);
+    ECP_ZZZ point;
+    ecp_ZZZ_set_to_generator(&point);
+    ECP_ZZZ_mul(&point, point_scalar);
+
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+
+    for (int w = ECP_ZZZ_FIXED_BASE_MIN_WINDOW_BITS; w <= ECP_ZZZ_FIXED_BASE_MAX_WINDOW_BITS; ++w) {
+        TEST_ASSERT((size_t)ECP_ZZZ_FIXED_BASE_TABLE_LENGTH(w) <= sizeof(fixed_base_window_table) / sizeof(ECP_ZZZ));
+
+        ecp_ZZZ_fixed_base_table_build_window(fixed_base_window_table, &point, w);
+
+        for (int i = 0; i < 4; ++i) {
+            BIG_XXX scalar;
+            ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+            if (0 == i)
+                BIG_XXX_zero(scalar);
+            if (1 == i) {
+                BIG_XXX_copy(scalar, curve_order);
+                BIG_XXX_dec(scalar, 1);
+                BIG_XXX_norm(scalar);
+            }
+
+            ECP_ZZZ expected, actual;
+            ECP_ZZZ_copy(&expected, &point);
+            ECP_ZZZ_mul(&expected, scalar);
+
+            ecp_ZZZ_fixed_base_mul_window(&actual, fixed_base_window_table, w, scalar);
+
+            TEST_ASSERT(ECP_ZZZ_equals(&expected, &actual));
+        }
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void fromhash_fouque_tibouchi_is_valid()
+{
+    printf("Starting ecp_ZZZ::fromhash_fouque_tibouchi_is_valid...\n");
+
+    uint8_t message1[] = "basename one";
+    uint8_t message2[] = "basename two";
+
+    ECP_ZZZ point1, point1_again, point2, try_and_increment;
+    TEST_ASSERT(0 == ecp_ZZZ_fromhash_fouque_tibouchi(&point1, message1, sizeof(message1)));
+    TEST_ASSERT(0 == ecp_ZZZ_fromhash_fouque_tibouchi(&point1_again, message1, sizeof(message1)));
+    TEST_ASSERT(0 == ecp_ZZZ_fromhash_fouque_tibouchi(&point2, message2, sizeof(message2)));
+    TEST_ASSERT(ecp_ZZZ_fromhash(&try_and_increment, message1, sizeof(message1)) >= 0);
+
+    TEST_ASSERT(!point1.inf);
+    TEST_ASSERT(ECP_ZZZ_equals(&point1, &point1_again));
+    TEST_ASSERT(!ECP_ZZZ_equals(&point1, &point2));
+    TEST_ASSERT(!ECP_ZZZ_equals(&point1, &try_and_increment));
+
+    // On the curve (deserialize checks that)
+    uint8_t buffer[ECP_ZZZ_LENGTH];
+    ECP_ZZZ deserialized;
+    ecp_ZZZ_serialize(buffer, &point1);
+    TEST_ASSERT(0 == ecp_ZZZ_deserialize(&deserialized, buffer));
+    TEST_ASSERT(ECP_ZZZ_equals(&point1, &deserialized));
+
+    // In G1
+    BIG_XXX curve_order;
+    BIG_XXX_rcopy(curve_order, CURVE_Order_ZZZ);
+    ECP_ZZZ_mul(&deserialized, curve_order);
+    TEST_ASSERT(ECP_ZZZ_isinf(&deserialized));
+
+    // Many messages (covering all three candidate x-coordinates)
+    for (uint32_t i = 0; i < 64; ++i) {
+        ECP_ZZZ point;
+        TEST_ASSERT(0 == ecp_ZZZ_fromhash_fouque_tibouchi(&point, (uint8_t*)&i, sizeof(i)));
+        ecp_ZZZ_serialize(buffer, &point);
+        TEST_ASSERT(0 == ecp_ZZZ_deserialize(&deserialized, buffer));
+    }
+
+    printf("\tsuccess\n");
+}
+
+// Randomize the (homogeneous) projective representation of `point`:
+//  (x, y, z) -> (r*x, r*y, r*z), which is still the same point.
+static void make_projective(ECP_ZZZ *point)
+{
+    BIG_XXX r_big;
+    ecp_ZZZ_random_mod_order(&r_big, test_randomness);
+    FP_YYY r;
+    FP_YYY_nres(&r, r_big);
+
+    FP_YYY_mul(&point->x, &point->x, &r);
+    FP_YYY_mul(&point->y, &point->y, &r);
+    FP_YYY_mul(&point->z, &point->z, &r);
+}
+
+#define NUM_BATCH_POINTS (ECP_ZZZ_BATCH_AFFINE_MAX_POINTS + 4)
+
+static void batch_affine_matches_affine()
+{
+    printf("Starting ecp_ZZZ::batch_affine_matches_affine...\n");
+
+    ECP_ZZZ points[NUM_BATCH_POINTS];
+    ECP_ZZZ expected[NUM_BATCH_POINTS];
+    ECP_ZZZ *point_ptrs[NUM_BATCH_POINTS];
+    for (int i = 0; i < NUM_BATCH_POINTS; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ecp_ZZZ_set_to_generator(&points[i]);
+        ECP_ZZZ_mul(&points[i], scalar);
+        ECP_ZZZ_affine(&points[i]);
+        ECP_ZZZ_copy(&expected[i], &points[i]);
+        point_ptrs[i] = &points[i];
+
+        // Leave one point affine, and one at infinity.
+        if (1 == i)
+            continue;
+        if (2 == i) {
+            ECP_ZZZ_inf(&points[i]);
+            ECP_ZZZ_inf(&expected[i]);
+            continue;
+        }
+        make_projective(&points[i]);
+    }
+
+    ecp_ZZZ_batch_affine(point_ptrs, NUM_BATCH_POINTS);
+
+    FP_YYY one;
+    FP_YYY_one(&one);
+    for (int i = 0; i < NUM_BATCH_POINTS; ++i) {
+        TEST_ASSERT(ECP_ZZZ_equals(&expected[i], &points[i]));
+        if (!ECP_ZZZ_isinf(&points[i])) {
+            TEST_ASSERT(FP_YYY_equals(&one, &points[i].z));
+            TEST_ASSERT(FP_YYY_equals(&expected[i].x, &points[i].x));
+            TEST_ASSERT(FP_YYY_equals(&expected[i].y, &points[i].y));
+        }
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void serialize_batch_matches_serialize()
+{
+    printf("Starting ecp_ZZZ::serialize_batch_matches_serialize...\n");
+
+    ECP_ZZZ points[NUM_BATCH_POINTS];
+    ECP_ZZZ *point_ptrs[NUM_BATCH_POINTS];
+    uint8_t expected[NUM_BATCH_POINTS * ECP_ZZZ_LENGTH];
+    for (int i = 0; i < NUM_BATCH_POINTS; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ecp_ZZZ_set_to_generator(&points[i]);
+        ECP_ZZZ_mul(&points[i], scalar);
+        make_projective(&points[i]);
+        point_ptrs[i] = &points[i];
+
+        ecp_ZZZ_serialize(expected + i*ECP_ZZZ_LENGTH, &points[i]);
+    }
+
+    ECP_ZZZ before;
+    ECP_ZZZ_copy(&before, &points[0]);
+
+    uint8_t actual[NUM_BATCH_POINTS * ECP_ZZZ_LENGTH];
+    ecp_ZZZ_serialize_batch(actual, point_ptrs, NUM_BATCH_POINTS);
+
+    TEST_ASSERT(0 == memcmp(expected, actual, sizeof(expected)));
+
+    // The inputs aren't touched.
+    TEST_ASSERT(FP_YYY_equals(&before.z, &points[0].z));
+
+    printf("\tsuccess\n");
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+#include "amcl-extensions/pairing_ZZZ.h"
+
+#include <amcl/fp12_YYY.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static void product_matches_separate_pairings();
+static void product_of_inverse_pairings_is_unity();
+static void product_skips_point_at_infinity();
+static void product_with_lines_matches_product();
+
+int main()
+{
+    product_matches_separate_pairings();
+    product_of_inverse_pairings_is_unity();
+    product_skips_point_at_infinity();
+    product_with_lines_matches_product();
+
+    return 0;
+}
+
+static void product_matches_separate_pairings()
+{
+    printf("Starting pairing::product_matches_separate_pairings...\n");
+
+    ECP_ZZZ g1[3];
+    ECP2_ZZZ g2[3];
+    for (int i = 0; i < 3; ++i) {
+        BIG_XXX a, b;
+        ecp_ZZZ_random_mod_order(&a, test_randomness);
+        ecp_ZZZ_random_mod_order(&b, test_randomness);
+        ecp_ZZZ_set_to_generator(&g1[i]);
+        ECP_ZZZ_mul(&g1[i], a);
+        ecp2_ZZZ_set_to_generator(&g2[i]);
+        ECP2_ZZZ_mul(&g2[i], b);
+    }
+
+    FP12_YYY expected, single;
+    FP12_YYY_one(&expected);
+    for (int i = 0; i < 3; ++i) {
+        compute_pairing_ZZZ(&single, &g1[i], &g2[i]);
+        FP12_YYY_mul(&expected, &single);
+    }
+
+    ECP_ZZZ *g1_points[3] = {&g1[0], &g1[1], &g1[2]};
+    ECP2_ZZZ *g2_points[3] = {&g2[0], &g2[1], &g2[2]};
+    FP12_YYY product;
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 3);
+    TEST_ASSERT(FP12_YYY_equals(&expected, &product));
+
+    // Even number of pairings
+    compute_pairing_ZZZ(&single, &g1[2], &g2[2]);
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 2);
+    FP12_YYY_mul(&product, &single);
+    TEST_ASSERT(FP12_YYY_equals(&expected, &product));
+
+    printf("\tsuccess\n");
+}
+
+static void product_of_inverse_pairings_is_unity()
+{
+    printf("Starting pairing::product_of_inverse_pairings_is_unity...\n");
+
+    BIG_XXX a, b;
+    ecp_ZZZ_random_mod_order(&a, test_randomness);
+    ecp_ZZZ_random_mod_order(&b, test_randomness);
+
+    // e(a*P1, b*P2) * e(-b*P1, a*P2) == 1
+    ECP_ZZZ aP1, negbP1;
+    ecp_ZZZ_set_to_generator(&aP1);
+    ECP_ZZZ_mul(&aP1, a);
+    ecp_ZZZ_set_to_generator(&negbP1);
+    ECP_ZZZ_mul(&negbP1, b);
+    ECP_ZZZ_neg(&negbP1);
+
+    ECP2_ZZZ bP2, aP2;
+    ecp2_ZZZ_set_to_generator(&bP2);
+    ECP2_ZZZ_mul(&bP2, b);
+    ecp2_ZZZ_set_to_generator(&aP2);
+    ECP2_ZZZ_mul(&aP2, a);
+
+    ECP_ZZZ *g1_points[2] = {&aP1, &negbP1};
+    ECP2_ZZZ *g2_points[2] = {&bP2, &aP2};
+    FP12_YYY product;
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 2);
+    TEST_ASSERT(FP12_YYY_isunity(&product));
+
+    // Changing one of the points breaks the equality
+    ECP2_ZZZ_add(&aP2, &bP2);
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 2);
+    TEST_ASSERT(!FP12_YYY_isunity(&product));
+
+    printf("\tsuccess\n");
+}
+
+static void product_skips_point_at_infinity()
+{
+    printf("Starting pairing::product_skips_point_at_infinity...\n");
+
+    ECP_ZZZ g1, inf;
+    ecp_ZZZ_set_to_generator(&g1);
+    ECP_ZZZ_inf(&inf);
+
+    ECP2_ZZZ g2;
+    ecp2_ZZZ_set_to_generator(&g2);
+
+    FP12_YYY expected;
+    compute_pairing_ZZZ(&expected, &g1, &g2);
+
+    ECP_ZZZ *g1_points[3] = {&inf, &g1, &inf};
+    ECP2_ZZZ *g2_points[3] = {&g2, &g2, &g2};
+    FP12_YYY product;
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 3);
+    TEST_ASSERT(FP12_YYY_equals(&expected, &product));
+
+    compute_pairing_product_ZZZ(&product, g1_points, g2_points, 0);
+    TEST_ASSERT(FP12_YYY_isunity(&product));
+
+    printf("\tsuccess\n");
+}
+
+#define MAX_LINES (4*MODBYTES_XXX + 10)
+static FP2_YYY lines[2][3*MAX_LINES];
+
+static void product_with_lines_matches_product()
+{
+    printf("Starting pairing::product_with_lines_matches_product...\n");
+
+    ECP_ZZZ g1[3];
+    ECP2_ZZZ g2[3];
+    for (int i = 0; i < 3; ++i) {
+        BIG_XXX a, b;
+        ecp_ZZZ_random_mod_order(&a, test_randomness);
+        ecp_ZZZ_random_mod_order(&b, test_randomness);
+        ecp_ZZZ_set_to_generator(&g1[i]);
+        ECP_ZZZ_mul(&g1[i], a);
+        ecp2_ZZZ_set_to_generator(&g2[i]);
+        ECP2_ZZZ_mul(&g2[i], b);
+    }
+
+    ECP_ZZZ *g1_points[3] = {&g1[0], &g1[1], &g1[2]};
+    ECP2_ZZZ *g2_points[3] = {&g2[0], &g2[1], &g2[2]};
+    FP12_YYY expected;
+    compute_pairing_product_ZZZ(&expected, g1_points, g2_points, 3);
+
+    // Lines may not be available for every AMCL configuration,
+    //  in which case the caller passes NULL instead.
+    FP2_YYY *g2_lines[3] = {NULL, NULL, NULL};
+    if (0 != prepare_g2_lines_ZZZ(lines[0], MAX_LINES, &g2[0]))
+        g2_lines[0] = lines[0];
+    if (0 != prepare_g2_lines_ZZZ(lines[1], MAX_LINES, &g2[2]))
+        g2_lines[2] = lines[1];
+
+    // The G1 points are normalized into copies, not in place
+    ECP_ZZZ g1_before[3];
+    memcpy(g1_before, g1, sizeof(g1));
+
+    FP12_YYY product;
+    compute_pairing_product_with_lines_ZZZ(&product, g1_points, g2_points, g2_lines, 3);
+    TEST_ASSERT(FP12_YYY_equals(&expected, &product));
+    TEST_ASSERT(0 == memcmp(g1_before, g1, sizeof(g1)));
+
+    compute_pairing_product_with_lines_ZZZ(&product, g1_points, g2_points, NULL, 3);
+    TEST_ASSERT(FP12_YYY_equals(&expected, &product));
+
+    // Too little room for the lines
+    TEST_ASSERT(0 == prepare_g2_lines_ZZZ(lines[0], 1, &g2[0]));
+
+    printf("\tsuccess\n");
+}
@@ -0,0 +1,199 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/credential_ZZZ.h>
+#include <ecdaa/issuer_keypair_ZZZ.h>
+#include <ecdaa/signature_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/prepared_credential_ZZZ.h>
+
+#include <string.h>
+
+static void prepare_with_bad_window_fails();
+static void prepare_with_small_storage_fails();
+static void sign_prepared_then_verify();
+static void sign_prepared_with_basename_then_verify();
+static void sign_begin_prepared_then_verify();
+
+typedef struct prepared_credential_fixture {
+    uint8_t *msg;
+    uint32_t msg_len;
+    uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_revocations_ZZZ revocations;
+    struct ecdaa_issuer_public_key_ZZZ ipk;
+    struct ecdaa_member_secret_key_ZZZ sk;
+    struct ecdaa_credential_ZZZ cred;
+    struct ecdaa_prepared_credential_ZZZ prepared_cred;
+} prepared_credential_fixture;
+
+static prepared_credential_fixture fixture;
+
+// Large, so keep it off the stack.
+static ECP_ZZZ table_storage[ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS)];
+
+static void setup(prepared_credential_fixture *fixture);
+static void teardown(prepared_credential_fixture *fixture);
+
+int main()
+{
+    prepare_with_bad_window_fails();
+    prepare_with_small_storage_fails();
+    sign_prepared_then_verify();
+    sign_prepared_with_basename_then_verify();
+    sign_begin_prepared_then_verify();
+}
+
+static void setup(prepared_credential_fixture *fixture)
+{
+    struct ecdaa_issuer_secret_key_ZZZ isk;
+    ecp_ZZZ_random_mod_order(&isk.x, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.X);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.X, isk.x);
+
+    ecp_ZZZ_random_mod_order(&isk.y, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.Y);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.Y, isk.y);
+
+    struct ecdaa_member_public_key_ZZZ pk;
+    ecp_ZZZ_set_to_generator(&pk.Q);
+    ecp_ZZZ_random_mod_order(&fixture->sk.sk, test_randomness);
+    ECP_ZZZ_mul(&pk.Q, fixture->sk.sk);
+
+    struct ecdaa_credential_ZZZ_signature cred_sig;
+    ecdaa_credential_ZZZ_generate(&fixture->cred, &cred_sig, &isk, &pk, test_randomness);
+
+    fixture->msg = (uint8_t*) "Test message";
+    fixture->msg_len = (uint32_t)strlen((char*)fixture->msg);
+
+    fixture->basename = (uint8_t*) "BASENAME";
+    fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
+
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
+}
+
+static void teardown(prepared_credential_fixture *fixture)
+{
+    (void)fixture;
+}
+
+static void prepare_with_bad_window_fails()
+{
+    printf("Starting prepared_credential::prepare_with_bad_window_fails...\n");
+
+    setup(&fixture);
+
+    size_t storage_length = sizeof(table_storage) / sizeof(ECP_ZZZ);
+    TEST_ASSERT(-1 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS - 1, table_storage, storage_length));
+    TEST_ASSERT(-1 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS + 1, table_storage, storage_length));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void prepare_with_small_storage_fails()
+{
+    printf("Starting prepared_credential::prepare_with_small_storage_fails...\n");
+
+    setup(&fixture);
+
+    int window_bits = ECDAA_PREPARED_CREDENTIAL_ZZZ_DEFAULT_WINDOW_BITS;
+    size_t needed = ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits);
+    TEST_ASSERT(-1 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, table_storage, needed - 1));
+    TEST_ASSERT(-1 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, NULL, needed));
+    TEST_ASSERT(0 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, table_storage, needed));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_prepared_then_verify()
+{
+    printf("Starting prepared_credential::sign_prepared_then_verify...\n");
+
+    setup(&fixture);
+
+    size_t storage_length = sizeof(table_storage) / sizeof(ECP_ZZZ);
+    for (int window_bits = ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS; window_bits <= ECDAA_PREPARED_CREDENTIAL_ZZZ_MAX_WINDOW_BITS; ++window_bits) {
+        TEST_ASSERT(0 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, table_storage, storage_length));
+
+        struct ecdaa_signature_ZZZ sig;
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_prepared(&sig, fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.prepared_cred, test_randomness));
+
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, NULL, 0));
+    }
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_prepared_with_basename_then_verify()
+{
+    printf("Starting prepared_credential::sign_prepared_with_basename_then_verify...\n");
+
+    setup(&fixture);
+
+    int window_bits = ECDAA_PREPARED_CREDENTIAL_ZZZ_MIN_WINDOW_BITS;
+    TEST_ASSERT(0 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, table_storage, ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits)));
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_prepared(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.prepared_cred, test_randomness));
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // The pseudonym is the same as from an unprepared signature.
+    struct ecdaa_signature_ZZZ unprepared_sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&unprepared_sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(ECP_ZZZ_equals(&sig.K, &unprepared_sig.K));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_begin_prepared_then_verify()
+{
+    printf("Starting prepared_credential::sign_begin_prepared_then_verify...\n");
+
+    setup(&fixture);
+
+    int window_bits = ECDAA_PREPARED_CREDENTIAL_ZZZ_DEFAULT_WINDOW_BITS;
+    TEST_ASSERT(0 == ecdaa_prepared_credential_ZZZ_prepare(&fixture.prepared_cred, &fixture.cred, window_bits, table_storage, ECDAA_PREPARED_CREDENTIAL_ZZZ_TABLE_LENGTH(window_bits)));
+
+    struct ecdaa_signature_ZZZ_sign_ctx ctx;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_begin_prepared(&ctx, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.prepared_cred, test_randomness));
+    ecdaa_signature_ZZZ_sign_update(&ctx, fixture.msg, 4);
+    ecdaa_signature_ZZZ_sign_update(&ctx, fixture.msg + 4, fixture.msg_len - 4);
+
+    struct ecdaa_signature_ZZZ sig;
+    ecdaa_signature_ZZZ_sign_finish(&ctx, &sig);
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
@@ -0,0 +1,290 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/credential_ZZZ.h>
+#include <ecdaa/issuer_keypair_ZZZ.h>
+#include <ecdaa/signature_ZZZ.h>
+#include <ecdaa/basename_ctx_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/presignature_pool_ZZZ.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#define POOL_CAPACITY 4
+
+static void init_with_no_capacity_fails();
+static void fill_stops_when_full();
+static void sign_uses_presignatures();
+static void sign_with_empty_pool();
+static void take_then_stream();
+static void sign_with_basename_ctx();
+static void fill_from_another_thread();
+
+typedef struct presignature_fixture {
+    uint8_t *msg;
+    uint32_t msg_len;
+    uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_revocations_ZZZ revocations;
+    struct ecdaa_issuer_public_key_ZZZ ipk;
+    struct ecdaa_member_secret_key_ZZZ sk;
+    struct ecdaa_credential_ZZZ cred;
+    struct ecdaa_signature_ZZZ_sign_ctx slots[POOL_CAPACITY];
+    struct ecdaa_presignature_pool_ZZZ pool;
+} presignature_fixture;
+
+static presignature_fixture fixture;
+
+// Large, so keep it off the stack.
+static struct ecdaa_basename_ctx_ZZZ basename_ctx;
+
+static void setup(presignature_fixture *fixture);
+static void teardown(presignature_fixture *fixture);
+static void *fill_thread(void *pool_in);
+
+int main()
+{
+    init_with_no_capacity_fails();
+    fill_stops_when_full();
+    sign_uses_presignatures();
+    sign_with_empty_pool();
+    take_then_stream();
+    sign_with_basename_ctx();
+    fill_from_another_thread();
+}
+
+static void setup(presignature_fixture *fixture)
+{
+    struct ecdaa_issuer_secret_key_ZZZ isk;
+    ecp_ZZZ_random_mod_order(&isk.x, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.X);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.X, isk.x);
+
+    ecp_ZZZ_random_mod_order(&isk.y, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.Y);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.Y, isk.y);
+
+    struct ecdaa_member_public_key_ZZZ pk;
+    ecp_ZZZ_set_to_generator(&pk.Q);
+    ecp_ZZZ_random_mod_order(&fixture->sk.sk, test_randomness);
+    ECP_ZZZ_mul(&pk.Q, fixture->sk.sk);
+
+    struct ecdaa_credential_ZZZ_signature cred_sig;
+    ecdaa_credential_ZZZ_generate(&fixture->cred, &cred_sig, &isk, &pk, test_randomness);
+
+    fixture->msg = (uint8_t*) "Test message";
+    fixture->msg_len = (uint32_t)strlen((char*)fixture->msg);
+
+    fixture->basename = (uint8_t*) "BASENAME";
+    fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
+
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
+}
+
+static void teardown(presignature_fixture *fixture)
+{
+    (void)fixture;
+}
+
+static void *fill_thread(void *pool_in)
+{
+    struct ecdaa_presignature_pool_ZZZ *pool = pool_in;
+
+    TEST_ASSERT(ecdaa_presignature_pool_ZZZ_fill(pool, POOL_CAPACITY) >= 0);
+
+    return NULL;
+}
+
+static void init_with_no_capacity_fails()
+{
+    printf("Starting presignature_pool::init_with_no_capacity_fails...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(-1 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, 0, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void fill_stops_when_full()
+{
+    printf("Starting presignature_pool::fill_stops_when_full...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, POOL_CAPACITY, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_count(&fixture.pool));
+
+    TEST_ASSERT(1 == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, 1));
+    TEST_ASSERT(1 == ecdaa_presignature_pool_ZZZ_count(&fixture.pool));
+
+    TEST_ASSERT(POOL_CAPACITY - 1 == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, 2*POOL_CAPACITY));
+    TEST_ASSERT(POOL_CAPACITY == ecdaa_presignature_pool_ZZZ_count(&fixture.pool));
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, 1));
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_uses_presignatures()
+{
+    printf("Starting presignature_pool::sign_uses_presignatures...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, POOL_CAPACITY, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(POOL_CAPACITY == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, POOL_CAPACITY));
+
+    // Each presignature is used once, and gives a differently-randomized signature
+    struct ecdaa_signature_ZZZ sigs[POOL_CAPACITY];
+    for (size_t i = 0; i < POOL_CAPACITY; ++i) {
+        TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&fixture.pool, &sigs[i], fixture.msg, fixture.msg_len));
+        TEST_ASSERT(POOL_CAPACITY - i - 1 == ecdaa_presignature_pool_ZZZ_count(&fixture.pool));
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sigs[i], &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+        if (i > 0)
+            TEST_ASSERT(!ECP_ZZZ_equals(&sigs[i].R, &sigs[i-1].R));
+    }
+
+    // Wrong message
+    uint8_t *wrong_msg = (uint8_t*) "Wrong message";
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify(&sigs[0], &fixture.ipk.gpk, &fixture.revocations, wrong_msg, (uint32_t)strlen((char*)wrong_msg), fixture.basename, fixture.basename_len));
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_with_empty_pool()
+{
+    printf("Starting presignature_pool::sign_with_empty_pool...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, POOL_CAPACITY, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+
+    struct ecdaa_signature_ZZZ_sign_ctx ctx;
+    TEST_ASSERT(-1 == ecdaa_presignature_pool_ZZZ_take(&fixture.pool, &ctx));
+
+    // (computed on the spot)
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&fixture.pool, &sig, fixture.msg, fixture.msg_len));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, NULL, 0));
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void take_then_stream()
+{
+    printf("Starting presignature_pool::take_then_stream...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, POOL_CAPACITY, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(2 == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, 2));
+
+    struct ecdaa_signature_ZZZ_sign_ctx ctx;
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_take(&fixture.pool, &ctx));
+    TEST_ASSERT(1 == ecdaa_presignature_pool_ZZZ_count(&fixture.pool));
+
+    struct ecdaa_signature_ZZZ sig;
+    ecdaa_signature_ZZZ_sign_update(&ctx, fixture.msg, 4);
+    ecdaa_signature_ZZZ_sign_update(&ctx, fixture.msg + 4, fixture.msg_len - 4);
+    ecdaa_signature_ZZZ_sign_finish(&ctx, &sig);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, NULL, 0));
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_with_basename_ctx()
+{
+    printf("Starting presignature_pool::sign_with_basename_ctx...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&basename_ctx, fixture.basename, fixture.basename_len));
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&basename_ctx, &fixture.sk);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init_with_basename_ctx(&fixture.pool, fixture.slots, POOL_CAPACITY, &basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(1 == ecdaa_presignature_pool_ZZZ_fill(&fixture.pool, 1));
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&fixture.pool, &sig, fixture.msg, fixture.msg_len));
+    TEST_ASSERT(ECP_ZZZ_equals(&basename_ctx.K, &sig.K));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void fill_from_another_thread()
+{
+    printf("Starting presignature_pool::fill_from_another_thread...\n");
+
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_init(&fixture.pool, fixture.slots, POOL_CAPACITY, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+
+    // Two fillers racing never overfill the pool, while signing goes on
+    pthread_t fillers[2];
+    TEST_ASSERT(0 == pthread_create(&fillers[0], NULL, fill_thread, &fixture.pool));
+    TEST_ASSERT(0 == pthread_create(&fillers[1], NULL, fill_thread, &fixture.pool));
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&fixture.pool, &sig, fixture.msg, fixture.msg_len));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, NULL, 0));
+
+    TEST_ASSERT(0 == pthread_join(fillers[0], NULL));
+    TEST_ASSERT(0 == pthread_join(fillers[1], NULL));
+    TEST_ASSERT(ecdaa_presignature_pool_ZZZ_count(&fixture.pool) <= POOL_CAPACITY);
+
+    while (0 != ecdaa_presignature_pool_ZZZ_count(&fixture.pool)) {
+        TEST_ASSERT(0 == ecdaa_presignature_pool_ZZZ_sign(&fixture.pool, &sig, fixture.msg, fixture.msg_len));
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, NULL, 0));
+    }
+
+    ecdaa_presignature_pool_ZZZ_destroy(&fixture.pool);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
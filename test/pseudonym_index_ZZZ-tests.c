@@ -0,0 +1,190 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <ecdaa/pseudonym_index_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+
+#include <string.h>
+
+#define CAPACITY 64
+#define NUM_KEYS 20
+
+static void sync_indexes_all_pseudonyms();
+static void sync_is_incremental();
+static void sync_rebuilds_on_new_generation();
+static void sync_fails_when_full();
+
+typedef struct index_fixture {
+    uint8_t *basename;
+    uint32_t basename_len;
+    ECP_ZZZ basepoint;
+    struct ecdaa_member_secret_key_ZZZ sk_list[NUM_KEYS + 1];
+    struct ecdaa_revocations_ZZZ revocations;
+    uint8_t slots[CAPACITY * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    uint8_t bloom[64];
+} index_fixture;
+
+static void setup(index_fixture *fixture);
+static void pseudonym_of(ECP_ZZZ *K_out, index_fixture *fixture, size_t i);
+
+int main()
+{
+    sync_indexes_all_pseudonyms();
+    sync_is_incremental();
+    sync_rebuilds_on_new_generation();
+    sync_fails_when_full();
+}
+
+static void setup(index_fixture *fixture)
+{
+    fixture->basename = (uint8_t*) "BASENAME";
+    fixture->basename_len = strlen((char*)fixture->basename);
+
+    TEST_ASSERT(-1 != ecp_ZZZ_fromhash(&fixture->basepoint, fixture->basename, fixture->basename_len));
+
+    for (size_t i = 0; i < NUM_KEYS + 1; ++i) {
+        ecp_ZZZ_random_mod_order(&fixture->sk_list[i].sk, test_randomness);
+    }
+
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
+    fixture->revocations.sk_list = fixture->sk_list;
+}
+
+static void pseudonym_of(ECP_ZZZ *K_out, index_fixture *fixture, size_t i)
+{
+    ECP_ZZZ_copy(K_out, &fixture->basepoint);
+    ECP_ZZZ_mul(K_out, fixture->sk_list[i].sk);
+}
+
+static void sync_indexes_all_pseudonyms()
+{
+    printf("Starting pseudonym_index::sync_indexes_all_pseudonyms...\n");
+
+    index_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, fixture.slots, CAPACITY, fixture.bloom, sizeof(fixture.bloom)));
+
+    fixture.revocations.sk_length = NUM_KEYS;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(NUM_KEYS == index.sk_length);
+
+    ECP_ZZZ K;
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        pseudonym_of(&K, &fixture, i);
+        TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+    }
+
+    // Not on the list
+    pseudonym_of(&K, &fixture, NUM_KEYS);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+
+    printf("\tsuccess\n");
+}
+
+static void sync_is_incremental()
+{
+    printf("Starting pseudonym_index::sync_is_incremental...\n");
+
+    index_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, fixture.slots, CAPACITY, NULL, 0));
+
+    ECP_ZZZ K;
+
+    fixture.revocations.sk_length = 3;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    pseudonym_of(&K, &fixture, 4);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+
+    // Append to the list
+    fixture.revocations.sk_length = 5;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(5 == index.sk_length);
+    for (size_t i = 0; i < 5; ++i) {
+        pseudonym_of(&K, &fixture, i);
+        TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+    }
+
+    // Shrink the list, so the index is rebuilt
+    fixture.revocations.sk_length = 2;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(2 == index.sk_length);
+    pseudonym_of(&K, &fixture, 1);
+    TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+    pseudonym_of(&K, &fixture, 4);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K));
+
+    printf("\tsuccess\n");
+}
+
+static void sync_rebuilds_on_new_generation()
+{
+    printf("Starting pseudonym_index::sync_rebuilds_on_new_generation...\n");
+
+    index_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, fixture.slots, CAPACITY, NULL, 0));
+
+    fixture.revocations.sk_length = 3;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+
+    // Remove entry 1 and add entry NUM_KEYS, keeping the length
+    ECP_ZZZ removed_K, added_K;
+    pseudonym_of(&removed_K, &fixture, 1);
+    fixture.sk_list[1] = fixture.sk_list[NUM_KEYS];
+    pseudonym_of(&added_K, &fixture, 1);
+    fixture.revocations.sk_generation += 1;
+
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(3 == index.sk_length);
+    TEST_ASSERT(fixture.revocations.sk_generation == index.sk_generation);
+    TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &added_K));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &removed_K));
+
+    printf("\tsuccess\n");
+}
+
+static void sync_fails_when_full()
+{
+    printf("Starting pseudonym_index::sync_fails_when_full...\n");
+
+    index_fixture fixture;
+    setup(&fixture);
+
+    // Room for only 7 entries
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, fixture.slots, 8, NULL, 0));
+
+    fixture.revocations.sk_length = NUM_KEYS;
+    TEST_ASSERT(0 != ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+
+    // Left stale
+    TEST_ASSERT(index.sk_length < fixture.revocations.sk_length);
+
+    printf("\tsuccess\n");
+}
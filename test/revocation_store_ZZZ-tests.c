@@ -0,0 +1,388 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <ecdaa/revocation_store_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/pseudonym_index_ZZZ.h>
+
+#include <string.h>
+
+static void init_is_empty();
+static void apply_adds_and_removes();
+static void apply_out_of_order_fails();
+static void removals_start_new_generation();
+static void snapshot_survives_update();
+static void replace_whole_list();
+static void delta_serialize_deserialize();
+static void delta_deserialize_garbage_fails();
+
+static void random_sks(struct ecdaa_member_secret_key_ZZZ *sks_out, size_t num_sks);
+static void random_points(ECP_ZZZ *points_out, size_t num_points);
+
+int main()
+{
+    init_is_empty();
+    apply_adds_and_removes();
+    apply_out_of_order_fails();
+    removals_start_new_generation();
+    snapshot_survives_update();
+    replace_whole_list();
+    delta_serialize_deserialize();
+    delta_deserialize_garbage_fails();
+}
+
+static void init_is_empty()
+{
+    printf("Starting revocation_store::init_is_empty...\n");
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 2));
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_epoch(&store));
+
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(0 == snapshot->epoch);
+    TEST_ASSERT(0 == snapshot->revocations.sk_length);
+    TEST_ASSERT(0 == snapshot->revocations.bsn_length);
+    TEST_ASSERT(2 == snapshot->revocations.sk_scan_threads);
+    TEST_ASSERT(NULL == snapshot->revocations.bsn_set);
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void apply_adds_and_removes()
+{
+    printf("Starting revocation_store::apply_adds_and_removes...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[3];
+    random_sks(sks, 3);
+    ECP_ZZZ points[2];
+    random_points(points, 2);
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 0));
+
+    struct ecdaa_revocation_delta_ZZZ add = {.base_epoch=0, .epoch=1,
+                                             .sk_added_length=3, .sk_added=sks, .sk_removed_length=0, .sk_removed=NULL,
+                                             .bsn_added_length=2, .bsn_added=points, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &add));
+    TEST_ASSERT(1 == ecdaa_revocation_store_ZZZ_epoch(&store));
+
+    struct ecdaa_revocation_delta_ZZZ remove = {.base_epoch=1, .epoch=5,
+                                                .sk_added_length=0, .sk_added=NULL, .sk_removed_length=1, .sk_removed=&sks[1],
+                                                .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=1, .bsn_removed=&points[0]};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &remove));
+    TEST_ASSERT(5 == ecdaa_revocation_store_ZZZ_epoch(&store));
+
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(2 == snapshot->revocations.sk_length);
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[0].sk, snapshot->revocations.sk_list[0].sk));
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[2].sk, snapshot->revocations.sk_list[1].sk));
+    TEST_ASSERT(1 == snapshot->revocations.bsn_length);
+    TEST_ASSERT(ECP_ZZZ_equals(&points[1], &snapshot->revocations.bsn_list[0]));
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void apply_out_of_order_fails()
+{
+    printf("Starting revocation_store::apply_out_of_order_fails...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[1];
+    random_sks(sks, 1);
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 0));
+
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=1, .epoch=2,
+                                               .sk_added_length=1, .sk_added=sks, .sk_removed_length=0, .sk_removed=NULL,
+                                               .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+
+    // Gap
+    TEST_ASSERT(-1 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+
+    // Not increasing
+    delta.base_epoch = 0;
+    delta.epoch = 0;
+    TEST_ASSERT(-1 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_epoch(&store));
+
+    // Replay
+    delta.epoch = 1;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+    TEST_ASSERT(-1 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void removals_start_new_generation()
+{
+    printf("Starting revocation_store::removals_start_new_generation...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[6];
+    random_sks(sks, 6);
+
+    uint8_t *basename = (uint8_t*)"BASENAME";
+    uint32_t basename_len = (uint32_t)strlen((char*)basename);
+    ECP_ZZZ basepoint;
+    TEST_ASSERT(-1 != ecp_ZZZ_fromhash(&basepoint, basename, basename_len));
+    ECP_ZZZ K[6];
+    for (size_t i = 0; i < 6; ++i) {
+        ECP_ZZZ_copy(&K[i], &basepoint);
+        ECP_ZZZ_mul(&K[i], sks[i].sk);
+    }
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, basename, basename_len, slots, 16, NULL, 0));
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 0));
+
+    struct ecdaa_revocation_delta_ZZZ add = {.base_epoch=0, .epoch=1,
+                                             .sk_added_length=2, .sk_added=sks, .sk_removed_length=0, .sk_removed=NULL,
+                                             .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &add));
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &snapshot->revocations));
+    uint64_t first_generation = snapshot->revocations.sk_generation;
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    // Remove one and add one: same length, but a new generation
+    struct ecdaa_revocation_delta_ZZZ swap = {.base_epoch=1, .epoch=2,
+                                              .sk_added_length=1, .sk_added=&sks[2], .sk_removed_length=1, .sk_removed=&sks[0],
+                                              .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &swap));
+    snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(2 == snapshot->revocations.sk_length);
+    TEST_ASSERT(first_generation != snapshot->revocations.sk_generation);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &snapshot->revocations));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[0]));
+    TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[1]));
+    TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[2]));
+    uint64_t second_generation = snapshot->revocations.sk_generation;
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    // Remove one and add two: longer, but still a new generation
+    struct ecdaa_revocation_delta_ZZZ grow = {.base_epoch=2, .epoch=3,
+                                              .sk_added_length=2, .sk_added=&sks[3], .sk_removed_length=1, .sk_removed=&sks[1],
+                                              .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &grow));
+    snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(3 == snapshot->revocations.sk_length);
+    TEST_ASSERT(second_generation != snapshot->revocations.sk_generation);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &snapshot->revocations));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[1]));
+    for (size_t i = 2; i < 5; ++i) {
+        TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[i]));
+    }
+    uint64_t third_generation = snapshot->revocations.sk_generation;
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    // Only appending keeps the generation
+    struct ecdaa_revocation_delta_ZZZ append = {.base_epoch=3, .epoch=4,
+                                                .sk_added_length=1, .sk_added=&sks[5], .sk_removed_length=0, .sk_removed=NULL,
+                                                .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &append));
+    snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(third_generation == snapshot->revocations.sk_generation);
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &snapshot->revocations));
+    TEST_ASSERT(1 == ecdaa_pseudonym_index_ZZZ_contains(&index, &K[5]));
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void snapshot_survives_update()
+{
+    printf("Starting revocation_store::snapshot_survives_update...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[2];
+    random_sks(sks, 2);
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 0));
+
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=0, .epoch=1,
+                                               .sk_added_length=1, .sk_added=&sks[0], .sk_removed_length=0, .sk_removed=NULL,
+                                               .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+
+    struct ecdaa_revocation_snapshot_ZZZ *old = ecdaa_revocation_store_ZZZ_acquire(&store);
+
+    delta.base_epoch = 1;
+    delta.epoch = 2;
+    delta.sk_added = &sks[1];
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_apply(&store, &delta));
+
+    // The old snapshot is unchanged
+    TEST_ASSERT(1 == old->epoch);
+    TEST_ASSERT(1 == old->revocations.sk_length);
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[0].sk, old->revocations.sk_list[0].sk));
+
+    struct ecdaa_revocation_snapshot_ZZZ *current = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(old != current);
+    TEST_ASSERT(2 == current->epoch);
+    TEST_ASSERT(2 == current->revocations.sk_length);
+
+    ecdaa_revocation_store_ZZZ_release(&store, old);
+    ecdaa_revocation_store_ZZZ_release(&store, current);
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void replace_whole_list()
+{
+    printf("Starting revocation_store::replace_whole_list...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[4];
+    random_sks(sks, 4);
+
+    struct ecdaa_revocation_store_ZZZ store;
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_init(&store, 0));
+
+    struct ecdaa_revocations_ZZZ revocations;
+    ecdaa_revocations_ZZZ_init(&revocations);
+    revocations.sk_length = 4;
+    revocations.sk_list = sks;
+
+    TEST_ASSERT(0 == ecdaa_revocation_store_ZZZ_replace(&store, &revocations, 10));
+    TEST_ASSERT(-1 == ecdaa_revocation_store_ZZZ_replace(&store, &revocations, 10));
+    TEST_ASSERT(10 == ecdaa_revocation_store_ZZZ_epoch(&store));
+
+    struct ecdaa_revocation_snapshot_ZZZ *snapshot = ecdaa_revocation_store_ZZZ_acquire(&store);
+    TEST_ASSERT(4 == snapshot->revocations.sk_length);
+    TEST_ASSERT(snapshot->revocations.sk_list != sks);
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[3].sk, snapshot->revocations.sk_list[3].sk));
+    ecdaa_revocation_store_ZZZ_release(&store, snapshot);
+
+    ecdaa_revocation_store_ZZZ_destroy(&store);
+
+    printf("\tsuccess\n");
+}
+
+static void delta_serialize_deserialize()
+{
+    printf("Starting revocation_store::delta_serialize_deserialize...\n");
+
+    struct ecdaa_member_secret_key_ZZZ sks[3];
+    random_sks(sks, 3);
+    ECP_ZZZ points[3];
+    random_points(points, 3);
+
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=7, .epoch=0x100000009ULL,
+                                               .sk_added_length=2, .sk_added=sks, .sk_removed_length=1, .sk_removed=&sks[2],
+                                               .bsn_added_length=1, .bsn_added=points, .bsn_removed_length=2, .bsn_removed=&points[1]};
+
+    uint8_t buffer[1024];
+    size_t length = ecdaa_revocation_delta_ZZZ_length(&delta);
+    TEST_ASSERT(length <= sizeof(buffer));
+    ecdaa_revocation_delta_ZZZ_serialize(buffer, &delta);
+
+    struct ecdaa_revocation_delta_ZZZ deserialized;
+    TEST_ASSERT(0 == ecdaa_revocation_delta_ZZZ_deserialize(&deserialized, buffer, length));
+
+    TEST_ASSERT(7 == deserialized.base_epoch);
+    TEST_ASSERT(0x100000009ULL == deserialized.epoch);
+    TEST_ASSERT(2 == deserialized.sk_added_length);
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[1].sk, deserialized.sk_added[1].sk));
+    TEST_ASSERT(1 == deserialized.sk_removed_length);
+    TEST_ASSERT(0 == BIG_XXX_comp(sks[2].sk, deserialized.sk_removed[0].sk));
+    TEST_ASSERT(1 == deserialized.bsn_added_length);
+    TEST_ASSERT(ECP_ZZZ_equals(&points[0], &deserialized.bsn_added[0]));
+    TEST_ASSERT(2 == deserialized.bsn_removed_length);
+    TEST_ASSERT(ECP_ZZZ_equals(&points[2], &deserialized.bsn_removed[1]));
+
+    ecdaa_revocation_delta_ZZZ_free(&deserialized);
+    TEST_ASSERT(NULL == deserialized.sk_added);
+
+    printf("\tsuccess\n");
+}
+
+static void delta_deserialize_garbage_fails()
+{
+    printf("Starting revocation_store::delta_deserialize_garbage_fails...\n");
+
+    ECP_ZZZ points[1];
+    random_points(points, 1);
+
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=0, .epoch=1,
+                                               .sk_added_length=0, .sk_added=NULL, .sk_removed_length=0, .sk_removed=NULL,
+                                               .bsn_added_length=1, .bsn_added=points, .bsn_removed_length=0, .bsn_removed=NULL};
+
+    uint8_t buffer[256];
+    size_t length = ecdaa_revocation_delta_ZZZ_length(&delta);
+    ecdaa_revocation_delta_ZZZ_serialize(buffer, &delta);
+
+    struct ecdaa_revocation_delta_ZZZ deserialized;
+
+    // Truncated
+    TEST_ASSERT(-1 == ecdaa_revocation_delta_ZZZ_deserialize(&deserialized, buffer, length - 1));
+
+    // Bad magic
+    buffer[0] ^= 1;
+    TEST_ASSERT(-1 == ecdaa_revocation_delta_ZZZ_deserialize(&deserialized, buffer, length));
+    buffer[0] ^= 1;
+
+    // Point not on the curve
+    buffer[length - 1] ^= 1;
+    TEST_ASSERT(-2 == ecdaa_revocation_delta_ZZZ_deserialize(&deserialized, buffer, length));
+    buffer[length - 1] ^= 1;
+
+    TEST_ASSERT(0 == ecdaa_revocation_delta_ZZZ_deserialize(&deserialized, buffer, length));
+    ecdaa_revocation_delta_ZZZ_free(&deserialized);
+
+    // Length overflows a size_t
+    struct ecdaa_revocation_delta_ZZZ huge = delta;
+    huge.bsn_added_length = SIZE_MAX / ECP_ZZZ_LENGTH;
+    huge.bsn_removed_length = SIZE_MAX / ECP_ZZZ_LENGTH;
+    TEST_ASSERT(0 == ecdaa_revocation_delta_ZZZ_length(&huge));
+
+    printf("\tsuccess\n");
+}
+
+static void random_sks(struct ecdaa_member_secret_key_ZZZ *sks_out, size_t num_sks)
+{
+    for (size_t i = 0; i < num_sks; ++i) {
+        ecp_ZZZ_random_mod_order(&sks_out[i].sk, test_randomness);
+    }
+}
+
+static void random_points(ECP_ZZZ *points_out, size_t num_points)
+{
+    for (size_t i = 0; i < num_points; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ecp_ZZZ_mul_generator(&points_out[i], scalar);
+    }
+}
@@ -0,0 +1,247 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/member_keypair_ZZZ.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_SK 5
+#define NUM_BSN 3
+
+static void write_then_map();
+static void write_then_map_empty();
+static void remap_with_replaced_entry_changes_generation();
+static void corrupted_file_fails();
+static void text_file_not_detected();
+
+typedef struct rev_file_fixture {
+    const char *filename;
+    struct ecdaa_member_secret_key_ZZZ sk_list[NUM_SK];
+    ECP_ZZZ bsn_list[NUM_BSN];
+    struct ecdaa_revocations_ZZZ revocations;
+} rev_file_fixture;
+
+static void setup(rev_file_fixture *fixture);
+static void teardown(rev_file_fixture *fixture);
+
+int main()
+{
+    write_then_map();
+    write_then_map_empty();
+    remap_with_replaced_entry_changes_generation();
+    corrupted_file_fails();
+    text_file_not_detected();
+}
+
+static void setup(rev_file_fixture *fixture)
+{
+    fixture->filename = "revocations.bin";
+
+    for (size_t i = 0; i < NUM_SK; ++i) {
+        ecp_ZZZ_random_mod_order(&fixture->sk_list[i].sk, test_randomness);
+    }
+    for (size_t i = 0; i < NUM_BSN; ++i) {
+        BIG_XXX scalar;
+        ecp_ZZZ_random_mod_order(&scalar, test_randomness);
+        ecp_ZZZ_mul_generator(&fixture->bsn_list[i], scalar);
+    }
+
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
+    fixture->revocations.sk_length = NUM_SK;
+    fixture->revocations.sk_list = fixture->sk_list;
+    fixture->revocations.bsn_length = NUM_BSN;
+    fixture->revocations.bsn_list = fixture->bsn_list;
+}
+
+static void teardown(rev_file_fixture *fixture)
+{
+    remove(fixture->filename);
+}
+
+static void write_then_map()
+{
+    printf("Starting revocations::write_then_map...\n");
+
+    rev_file_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+
+    struct ecdaa_revocations_ZZZ mapped;
+    struct ecdaa_revocations_file_ZZZ file;
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+
+    TEST_ASSERT(0 == ((uintptr_t)mapped.sk_list % ECDAA_REVOCATIONS_FILE_ALIGNMENT));
+    TEST_ASSERT(0 == ((uintptr_t)mapped.bsn_list % ECDAA_REVOCATIONS_FILE_ALIGNMENT));
+
+    TEST_ASSERT(NUM_SK == mapped.sk_length);
+    for (size_t i = 0; i < NUM_SK; ++i) {
+        TEST_ASSERT(0 == BIG_XXX_comp(fixture.sk_list[i].sk, mapped.sk_list[i].sk));
+    }
+
+    TEST_ASSERT(NUM_BSN == mapped.bsn_length);
+    for (size_t i = 0; i < NUM_BSN; ++i) {
+        TEST_ASSERT(ECP_ZZZ_equals(&fixture.bsn_list[i], &mapped.bsn_list[i]));
+    }
+
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+    TEST_ASSERT(NULL == file.map);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void remap_with_replaced_entry_changes_generation()
+{
+    printf("Starting revocations::remap_with_replaced_entry_changes_generation...\n");
+
+    rev_file_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_revocations_ZZZ mapped;
+    struct ecdaa_revocations_file_ZZZ file;
+
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+    uint64_t first_generation = mapped.sk_generation;
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+
+    // Same contents, same generation
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+    TEST_ASSERT(first_generation == mapped.sk_generation);
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+
+    // Same length, but an entry replaced
+    ecp_ZZZ_random_mod_order(&fixture.sk_list[2].sk, test_randomness);
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+    TEST_ASSERT(NUM_SK == mapped.sk_length);
+    TEST_ASSERT(first_generation != mapped.sk_generation);
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void write_then_map_empty()
+{
+    printf("Starting revocations::write_then_map_empty...\n");
+
+    rev_file_fixture fixture;
+    setup(&fixture);
+
+    fixture.revocations.sk_length = 0;
+    fixture.revocations.sk_list = NULL;
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+
+    struct ecdaa_revocations_ZZZ mapped;
+    struct ecdaa_revocations_file_ZZZ file;
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+    TEST_ASSERT(0 == mapped.sk_length);
+    TEST_ASSERT(NULL == mapped.sk_list);
+    TEST_ASSERT(NUM_BSN == mapped.bsn_length);
+
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void corrupted_file_fails()
+{
+    printf("Starting revocations::corrupted_file_fails...\n");
+
+    rev_file_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_write_file(fixture.filename, &fixture.revocations));
+
+    struct ecdaa_revocations_ZZZ mapped;
+    struct ecdaa_revocations_file_ZZZ file;
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, fixture.filename));
+
+    // Copy into an (aligned) buffer we can modify.
+    static uint64_t buffer[4096];
+    TEST_ASSERT(file.map_length <= sizeof(buffer));
+    size_t length = file.map_length;
+    memcpy(buffer, file.map, length);
+    ecdaa_revocations_ZZZ_unmap_file(&file);
+    uint8_t *bytes = (uint8_t*)buffer;
+
+    struct ecdaa_revocations_ZZZ loaded;
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+
+    // Truncated
+    TEST_ASSERT(-3 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length - 1));
+
+    // Entry modified
+    bytes[length - ECDAA_REVOCATIONS_FILE_ALIGNMENT - 1] ^= 1;
+    TEST_ASSERT(-3 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+    bytes[length - ECDAA_REVOCATIONS_FILE_ALIGNMENT - 1] ^= 1;
+
+    // Different curve (the name follows the magic, version, and byte-order mark)
+    bytes[16] ^= 1;
+    TEST_ASSERT(-2 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+    bytes[16] ^= 1;
+
+    // Different version
+    bytes[8] ^= 0x80;
+    TEST_ASSERT(-1 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+    bytes[8] ^= 0x80;
+
+    // Bad magic
+    bytes[0] ^= 1;
+    TEST_ASSERT(-1 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+    bytes[0] ^= 1;
+
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_from_buffer(&loaded, bytes, length));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void text_file_not_detected()
+{
+    printf("Starting revocations::text_file_not_detected...\n");
+
+    // A serialized secret key (the old, headerless format).
+    uint8_t buffer[ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH];
+    struct ecdaa_member_secret_key_ZZZ sk;
+    ecp_ZZZ_random_mod_order(&sk.sk, test_randomness);
+    ecdaa_member_secret_key_ZZZ_serialize(buffer, &sk);
+
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_is_file(buffer, sizeof(buffer)));
+    TEST_ASSERT(1 == ecdaa_revocations_ZZZ_is_file((const uint8_t*)"ECDAAREV", 8));
+    TEST_ASSERT(0 == ecdaa_revocations_ZZZ_is_file((const uint8_t*)"ECDAAREV", 7));
+
+    struct ecdaa_revocations_ZZZ mapped;
+    struct ecdaa_revocations_file_ZZZ file;
+    TEST_ASSERT(-4 == ecdaa_revocations_ZZZ_map_file(&mapped, &file, "does-not-exist.bin"));
+
+    printf("\tsuccess\n");
+}
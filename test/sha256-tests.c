@@ -0,0 +1,220 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include "ecdaa-test-utils.h"
+
+#include "internal-utilities/sha256.h"
+
+#include <amcl/amcl.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static void known_answers();
+static void matches_amcl();
+static void split_updates_match_one_shot();
+static void implementations_agree();
+static void multi_matches_one_at_a_time();
+
+static void check_known_answers();
+
+int main()
+{
+    known_answers();
+    matches_amcl();
+    split_updates_match_one_shot();
+    implementations_agree();
+    multi_matches_one_at_a_time();
+}
+
+static void known_answers()
+{
+    printf("Starting sha256::known_answers...\n");
+
+    check_known_answers();
+
+    printf("\tsuccess\n");
+}
+
+static void matches_amcl()
+{
+    printf("Starting sha256::matches_amcl...\n");
+
+    uint8_t message[300];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = (uint8_t)(7*i + 3);
+
+    for (size_t length = 0; length <= sizeof(message); ++length) {
+        hash256 amcl_hash;
+        HASH256_init(&amcl_hash);
+        for (size_t i = 0; i < length; ++i)
+            HASH256_process(&amcl_hash, message[i]);
+        char expected[32];
+        HASH256_hash(&amcl_hash, expected);
+
+        uint8_t actual[ECDAA_SHA256_DIGEST_LENGTH];
+        ecdaa_sha256(actual, message, length);
+
+        TEST_ASSERT(0 == memcmp(expected, actual, sizeof(actual)));
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void split_updates_match_one_shot()
+{
+    printf("Starting sha256::split_updates_match_one_shot...\n");
+
+    uint8_t message[200];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = (uint8_t)i;
+
+    uint8_t expected[ECDAA_SHA256_DIGEST_LENGTH];
+    ecdaa_sha256(expected, message, sizeof(message));
+
+    size_t chunk_lengths[] = {1, 3, 55, 56, 63, 64, 65, 128};
+    for (size_t c = 0; c < sizeof(chunk_lengths) / sizeof(chunk_lengths[0]); ++c) {
+        struct ecdaa_sha256 ctx;
+        ecdaa_sha256_init(&ctx);
+        for (size_t offset = 0; offset < sizeof(message); offset += chunk_lengths[c]) {
+            size_t remaining = sizeof(message) - offset;
+            ecdaa_sha256_update(&ctx, message + offset, remaining < chunk_lengths[c] ? remaining : chunk_lengths[c]);
+        }
+
+        uint8_t actual[ECDAA_SHA256_DIGEST_LENGTH];
+        ecdaa_sha256_final(&ctx, actual);
+
+        TEST_ASSERT(0 == memcmp(expected, actual, sizeof(actual)));
+    }
+
+    printf("\tsuccess\n");
+}
+
+static void implementations_agree()
+{
+    printf("Starting sha256::implementations_agree...\n");
+
+    enum ecdaa_sha256_implementation original = ecdaa_sha256_get_implementation();
+
+    enum ecdaa_sha256_implementation all[] = {ECDAA_SHA256_PORTABLE, ECDAA_SHA256_SHA_NI};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i) {
+        if (0 != ecdaa_sha256_set_implementation(all[i])) {
+            printf("\t(implementation %d not supported here)\n", (int)all[i]);
+            continue;
+        }
+        TEST_ASSERT(all[i] == ecdaa_sha256_get_implementation());
+
+        check_known_answers();
+    }
+
+    // Portable is always available
+    TEST_ASSERT(0 == ecdaa_sha256_set_implementation(ECDAA_SHA256_PORTABLE));
+
+    TEST_ASSERT(0 == ecdaa_sha256_set_implementation(original));
+
+    printf("\tsuccess\n");
+}
+
+static void multi_matches_one_at_a_time()
+{
+    printf("Starting sha256::multi_matches_one_at_a_time...\n");
+
+    enum ecdaa_sha256_multi_implementation original = ecdaa_sha256_multi_get_implementation();
+
+    // Lengths crossing the padding boundaries, in more messages than there are lanes,
+    //  split into segments in various ways.
+    static uint8_t data[600];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = (uint8_t)(i * 31 + 5);
+
+    enum { NUM_MESSAGES = 2*ECDAA_SHA256_MULTI_LANES + 3 };
+    size_t lengths[NUM_MESSAGES] = {0, 1, 55, 56, 57, 63, 64, 65, 119, 120, 127, 128, 129, 390, 391, 512, 599, 3, 200};
+    struct ecdaa_sha256_message messages[NUM_MESSAGES];
+    uint8_t expected[NUM_MESSAGES * ECDAA_SHA256_DIGEST_LENGTH];
+    for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+        size_t first = (i % 3 == 0) ? lengths[i] : lengths[i] / 3;
+        size_t second = (i % 3 == 2) ? lengths[i] - first : 0;
+        memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].segments[0] = data;
+        messages[i].segment_lengths[0] = first;
+        messages[i].segments[1] = data + first;
+        messages[i].segment_lengths[1] = second;
+        messages[i].segments[2] = data + first + second;
+        messages[i].segment_lengths[2] = lengths[i] - first - second;
+
+        ecdaa_sha256(expected + i*ECDAA_SHA256_DIGEST_LENGTH, data, lengths[i]);
+    }
+
+    enum ecdaa_sha256_multi_implementation all[] = {ECDAA_SHA256_MULTI_SERIAL, ECDAA_SHA256_MULTI_AVX2};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i) {
+        if (0 != ecdaa_sha256_multi_set_implementation(all[i])) {
+            printf("\t(implementation %d not supported here)\n", (int)all[i]);
+            continue;
+        }
+        TEST_ASSERT(all[i] == ecdaa_sha256_multi_get_implementation());
+
+        for (size_t num_messages = 1; num_messages <= NUM_MESSAGES; ++num_messages) {
+            uint8_t actual[NUM_MESSAGES * ECDAA_SHA256_DIGEST_LENGTH];
+            ecdaa_sha256_multi(actual, messages, num_messages);
+            TEST_ASSERT(0 == memcmp(expected, actual, num_messages * ECDAA_SHA256_DIGEST_LENGTH));
+        }
+    }
+
+    TEST_ASSERT(0 == ecdaa_sha256_multi_set_implementation(original));
+
+    printf("\tsuccess\n");
+}
+
+static void check_known_answers()
+{
+    // FIPS 180-2, Appendix B
+    const char *messages[] = {
+        "",
+        "abc",
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+    };
+    const uint8_t digests[][ECDAA_SHA256_DIGEST_LENGTH] = {
+        {0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+         0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55},
+        {0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+         0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad},
+        {0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+         0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1}
+    };
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); ++i) {
+        uint8_t actual[ECDAA_SHA256_DIGEST_LENGTH];
+        ecdaa_sha256(actual, (const uint8_t*)messages[i], strlen(messages[i]));
+        TEST_ASSERT(0 == memcmp(digests[i], actual, sizeof(actual)));
+    }
+
+    // One million 'a's, in uneven pieces
+    const uint8_t million_a_digest[ECDAA_SHA256_DIGEST_LENGTH] = {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+        0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    uint8_t a_s[1001];
+    memset(a_s, 'a', sizeof(a_s));
+    struct ecdaa_sha256 ctx;
+    ecdaa_sha256_init(&ctx);
+    for (size_t i = 0; i < 1000; ++i)
+        ecdaa_sha256_update(&ctx, a_s, (i & 1) ? 999 : 1001);
+    uint8_t actual[ECDAA_SHA256_DIGEST_LENGTH];
+    ecdaa_sha256_final(&ctx, actual);
+    TEST_ASSERT(0 == memcmp(million_a_digest, actual, sizeof(actual)));
+}
@@ -21,13 +21,19 @@
 #include "amcl-extensions/big_XXX.h"
 #include "amcl-extensions/ecp_ZZZ.h"
 #include "amcl-extensions/ecp2_ZZZ.h"
+#include "revocations/sk_revocation_scan_ZZZ.h"
 
 #include <ecdaa/member_keypair_ZZZ.h>
 #include <ecdaa/credential_ZZZ.h>
 #include <ecdaa/issuer_keypair_ZZZ.h>
 #include <ecdaa/signature_ZZZ.h>
 #include <ecdaa/group_public_key_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
 #include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/bsn_revocation_set_ZZZ.h>
+#include <ecdaa/pseudonym_index_ZZZ.h>
+#include <ecdaa/revocation_store_ZZZ.h>
+#include <ecdaa/basename_ctx_ZZZ.h>
 
 #include <string.h>
 
@@ -38,6 +44,10 @@ static void sign_then_verify_on_rev_list();
 static void sign_then_verify_bad_basename_fails();
 static void sign_then_verify_no_basename();
 static void sign_then_verify_on_bsn_rev_list();
+static void sign_then_verify_on_bsn_rev_set();
+static void sign_then_verify_on_pseudonym_index();
+static void sign_then_verify_on_pseudonym_index_after_remove_and_add();
+static void sign_then_verify_on_long_rev_list();
 static void lengths_same();
 static void serialize_deserialize();
 static void serialize_deserialize_file();
@@ -45,6 +55,19 @@ static void serialize_deserialize_fp();
 static void pseudonym();
 static void deserialize_garbage_fails();
 static void trivial_credential_fails();
+static void modified_R_or_T_fails();
+static void batch_verify_good();
+static void batch_verify_finds_bad_signatures();
+static void batch_verify_prepared_finds_bad_signatures();
+static void verify_prepared();
+static void verify_with_policy_reports_stage();
+static void verify_crypto_then_recheck_revocations();
+static void sign_then_verify_with_basename_ctx();
+static void sign_with_basename_ctx_of_other_key_fails();
+static void sign_then_verify_with_fouque_tibouchi_basename_ctx();
+static void fouque_tibouchi_batch_streamed_and_revocations();
+static void sign_then_verify_streamed();
+static void sign_then_verify_streamed_with_basename_ctx();
 
 typedef struct sign_and_verify_fixture {
     uint8_t *msg;
@@ -69,6 +92,10 @@ int main()
     sign_then_verify_bad_basename_fails();
     sign_then_verify_no_basename();
     sign_then_verify_on_bsn_rev_list();
+    sign_then_verify_on_bsn_rev_set();
+    sign_then_verify_on_pseudonym_index();
+    sign_then_verify_on_pseudonym_index_after_remove_and_add();
+    sign_then_verify_on_long_rev_list();
     lengths_same();
     serialize_deserialize();
     serialize_deserialize_file();
@@ -76,6 +103,19 @@ int main()
     pseudonym();
     deserialize_garbage_fails();
     trivial_credential_fails();
+    modified_R_or_T_fails();
+    batch_verify_good();
+    batch_verify_finds_bad_signatures();
+    batch_verify_prepared_finds_bad_signatures();
+    verify_prepared();
+    verify_with_policy_reports_stage();
+    verify_crypto_then_recheck_revocations();
+    sign_then_verify_with_basename_ctx();
+    sign_with_basename_ctx_of_other_key_fails();
+    sign_then_verify_with_fouque_tibouchi_basename_ctx();
+    fouque_tibouchi_batch_streamed_and_revocations();
+    sign_then_verify_streamed();
+    sign_then_verify_streamed_with_basename_ctx();
 }
 
 static void setup(sign_and_verify_fixture* fixture)
@@ -101,10 +141,7 @@ static void setup(sign_and_verify_fixture* fixture)
     fixture->basename = (uint8_t*) "BASENAME";
     fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
 
-    fixture->revocations.sk_length=0;
-    fixture->revocations.sk_list=NULL;
-    fixture->revocations.bsn_length=0;
-    fixture->revocations.bsn_list=NULL;
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
 }
 
 static void teardown(sign_and_verify_fixture *fixture)
@@ -139,7 +176,7 @@ static void sign_then_verify_on_rev_list()
     // Put self on a secret-key revocation list, to be used in verify.
     struct ecdaa_member_secret_key_ZZZ sk_rev_list_bad_raw[1];
     BIG_XXX_copy(sk_rev_list_bad_raw[0].sk, fixture.sk.sk);
-    struct ecdaa_revocations_ZZZ rev_list_bad = {.sk_length=1, .sk_list=sk_rev_list_bad_raw, .bsn_length=0, .bsn_list=NULL};
+    struct ecdaa_revocations_ZZZ rev_list_bad = {.sk_length=1, .sk_list=sk_rev_list_bad_raw, .bsn_length=0, .bsn_list=NULL, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
 
     struct ecdaa_signature_ZZZ sig;
     TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
@@ -164,7 +201,7 @@ static void sign_then_verify_on_bsn_rev_list()
     // Put self on a basename revocation list, to be used in verify.
     ECP_ZZZ bsn_rev_list_bad_raw[1];
     ECP_ZZZ_copy(&bsn_rev_list_bad_raw[0], &sig.K);
-    struct ecdaa_revocations_ZZZ rev_list_bad = {.bsn_length=1, .bsn_list=bsn_rev_list_bad_raw, .sk_length=0, .sk_list=NULL};
+    struct ecdaa_revocations_ZZZ rev_list_bad = {.bsn_length=1, .bsn_list=bsn_rev_list_bad_raw, .sk_length=0, .sk_list=NULL, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
 
     TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &rev_list_bad, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
 
@@ -173,6 +210,157 @@ static void sign_then_verify_on_bsn_rev_list()
     printf("\tsuccess\n");
 }
 
+static void sign_then_verify_on_bsn_rev_set()
+{
+    printf("Starting signature::sign_then_verify_on_bsn_rev_set...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_bsn_revocation_set_ZZZ bsn_set;
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_init(&bsn_set, slots, 16, NULL, 0));
+    fixture.revocations.bsn_set = &bsn_set;
+
+    // Empty set doesn't reject
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Put self in the set
+    TEST_ASSERT(0 == ecdaa_bsn_revocation_set_ZZZ_insert(&bsn_set, &sig.K));
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_on_pseudonym_index()
+{
+    printf("Starting signature::sign_then_verify_on_pseudonym_index...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    // Some other member is revoked
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_raw[2];
+    ecp_ZZZ_random_mod_order(&sk_rev_list_raw[0].sk, test_randomness);
+    fixture.revocations.sk_list = sk_rev_list_raw;
+    fixture.revocations.sk_length = 1;
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, slots, 16, NULL, 0));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    fixture.revocations.pseudonym_indexes = &index;
+    fixture.revocations.num_pseudonym_indexes = 1;
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Revoke self: index is stale, so the scan catches it
+    BIG_XXX_copy(sk_rev_list_raw[1].sk, fixture.sk.sk);
+    fixture.revocations.sk_length = 2;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Once synced, the index catches it
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    enum ecdaa_verify_stage stage;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, ECDAA_VERIFY_POLICY_COMPLETE, &stage));
+    TEST_ASSERT(ECDAA_VERIFY_STAGE_SK_REVOCATION == stage);
+
+    // The index really replaces the scan (which would now find nothing)
+    ecp_ZZZ_random_mod_order(&sk_rev_list_raw[1].sk, test_randomness);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_on_pseudonym_index_after_remove_and_add()
+{
+    printf("Starting signature::sign_then_verify_on_pseudonym_index_after_remove_and_add...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    // Some other member is revoked
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_raw[1];
+    ecp_ZZZ_random_mod_order(&sk_rev_list_raw[0].sk, test_randomness);
+    fixture.revocations.sk_list = sk_rev_list_raw;
+    fixture.revocations.sk_length = 1;
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, slots, 16, NULL, 0));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    fixture.revocations.pseudonym_indexes = &index;
+    fixture.revocations.num_pseudonym_indexes = 1;
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Un-revoke the other member and revoke self: same length, new generation.
+    //  The index is stale, so the scan catches it.
+    BIG_XXX_copy(sk_rev_list_raw[0].sk, fixture.sk.sk);
+    fixture.revocations.sk_generation += 1;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Once synced (i.e. rebuilt), the index catches it
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static struct ecdaa_member_secret_key_ZZZ long_sk_rev_list_raw[2*SK_REVOCATION_SCAN_ZZZ_MIN_ENTRIES_PER_THREAD + 8];
+
+static void sign_then_verify_on_long_rev_list()
+{
+    printf("Starting signature::sign_then_verify_on_long_rev_list...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    size_t list_length = sizeof(long_sk_rev_list_raw) / sizeof(long_sk_rev_list_raw[0]);
+    for (size_t i = 0; i < list_length; ++i) {
+        ecp_ZZZ_random_mod_order(&long_sk_rev_list_raw[i].sk, test_randomness);
+    }
+
+    // Long enough to use the fixed-base table, but not extra threads.
+    struct ecdaa_revocations_ZZZ short_rev_list = {.sk_length=SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD, .sk_list=long_sk_rev_list_raw, .bsn_length=0, .bsn_list=NULL, .sk_scan_threads=4, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &short_rev_list, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    BIG_XXX_copy(long_sk_rev_list_raw[SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD - 1].sk, fixture.sk.sk);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &short_rev_list, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    ecp_ZZZ_random_mod_order(&long_sk_rev_list_raw[SK_REVOCATION_SCAN_ZZZ_TABLE_THRESHOLD - 1].sk, test_randomness);
+
+    // Long enough to be split across threads (with self in the last shard).
+    struct ecdaa_revocations_ZZZ long_rev_list = {.sk_length=list_length, .sk_list=long_sk_rev_list_raw, .bsn_length=0, .bsn_list=NULL, .sk_scan_threads=4, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &long_rev_list, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    BIG_XXX_copy(long_sk_rev_list_raw[list_length - 1].sk, fixture.sk.sk);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &long_rev_list, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Same, in the calling thread only.
+    long_rev_list.sk_scan_threads = 1;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &long_rev_list, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
 static void sign_then_verify_bad_basename_fails()
 {
     printf("Starting signature::sign_then_verify_bad_basename_fails...\n");
@@ -383,3 +571,597 @@ static void trivial_credential_fails()
     printf("\tsuccess\n");
 }
 
+
+static void modified_R_or_T_fails()
+{
+    printf("Starting signature::modified_R_or_T_fails...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    ECP_ZZZ generator;
+    ecp_ZZZ_set_to_generator(&generator);
+
+    // R and T aren't covered by the Schnorr proof, only by the pairing checks.
+    struct ecdaa_signature_ZZZ sig_bad_R = sig;
+    ECP_ZZZ_add(&sig_bad_R.R, &generator);
+    ECP_ZZZ_affine(&sig_bad_R.R);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig_bad_R, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    struct ecdaa_signature_ZZZ sig_bad_T = sig;
+    ECP_ZZZ_add(&sig_bad_T.T, &generator);
+    ECP_ZZZ_affine(&sig_bad_T.T);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify(&sig_bad_T, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void batch_verify_good()
+{
+    printf("Starting signature::batch_verify_good...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sigs[3];
+    uint8_t *messages[3] = {fixture.msg, fixture.msg, fixture.msg};
+    uint32_t message_lengths[3] = {fixture.msg_len, fixture.msg_len, fixture.msg_len};
+    uint8_t *basenames[3] = {fixture.basename, NULL, fixture.basename};
+    uint32_t basename_lengths[3] = {fixture.basename_len, 0, fixture.basename_len};
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], messages[i], message_lengths[i], basenames[i], basename_lengths[i], &fixture.sk, &fixture.cred, test_randomness));
+    }
+
+    int results[3] = {-1, -1, -1};
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify(sigs, messages, message_lengths, basenames, basename_lengths, 3, &fixture.ipk.gpk, &fixture.revocations, results));
+    TEST_ASSERT(0 == results[0] && 0 == results[1] && 0 == results[2]);
+
+    // Without any basenames
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], messages[i], message_lengths[i], NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    }
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify(sigs, messages, message_lengths, NULL, NULL, 3, &fixture.ipk.gpk, &fixture.revocations, results));
+    TEST_ASSERT(0 == results[0] && 0 == results[1] && 0 == results[2]);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void batch_verify_finds_bad_signatures()
+{
+    printf("Starting signature::batch_verify_finds_bad_signatures...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sigs[5];
+    uint8_t *messages[5];
+    uint32_t message_lengths[5];
+    for (int i = 0; i < 5; ++i) {
+        messages[i] = fixture.msg;
+        message_lengths[i] = fixture.msg_len;
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], messages[i], message_lengths[i], NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    }
+
+    ECP_ZZZ generator;
+    ecp_ZZZ_set_to_generator(&generator);
+
+    // Only caught by the pairing checks
+    ECP_ZZZ_add(&sigs[1].T, &generator);
+    ECP_ZZZ_affine(&sigs[1].T);
+    ECP_ZZZ_add(&sigs[4].R, &generator);
+    ECP_ZZZ_affine(&sigs[4].R);
+
+    // Only caught by the Schnorr check
+    message_lengths[2] -= 1;
+
+    int results[5];
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_batch_verify(sigs, messages, message_lengths, NULL, NULL, 5, &fixture.ipk.gpk, &fixture.revocations, results));
+    TEST_ASSERT(0 == results[0]);
+    TEST_ASSERT(0 != results[1]);
+    TEST_ASSERT(0 != results[2]);
+    TEST_ASSERT(0 == results[3]);
+    TEST_ASSERT(0 != results[4]);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void batch_verify_prepared_finds_bad_signatures()
+{
+    printf("Starting signature::batch_verify_prepared_finds_bad_signatures...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    // More than one group of multi-scalar multiplications
+    struct ecdaa_signature_ZZZ sigs[11];
+    uint8_t *messages[11];
+    uint32_t message_lengths[11];
+    for (int i = 0; i < 11; ++i) {
+        messages[i] = fixture.msg;
+        message_lengths[i] = fixture.msg_len;
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[i], messages[i], message_lengths[i], NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    }
+
+    struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    int results[11];
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify_prepared(sigs, messages, message_lengths, NULL, NULL, 11, &prepared_gpk, &fixture.revocations, results));
+    for (int i = 0; i < 11; ++i) {
+        TEST_ASSERT(0 == results[i]);
+    }
+
+    ECP_ZZZ generator;
+    ecp_ZZZ_set_to_generator(&generator);
+    ECP_ZZZ_add(&sigs[9].S, &generator);
+    ECP_ZZZ_affine(&sigs[9].S);
+
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_batch_verify_prepared(sigs, messages, message_lengths, NULL, NULL, 11, &prepared_gpk, &fixture.revocations, results));
+    for (int i = 0; i < 11; ++i) {
+        TEST_ASSERT((9 == i) == (0 != results[i]));
+    }
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+
+static void verify_prepared()
+{
+    printf("Starting signature::verify_prepared...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_prepared(&sig, &prepared_gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // Modified T
+    ECP_ZZZ_add(&sig.T, &sig.R);
+    ECP_ZZZ_affine(&sig.T);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_prepared(&sig, &prepared_gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void verify_with_policy_reports_stage()
+{
+    printf("Starting signature::verify_with_policy_reports_stage...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_bad_raw[1];
+    BIG_XXX_copy(sk_rev_list_bad_raw[0].sk, fixture.sk.sk);
+    struct ecdaa_revocations_ZZZ sk_rev_list_bad = {.sk_length=1, .sk_list=sk_rev_list_bad_raw, .bsn_length=0, .bsn_list=NULL, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+
+    ECP_ZZZ bsn_rev_list_bad_raw[1];
+    ECP_ZZZ_copy(&bsn_rev_list_bad_raw[0], &sig.K);
+    struct ecdaa_revocations_ZZZ bsn_rev_list_bad = {.bsn_length=1, .bsn_list=bsn_rev_list_bad_raw, .sk_length=0, .sk_list=NULL, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+
+    ECP_ZZZ generator;
+    ecp_ZZZ_set_to_generator(&generator);
+    struct ecdaa_signature_ZZZ sig_bad_T = sig;
+    ECP_ZZZ_add(&sig_bad_T.T, &generator);
+    ECP_ZZZ_affine(&sig_bad_T.T);
+
+    uint8_t *wrong_msg = (uint8_t*) "Wrong message";
+    uint32_t wrong_msg_len = (uint32_t)strlen((char*)wrong_msg);
+
+    enum ecdaa_verify_policy policies[2] = {ECDAA_VERIFY_POLICY_COMPLETE, ECDAA_VERIFY_POLICY_FAIL_FAST};
+    for (int i = 0; i < 2; ++i) {
+        enum ecdaa_verify_stage stage = ECDAA_VERIFY_STAGE_PAIRING;
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_policy(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_NONE == stage);
+
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig, &fixture.ipk.gpk, &bsn_rev_list_bad, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_BSN_REVOCATION == stage);
+
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig, &fixture.ipk.gpk, &fixture.revocations, wrong_msg, wrong_msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_SCHNORR == stage);
+
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig_bad_T, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_PAIRING == stage);
+
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig, &fixture.ipk.gpk, &sk_rev_list_bad, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_SK_REVOCATION == stage);
+
+        // Several failures: the earliest stage is reported.
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig_bad_T, &fixture.ipk.gpk, &bsn_rev_list_bad, wrong_msg, wrong_msg_len, fixture.basename, fixture.basename_len, policies[i], &stage));
+        TEST_ASSERT(ECDAA_VERIFY_STAGE_BSN_REVOCATION == stage);
+
+        // Stage output is optional.
+        TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_with_policy(&sig_bad_T, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, policies[i], NULL));
+    }
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void verify_crypto_then_recheck_revocations()
+{
+    printf("Starting signature::verify_crypto_then_recheck_revocations...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_signature_ZZZ sigs[2];
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[0], fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sigs[1], fixture.msg, fixture.msg_len, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+
+    // Crypto phase ignores revocations, but not the message
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_crypto(&sigs[0], &fixture.ipk.gpk, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_verify_crypto(&sigs[0], &fixture.ipk.gpk, fixture.msg, fixture.msg_len - 1, fixture.basename, fixture.basename_len));
+
+    struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_crypto_prepared(&sigs[1], &prepared_gpk, fixture.msg, fixture.msg_len, NULL, 0));
+
+    // Revocation phase
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_raw[2];
+    ecp_ZZZ_random_mod_order(&sk_rev_list_raw[0].sk, test_randomness);
+    BIG_XXX_copy(sk_rev_list_raw[1].sk, fixture.sk.sk);
+    enum ecdaa_verify_stage stage;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_check_revocations(&sigs[0], &fixture.revocations, fixture.basename, fixture.basename_len, &stage));
+    TEST_ASSERT(ECDAA_VERIFY_STAGE_NONE == stage);
+    fixture.revocations.sk_list = sk_rev_list_raw;
+    fixture.revocations.sk_length = 2;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_check_revocations(&sigs[0], &fixture.revocations, fixture.basename, fixture.basename_len, &stage));
+    TEST_ASSERT(ECDAA_VERIFY_STAGE_SK_REVOCATION == stage);
+
+    // A delta revoking someone else doesn't affect either signature
+    int results[2];
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=0, .epoch=1,
+                                               .sk_added_length=1, .sk_added=&sk_rev_list_raw[0], .sk_removed_length=0, .sk_removed=NULL,
+                                               .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_recheck_revocations(results, sigs, 2, &delta, 0));
+    TEST_ASSERT(0 == results[0] && 0 == results[1]);
+
+    // Revoking the signer's key catches both
+    delta.sk_added = &sk_rev_list_raw[1];
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_recheck_revocations(results, sigs, 2, &delta, 0));
+    TEST_ASSERT(0 != results[0] && 0 != results[1]);
+
+    // Revoking the pseudonym catches only the basename signature
+    delta.sk_added_length = 0;
+    delta.bsn_added_length = 1;
+    delta.bsn_added = &sigs[0].K;
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_recheck_revocations(results, sigs, 2, &delta, 0));
+    TEST_ASSERT(0 != results[0] && 0 == results[1]);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static struct ecdaa_basename_ctx_ZZZ signer_basename_ctx;
+static struct ecdaa_basename_ctx_ZZZ verifier_basename_ctx;
+
+static void sign_then_verify_with_basename_ctx()
+{
+    printf("Starting signature::sign_then_verify_with_basename_ctx...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(-1 == ecdaa_basename_ctx_ZZZ_init(&signer_basename_ctx, fixture.basename, 0));
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&signer_basename_ctx, fixture.basename, fixture.basename_len));
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&verifier_basename_ctx, fixture.basename, fixture.basename_len));
+
+    // Without the cached pseudonym
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // With the cached pseudonym (which is the same as computed when signing)
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+    TEST_ASSERT(ECP_ZZZ_equals(&signer_basename_ctx.K, &sig.K));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_prepared_with_basename_ctx(&sig, &prepared_gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // A signature made without a context verifies with one
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // Wrong basename
+    uint8_t *wrong_basename = (uint8_t*) "WRONG BASENAME";
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&verifier_basename_ctx, wrong_basename, (uint32_t)strlen((char*)wrong_basename)));
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // Revoked basename
+    ECP_ZZZ bsn_rev_list[1];
+    ECP_ZZZ_copy(&bsn_rev_list[0], &sig.K);
+    struct ecdaa_revocations_ZZZ bsn_revocations = {.sk_length=0, .sk_list=NULL, .bsn_length=1, .bsn_list=bsn_rev_list, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&verifier_basename_ctx, fixture.basename, fixture.basename_len));
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &bsn_revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_with_fouque_tibouchi_basename_ctx()
+{
+    printf("Starting signature::sign_then_verify_with_fouque_tibouchi_basename_ctx...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(&signer_basename_ctx, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI));
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(&verifier_basename_ctx, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI));
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // The method is part of the signature: plain verification (try-and-increment) fails
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    // A try-and-increment index for this basename must not be used for this signature
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_raw[1];
+    BIG_XXX_copy(sk_rev_list_raw[0].sk, fixture.sk.sk);
+    fixture.revocations.sk_list = sk_rev_list_raw;
+    fixture.revocations.sk_length = 1;
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init(&index, fixture.basename, fixture.basename_len, slots, 16, NULL, 0));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    fixture.revocations.pseudonym_indexes = &index;
+    fixture.revocations.num_pseudonym_indexes = 1;
+    TEST_ASSERT(!ecdaa_pseudonym_index_ZZZ_contains(&index, &sig.K));
+
+    // (so the scan catches it)
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    // A matching index holds the pseudonym
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init_with_hash_to_curve(&index, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, slots, 16, NULL, 0));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    TEST_ASSERT(ecdaa_pseudonym_index_ZZZ_contains(&index, &sig.K));
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_with_basename_ctx(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, &verifier_basename_ctx));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void fouque_tibouchi_batch_streamed_and_revocations()
+{
+    printf("Starting signature::fouque_tibouchi_batch_streamed_and_revocations...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init_with_hash_to_curve(&signer_basename_ctx, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI));
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+
+    struct ecdaa_signature_ZZZ sigs[2];
+    for (int i = 0; i < 2; ++i) {
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sigs[i], fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    }
+
+    // Batch, under the matching method only
+    uint8_t *messages[2] = {fixture.msg, fixture.msg};
+    uint32_t message_lengths[2] = {fixture.msg_len, fixture.msg_len};
+    uint8_t *basenames[2] = {fixture.basename, fixture.basename};
+    uint32_t basename_lengths[2] = {fixture.basename_len, fixture.basename_len};
+    int results[2] = {-1, -1};
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify_with_hash_to_curve(sigs, messages, message_lengths, basenames, basename_lengths, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, 2, &fixture.ipk.gpk, &fixture.revocations, results));
+    TEST_ASSERT(0 == results[0] && 0 == results[1]);
+    TEST_ASSERT(0 != ecdaa_signature_ZZZ_batch_verify(sigs, messages, message_lengths, basenames, basename_lengths, 2, &fixture.ipk.gpk, &fixture.revocations, results));
+
+    struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_batch_verify_prepared_with_hash_to_curve(sigs, messages, message_lengths, basenames, basename_lengths, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, 2, &prepared_gpk, &fixture.revocations, results));
+
+    // Streamed
+    struct ecdaa_signature_ZZZ_verify_ctx verify_ctx;
+    ecdaa_signature_ZZZ_verify_begin_with_hash_to_curve(&verify_ctx, &sigs[0], fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, fixture.msg, fixture.msg_len);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sigs[0], fixture.basename, fixture.basename_len);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, fixture.msg, fixture.msg_len);
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    // Revocations, found through a matching pseudonym index
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list_raw[1];
+    BIG_XXX_copy(sk_rev_list_raw[0].sk, fixture.sk.sk);
+    fixture.revocations.sk_list = sk_rev_list_raw;
+    fixture.revocations.sk_length = 1;
+
+    uint8_t slots[16 * ECDAA_BSN_REVOCATION_SET_ZZZ_SLOT_LENGTH];
+    struct ecdaa_pseudonym_index_ZZZ index;
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_init_with_hash_to_curve(&index, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, slots, 16, NULL, 0));
+    TEST_ASSERT(0 == ecdaa_pseudonym_index_ZZZ_sync(&index, &fixture.revocations));
+    fixture.revocations.pseudonym_indexes = &index;
+    fixture.revocations.num_pseudonym_indexes = 1;
+
+    enum ecdaa_verify_stage stage;
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_check_revocations_with_hash_to_curve(&sigs[0], &fixture.revocations, fixture.basename, fixture.basename_len, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, &stage));
+    TEST_ASSERT(ECDAA_VERIFY_STAGE_SK_REVOCATION == stage);
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_batch_verify_with_hash_to_curve(sigs, messages, message_lengths, basenames, basename_lengths, ECDAA_HASH_TO_CURVE_FOUQUE_TIBOUCHI, 2, &fixture.ipk.gpk, &fixture.revocations, results));
+    TEST_ASSERT(0 != results[0] && 0 != results[1]);
+
+    // Recheck doesn't hash the basename, so works for these signatures too
+    struct ecdaa_revocation_delta_ZZZ delta = {.base_epoch=0, .epoch=1,
+                                               .sk_added_length=1, .sk_added=sk_rev_list_raw, .sk_removed_length=0, .sk_removed=NULL,
+                                               .bsn_added_length=0, .bsn_added=NULL, .bsn_removed_length=0, .bsn_removed=NULL};
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_recheck_revocations(results, sigs, 2, &delta, 0));
+    TEST_ASSERT(0 != results[0] && 0 != results[1]);
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_streamed()
+{
+    printf("Starting signature::sign_then_verify_streamed...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    // Long enough to span several hash blocks, in uneven pieces
+    uint8_t msg[1000];
+    for (size_t i = 0; i < sizeof(msg); ++i)
+        msg[i] = (uint8_t)(i * 7);
+    const uint8_t *chunks[] = {msg, msg + 1, msg + 64, msg + 200, msg + 999};
+    const uint32_t chunk_lengths[] = {1, 63, 136, 799, 1};
+
+    struct ecdaa_signature_ZZZ_sign_ctx sign_ctx;
+    struct ecdaa_signature_ZZZ_verify_ctx verify_ctx;
+    struct ecdaa_signature_ZZZ sig;
+
+    // With a basename: streamed signature verifies one-shot, and streamed
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_begin(&sign_ctx, fixture.basename, fixture.basename_len, &fixture.sk, &fixture.cred, test_randomness));
+    for (size_t i = 0; i < sizeof(msg); i += 100)
+        ecdaa_signature_ZZZ_sign_update(&sign_ctx, msg + i, 100);
+    ecdaa_signature_ZZZ_sign_finish(&sign_ctx, &sig);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, msg, sizeof(msg), fixture.basename, fixture.basename_len));
+
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, fixture.basename, fixture.basename_len);
+    ecdaa_signature_ZZZ_verify_updatev(&verify_ctx, chunks, chunk_lengths, 5);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    // Without a basename: one-shot signature verifies streamed
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&sig, msg, sizeof(msg), NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, NULL, 0);
+    ecdaa_signature_ZZZ_verify_updatev(&verify_ctx, chunks, chunk_lengths, 5);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_begin(&sign_ctx, NULL, 0, &fixture.sk, &fixture.cred, test_randomness));
+    ecdaa_signature_ZZZ_sign_updatev(&sign_ctx, chunks, chunk_lengths, 5);
+    ecdaa_signature_ZZZ_sign_finish(&sign_ctx, &sig);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, msg, sizeof(msg), NULL, 0));
+
+    // A missing piece fails
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, NULL, 0);
+    ecdaa_signature_ZZZ_verify_updatev(&verify_ctx, chunks, chunk_lengths, 4);
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    // So does a basename-less signature checked against a basename
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, fixture.basename, fixture.basename_len);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, msg, sizeof(msg));
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    // The rest of the checks still run (here, the sk revocation list)
+    struct ecdaa_member_secret_key_ZZZ sk_rev_list[1];
+    BIG_XXX_copy(sk_rev_list[0].sk, fixture.sk.sk);
+    fixture.revocations.sk_list = sk_rev_list;
+    fixture.revocations.sk_length = 1;
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, NULL, 0);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, msg, sizeof(msg));
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &fixture.revocations));
+
+    // Mismatched basename arguments
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_sign_begin(&sign_ctx, NULL, 1, &fixture.sk, &fixture.cred, test_randomness));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_with_basename_ctx_of_other_key_fails()
+{
+    printf("Starting signature::sign_with_basename_ctx_of_other_key_fails...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    struct ecdaa_member_secret_key_ZZZ other_sk;
+    ecp_ZZZ_random_mod_order(&other_sk.sk, test_randomness);
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&signer_basename_ctx, fixture.basename, fixture.basename_len));
+
+    // Any key may sign before a pseudonym is set
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_check_secret_key(&signer_basename_ctx, &other_sk));
+
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_check_secret_key(&signer_basename_ctx, &fixture.sk));
+    TEST_ASSERT(-1 == ecdaa_basename_ctx_ZZZ_check_secret_key(&signer_basename_ctx, &other_sk));
+
+    struct ecdaa_signature_ZZZ sig;
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &other_sk, &fixture.cred, test_randomness));
+
+    struct ecdaa_signature_ZZZ_sign_ctx sign_ctx;
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_sign_begin_with_basename_ctx(&sign_ctx, &signer_basename_ctx, &other_sk, &fixture.cred, test_randomness));
+
+    // The right key still signs
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_with_basename_ctx(&sig, fixture.msg, fixture.msg_len, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void sign_then_verify_streamed_with_basename_ctx()
+{
+    printf("Starting signature::sign_then_verify_streamed_with_basename_ctx...\n");
+
+    sign_and_verify_fixture fixture;
+    setup(&fixture);
+
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&signer_basename_ctx, fixture.basename, fixture.basename_len));
+    TEST_ASSERT(0 == ecdaa_basename_ctx_ZZZ_init(&verifier_basename_ctx, fixture.basename, fixture.basename_len));
+    ecdaa_basename_ctx_ZZZ_set_secret_key(&signer_basename_ctx, &fixture.sk);
+    ecdaa_prepared_gpk_ZZZ_prepare(&prepared_gpk, &fixture.ipk.gpk);
+
+    struct ecdaa_signature_ZZZ_sign_ctx sign_ctx;
+    struct ecdaa_signature_ZZZ_verify_ctx verify_ctx;
+    struct ecdaa_signature_ZZZ sig;
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign_begin_with_basename_ctx(&sign_ctx, &signer_basename_ctx, &fixture.sk, &fixture.cred, test_randomness));
+    ecdaa_signature_ZZZ_sign_update(&sign_ctx, fixture.msg, 4);
+    ecdaa_signature_ZZZ_sign_update(&sign_ctx, fixture.msg + 4, fixture.msg_len - 4);
+    ecdaa_signature_ZZZ_sign_finish(&sign_ctx, &sig);
+    TEST_ASSERT(ECP_ZZZ_equals(&signer_basename_ctx.K, &sig.K));
+
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify(&sig, &fixture.ipk.gpk, &fixture.revocations, fixture.msg, fixture.msg_len, fixture.basename, fixture.basename_len));
+
+    ecdaa_signature_ZZZ_verify_begin_with_basename_ctx(&verify_ctx, &sig, &verifier_basename_ctx);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, fixture.msg, fixture.msg_len);
+    TEST_ASSERT(0 == ecdaa_signature_ZZZ_verify_finish_prepared(&verify_ctx, &prepared_gpk, &fixture.revocations));
+
+    // Revoked basename
+    ECP_ZZZ bsn_rev_list[1];
+    ECP_ZZZ_copy(&bsn_rev_list[0], &sig.K);
+    struct ecdaa_revocations_ZZZ bsn_revocations = {.sk_length=0, .sk_list=NULL, .bsn_length=1, .bsn_list=bsn_rev_list, .sk_scan_threads=0, .bsn_set=NULL, .num_pseudonym_indexes=0, .pseudonym_indexes=NULL};
+    ecdaa_signature_ZZZ_verify_begin_with_basename_ctx(&verify_ctx, &sig, &verifier_basename_ctx);
+    ecdaa_signature_ZZZ_verify_update(&verify_ctx, fixture.msg, fixture.msg_len);
+    TEST_ASSERT(-1 == ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &fixture.ipk.gpk, &bsn_revocations));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
@@ -58,3 +58,9 @@ if [[ 0 -eq $verify_rc ]]; then
         exit 1
 fi
 set -e
+
+echo "Sign and verify a message larger than one read (the tool streams it)..."
+head -c 100000 /dev/urandom > ${tmp_dir}/message_large.bin
+${tool_dir}/ecdaa member sign -s ${tmp_dir}/sk.bin -g ${tmp_dir}/sig_large.bin -c \
+        ${tmp_dir}/cred.bin -m ${tmp_dir}/message_large.bin
+${tool_dir}/ecdaa verify -s ${tmp_dir}/sig_large.bin -g ${tmp_dir}/gpk.bin -m ${tmp_dir}/message_large.bin
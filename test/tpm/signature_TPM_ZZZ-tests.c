@@ -90,10 +90,7 @@ static void setup(sign_and_verify_fixture* fixture)
     fixture->basename = (uint8_t*) "BASENAME";
     fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
 
-    fixture->revocations.sk_length=0;
-    fixture->revocations.sk_list=NULL;
-    fixture->revocations.bsn_length=0;
-    fixture->revocations.bsn_list=NULL;
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
 }
 
 static void teardown(sign_and_verify_fixture *fixture)
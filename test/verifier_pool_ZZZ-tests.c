@@ -0,0 +1,282 @@
+/******************************************************************************
+ *
+ * Copyright 2017 Xaptum, Inc.
+ * 
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ * 
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License
+ *
+ *****************************************************************************/
+
+#include "ecdaa-test-utils.h"
+
+#include "amcl-extensions/ecp_ZZZ.h"
+#include "amcl-extensions/ecp2_ZZZ.h"
+
+#include <ecdaa/member_keypair_ZZZ.h>
+#include <ecdaa/credential_ZZZ.h>
+#include <ecdaa/issuer_keypair_ZZZ.h>
+#include <ecdaa/signature_ZZZ.h>
+#include <ecdaa/prepared_gpk_ZZZ.h>
+#include <ecdaa/revocations_ZZZ.h>
+#include <ecdaa/verifier_pool_ZZZ.h>
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+#define NUM_JOBS 8
+
+static void init_with_no_threads_fails();
+static void wait_collects_all_jobs();
+static void callbacks_called_for_all_jobs();
+static void submit_fails_when_full();
+static void event_fd_signaled();
+
+typedef struct pool_fixture {
+    uint8_t *msg;
+    uint32_t msg_len;
+    uint8_t *basename;
+    uint32_t basename_len;
+    struct ecdaa_revocations_ZZZ revocations;
+    struct ecdaa_issuer_public_key_ZZZ ipk;
+    struct ecdaa_prepared_gpk_ZZZ prepared_gpk;
+    struct ecdaa_signature_ZZZ signatures[NUM_JOBS];
+    struct ecdaa_verifier_pool_job_ZZZ jobs[NUM_JOBS];
+    pthread_t threads[NUM_THREADS];
+    struct ecdaa_verifier_pool_job_ZZZ *submitted[NUM_JOBS];
+    struct ecdaa_verifier_pool_job_ZZZ *completed[NUM_JOBS];
+    struct ecdaa_verifier_pool_ZZZ pool;
+} pool_fixture;
+
+// Large, so keep it off the stack.
+static pool_fixture fixture;
+
+static pthread_mutex_t callback_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t num_callbacks;
+
+static void setup(pool_fixture *fixture, ecdaa_verifier_pool_ZZZ_callback callback);
+static void teardown(pool_fixture *fixture);
+static void count_callback(struct ecdaa_verifier_pool_job_ZZZ *job);
+
+int main()
+{
+    init_with_no_threads_fails();
+    wait_collects_all_jobs();
+    callbacks_called_for_all_jobs();
+    submit_fails_when_full();
+    event_fd_signaled();
+}
+
+static void setup(pool_fixture *fixture, ecdaa_verifier_pool_ZZZ_callback callback)
+{
+    struct ecdaa_issuer_secret_key_ZZZ isk;
+    ecp_ZZZ_random_mod_order(&isk.x, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.X);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.X, isk.x);
+
+    ecp_ZZZ_random_mod_order(&isk.y, test_randomness);
+    ecp2_ZZZ_set_to_generator(&fixture->ipk.gpk.Y);
+    ECP2_ZZZ_mul(&fixture->ipk.gpk.Y, isk.y);
+
+    ecdaa_prepared_gpk_ZZZ_prepare(&fixture->prepared_gpk, &fixture->ipk.gpk);
+
+    struct ecdaa_member_public_key_ZZZ pk;
+    struct ecdaa_member_secret_key_ZZZ sk;
+    ecp_ZZZ_set_to_generator(&pk.Q);
+    ecp_ZZZ_random_mod_order(&sk.sk, test_randomness);
+    ECP_ZZZ_mul(&pk.Q, sk.sk);
+
+    struct ecdaa_credential_ZZZ cred;
+    struct ecdaa_credential_ZZZ_signature cred_sig;
+    ecdaa_credential_ZZZ_generate(&cred, &cred_sig, &isk, &pk, test_randomness);
+
+    fixture->msg = (uint8_t*) "Test message";
+    fixture->msg_len = (uint32_t)strlen((char*)fixture->msg);
+
+    fixture->basename = (uint8_t*) "BASENAME";
+    fixture->basename_len = (uint32_t)strlen((char*)fixture->basename);
+
+    ecdaa_revocations_ZZZ_init(&fixture->revocations);
+
+    // Every odd-numbered job has a bad signature.
+    for (size_t i = 0; i < NUM_JOBS; ++i) {
+        TEST_ASSERT(0 == ecdaa_signature_ZZZ_sign(&fixture->signatures[i], fixture->msg, fixture->msg_len, fixture->basename, fixture->basename_len, &sk, &cred, test_randomness));
+        if (1 == i % 2)
+            BIG_XXX_inc(fixture->signatures[i].s, 1);
+
+        struct ecdaa_verifier_pool_job_ZZZ *job = &fixture->jobs[i];
+        job->signature = &fixture->signatures[i];
+        job->message = fixture->msg;
+        job->message_len = fixture->msg_len;
+        job->basename = fixture->basename;
+        job->basename_len = fixture->basename_len;
+        job->callback = callback;
+        job->user_data = (void*)i;
+        job->result = 1;
+    }
+
+    TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_init(&fixture->pool,
+                                                  &fixture->prepared_gpk,
+                                                  &fixture->revocations,
+                                                  ECDAA_VERIFY_POLICY_FAIL_FAST,
+                                                  fixture->threads,
+                                                  NUM_THREADS,
+                                                  fixture->submitted,
+                                                  fixture->completed,
+                                                  NUM_JOBS));
+}
+
+static void teardown(pool_fixture *fixture)
+{
+    ecdaa_verifier_pool_ZZZ_destroy(&fixture->pool);
+}
+
+static void count_callback(struct ecdaa_verifier_pool_job_ZZZ *job)
+{
+    (void)job;
+
+    pthread_mutex_lock(&callback_mutex);
+    ++num_callbacks;
+    pthread_mutex_unlock(&callback_mutex);
+}
+
+static void init_with_no_threads_fails()
+{
+    printf("Starting verifier_pool::init_with_no_threads_fails...\n");
+
+    TEST_ASSERT(0 != ecdaa_verifier_pool_ZZZ_init(&fixture.pool,
+                                                  &fixture.prepared_gpk,
+                                                  &fixture.revocations,
+                                                  ECDAA_VERIFY_POLICY_COMPLETE,
+                                                  fixture.threads,
+                                                  0,
+                                                  fixture.submitted,
+                                                  fixture.completed,
+                                                  NUM_JOBS));
+
+    printf("\tsuccess\n");
+}
+
+static void wait_collects_all_jobs()
+{
+    printf("Starting verifier_pool::wait_collects_all_jobs...\n");
+
+    setup(&fixture, NULL);
+
+    for (size_t i = 0; i < NUM_JOBS; ++i) {
+        TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &fixture.jobs[i]));
+    }
+
+    size_t num_collected = 0;
+    struct ecdaa_verifier_pool_job_ZZZ *collected[NUM_JOBS];
+    size_t num_ret;
+    while (0 != (num_ret = ecdaa_verifier_pool_ZZZ_wait(&fixture.pool, collected, NUM_JOBS))) {
+        for (size_t i = 0; i < num_ret; ++i) {
+            size_t index = (size_t)collected[i]->user_data;
+            if (0 == index % 2) {
+                TEST_ASSERT(0 == collected[i]->result);
+                TEST_ASSERT(ECDAA_VERIFY_STAGE_NONE == collected[i]->rejected_stage);
+            } else {
+                TEST_ASSERT(-1 == collected[i]->result);
+                TEST_ASSERT(ECDAA_VERIFY_STAGE_SCHNORR == collected[i]->rejected_stage);
+            }
+        }
+        num_collected += num_ret;
+    }
+    TEST_ASSERT(NUM_JOBS == num_collected);
+
+    TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_poll(&fixture.pool, collected, NUM_JOBS));
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void callbacks_called_for_all_jobs()
+{
+    printf("Starting verifier_pool::callbacks_called_for_all_jobs...\n");
+
+    setup(&fixture, count_callback);
+    num_callbacks = 0;
+
+    for (size_t i = 0; i < NUM_JOBS; ++i) {
+        TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &fixture.jobs[i]));
+    }
+
+    // Returns once all callbacks are done, with nothing on the completion queue.
+    struct ecdaa_verifier_pool_job_ZZZ *collected[NUM_JOBS];
+    TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_wait(&fixture.pool, collected, NUM_JOBS));
+    TEST_ASSERT(NUM_JOBS == num_callbacks);
+
+    for (size_t i = 0; i < NUM_JOBS; ++i) {
+        TEST_ASSERT((0 == i % 2) == (0 == fixture.jobs[i].result));
+    }
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
+
+static void submit_fails_when_full()
+{
+    printf("Starting verifier_pool::submit_fails_when_full...\n");
+
+    setup(&fixture, NULL);
+
+    for (size_t i = 0; i < NUM_JOBS; ++i) {
+        TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &fixture.jobs[i]));
+    }
+
+    // Jobs occupy the pool until collected.
+    struct ecdaa_verifier_pool_job_ZZZ extra_job = fixture.jobs[0];
+    TEST_ASSERT(0 != ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &extra_job));
+
+    struct ecdaa_verifier_pool_job_ZZZ *collected[1];
+    TEST_ASSERT(1 == ecdaa_verifier_pool_ZZZ_wait(&fixture.pool, collected, 1));
+    TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &extra_job));
+
+    // Destroy finishes the remaining jobs.
+    teardown(&fixture);
+    TEST_ASSERT(0 == extra_job.result);
+
+    printf("\tsuccess\n");
+}
+
+static void event_fd_signaled()
+{
+    printf("Starting verifier_pool::event_fd_signaled...\n");
+
+    setup(&fixture, NULL);
+
+    int fd = ecdaa_verifier_pool_ZZZ_event_fd(&fixture.pool);
+#ifdef __linux__
+    TEST_ASSERT(fd >= 0);
+
+    // Nothing completed yet.
+    uint64_t count = 0;
+    TEST_ASSERT(-1 == read(fd, &count, sizeof(count)));
+
+    TEST_ASSERT(0 == ecdaa_verifier_pool_ZZZ_submit(&fixture.pool, &fixture.jobs[0]));
+    struct ecdaa_verifier_pool_job_ZZZ *collected[1];
+    TEST_ASSERT(1 == ecdaa_verifier_pool_ZZZ_wait(&fixture.pool, collected, 1));
+
+    TEST_ASSERT(sizeof(count) == read(fd, &count, sizeof(count)));
+    TEST_ASSERT(1 == count);
+#else
+    TEST_ASSERT(-1 == fd);
+#endif
+
+    teardown(&fixture);
+
+    printf("\tsuccess\n");
+}
@@ -22,7 +22,10 @@
 
 #include "tool_rand.h"
 
-#define MAX_MESSAGE_SIZE 1024
+#include <stdio.h>
+
+#define MAX_BASENAME_SIZE 1024
+#define MESSAGE_CHUNK_SIZE 4096
 
 int member_sign_ZZZ(const char* secret_key_file, const char* credential_file, const char* sig_out_file,
                         const char* message_file, const char* basename_file)
@@ -41,18 +44,10 @@ int member_sign_ZZZ(const char* secret_key_file, const char* credential_file, co
         return ret;
     }
 
-    // Read message file
-    uint8_t message[MAX_MESSAGE_SIZE];
-    int read_ret = ecdaa_read_from_file(message, sizeof(message), message_file);
-    if (read_ret < 0) {
-        return READ_FROM_FILE_ERROR;
-    }
-    uint32_t msg_len = (uint32_t)read_ret;
-
     // Read basename file (if requested)
     uint8_t *basename = NULL;
     uint32_t basename_len = 0;
-    uint8_t basename_buffer[MAX_MESSAGE_SIZE];
+    uint8_t basename_buffer[MAX_BASENAME_SIZE];
     if (NULL != basename_file) {
         basename = basename_buffer;
 
@@ -63,12 +58,34 @@ int member_sign_ZZZ(const char* secret_key_file, const char* credential_file, co
         basename_len = (uint32_t)read_ret;
     }
 
-    // Create signature
-    struct ecdaa_signature_ZZZ sig;
-    if (0 != ecdaa_signature_ZZZ_sign(&sig, message, msg_len, basename, basename_len, &sk, &cred, tool_rand)) {
+    // Open message file
+    FILE *message_fp = fopen(message_file, "rb");
+    if (NULL == message_fp) {
+        return READ_FROM_FILE_ERROR;
+    }
+
+    // Create signature, hashing the message as it's read
+    //  (so it needn't fit in memory)
+    struct ecdaa_signature_ZZZ_sign_ctx sign_ctx;
+    if (0 != ecdaa_signature_ZZZ_sign_begin(&sign_ctx, basename, basename_len, &sk, &cred, tool_rand)) {
+        fclose(message_fp);
         return SIGNING_ERROR;
     }
 
+    uint8_t message_chunk[MESSAGE_CHUNK_SIZE];
+    size_t chunk_len;
+    while (0 != (chunk_len = fread(message_chunk, 1, sizeof(message_chunk), message_fp))) {
+        ecdaa_signature_ZZZ_sign_update(&sign_ctx, message_chunk, (uint32_t)chunk_len);
+    }
+    int read_error = ferror(message_fp);
+    fclose(message_fp);
+
+    struct ecdaa_signature_ZZZ sig;
+    ecdaa_signature_ZZZ_sign_finish(&sign_ctx, &sig);
+    if (read_error) {
+        return READ_FROM_FILE_ERROR;
+    }
+
     // Write signature to file
     int has_nym = basename_len != 0;
     ecdaa_signature_ZZZ_serialize_file(sig_out_file, &sig, has_nym);
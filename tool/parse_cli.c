@@ -378,9 +378,11 @@ void parse_verify_cli(int argc, char **argv, struct cli_params *params)
         "\t\t-s --sig               Signature location [default = sig.bin].\n"
         "\t\t-k --sk_rev_list       Secret key revocation list location [default = NULL].\n"
         "\t\t-e --num_sk_revs       Number of secret key revocations [default = 0].\n"
+        "\t\t\t(Not needed if the list is a binary revocation-list file.)\n"
         "\t\t-b --basename          Basename location [default = NULL].\n"
         "\t\t-n --bsn_rev_list      Basename revocation list location [default = NULL].\n"
         "\t\t-v --num_bsn_revs      Number of basename revocations [default = 0].\n"
+        "\t\t\t(Not needed if the list is a binary revocation-list file.)\n"
         ;
 
     static struct option cli_options[] =
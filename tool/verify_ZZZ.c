@@ -20,13 +20,21 @@
 
 #include <ecdaa.h>
 
-#define MAX_MESSAGE_SIZE 1024
+#include <stdio.h>
+
+#define MAX_BASENAME_SIZE 1024
+#define MESSAGE_CHUNK_SIZE 4096
+
+static
+int parse_sk_rev_list_file(struct ecdaa_revocations_ZZZ *rev_list_out, struct ecdaa_revocations_file_ZZZ *file_out,
+                           const char *filename, unsigned num_revs);
 
 static
-int parse_sk_rev_list_file(struct ecdaa_revocations_ZZZ *rev_list_out, const char *filename, unsigned num_revs);
+int parse_bsn_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, struct ecdaa_revocations_file_ZZZ *file_out,
+                            const char *filename, unsigned num_revs);
 
 static
-int parse_bsn_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, const char *filename, unsigned num_revs);
+int is_binary_rev_list_file(const char *filename);
 
 int verify_ZZZ(const char *message_file, const char *sig_file, const char *gpk_file, const char *sk_rev_list_file,
                 const char *sk_revs, const char *bsn_rev_list_file, const char *bsn_revs, const char *basename_file)
@@ -39,14 +47,16 @@ int verify_ZZZ(const char *message_file, const char *sig_file, const char *gpk_f
     int number_of_bsn_revs = atoi(bsn_revs);
 
     struct ecdaa_revocations_ZZZ revocations;
-    revocations.sk_list = NULL;
-    revocations.bsn_list = NULL;
+    ecdaa_revocations_ZZZ_init(&revocations);
 
+    // Binary revocation-list files are mapped, rather than read into malloc'd lists.
+    struct ecdaa_revocations_file_ZZZ sk_rev_file = {.map=NULL, .map_length=0};
+    struct ecdaa_revocations_file_ZZZ bsn_rev_file = {.map=NULL, .map_length=0};
 
     // Read basename file (if requested)
     uint8_t *basename = NULL;
     uint32_t basename_len = 0;
-    uint8_t basename_buffer[MAX_MESSAGE_SIZE];
+    uint8_t basename_buffer[MAX_BASENAME_SIZE];
     if (NULL != basename_file) {
         basename = basename_buffer;
 
@@ -87,51 +97,81 @@ int verify_ZZZ(const char *message_file, const char *sig_file, const char *gpk_f
     }
 
     // Read in sk_rev_list from disk.
-    if (0 != parse_sk_rev_list_file(&revocations, sk_rev_list_file, number_of_sk_revs)) {
+    if (0 != parse_sk_rev_list_file(&revocations, &sk_rev_file, sk_rev_list_file, number_of_sk_revs)) {
         ret = PARSE_REVOC_LIST_ERROR;
         goto cleanup;
     }
 
     // Read in bsn_rev_list from disk.
-    if (0 != parse_bsn_rev_list_file(&revocations, bsn_rev_list_file, number_of_bsn_revs)) {
+    if (0 != parse_bsn_rev_list_file(&revocations, &bsn_rev_file, bsn_rev_list_file, number_of_bsn_revs)) {
         ret = PARSE_REVOC_LIST_ERROR;
         goto cleanup;
     }
 
-    // Read message from disk.
-    uint8_t message[MAX_MESSAGE_SIZE];
-    int read_ret = ecdaa_read_from_file(message, sizeof(message), message_file);
-    if (read_ret < 0) {
+    // Verify signature, hashing the message as it's read from disk
+    //  (so it needn't fit in memory)
+    FILE *message_fp = fopen(message_file, "rb");
+    if (NULL == message_fp) {
         ret = READ_FROM_FILE_ERROR;
         goto cleanup;
     }
-    uint32_t msg_len = (uint32_t)read_ret;
 
-    // Verify signature
-    if (0 != ecdaa_signature_ZZZ_verify(&sig, &gpk, &revocations, message, msg_len, basename, basename_len)) {
+    struct ecdaa_signature_ZZZ_verify_ctx verify_ctx;
+    ecdaa_signature_ZZZ_verify_begin(&verify_ctx, &sig, basename, basename_len);
+
+    uint8_t message_chunk[MESSAGE_CHUNK_SIZE];
+    size_t chunk_len;
+    while (0 != (chunk_len = fread(message_chunk, 1, sizeof(message_chunk), message_fp))) {
+        ecdaa_signature_ZZZ_verify_update(&verify_ctx, message_chunk, (uint32_t)chunk_len);
+    }
+    int read_error = ferror(message_fp);
+    fclose(message_fp);
+
+    int verify_ret = ecdaa_signature_ZZZ_verify_finish(&verify_ctx, &gpk, &revocations);
+    if (read_error) {
+        ret = READ_FROM_FILE_ERROR;
+        goto cleanup;
+    }
+    if (0 != verify_ret) {
         ret = VERIFY_ERROR;
         goto cleanup;
     }
 
 cleanup:
-    if (NULL != revocations.sk_list) {
+    if (NULL != revocations.sk_list && NULL == sk_rev_file.map) {
         free(revocations.sk_list);
     }
-    if (NULL != revocations.bsn_list) {
+    if (NULL != revocations.bsn_list && NULL == bsn_rev_file.map) {
         free(revocations.bsn_list);
     }
+    ecdaa_revocations_ZZZ_unmap_file(&sk_rev_file);
+    ecdaa_revocations_ZZZ_unmap_file(&bsn_rev_file);
 
     return ret;
 }
 
 
-int parse_sk_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, const char *filename, unsigned num_revs)
+int parse_sk_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, struct ecdaa_revocations_file_ZZZ *file_out,
+                           const char *filename, unsigned num_revs)
 {
     int ret = 0;
 
     revocations_out->sk_list = NULL;
     revocations_out->sk_length = 0;
 
+    // A binary file records its own length, so `num_revs` isn't needed.
+    if (NULL != filename && is_binary_rev_list_file(filename)) {
+        struct ecdaa_revocations_ZZZ mapped;
+        if (0 != ecdaa_revocations_ZZZ_map_file(&mapped, file_out, filename))
+            return 1;
+
+        revocations_out->sk_list = mapped.sk_list;
+        revocations_out->sk_length = mapped.sk_length;
+        revocations_out->sk_generation = mapped.sk_generation;
+
+        return 0;
+    }
+
     if (NULL != filename && num_revs != 0) {
         // Allocate a buffer to hold the full file.
         size_t file_length = num_revs * ECDAA_MEMBER_SECRET_KEY_ZZZ_LENGTH;
@@ -182,13 +222,26 @@ cleanup:
     return ret;
 }
 
-int parse_bsn_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, const char *filename, unsigned num_revs)
+int parse_bsn_rev_list_file(struct ecdaa_revocations_ZZZ *revocations_out, struct ecdaa_revocations_file_ZZZ *file_out,
+                            const char *filename, unsigned num_revs)
 {
     int ret = 0;
 
     revocations_out->bsn_list = NULL;
     revocations_out->bsn_length = 0;
 
+    // A binary file records its own length, so `num_revs` isn't needed.
+    if (NULL != filename && is_binary_rev_list_file(filename)) {
+        struct ecdaa_revocations_ZZZ mapped;
+        if (0 != ecdaa_revocations_ZZZ_map_file(&mapped, file_out, filename))
+            return 1;
+
+        revocations_out->bsn_list = mapped.bsn_list;
+        revocations_out->bsn_length = mapped.bsn_length;
+
+        return 0;
+    }
+
     size_t point_size = (2*MODBYTES_XXX + 1);
 
     if (NULL != filename && num_revs != 0) {
@@ -242,3 +295,16 @@ cleanup:
 
     return ret;
 }
+
+int is_binary_rev_list_file(const char *filename)
+{
+    FILE *file_ptr = fopen(filename, "rb");
+    if (NULL == file_ptr)
+        return 0;
+
+    uint8_t magic[8];
+    size_t read_ret = fread(magic, 1, sizeof(magic), file_ptr);
+    fclose(file_ptr);
+
+    return ecdaa_revocations_ZZZ_is_file(magic, read_ret);
+}